@@ -0,0 +1,263 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "cookiestore.h"
+#include <QDataStream>
+#include <QSaveFile>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+	namespace
+	{
+		const quint32 LogMagic = 0x4c43434b;
+		const quint8 LogVersion = 1;
+
+		const qint64 HeaderSize = sizeof (LogMagic) + sizeof (LogVersion);
+
+		const qint64 MinCompactionGarbage = 256 * 1024;
+
+		QByteArray Serialize (const QList<QNetworkCookie>& cookies)
+		{
+			QByteArray result;
+			for (const auto& cookie : cookies)
+			{
+				if (cookie.isSessionCookie ())
+					continue;
+
+				result += cookie.toRawForm ();
+				result += '\n';
+			}
+			return result;
+		}
+
+		qint64 GetRecordSize (const QString& domain, const QByteArray& raw)
+		{
+			// The sizes of a QString and a QByteArray in a QDataStream.
+			return sizeof (quint32) + domain.size () * 2 + sizeof (quint32) + raw.size ();
+		}
+	}
+
+	CookieStore::CookieStore (const QString& path)
+	: File_ { path }
+	{
+	}
+
+	bool CookieStore::Exists () const
+	{
+		return File_.exists ();
+	}
+
+	QList<QNetworkCookie> CookieStore::Load ()
+	{
+		if (!Open ())
+			return {};
+
+		QDataStream in { &File_ };
+		in.setVersion (QDataStream::Qt_5_0);
+
+		quint32 magic = 0;
+		quint8 version = 0;
+		in >> magic >> version;
+		if (in.status () != QDataStream::Ok ||
+				magic != LogMagic ||
+				version != LogVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown cookie store format in"
+					<< File_.fileName ()
+					<< "; discarding it";
+			File_.resize (0);
+			WriteHeader ();
+			return {};
+		}
+
+		auto lastGood = File_.pos ();
+		while (!in.atEnd ())
+		{
+			QString domain;
+			QByteArray raw;
+			in >> domain >> raw;
+			if (in.status () != QDataStream::Ok)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "truncated record at"
+						<< lastGood
+						<< "in"
+						<< File_.fileName ();
+				File_.resize (lastGood);
+				break;
+			}
+
+			const auto pos = Records_.find (domain);
+			if (pos != Records_.end ())
+			{
+				LiveSize_ -= GetRecordSize (domain, *pos);
+				Records_.erase (pos);
+			}
+			if (!raw.isEmpty ())
+			{
+				Records_ [domain] = raw;
+				LiveSize_ += GetRecordSize (domain, raw);
+			}
+
+			lastGood = File_.pos ();
+		}
+
+		QList<QNetworkCookie> result;
+		for (const auto& raw : Records_)
+			for (const auto& line : raw.split ('\n'))
+				result += QNetworkCookie::parseCookies (line);
+
+		Compact ();
+
+		return result;
+	}
+
+	bool CookieStore::Write (const QHash<QString, QList<QNetworkCookie>>& domains)
+	{
+		if (!File_.isOpen () && !Open ())
+			return false;
+
+		QDataStream out { &File_ };
+		out.setVersion (QDataStream::Qt_5_0);
+
+		File_.seek (File_.size ());
+
+		for (auto i = domains.begin (); i != domains.end (); ++i)
+		{
+			const auto& domain = i.key ();
+			const auto& raw = Serialize (*i);
+
+			const auto pos = Records_.find (domain);
+			if (pos == Records_.end () ? raw.isEmpty () : *pos == raw)
+				continue;
+
+			out << domain << raw;
+
+			if (pos != Records_.end ())
+			{
+				LiveSize_ -= GetRecordSize (domain, *pos);
+				Records_.erase (pos);
+			}
+			if (!raw.isEmpty ())
+			{
+				Records_ [domain] = raw;
+				LiveSize_ += GetRecordSize (domain, raw);
+			}
+		}
+
+		if (out.status () != QDataStream::Ok || !File_.flush ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to write to"
+					<< File_.fileName ()
+					<< File_.errorString ();
+			return false;
+		}
+
+		Compact ();
+
+		return true;
+	}
+
+	bool CookieStore::Clear ()
+	{
+		if (File_.isOpen () && Records_.isEmpty () && File_.size () == HeaderSize)
+			return true;
+
+		if (!File_.isOpen () && !Open ())
+			return false;
+
+		Records_.clear ();
+		LiveSize_ = 0;
+
+		return File_.resize (0) && WriteHeader ();
+	}
+
+	bool CookieStore::Open ()
+	{
+		if (!File_.open (QIODevice::ReadWrite))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< File_.fileName ()
+					<< File_.errorString ();
+			return false;
+		}
+
+		if (!File_.size ())
+			return WriteHeader ();
+
+		return true;
+	}
+
+	bool CookieStore::WriteHeader ()
+	{
+		File_.seek (0);
+
+		QDataStream out { &File_ };
+		out.setVersion (QDataStream::Qt_5_0);
+		out << LogMagic << LogVersion;
+
+		return out.status () == QDataStream::Ok && File_.flush ();
+	}
+
+	void CookieStore::Compact ()
+	{
+		const auto garbage = File_.size () - HeaderSize - LiveSize_;
+		if (garbage < MinCompactionGarbage || garbage < LiveSize_)
+			return;
+
+		QSaveFile file { File_.fileName () };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out.setVersion (QDataStream::Qt_5_0);
+		out << LogMagic << LogVersion;
+		for (auto i = Records_.begin (); i != Records_.end (); ++i)
+			out << i.key () << *i;
+
+		File_.close ();
+		if (!file.commit ())
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< file.fileName ()
+					<< file.errorString ();
+
+		Open ();
+	}
+}
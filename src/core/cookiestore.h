@@ -0,0 +1,98 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QNetworkCookie>
+
+namespace LeechCraft
+{
+	/** @brief Persistent storage for cookies, split by domain.
+	 *
+	 * The store is an append-only log of per-domain records, each
+	 * replacing the previous record for the same domain, so saving the
+	 * cookies of a domain doesn't touch the others. An empty record
+	 * removes the domain. The log is compacted once most of it is
+	 * superseded records.
+	 *
+	 * Session cookies are never stored.
+	 */
+	class CookieStore
+	{
+		QFile File_;
+
+		QHash<QString, QByteArray> Records_;
+		qint64 LiveSize_ = 0;
+	public:
+		/** @brief Creates the store backed by the given file.
+		 *
+		 * The file isn't read until Load() is called.
+		 */
+		explicit CookieStore (const QString& path);
+
+		CookieStore (const CookieStore&) = delete;
+		CookieStore& operator= (const CookieStore&) = delete;
+
+		/** @brief Returns whether the backing file exists.
+		 */
+		bool Exists () const;
+
+		/** @brief Reads all the stored cookies.
+		 *
+		 * A truncated record at the end of the log, like the one left
+		 * by a crash, is dropped.
+		 *
+		 * @return The stored cookies.
+		 */
+		QList<QNetworkCookie> Load ();
+
+		/** @brief Replaces the stored cookies of the given domains.
+		 *
+		 * Domains whose cookies haven't actually changed are skipped.
+		 *
+		 * @param[in] domains The cookie domains mapped to all their
+		 * current cookies.
+		 * @return Whether the cookies have been written successfully.
+		 */
+		bool Write (const QHash<QString, QList<QNetworkCookie>>& domains);
+
+		/** @brief Removes all the stored cookies.
+		 *
+		 * @return Whether the cookies have been removed successfully.
+		 */
+		bool Clear ();
+	private:
+		bool Open ();
+		bool WriteHeader ();
+		void Compact ();
+	};
+}
@@ -116,6 +116,8 @@ namespace LeechCraft
 			if (Core::Instance ().IsShuttingDown ())
 				return {};
 
+			Core::Instance ().GetPluginManager ()->ActivateForEntity (e);
+
 			const auto& unwanted = e.Additional_ ["IgnorePlugins"].toStringList ();
 			auto removeUnwanted = [&unwanted] (QObjectList& handlers)
 			{
@@ -34,6 +34,7 @@
 #include <QDir>
 #include <QFile>
 #include <QNetworkReply>
+#include <QNetworkCookie>
 #include <QTimer>
 #include <util/util.h>
 #include <util/network/customcookiejar.h>
@@ -43,6 +44,7 @@
 #include "xmlsettingsmanager.h"
 #include "mainwindow.h"
 #include "sslerrorshandler.h"
+#include "cookiestore.h"
 
 Q_DECLARE_METATYPE (QNetworkReply*);
 
@@ -52,6 +54,7 @@ using namespace LeechCraft::Util;
 NetworkAccessManager::NetworkAccessManager (QObject *parent)
 : QNetworkAccessManager (parent)
 , CookieSaveTimer_ (new QTimer (this))
+, CookieStore_ (new CookieStore (QDir::homePath () + "/.leechcraft/core/cookies.log"))
 {
 	connect (this,
 			SIGNAL (sslErrors (QNetworkReply*, QList<QSslError>)),
@@ -98,15 +101,22 @@ NetworkAccessManager::NetworkAccessManager (QObject *parent)
 			<< "so continuing without cache";
 	}
 
-	QFile file (QDir::homePath () +
-			"/.leechcraft/core/cookies.txt");
-	if (file.open (QIODevice::ReadOnly))
-		CookieJar_->Load (file.readAll ());
+	if (CookieStore_->Exists ())
+		CookieJar_->LoadCookies (CookieStore_->Load ());
 	else
-		qWarning () << Q_FUNC_INFO
-			<< "could not open file"
-			<< file.fileName ()
-			<< file.errorString ();
+	{
+		// The cookies used to be stored in a single text file, which
+		// is imported once and left intact.
+		QFile file (QDir::homePath () +
+				"/.leechcraft/core/cookies.txt");
+		if (file.open (QIODevice::ReadOnly))
+			CookieJar_->Load (file.readAll ());
+		else
+			qWarning () << Q_FUNC_INFO
+				<< "could not open file"
+				<< file.fileName ()
+				<< file.errorString ();
+	}
 
 	connect (CookieSaveTimer_,
 			SIGNAL (timeout ()),
@@ -155,7 +165,7 @@ void LeechCraft::NetworkAccessManager::handleSslErrors (QNetworkReply *replyObj,
 	new SslErrorsHandler { replyObj, errors };
 }
 
-void LeechCraft::NetworkAccessManager::saveCookies () const
+void LeechCraft::NetworkAccessManager::saveCookies ()
 {
 	QDir dir = QDir::home ();
 	dir.cd (".leechcraft");
@@ -166,19 +176,36 @@ void LeechCraft::NetworkAccessManager::saveCookies () const
 		return;
 	}
 
-	QFile file (QDir::homePath () +
-			"/.leechcraft/core/cookies.txt");
-	if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate))
+	const bool saveEnabled = !XmlSettingsManager::Instance ()->
+			property ("DeleteCookiesOnExit").toBool ();
+	if (!saveEnabled)
+	{
+		if (!CookieStore_->Clear ())
+			emit error (tr ("Could not save cookies, error opening cookie file."));
+		CookiesCleared_ = true;
+		return;
+	}
+
+	auto domains = CookieJar_->TakeDirtyDomains ();
+	if (CookiesCleared_)
+		domains.unite (QSet<QString>::fromList (CookieJar_->GetDomains ()));
+	if (domains.isEmpty ())
+		return;
+
+	QHash<QString, QList<QNetworkCookie>> changes;
+	for (const auto& domain : domains)
+		changes [domain] = CookieJar_->GetDomainCookies (domain);
+
+	if (!CookieStore_->Write (changes))
 	{
 		emit error (tr ("Could not save cookies, error opening cookie file."));
-		qWarning () << Q_FUNC_INFO
-			<< file.errorString ();
+
+		// Retry the same domains next time.
+		CookieJar_->MarkDomainsDirty (domains);
 		return;
 	}
 
-	const bool saveEnabled = !XmlSettingsManager::Instance ()->
-			property ("DeleteCookiesOnExit").toBool ();
-	file.write (saveEnabled ? CookieJar_->Save () : QByteArray ());
+	CookiesCleared_ = false;
 }
 
 void LeechCraft::NetworkAccessManager::handleFilterTrackingCookies ()
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <QNetworkAccessManager>
 #include <QLocale>
 #include "interfaces/core/ihookproxy.h"
@@ -38,6 +39,7 @@ class QTimer;
 namespace LeechCraft
 {
 	class SslErrorsDialog;
+	class CookieStore;
 
 	namespace Util
 	{
@@ -51,6 +53,9 @@ namespace LeechCraft
 		QTimer * const CookieSaveTimer_;
 
 		Util::CustomCookieJar *CookieJar_;
+
+		const std::unique_ptr<CookieStore> CookieStore_;
+		bool CookiesCleared_ = false;
 	public:
 		NetworkAccessManager (QObject* = 0);
 		virtual ~NetworkAccessManager ();
@@ -60,7 +65,7 @@ namespace LeechCraft
 	private slots:
 		void handleSslErrors (QNetworkReply*, const QList<QSslError>&);
 
-		void saveCookies () const;
+		void saveCookies ();
 		void handleFilterTrackingCookies ();
 		void setCookiesEnabled ();
 		void setMatchDomainExactly ();
@@ -53,6 +53,7 @@ namespace LeechCraft
 			return;
 
 		IInfo *ii = qobject_cast<IInfo*> (obj);
+		RemoveDeferred (ii->GetUniqueID ());
 
 		for (const auto& info : imt->GetTabClasses ())
 		{
@@ -88,6 +89,34 @@ namespace LeechCraft
 		}
 	}
 
+	void NewTabMenuManager::AddDeferred (const QByteArray& pluginId, const QString& pluginName,
+			const QIcon& pluginIcon, const TabClasses_t& tabClasses)
+	{
+		const auto tcCount = std::count_if (tabClasses.begin (), tabClasses.end (),
+				[] (const TabClassInfo& tc) { return tc.Features_ & TFOpenableByRequest; });
+
+		for (const auto& info : tabClasses)
+		{
+			if (!(info.Features_ & TFOpenableByRequest))
+				continue;
+
+			QAction *newAct = new QAction (info.Icon_,
+					AccelerateName (info.VisibleName_),
+					this);
+			connect (newAct,
+					SIGNAL (triggered ()),
+					this,
+					SLOT (handleNewTabRequested ()));
+			newAct->setProperty ("DeferredPluginID", pluginId);
+			newAct->setProperty ("TabClass", info.TabClass_);
+			newAct->setStatusTip (info.Description_);
+			newAct->setToolTip (info.Description_);
+
+			InsertActionToMenu (newAct, pluginName, pluginIcon, tcCount > 1);
+			DeferredActions_ [pluginId] << newAct;
+		}
+	}
+
 	void NewTabMenuManager::SetToolbarActions (QList<QList<QAction*>> lists)
 	{
 		QList<QAction*> ones;
@@ -201,6 +230,12 @@ namespace LeechCraft
 
 	void NewTabMenuManager::OpenTab (QAction *action)
 	{
+		if (!action->property ("DeferredPluginID").isNull ())
+		{
+			OpenDeferredTab (action);
+			return;
+		}
+
 		QObject *pObj = action->property ("PluginObj").value<QObject*> ();
 		IHaveTabs *tabs = qobject_cast<IHaveTabs*> (pObj);
 		if (!tabs)
@@ -262,10 +297,14 @@ namespace LeechCraft
 				[] (const TabClassInfo& tc) { return tc.Features_ & TFOpenableByRequest; });
 
 		const auto ii = qobject_cast<IInfo*> (pObj);
-		const auto& name = ii->GetName ();
+		InsertActionToMenu (act, ii->GetName (), ii->GetIcon (), sub || tcCount > 1);
+	}
 
+	void NewTabMenuManager::InsertActionToMenu (QAction *act,
+			const QString& name, const QIcon& icon, bool sub)
+	{
 		auto rootMenu = NewTabMenu_;
-		if (sub || tcCount > 1)
+		if (sub)
 		{
 			bool menuFound = false;
 			for (auto menuAct : rootMenu->actions ())
@@ -279,7 +318,7 @@ namespace LeechCraft
 			if (!menuFound)
 			{
 				auto menu = new QMenu (name, rootMenu);
-				menu->setIcon (ii->GetIcon ());
+				menu->setIcon (icon);
 				rootMenu->insertMenu (FindActionBefore (name, rootMenu), menu);
 				rootMenu = menu;
 			}
@@ -288,6 +327,48 @@ namespace LeechCraft
 		rootMenu->insertAction (FindActionBefore (act->text (), rootMenu), act);
 	}
 
+	void NewTabMenuManager::RemoveDeferred (const QByteArray& pluginId)
+	{
+		for (const auto action : DeferredActions_.take (pluginId))
+		{
+			for (const auto widget : action->associatedWidgets ())
+				widget->removeAction (action);
+
+			// The action may be the one being triggered right now.
+			action->deleteLater ();
+		}
+	}
+
+	void NewTabMenuManager::OpenDeferredTab (QAction *action)
+	{
+		const auto& pluginId = action->property ("DeferredPluginID").toByteArray ();
+		const auto& tabClass = action->property ("TabClass").toByteArray ();
+
+		const auto pObj = Core::Instance ().GetPluginManager ()->ActivateDeferred (pluginId);
+		if (!pObj)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to activate"
+					<< pluginId;
+			return;
+		}
+
+		// Activation has replaced the placeholder actions with the real ones.
+		for (const auto realAction : findChildren<QAction*> ())
+			if (realAction->property ("PluginObj").value<QObject*> () == pObj &&
+					realAction->property ("TabClass").toByteArray () == tabClass)
+			{
+				OpenTab (realAction);
+				return;
+			}
+
+		qWarning () << Q_FUNC_INFO
+				<< "no action for"
+				<< tabClass
+				<< "after activating"
+				<< pluginId;
+	}
+
 	void NewTabMenuManager::handleNewTabRequested ()
 	{
 		QAction *action = qobject_cast<QAction*> (sender ());
@@ -33,9 +33,11 @@
 #include <QMap>
 #include <QString>
 #include <QSet>
+#include <interfaces/ihavetabs.h>
 
 class QMenu;
 class QAction;
+class QIcon;
 
 class ITabWidget;
 
@@ -50,10 +52,18 @@ namespace LeechCraft
 		QList<QObject*> RegisteredMultiTabs_;
 		QSet<QChar> UsedAccelerators_;
 		QMap<QObject*, QMap<QString, QAction*>> HiddenActions_;
+		QMap<QByteArray, QList<QAction*>> DeferredActions_;
 	public:
 		NewTabMenuManager (QObject* = 0);
 
 		void AddObject (QObject*);
+
+		/** Adds the actions for the tab classes of a plugin that isn't
+		 * loaded yet. Triggering such an action activates the plugin,
+		 * and then the action is replaced by the plugin's own one.
+		 */
+		void AddDeferred (const QByteArray& pluginId, const QString& pluginName,
+				const QIcon& pluginIcon, const TabClasses_t& tabClasses);
 		void SetToolbarActions (QList<QList<QAction*>>);
 		void SingleRemoved (ITabWidget*);
 
@@ -68,6 +78,9 @@ namespace LeechCraft
 		void OpenTab (QAction*);
 		void InsertAction (QAction*);
 		void InsertActionWParent (QAction*, QObject*, bool sub);
+		void InsertActionToMenu (QAction*, const QString& parentName, const QIcon& parentIcon, bool sub);
+		void RemoveDeferred (const QByteArray& pluginId);
+		void OpenDeferredTab (QAction*);
 	private slots:
 		void handleNewTabRequested ();
 	signals:
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <functional>
 #include <numeric>
+#include <boost/optional.hpp>
 #include <QApplication>
 #include <QDir>
 #include <QStringList>
@@ -49,6 +50,7 @@
 #include <interfaces/ipluginadaptor.h>
 #include <interfaces/ihaveshortcuts.h>
 #include <interfaces/ishutdownlistener.h>
+#include <interfaces/structures.h>
 #include "core.h"
 #include "pluginmanager.h"
 #include "mainwindow.h"
@@ -64,6 +66,8 @@
 #include "loaders/sopluginloader.h"
 #include "loadprocessbase.h"
 #include "splashscreen.h"
+#include "startupprofile.h"
+#include "newtabmenumanager.h"
 
 #ifdef WITH_DBUS_LOADERS
 #include "loaders/dbuspluginloader.h"
@@ -75,6 +79,8 @@ namespace LeechCraft
 	: QAbstractItemModel (parent)
 	, DBusMode_ (static_cast<Application*> (qApp)->GetVarMap ().count ("multiprocess"))
 	, PluginTreeBuilder_ (new PluginTreeBuilder)
+	, StartupProfile_ (new StartupProfile)
+	, ManifestCache_ (new PluginManifestCache)
 	, CacheValid_ (false)
 	{
 		Headers_ << tr ("Name")
@@ -400,7 +406,10 @@ namespace LeechCraft
 			{
 				qDebug () << "Initializing" << ii->GetName ();
 				emit loadProgress (tr ("Initializing %1: stage one...").arg (ii->GetName ()));
-				ii->Init (std::make_shared<CoreProxy> ());
+				{
+					StartupProfile::Scope scope { StartupProfile_.get (), GetProfileKey (obj), "Init" };
+					ii->Init (std::make_shared<CoreProxy> ());
+				}
 
 				const auto& path = GetPluginLibraryPath (obj);
 				if (path.isEmpty ())
@@ -455,9 +464,17 @@ namespace LeechCraft
 
 	void PluginManager::Init (bool safeMode)
 	{
+		const auto profile = StartupProfile_.get ();
+
 		DefaultPluginIcon_ = QIcon ("lcicons:/resources/images/defaultpluginicon.svg");
-		CheckPlugins ();
+		{
+			StartupProfile::Scope scope { profile, "Checking plugins", "Core" };
+			if (!safeMode)
+				DeferLazyPlugins ();
+			CheckPlugins ();
+		}
 		FillInstances ();
+		LoadRequiredDeferred ();
 
 		if (safeMode)
 			Plugins_.clear ();
@@ -487,12 +504,19 @@ namespace LeechCraft
 				std::make_shared<PluginLoadProcess> (tr ("Plugins initialization: second stage..."),
 						ordered.size ());
 
-		const auto& failed = FirstInitAll (fstInitProc.get ());
+		QObjectList failed;
+		{
+			StartupProfile::Scope scope { profile, "First stage", "Core" };
+			failed = FirstInitAll (fstInitProc.get ());
+		}
 
 		SetInitStage (InitStage::BeforeSecond);
 
 		for (const auto obj : ordered)
+		{
+			StartupProfile::Scope scope { profile, GetProfileKey (obj), "Setup" };
 			Core::Instance ().Setup (obj);
+		}
 
 		auto coreInstanceObj = Core::Instance ().GetCoreInstanceObject ();
 		for (auto obj : GetAllCastableRoots<IHaveShortcuts*> ())
@@ -516,6 +540,7 @@ namespace LeechCraft
 			try
 			{
 				emit loadProgress (tr ("Initializing %1: stage two...").arg (ii->GetName ()));
+				StartupProfile::Scope scope { profile, GetProfileKey (obj), "SecondInit" };
 				ii->SecondInit ();
 			}
 			catch (const std::exception& e)
@@ -532,11 +557,27 @@ namespace LeechCraft
 		SetInitStage (InitStage::PostSecond);
 
 		for (const auto plugin : GetAllPlugins ())
+		{
+			StartupProfile::Scope scope { profile, GetProfileKey (plugin), "PostSecondInit" };
 			Core::Instance ().PostSecondInit (plugin);
+		}
+
+		const auto newTabMenuManager = Core::Instance ().GetNewTabMenuManager ();
+		for (const auto& deferred : Deferred_)
+			newTabMenuManager->AddDeferred (deferred.Info_.UniqueID_,
+					deferred.Info_.Name_, deferred.Info_.Icon_, deferred.Info_.TabClasses_);
 
 		SetInitStage (InitStage::Complete);
 
 		TryUnload (failed);
+
+		UpdateManifestCache ();
+
+		StartupProfile_->LogSummary (10);
+
+		const auto& tracePath = qgetenv ("LC_STARTUP_PROFILE");
+		if (!tracePath.isEmpty ())
+			StartupProfile_->WriteTrace (QString::fromLocal8Bit (tracePath));
 	}
 
 	void PluginManager::Release ()
@@ -633,6 +674,14 @@ namespace LeechCraft
 		return QString ();
 	}
 
+	QString PluginManager::GetProfileKey (QObject *obj) const
+	{
+		if (const auto loader = Obj2Loader_.value (obj))
+			return QFileInfo { loader->GetFileName () }.fileName ();
+
+		return qobject_cast<IInfo*> (obj)->GetName ();
+	}
+
 	QObject* PluginManager::GetPluginByID (const QByteArray& id) const
 	{
 		if (!PluginID2PluginCache_.contains (id))
@@ -643,7 +692,133 @@ namespace LeechCraft
 					break;
 				}
 
-		return PluginID2PluginCache_ [id];
+		if (const auto plugin = PluginID2PluginCache_ [id])
+			return plugin;
+
+		/* Activating a deferred plugin only makes it available earlier
+		 * than the user would get to it otherwise, so it's fine to do
+		 * it here despite the constness.
+		 */
+		return const_cast<PluginManager*> (this)->ActivateDeferred (id);
+	}
+
+	QObject* PluginManager::ActivateDeferred (const QByteArray& id)
+	{
+		const auto pos = std::find_if (Deferred_.begin (), Deferred_.end (),
+				[&id] (const DeferredPlugin& deferred) { return deferred.Info_.UniqueID_ == id; });
+		if (pos == Deferred_.end ())
+			return nullptr;
+
+		if (InitStage_ == InitStage::BeforeFirst)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "refusing to activate"
+					<< id
+					<< "before the first initialization stage is complete";
+			return nullptr;
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< "activating"
+				<< pos->Info_.Name_;
+
+		const auto deferred = *pos;
+		Deferred_.erase (pos);
+
+		const auto firstNew = Plugins_.size ();
+		const auto& loaded = LoadDeferred (deferred);
+		if (loaded.isEmpty ())
+			return nullptr;
+
+		LoadRequiredDeferred ();
+
+		const auto& newObjects = Plugins_.mid (firstNew);
+		PluginTreeBuilder_->AddObjects (newObjects);
+		PluginTreeBuilder_->Calculate ();
+		CacheValid_ = false;
+		PluginID2PluginCache_.clear ();
+
+		const auto shortcutManager = Core::Instance ().GetCoreInstanceObject ()->GetShortcutManager ();
+
+		QObjectList failed;
+		for (const auto obj : PluginTreeBuilder_->GetResult ())
+		{
+			if (!newObjects.contains (obj))
+				continue;
+
+			try
+			{
+				InjectPlugin (obj);
+			}
+			catch (...)
+			{
+				PluginLoadErrors_ << tr ("Could not activate plugin %1.")
+						.arg (qobject_cast<IInfo*> (obj)->GetName ());
+				PluginTreeBuilder_->RemoveObject (obj);
+				failed << obj;
+				continue;
+			}
+
+			if (qobject_cast<IHaveShortcuts*> (obj))
+				shortcutManager->AddObject (obj);
+		}
+
+		if (!failed.isEmpty ())
+		{
+			for (const auto obj : failed)
+				Plugins_.removeOne (obj);
+			TryUnload (failed);
+
+			PluginTreeBuilder_->Calculate ();
+			CacheValid_ = false;
+		}
+
+		emit dataChanged (index (0, 0), index (AvailablePlugins_.size () - 1, columnCount () - 1));
+
+		const auto instance = loaded.first ();
+		return PluginTreeBuilder_->GetResult ().contains (instance) ? instance : nullptr;
+	}
+
+	namespace
+	{
+		bool MatchesMime (const QString& mime, const QStringList& patterns)
+		{
+			if (mime.isEmpty ())
+				return false;
+
+			return std::any_of (patterns.begin (), patterns.end (),
+					[&mime] (const QString& pattern)
+					{
+						return pattern.endsWith ("/*") ?
+								mime.startsWith (pattern.left (pattern.size () - 1)) :
+								mime == pattern;
+					});
+		}
+	}
+
+	void PluginManager::ActivateForEntity (const Entity& e)
+	{
+		if (Deferred_.isEmpty ())
+			return;
+
+		const auto& url = e.Entity_.toUrl ();
+		const auto& scheme = url.scheme ();
+		const auto& suffix = url.isLocalFile () ?
+				QFileInfo { url.toLocalFile () }.suffix ().toLower () :
+				QString {};
+
+		QList<QByteArray> ids;
+		for (const auto& deferred : Deferred_)
+		{
+			const auto& info = deferred.Info_;
+			if (MatchesMime (e.Mime_, info.Mimes_) ||
+					(!scheme.isEmpty () && info.Schemes_.contains (scheme)) ||
+					(!suffix.isEmpty () && info.Extensions_.contains (suffix)))
+				ids << info.UniqueID_;
+		}
+
+		for (const auto& id : ids)
+			ActivateDeferred (id);
 	}
 
 	QObjectList PluginManager::GetFirstLevels (const QByteArray& pclass) const
@@ -978,9 +1153,12 @@ namespace LeechCraft
 		};
 
 		const bool shouldDump = qgetenv ("LC_DUMP_SOCHECKS") == "1";
+		const auto profile = StartupProfile_.get ();
 
-		auto thrCheck = [shouldDump, checks] (Loaders::IPluginLoader_ptr loader) -> boost::optional<Checks::Fail>
+		auto thrCheck = [shouldDump, checks, profile] (Loaders::IPluginLoader_ptr loader) -> boost::optional<Checks::Fail>
 		{
+			StartupProfile::Scope scope { profile, QFileInfo { loader->GetFileName () }.fileName (), "Load" };
+
 			QElapsedTimer timer;
 			if (shouldDump)
 			{
@@ -1051,6 +1229,7 @@ namespace LeechCraft
 			for (auto check : checks)
 				try
 				{
+					StartupProfile::Scope scope { profile, QFileInfo { loader->GetFileName () }.fileName (), "Instance" };
 					check (loader);
 				}
 				catch (const Checks::Fail& f)
@@ -1128,6 +1307,144 @@ namespace LeechCraft
 		}
 	}
 
+	void PluginManager::DeferLazyPlugins ()
+	{
+		if (DBusMode_ ||
+				!XmlSettingsManager::Instance ()->property ("LazyPluginActivation").toBool ())
+			return;
+
+		for (auto i = PluginContainers_.begin (); i != PluginContainers_.end (); )
+		{
+			const auto& info = ManifestCache_->Get ((*i)->GetFileName ());
+			if (!info)
+			{
+				++i;
+				continue;
+			}
+
+			qDebug () << Q_FUNC_INFO
+					<< "deferring"
+					<< info->Name_;
+			Deferred_.append ({ *i, *info });
+			i = PluginContainers_.erase (i);
+		}
+	}
+
+	void PluginManager::LoadRequiredDeferred ()
+	{
+		bool changed = true;
+		while (changed && !Deferred_.isEmpty ())
+		{
+			changed = false;
+
+			QSet<QString> needs;
+			QSet<QByteArray> pluginClasses;
+			QSet<QByteArray> expectedClasses;
+			for (const auto obj : Plugins_)
+			{
+				try
+				{
+					needs += QSet<QString>::fromList (qobject_cast<IInfo*> (obj)->Needs ());
+					if (const auto ip2 = qobject_cast<IPlugin2*> (obj))
+						pluginClasses += ip2->GetPluginClasses ();
+					if (const auto ipr = qobject_cast<IPluginReady*> (obj))
+						expectedClasses += ipr->GetExpectedPluginClasses ();
+				}
+				catch (const std::exception& e)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "failed to query dependencies of"
+							<< obj
+							<< e.what ();
+				}
+			}
+
+			for (auto i = Deferred_.begin (); i != Deferred_.end (); )
+			{
+				const auto& info = i->Info_;
+				const bool required = !QSet<QString>::fromList (info.Provides_).intersect (needs).isEmpty () ||
+						!QSet<QByteArray> (info.ExpectedPluginClasses_).intersect (pluginClasses).isEmpty () ||
+						!QSet<QByteArray> (info.PluginClasses_).intersect (expectedClasses).isEmpty ();
+				if (!required)
+				{
+					++i;
+					continue;
+				}
+
+				qDebug () << Q_FUNC_INFO
+						<< "loading"
+						<< info.Name_
+						<< "required by other plugins";
+
+				const auto deferred = *i;
+				i = Deferred_.erase (i);
+				LoadDeferred (deferred);
+				changed = true;
+			}
+		}
+	}
+
+	QObjectList PluginManager::LoadDeferred (const DeferredPlugin& deferred)
+	{
+		const auto& loader = deferred.Loader_;
+
+		const QList<std::function<void (Loaders::IPluginLoader_ptr)>> checks
+		{
+			Checks::IsFile,
+			Checks::TryLoad,
+			Checks::APILevel,
+			Checks::TryInstance
+		};
+
+		try
+		{
+			StartupProfile::Scope scope { StartupProfile_.get (), QFileInfo { loader->GetFileName () }.fileName (), "Load" };
+			for (const auto& check : checks)
+				check (loader);
+		}
+		catch (const Checks::Fail& f)
+		{
+			PluginLoadErrors_ << f.Error_;
+			if (loader->IsLoaded ())
+				loader->Unload ();
+			return {};
+		}
+
+		for (const auto obj : Plugins_)
+			if (qobject_cast<IInfo*> (obj)->GetUniqueID () == deferred.Info_.UniqueID_)
+			{
+				PluginLoadErrors_ << tr ("Plugin with ID %1 is already loaded; aborting load from %2.")
+						.arg (QString::fromUtf8 (deferred.Info_.UniqueID_))
+						.arg (loader->GetFileName ());
+				loader->Unload ();
+				return {};
+			}
+
+		const auto inst = loader->Instance ();
+		PluginContainers_ << loader;
+		Obj2Loader_ [inst] = loader;
+
+		QObjectList result { inst };
+		if (const auto ipa = qobject_cast<IPluginAdaptor*> (inst))
+			result << ipa->GetPlugins ();
+		Plugins_ << result;
+		return result;
+	}
+
+	void PluginManager::UpdateManifestCache ()
+	{
+		if (DBusMode_)
+			return;
+
+		for (const auto& loader : PluginContainers_)
+			if (loader->IsLoaded ())
+				ManifestCache_->Update (loader->GetFileName (), loader->Instance (), loader->GetManifest ());
+
+		ManifestCache_->Retain (Util::Map (AvailablePlugins_,
+				[] (const Loaders::IPluginLoader_ptr& loader) { return loader->GetFileName (); }));
+		ManifestCache_->Save ();
+	}
+
 	QObjectList PluginManager::FirstInitAll (PluginLoadProcess *proc)
 	{
 		QObjectList ordered = PluginTreeBuilder_->GetResult ();
@@ -39,11 +39,14 @@
 #include "loaders/ipluginloader.h"
 #include "interfaces/iinfo.h"
 #include "interfaces/core/ipluginsmanager.h"
+#include "pluginmanifestcache.h"
 
 namespace LeechCraft
 {
 	class MainWindow;
 	class PluginTreeBuilder;
+	class StartupProfile;
+	struct Entity;
 
 	class PluginManager : public QAbstractItemModel
 						, public IPluginsManager
@@ -72,6 +75,16 @@ namespace LeechCraft
 		mutable QMap<QByteArray, QObject*> PluginID2PluginCache_;
 
 		std::shared_ptr<PluginTreeBuilder> PluginTreeBuilder_;
+		std::shared_ptr<StartupProfile> StartupProfile_;
+		std::shared_ptr<PluginManifestCache> ManifestCache_;
+
+		struct DeferredPlugin
+		{
+			Loaders::IPluginLoader_ptr Loader_;
+			CachedPluginInfo Info_;
+		};
+		// Plugins whose loading is postponed until they are used.
+		QList<DeferredPlugin> Deferred_;
 
 		mutable bool CacheValid_;
 		mutable QObjectList SortedCache_;
@@ -117,8 +130,23 @@ namespace LeechCraft
 		QObjectList GetAllPlugins () const;
 		QString GetPluginLibraryPath (const QObject*) const;
 
+		/** Returns the plugin with the given ID, activating it first if
+		 * it is deferred.
+		 */
 		QObject* GetPluginByID (const QByteArray&) const;
 
+		/** Loads and initializes the deferred plugin with the given ID
+		 * along with the deferred plugins it needs and the deferred
+		 * second-level plugins for it. Returns the plugin instance or
+		 * null if there is no such deferred plugin or it failed to load.
+		 */
+		QObject* ActivateDeferred (const QByteArray& id);
+
+		/** Activates the deferred plugins whose manifests declare they
+		 * handle entities like the given one.
+		 */
+		void ActivateForEntity (const Entity&);
+
 		QObjectList GetFirstLevels (const QByteArray& pclass) const;
 		QObjectList GetFirstLevels (const QSet<QByteArray>& pclasses) const;
 
@@ -155,6 +183,26 @@ namespace LeechCraft
 		 */
 		void FillInstances ();
 
+		/** Moves the plugins that have valid cached manifests out of
+		 * PluginContainers_ into Deferred_ if lazy activation is
+		 * enabled.
+		 */
+		void DeferLazyPlugins ();
+
+		/** Loads the deferred plugins needed by the loaded ones, either
+		 * as feature providers or as the first-level plugins for the
+		 * loaded second-level ones, and vice versa.
+		 */
+		void LoadRequiredDeferred ();
+
+		/** Loads the library and creates the instance for the deferred
+		 * plugin, registering it the same way FillInstances() does.
+		 * Returns the new instances, including adapted plugins.
+		 */
+		QObjectList LoadDeferred (const DeferredPlugin&);
+
+		void UpdateManifestCache ();
+
 		/** Tries to perform IInfo::Init() on all plugins. Returns the
 		 * list of plugins that failed.
 		 */
@@ -167,6 +215,13 @@ namespace LeechCraft
 		 */
 		QObject* TryFirstInit (QObjectList, PluginLoadProcess*);
 
+		/** Returns the name the plugin's events are recorded under in
+		 * the startup profile: the file name of its library, like for
+		 * the library loading events, or the plugin name for the
+		 * plugins having no library of their own.
+		 */
+		QString GetProfileKey (QObject*) const;
+
 		/** Plainly tries to find a corresponding QPluginLoader and
 		 * unload the corresponding library.
 		 */
@@ -0,0 +1,310 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "pluginmanifestcache.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtDebug>
+#include <util/util.h>
+#include <util/sys/paths.h>
+#include <interfaces/iinfo.h>
+#include <interfaces/iplugin2.h>
+#include <interfaces/ipluginready.h>
+
+namespace LeechCraft
+{
+	namespace
+	{
+		const quint32 CacheMagic = 0x4c435043;
+		const quint8 CacheVersion = 2;
+
+		QString GetCachePath ()
+		{
+			try
+			{
+				return Util::GetUserDir (Util::UserDir::Cache, "core").filePath ("pluginmanifests");
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "plugin manifests won't be cached:"
+						<< e.what ();
+				return {};
+			}
+		}
+
+		void Write (QDataStream& out, const CachedPluginInfo& info)
+		{
+			out << info.Size_
+					<< info.Modified_
+					<< info.Locale_
+					<< info.UniqueID_
+					<< info.Name_
+					<< info.Info_
+					<< info.Icon_
+					<< info.Needs_
+					<< info.Provides_
+					<< info.PluginClasses_
+					<< info.ExpectedPluginClasses_;
+
+			out << static_cast<quint32> (info.TabClasses_.size ());
+			for (const auto& tc : info.TabClasses_)
+				out << tc.TabClass_
+						<< tc.VisibleName_
+						<< tc.Description_
+						<< tc.Icon_
+						<< tc.Priority_
+						<< static_cast<quint32> (tc.Features_);
+
+			out << info.Mimes_
+					<< info.Schemes_
+					<< info.Extensions_;
+		}
+
+		void Read (QDataStream& in, CachedPluginInfo& info)
+		{
+			in >> info.Size_
+					>> info.Modified_
+					>> info.Locale_
+					>> info.UniqueID_
+					>> info.Name_
+					>> info.Info_
+					>> info.Icon_
+					>> info.Needs_
+					>> info.Provides_
+					>> info.PluginClasses_
+					>> info.ExpectedPluginClasses_;
+
+			quint32 tcCount = 0;
+			in >> tcCount;
+			for (quint32 i = 0; i < tcCount && in.status () == QDataStream::Ok; ++i)
+			{
+				TabClassInfo tc;
+				quint32 features = 0;
+				in >> tc.TabClass_
+						>> tc.VisibleName_
+						>> tc.Description_
+						>> tc.Icon_
+						>> tc.Priority_
+						>> features;
+				tc.Features_ = TabFeatures { QFlag (static_cast<int> (features)) };
+				info.TabClasses_ << tc;
+			}
+
+			in >> info.Mimes_
+					>> info.Schemes_
+					>> info.Extensions_;
+		}
+	}
+
+	PluginManifestCache::PluginManifestCache ()
+	: Path_ { GetCachePath () }
+	, Locale_ { Util::GetLocaleName () }
+	{
+		Load ();
+	}
+
+	boost::optional<CachedPluginInfo> PluginManifestCache::Get (const QString& libPath) const
+	{
+		const auto pos = Entries_.find (libPath);
+		if (pos == Entries_.end ())
+			return {};
+
+		const QFileInfo fi { libPath };
+		if (fi.size () != pos->Size_ ||
+				fi.lastModified () != pos->Modified_ ||
+				Locale_ != pos->Locale_)
+			return {};
+
+		return *pos;
+	}
+
+	void PluginManifestCache::Update (const QString& libPath, QObject *instance, const QVariantMap& manifest)
+	{
+		if (!manifest.contains ("LazyActivation"))
+		{
+			if (Entries_.remove (libPath))
+				Dirty_ = true;
+			return;
+		}
+
+		if (Get (libPath))
+			return;
+
+		const auto ii = qobject_cast<IInfo*> (instance);
+		if (!ii)
+			return;
+
+		const QFileInfo fi { libPath };
+
+		CachedPluginInfo info;
+		info.Size_ = fi.size ();
+		info.Modified_ = fi.lastModified ();
+		info.Locale_ = Locale_;
+
+		try
+		{
+			info.UniqueID_ = ii->GetUniqueID ();
+			info.Name_ = ii->GetName ();
+			info.Info_ = ii->GetInfo ();
+			info.Icon_ = ii->GetIcon ();
+			info.Needs_ = ii->Needs ();
+			info.Provides_ = ii->Provides ();
+
+			if (const auto ip2 = qobject_cast<IPlugin2*> (instance))
+				info.PluginClasses_ = ip2->GetPluginClasses ();
+			if (const auto ipr = qobject_cast<IPluginReady*> (instance))
+				info.ExpectedPluginClasses_ = ipr->GetExpectedPluginClasses ();
+			if (const auto iht = qobject_cast<IHaveTabs*> (instance))
+				info.TabClasses_ = iht->GetTabClasses ();
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to query"
+					<< libPath
+					<< e.what ();
+			return;
+		}
+
+		const auto& lazyMap = manifest ["LazyActivation"].toMap ();
+		info.Mimes_ = lazyMap ["Mime"].toStringList ();
+		info.Schemes_ = lazyMap ["Schemes"].toStringList ();
+		info.Extensions_ = lazyMap ["Extensions"].toStringList ();
+
+		Entries_ [libPath] = info;
+		Dirty_ = true;
+	}
+
+	void PluginManifestCache::Retain (const QStringList& libPaths)
+	{
+		for (auto i = Entries_.begin (); i != Entries_.end (); )
+			if (libPaths.contains (i.key ()))
+				++i;
+			else
+			{
+				i = Entries_.erase (i);
+				Dirty_ = true;
+			}
+	}
+
+	void PluginManifestCache::Save ()
+	{
+		if (!Dirty_ || Path_.isEmpty ())
+			return;
+
+		QSaveFile file { Path_ };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< Path_
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out.setVersion (QDataStream::Qt_5_0);
+		out << CacheMagic
+				<< CacheVersion
+				<< static_cast<quint32> (Entries_.size ());
+		for (auto i = Entries_.begin (); i != Entries_.end (); ++i)
+		{
+			out << i.key ();
+			Write (out, i.value ());
+		}
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to write"
+					<< Path_
+					<< file.errorString ();
+			return;
+		}
+
+		Dirty_ = false;
+	}
+
+	void PluginManifestCache::Load ()
+	{
+		if (Path_.isEmpty ())
+			return;
+
+		QFile file { Path_ };
+		if (!file.exists ())
+			return;
+
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< Path_
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream in { &file };
+		in.setVersion (QDataStream::Qt_5_0);
+
+		quint32 magic = 0;
+		quint8 version = 0;
+		quint32 count = 0;
+		in >> magic >> version >> count;
+		if (magic != CacheMagic || version != CacheVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown cache format in"
+					<< Path_;
+			Dirty_ = true;
+			return;
+		}
+
+		for (quint32 i = 0; i < count; ++i)
+		{
+			QString path;
+			CachedPluginInfo info;
+			in >> path;
+			Read (in, info);
+
+			if (in.status () != QDataStream::Ok)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "truncated cache"
+						<< Path_;
+				Entries_.clear ();
+				Dirty_ = true;
+				return;
+			}
+
+			Entries_ [path] = info;
+		}
+	}
+}
@@ -0,0 +1,119 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <QDateTime>
+#include <QHash>
+#include <QIcon>
+#include <QSet>
+#include <QStringList>
+#include <QVariantMap>
+#include <interfaces/ihavetabs.h>
+
+namespace LeechCraft
+{
+	/** @brief The metadata of a plugin known without loading it.
+	 */
+	struct CachedPluginInfo
+	{
+		qint64 Size_ = 0;
+		QDateTime Modified_;
+
+		/* The UI locale the names and descriptions below are
+		 * translated to.
+		 */
+		QString Locale_;
+
+		QByteArray UniqueID_;
+		QString Name_;
+		QString Info_;
+		QIcon Icon_;
+
+		QStringList Needs_;
+		QStringList Provides_;
+		QSet<QByteArray> PluginClasses_;
+		QSet<QByteArray> ExpectedPluginClasses_;
+
+		TabClasses_t TabClasses_;
+
+		/* The entities the plugin handles, from the LazyActivation key
+		 * of its manifest.
+		 */
+		QStringList Mimes_;
+		QStringList Schemes_;
+		QStringList Extensions_;
+	};
+
+	/** @brief Persistent cache of the metadata of lazily loadable
+	 * plugins.
+	 *
+	 * Only plugins whose manifest has the LazyActivation key are
+	 * cached. An entry holds what otherwise requires loading the
+	 * library and creating the plugin instance: the IInfo data, the tab
+	 * classes and the plugin classes. An entry is valid as long as the
+	 * library's size and modification time and the UI locale stay the
+	 * same.
+	 */
+	class PluginManifestCache
+	{
+		const QString Path_;
+		const QString Locale_;
+		QHash<QString, CachedPluginInfo> Entries_;
+		bool Dirty_ = false;
+	public:
+		PluginManifestCache ();
+
+		/** @brief Returns the valid entry for the library, if any.
+		 */
+		boost::optional<CachedPluginInfo> Get (const QString& libPath) const;
+
+		/** @brief Caches the metadata of the loaded plugin.
+		 *
+		 * A valid entry is left as is. The entry is removed if the
+		 * manifest doesn't have the LazyActivation key.
+		 *
+		 * @param[in] libPath The path to the plugin library.
+		 * @param[in] instance The plugin instance.
+		 * @param[in] manifest The plugin manifest.
+		 */
+		void Update (const QString& libPath, QObject *instance, const QVariantMap& manifest);
+
+		/** @brief Removes the entries for libraries not in the list.
+		 */
+		void Retain (const QStringList& libPaths);
+
+		/** @brief Writes the cache if it has been changed.
+		 */
+		void Save ();
+	private:
+		void Load ();
+	};
+}
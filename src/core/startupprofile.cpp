@@ -0,0 +1,173 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "startupprofile.h"
+#include <algorithm>
+#include <QCoreApplication>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+	StartupProfile::Scope::Scope (StartupProfile *profile, const QString& name, const QString& stage)
+	: Profile_ { profile }
+	, Name_ { name }
+	, Stage_ { stage }
+	{
+	}
+
+	StartupProfile::Scope::~Scope ()
+	{
+		if (Profile_)
+			Profile_->Record (Name_, Stage_, Start_, Clock_t::now ());
+	}
+
+	StartupProfile::StartupProfile ()
+	: GuiThread_ { QThread::currentThreadId () }
+	{
+	}
+
+	void StartupProfile::Record (const QString& name, const QString& stage,
+			Clock_t::time_point start, Clock_t::time_point end)
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+
+		const Event event
+		{
+			name,
+			stage,
+			QThread::currentThreadId (),
+			duration_cast<microseconds> (start - Origin_).count (),
+			duration_cast<microseconds> (end - start).count ()
+		};
+
+		QMutexLocker locker { &Lock_ };
+		Events_ << event;
+	}
+
+	void StartupProfile::LogSummary (int count) const
+	{
+		QHash<QString, qint64> name2total;
+		{
+			QMutexLocker locker { &Lock_ };
+			for (const auto& event : Events_)
+				if (event.Stage_ != "Core")
+					name2total [event.Name_] += event.DurationUs_;
+		}
+
+		QList<QPair<QString, qint64>> totals;
+		for (auto i = name2total.begin (); i != name2total.end (); ++i)
+			totals.append ({ i.key (), i.value () });
+
+		std::sort (totals.begin (), totals.end (),
+				[] (const auto& left, const auto& right) { return left.second > right.second; });
+
+		qDebug () << Q_FUNC_INFO << "slowest startup items:";
+		for (const auto& pair : totals.mid (0, count))
+			qDebug () << "\t" << pair.first << pair.second / 1000 << "ms";
+	}
+
+	bool StartupProfile::WriteTrace (const QString& path) const
+	{
+		const auto pid = QCoreApplication::applicationPid ();
+
+		QHash<Qt::HANDLE, int> thread2tid { { GuiThread_, 0 } };
+		QJsonArray traceEvents;
+
+		auto addThreadName = [&traceEvents, pid] (int tid, const QString& name)
+		{
+			traceEvents.append (QJsonObject
+					{
+						{ "name", "thread_name" },
+						{ "ph", "M" },
+						{ "pid", pid },
+						{ "tid", tid },
+						{ "args", QJsonObject { { "name", name } } }
+					});
+		};
+		addThreadName (0, "GUI thread");
+
+		{
+			QMutexLocker locker { &Lock_ };
+			for (const auto& event : Events_)
+			{
+				if (!thread2tid.contains (event.Thread_))
+				{
+					const auto tid = thread2tid.size ();
+					thread2tid [event.Thread_] = tid;
+					addThreadName (tid, QString { "Worker %1" }.arg (tid));
+				}
+
+				traceEvents.append (QJsonObject
+						{
+							{ "name", event.Name_ },
+							{ "cat", event.Stage_ },
+							{ "ph", "X" },
+							{ "pid", pid },
+							{ "tid", thread2tid [event.Thread_] },
+							{ "ts", event.StartUs_ },
+							{ "dur", event.DurationUs_ }
+						});
+			}
+		}
+
+		QSaveFile file { path };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< path
+					<< file.errorString ();
+			return false;
+		}
+
+		const QJsonObject root
+		{
+			{ "traceEvents", traceEvents },
+			{ "displayTimeUnit", "ms" }
+		};
+		file.write (QJsonDocument { root }.toJson (QJsonDocument::Compact));
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to write"
+					<< path
+					<< file.errorString ();
+			return false;
+		}
+
+		return true;
+	}
+}
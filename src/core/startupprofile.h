@@ -0,0 +1,105 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+namespace LeechCraft
+{
+	/** @brief Collects the timings of the startup stages.
+	 *
+	 * Each event is a named span (like a plugin's Init() call) tagged
+	 * with its stage and the thread it ran in. Events may be recorded
+	 * from any thread.
+	 *
+	 * The collected profile can be written as a Chrome trace file,
+	 * which chrome://tracing or Perfetto can open.
+	 */
+	class StartupProfile
+	{
+		using Clock_t = std::chrono::steady_clock;
+
+		const Clock_t::time_point Origin_ = Clock_t::now ();
+		const Qt::HANDLE GuiThread_;
+
+		struct Event
+		{
+			QString Name_;
+			QString Stage_;
+			Qt::HANDLE Thread_;
+			qint64 StartUs_;
+			qint64 DurationUs_;
+		};
+
+		mutable QMutex Lock_;
+		QList<Event> Events_;
+	public:
+		/** @brief Records the lifetime of the scope as an event.
+		 */
+		class Scope
+		{
+			StartupProfile * const Profile_;
+			const QString Name_;
+			const QString Stage_;
+			const Clock_t::time_point Start_ = Clock_t::now ();
+		public:
+			Scope (StartupProfile *profile, const QString& name, const QString& stage);
+			~Scope ();
+
+			Scope (const Scope&) = delete;
+			Scope& operator= (const Scope&) = delete;
+		};
+
+		/** @brief Creates the profile.
+		 *
+		 * The calling thread is considered to be the GUI thread.
+		 */
+		StartupProfile ();
+
+		void Record (const QString& name, const QString& stage,
+				Clock_t::time_point start, Clock_t::time_point end);
+
+		/** @brief Logs the names with the largest total time.
+		 *
+		 * @param[in] count The maximum number of names to log.
+		 */
+		void LogSummary (int count) const;
+
+		/** @brief Writes the profile in the Chrome trace event format.
+		 *
+		 * @param[in] path The path of the file to write.
+		 * @return Whether the file has been written successfully.
+		 */
+		bool WriteTrace (const QString& path) const;
+	};
+}
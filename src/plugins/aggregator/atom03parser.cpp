@@ -67,15 +67,8 @@ namespace Aggregator
 		channels.push_back (chan);
 	
 		QDomElement root = doc.documentElement ();
-		chan->Title_ = root.firstChildElement ("title").text ().trimmed ();
-		if (chan->Title_.isEmpty ())
-			chan->Title_ = QObject::tr ("(No title)");
-		chan->LastBuild_ = FromRFC3339 (root.firstChildElement ("updated").text ());
-		chan->Link_ = GetLink (root);
-		chan->Description_ = root.firstChildElement ("tagline").text ();
-		chan->Language_ = "<>";
-		chan->Author_ = GetAuthor (root);
-	
+		FillChannel (root, *chan);
+
 		QDomElement entry = root.firstChildElement ("entry");
 		while (!entry.isNull ())
 		{
@@ -86,6 +79,18 @@ namespace Aggregator
 		return channels;
 	}
 	
+	void Atom03Parser::FillChannel (const QDomElement& feed, Channel& chan) const
+	{
+		chan.Title_ = feed.firstChildElement ("title").text ().trimmed ();
+		if (chan.Title_.isEmpty ())
+			chan.Title_ = QObject::tr ("(No title)");
+		chan.LastBuild_ = FromRFC3339 (feed.firstChildElement ("updated").text ());
+		chan.Link_ = GetLink (feed);
+		chan.Description_ = feed.firstChildElement ("tagline").text ();
+		chan.Language_ = "<>";
+		chan.Author_ = GetAuthor (feed);
+	}
+	
 	Item* Atom03Parser::ParseItem (const QDomElement& entry,
 			const IDType_t& channelId) const
 	{
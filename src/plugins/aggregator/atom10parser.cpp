@@ -65,23 +65,8 @@ namespace Aggregator
 		channels.push_back (chan);
 	
 		QDomElement root = doc.documentElement ();
-		chan->Title_ = root.firstChildElement ("title").text ().trimmed ();
-		if (chan->Title_.isEmpty ())
-			chan->Title_ = QObject::tr ("(No title)");
-		chan->LastBuild_ = FromRFC3339 (root.firstChildElement ("updated").text ());
-		chan->Link_ = GetLink (root);
-		chan->Description_ = root.firstChildElement ("subtitle").text ();
-		chan->Author_ = GetAuthor (root);
-		if (chan->Author_.isEmpty ())
-		{
-			QDomElement author = root.firstChildElement ("author");
-			chan->Author_ = author.firstChildElement ("name").text () +
-				" (" +
-				author.firstChildElement ("email").text () +
-				")";
-		}
-		chan->Language_ = "<>";
-	
+		FillChannel (root, *chan);
+
 		QDomElement entry = root.firstChildElement ("entry");
 		while (!entry.isNull ())
 		{
@@ -92,6 +77,26 @@ namespace Aggregator
 		return channels;
 	}
 	
+	void Atom10Parser::FillChannel (const QDomElement& feed, Channel& chan) const
+	{
+		chan.Title_ = feed.firstChildElement ("title").text ().trimmed ();
+		if (chan.Title_.isEmpty ())
+			chan.Title_ = QObject::tr ("(No title)");
+		chan.LastBuild_ = FromRFC3339 (feed.firstChildElement ("updated").text ());
+		chan.Link_ = GetLink (feed);
+		chan.Description_ = feed.firstChildElement ("subtitle").text ();
+		chan.Author_ = GetAuthor (feed);
+		if (chan.Author_.isEmpty ())
+		{
+			QDomElement author = feed.firstChildElement ("author");
+			chan.Author_ = author.firstChildElement ("name").text () +
+				" (" +
+				author.firstChildElement ("email").text () +
+				")";
+		}
+		chan.Language_ = "<>";
+	}
+	
 	Item* Atom10Parser::ParseItem (const QDomElement& entry,
 			const IDType_t& channelId) const
 	{
@@ -44,6 +44,16 @@ namespace Aggregator
 	{
 	}
 
+	Parser::ElementRole AtomParser::GetElementRole (const QDomElement& elem) const
+	{
+		const auto& root = elem.ownerDocument ().documentElement ();
+		if (elem == root)
+			return ElementRole::Channel;
+		if (elem.tagName () == "entry" && elem.parentNode () == root)
+			return ElementRole::Item;
+		return ElementRole::Other;
+	}
+
 	QString AtomParser::ParseEscapeAware (const QDomElement& parent) const
 	{
 		QString result;
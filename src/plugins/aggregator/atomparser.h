@@ -46,6 +46,7 @@ namespace Aggregator
 	public:
 		virtual ~AtomParser ();
 	protected:
+		ElementRole GetElementRole (const QDomElement&) const;
 		virtual QString ParseEscapeAware (const QDomElement&) const;
 		QList<Enclosure> GetEnclosures (const QDomElement&,
 				const IDType_t&) const;
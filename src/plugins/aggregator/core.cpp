@@ -39,6 +39,7 @@
 #include <QTextCodec>
 #include <QXmlStreamWriter>
 #include <QNetworkReply>
+#include <QtConcurrentRun>
 #include <interfaces/iwebbrowser.h>
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/itagsmanager.h>
@@ -52,6 +53,8 @@
 #include <util/shortcuts/shortcutmanager.h>
 #include <util/sll/prelude.h>
 #include <util/sll/qtutil.h>
+#include <util/sll/visitor.h>
+#include <util/threads/futures.h>
 #include "core.h"
 #include "xmlsettingsmanager.h"
 #include "parserfactory.h"
@@ -129,7 +132,7 @@ namespace Aggregator
 
 	Util::IDPool<IDType_t>& Core::GetPool (PoolType type)
 	{
-		return Pools_ [type];
+		return Pools_.at (type);
 	}
 
 	bool Core::CouldHandle (const Entity& e)
@@ -374,7 +377,8 @@ namespace Aggregator
 
 	bool Core::ReinitStorage ()
 	{
-		Pools_.clear ();
+		for (auto& pool : Pools_)
+			pool.SetID (0);
 		ChannelsModel_->Clear ();
 
 		StorageBackend_.reset (new DumbStorage);
@@ -403,7 +407,7 @@ namespace Aggregator
 
 		const int feedsTable = 1;
 		const int channelsTable = 2;
-		const int itemsTable = 6;
+		const int itemsTable = 7;
 
 		if (StorageBackend_->UpdateFeedsStorage (XmlSettingsManager::Instance ()->
 				Property (strType + "FeedsTableVersion", feedsTable).toInt (),
@@ -443,11 +447,7 @@ namespace Aggregator
 		}
 
 		for (int type = 0; type < PTMAX; ++type)
-		{
-			Util::IDPool<IDType_t> pool;
-			pool.SetID (StorageBackend_->GetHighestID (static_cast<PoolType> (type)) + 1);
-			Pools_ [static_cast<PoolType> (type)] = pool;
-		}
+			Pools_ [type].SetID (StorageBackend_->GetHighestID (static_cast<PoolType> (type)) + 1);
 
 		return true;
 	}
@@ -1013,6 +1013,11 @@ namespace Aggregator
 		}
 	}
 
+	QFuture<StorageBackend::search_results_t> Core::SearchItems (const QString& query, int limit)
+	{
+		return DBUpThread_->ScheduleImpl (&DBUpdateThreadWorker::SearchItems, query, limit);
+	}
+
 	void Core::GetChannels (channels_shorts_t& channels) const
 	{
 		ids_t ids;
@@ -1075,13 +1080,13 @@ namespace Aggregator
 		PendingJobs_.remove (id);
 		ID2Downloader_.remove (id);
 
-		Util::FileRemoveGuard file (pj.Filename_);
-		if (!file.open (QIODevice::ReadOnly))
+		const auto file = std::make_shared<Util::FileRemoveGuard> (pj.Filename_);
+		if (!file->open (QIODevice::ReadOnly))
 		{
 			qWarning () << Q_FUNC_INFO << "could not open file for pj " << pj.Filename_;
 			return;
 		}
-		if (!file.size ())
+		if (!file->size ())
 		{
 			if (pj.Role_ != PendingJob::RFeedExternalData)
 				ErrorNotification (tr ("Feed error"),
@@ -1089,64 +1094,67 @@ namespace Aggregator
 			return;
 		}
 
-		channels_container_t channels;
-		if (pj.Role_ != PendingJob::RFeedExternalData)
+		if (pj.Role_ == PendingJob::RFeedExternalData)
 		{
-			QByteArray data = file.readAll ();
-			QDomDocument doc;
-			QString errorMsg;
-			int errorLine, errorColumn;
-			if (!doc.setContent (data, true, &errorMsg, &errorLine, &errorColumn))
-			{
-				file.copy (QDir::tempPath () + "/failedFile.xml");
-				ErrorNotification (tr ("Feed error"),
-						tr ("XML file parse error: %1, line %2, column %3, filename %4, from %5")
-						.arg (errorMsg)
-						.arg (errorLine)
-						.arg (errorColumn)
-						.arg (pj.Filename_)
-						.arg (pj.URL_));
-				return;
-			}
-
-			Parser *parser = ParserFactory::Instance ().Return (doc);
-			if (!parser)
-			{
-				file.copy (QDir::tempPath () + "/failedFile.xml");
-				ErrorNotification (tr ("Feed error"),
-						tr ("Could not find parser to parse file %1 from %2")
-						.arg (pj.Filename_)
-						.arg (pj.URL_));
-				return;
-			}
-
-			IDType_t feedId = IDNotFound;
-			if (pj.Role_ == PendingJob::RFeedAdded)
-			{
-				const auto& feed = std::make_shared<Feed> ();
-				feed->URL_ = pj.URL_;
-				StorageBackend_->AddFeed (feed);
-				feedId = feed->FeedID_;
-			}
-			else
-				feedId = StorageBackend_->FindFeed (pj.URL_);
+			HandleExternalData (pj.URL_, *file);
+			return;
+		}
 
-			if (feedId == IDNotFound)
-			{
-				ErrorNotification (tr ("Feed error"),
-						tr ("Feed with url %1 not found.").arg (pj.URL_));
-				return;
-			}
+		Util::Sequence (this,
+				QtConcurrent::run ([file] { return ParserFactory::Instance ().Parse (file.get (), IDNotFound); })) >>
+				[this, pj, file] (const ParserFactory::ParseResult_t& result)
+				{
+					Util::Visit (result,
+							[this, &pj] (const channels_container_t& channels) { HandleFeedParsed (channels, pj); },
+							[this, &pj, &file] (const ParserFactory::XmlError& error)
+							{
+								file->copy (QDir::tempPath () + "/failedFile.xml");
+								ErrorNotification (tr ("Feed error"),
+										tr ("XML file parse error: %1, line %2, column %3, filename %4, from %5")
+										.arg (error.Message_)
+										.arg (error.Line_)
+										.arg (error.Column_)
+										.arg (pj.Filename_)
+										.arg (pj.URL_));
+							},
+							[this, &pj, &file] (ParserFactory::UnknownFormat)
+							{
+								file->copy (QDir::tempPath () + "/failedFile.xml");
+								ErrorNotification (tr ("Feed error"),
+										tr ("Could not find parser to parse file %1 from %2")
+										.arg (pj.Filename_)
+										.arg (pj.URL_));
+							});
+				};
+	}
+
+	void Core::HandleFeedParsed (const channels_container_t& channels, const PendingJob& pj)
+	{
+		IDType_t feedId = IDNotFound;
+		if (pj.Role_ == PendingJob::RFeedAdded)
+		{
+			const auto& feed = std::make_shared<Feed> ();
+			feed->URL_ = pj.URL_;
+			StorageBackend_->AddFeed (feed);
+			feedId = feed->FeedID_;
+		}
+		else
+			feedId = StorageBackend_->FindFeed (pj.URL_);
 
-			channels = parser->ParseFeed (doc, feedId);
+		if (feedId == IDNotFound)
+		{
+			ErrorNotification (tr ("Feed error"),
+					tr ("Feed with url %1 not found.").arg (pj.URL_));
+			return;
 		}
 
+		for (const auto& channel : channels)
+			channel->FeedID_ = feedId;
+
 		if (pj.Role_ == PendingJob::RFeedAdded)
 			HandleFeedAdded (channels, pj);
-		else if (pj.Role_ == PendingJob::RFeedUpdated)
+		else
 			HandleFeedUpdated (channels, pj);
-		else if (pj.Role_ == PendingJob::RFeedExternalData)
-			HandleExternalData (pj.URL_, file);
 	}
 
 	void Core::handleJobRemoved (int id)
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <QAbstractItemModel>
 #include <QString>
@@ -36,6 +37,7 @@
 #include <QPair>
 #include <QList>
 #include <QDateTime>
+#include <QFuture>
 #include <interfaces/idownload.h>
 #include <interfaces/core/icoreproxy.h>
 #include <interfaces/core/ihookproxy.h>
@@ -135,7 +137,11 @@ namespace Aggregator
 
 		Core ();
 	private:
-		QHash<PoolType, Util::IDPool<IDType_t>> Pools_;
+		/* A fixed array rather than a hash: GetPool() is called from
+		 * the feed parser threads, and looking an element up must not
+		 * modify the container.
+		 */
+		std::array<Util::IDPool<IDType_t>, PTMAX> Pools_;
 	public:
 		struct ChannelInfo
 		{
@@ -229,6 +235,12 @@ namespace Aggregator
 
 		StorageBackend_ptr MakeStorageBackendForThread () const;
 
+		/** Searches the stored items in the storage thread.
+		 *
+		 * @sa StorageBackend::SearchItems()
+		 */
+		QFuture<StorageBackend::search_results_t> SearchItems (const QString& query, int limit);
+
 		void GetChannels (channels_shorts_t&) const;
 		void AddFeeds (const feeds_container_t&, const QString&);
 		void SetContextMenu (QMenu*);
@@ -251,6 +263,8 @@ namespace Aggregator
 		void FetchPixmap (const Channel_ptr&);
 		void FetchFavicon (const Channel_ptr&);
 		void HandleExternalData (const QString&, const QFile&);
+		void HandleFeedParsed (const channels_container_t&,
+				const PendingJob&);
 		void HandleFeedAdded (const channels_container_t&,
 				const PendingJob&);
 		void HandleFeedUpdated (const channels_container_t&,
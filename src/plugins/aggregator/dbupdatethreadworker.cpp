@@ -31,10 +31,11 @@
 #include <stdexcept>
 #include <boost/optional.hpp>
 #include <QUrl>
+#include <QHash>
+#include <QSet>
 #include <QtDebug>
 #include <util/xpc/util.h>
 #include <util/xpc/defaulthookproxy.h>
-#include <util/sll/lazy.h>
 #include <interfaces/core/ientitymanager.h>
 #include "xmlsettingsmanager.h"
 #include "storagebackend.h"
@@ -43,6 +44,54 @@ namespace LeechCraft
 {
 namespace Aggregator
 {
+	namespace
+	{
+		/** Mirrors the lookup order of StorageBackend::FindItem(),
+		 * StorageBackend::FindItemByLink() and
+		 * StorageBackend::FindItemByTitle() over an in-memory set of
+		 * items' identities.
+		 */
+		class ItemsIndex
+		{
+			QHash<QPair<QString, QString>, IDType_t> ByTitleLink_;
+			QHash<QString, IDType_t> ByLink_;
+			QHash<QString, IDType_t> ByTitle_;
+		public:
+			void Add (IDType_t id, const QString& title, const QString& link)
+			{
+				const QPair<QString, QString> titleLink { title, link };
+				if (!ByTitleLink_.contains (titleLink))
+					ByTitleLink_ [titleLink] = id;
+				if (!link.isEmpty () && !ByLink_.contains (link))
+					ByLink_ [link] = id;
+				if (!ByTitle_.contains (title))
+					ByTitle_ [title] = id;
+			}
+
+			boost::optional<IDType_t> Find (const QString& title, const QString& link) const
+			{
+				const auto titleLinkPos = ByTitleLink_.find ({ title, link });
+				if (titleLinkPos != ByTitleLink_.end ())
+					return *titleLinkPos;
+
+				if (!link.isEmpty ())
+				{
+					const auto linkPos = ByLink_.find (link);
+					if (linkPos != ByLink_.end ())
+						return *linkPos;
+
+					return {};
+				}
+
+				const auto titlePos = ByTitle_.find (title);
+				if (titlePos != ByTitle_.end ())
+					return *titlePos;
+
+				return {};
+			}
+		};
+	}
+
 	DBUpdateThreadWorker::DBUpdateThreadWorker (const ICoreProxy_ptr& proxy, QObject *parent)
 	: QObject (parent)
 	, Proxy_ { proxy }
@@ -74,6 +123,14 @@ namespace Aggregator
 		func (this);
 	}
 
+	StorageBackend::search_results_t DBUpdateThreadWorker::SearchItems (const QString& query, int limit)
+	{
+		if (!SB_)
+			return {};
+
+		return SB_->SearchItems (query, limit);
+	}
+
 	Feed::FeedSettings DBUpdateThreadWorker::GetFeedSettings (IDType_t feedId)
 	{
 		const auto itemAge = XmlSettingsManager::Instance ()->property ("ItemsMaxAge").toInt ();
@@ -131,7 +188,7 @@ namespace Aggregator
 		Proxy_->GetEntityManager ()->HandleEntity (Util::MakeNotification ("Aggregator", str, PInfo_));
 	}
 
-	bool DBUpdateThreadWorker::AddItem (const Item_ptr& item, const Channel_ptr& channel,
+	bool DBUpdateThreadWorker::PrepareNewItem (const Item_ptr& item, const Channel_ptr& channel,
 			const Feed::FeedSettings& settings)
 	{
 		if (item->PubDate_.isValid ())
@@ -143,12 +200,25 @@ namespace Aggregator
 			item->FixDate ();
 
 		item->ChannelID_ = channel->ChannelID_;
-		SB_->AddItem (item);
+		return true;
+	}
+
+	void DBUpdateThreadWorker::HandleNewItems (const QList<Item_ptr>& items, const Channel_ptr& channel,
+			const Feed::FeedSettings& settings)
+	{
+		if (items.isEmpty ())
+			return;
 
-		emit hookGotNewItems (std::make_shared<Util::DefaultHookProxy> (), { item });
+		QList<Item_cptr> constItems;
+		for (const auto& item : items)
+			constItems << item;
+		emit hookGotNewItems (std::make_shared<Util::DefaultHookProxy> (), constItems);
+
+		if (!settings.AutoDownloadEnclosures_)
+			return;
 
 		const auto iem = Proxy_->GetEntityManager ();
-		if (settings.AutoDownloadEnclosures_)
+		for (const auto& item : items)
 			for (const auto& e : item->Enclosures_)
 			{
 				auto de = Util::MakeEntity (QUrl (e.URL_),
@@ -159,11 +229,9 @@ namespace Aggregator
 				de.Additional_ [" Tags"] = channel->Tags_;
 				iem->HandleEntity (de);
 			}
-
-		return true;
 	}
 
-	bool DBUpdateThreadWorker::UpdateItem (const Item_ptr& item, const Item_ptr& ourItem)
+	bool DBUpdateThreadWorker::MergeItem (const Item_ptr& item, const Item_ptr& ourItem)
 	{
 		if (!IsModified (ourItem, item))
 			return false;
@@ -192,8 +260,6 @@ namespace Aggregator
 				ourItem->MRSSEntries_ << entry;
 			}
 
-		SB_->UpdateItem (ourItem);
-
 		return true;
 	}
 
@@ -259,36 +325,83 @@ namespace Aggregator
 				continue;
 			}
 
-			int newItems = 0;
-			int updatedItems = 0;
+			StorageBackend::items_identities_t identities;
+			try
+			{
+				SB_->GetItemsIdentities (identities, ourChannel->ChannelID_);
+			}
+			catch (const StorageBackend::ItemGettingError&)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to get items for channel"
+						<< ourChannel->ChannelID_;
+				continue;
+			}
+
+			ItemsIndex index;
+			QHash<IDType_t, QByteArray> storedHashes;
+			for (const auto& identity : identities)
+			{
+				index.Add (identity.ItemID_, identity.Title_, identity.Link_);
+				storedHashes [identity.ItemID_] = identity.ContentHash_;
+			}
+
+			StorageBackend::ItemsBatch batch;
+			QList<Item_ptr> addedItems;
+			QSet<IDType_t> seenIds;
 
 			for (const auto& item : channel->Items_)
 			{
-				auto mkLazy = [] (auto&& f) { return Util::MakeLazyF<boost::optional<IDType_t>> (f); };
-				const auto& ourItemID = Util::Msum ({
-							mkLazy ([&] { return SB_->FindItem (item->Title_, item->Link_, ourChannel->ChannelID_); }),
-							mkLazy ([&] { return SB_->FindItemByLink (item->Link_, ourChannel->ChannelID_); }),
-							mkLazy ([&]
-									{
-										if (!item->Link_.isEmpty ())
-											return boost::optional<IDType_t> {};
-
-										return SB_->FindItemByTitle (item->Title_, ourChannel->ChannelID_);
-									})
-						}) ();
-				if (ourItemID)
+				const auto& hash = GetContentHash (*item);
+
+				const auto& ourItemID = index.Find (item->Title_, item->Link_);
+				if (!ourItemID)
 				{
-					const auto& ourItem = SB_->GetItem (*ourItemID);
-					if (UpdateItem (item, ourItem))
-						++updatedItems;
+					if (!PrepareNewItem (item, ourChannel, feedSettings))
+						continue;
+
+					batch.Added_.append (StorageBackend::HashedItem { item, hash });
+					addedItems << item;
+					index.Add (item->ItemID_, item->Title_, item->Link_);
+					seenIds << item->ItemID_;
+					continue;
 				}
-				else if (AddItem (item, ourChannel, feedSettings))
-					++newItems;
+
+				// The feed lists the same item more than once, the first
+				// occurrence wins.
+				if (seenIds.contains (*ourItemID))
+					continue;
+				seenIds << *ourItemID;
+
+				// The item hasn't changed in the feed since the last update.
+				if (storedHashes.value (*ourItemID) == hash)
+					continue;
+
+				const auto& ourItem = SB_->GetItem (*ourItemID);
+				if (MergeItem (item, ourItem))
+					batch.Updated_.append (StorageBackend::HashedItem { ourItem, hash });
+				else
+					batch.Rehashed_.append (qMakePair (*ourItemID, hash));
+			}
+
+			try
+			{
+				SB_->StoreItems (batch, ourChannel->ChannelID_);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to store items for channel"
+						<< ourChannel->ChannelID_
+						<< e.what ();
+				continue;
 			}
 
+			HandleNewItems (addedItems, ourChannel, feedSettings);
+
 			SB_->TrimChannel (ourChannel->ChannelID_, days, ipc);
 
-			NotifyUpdates (newItems, updatedItems, channel);
+			NotifyUpdates (addedItems.size (), batch.Updated_.size (), channel);
 		}
 	}
 }
@@ -37,6 +37,7 @@
 #include "common.h"
 #include "channel.h"
 #include "feed.h"
+#include "storagebackend.h"
 
 namespace LeechCraft
 {
@@ -54,12 +55,16 @@ namespace Aggregator
 		DBUpdateThreadWorker (const ICoreProxy_ptr&, QObject* = nullptr);
 
 		void WithWorker (const std::function<void (DBUpdateThreadWorker*)>&);
+
+		StorageBackend::search_results_t SearchItems (const QString& query, int limit);
 	private:
 		Feed::FeedSettings GetFeedSettings (IDType_t);
 		void AddChannel (const Channel_ptr& channel, const Feed::FeedSettings& settings);
-		bool AddItem (const Item_ptr& item, const Channel_ptr& channel,
+		bool PrepareNewItem (const Item_ptr& item, const Channel_ptr& channel,
+				const Feed::FeedSettings& settings);
+		void HandleNewItems (const QList<Item_ptr>& items, const Channel_ptr& channel,
 				const Feed::FeedSettings& settings);
-		bool UpdateItem (const Item_ptr& item, const Item_ptr& ourItem);
+		bool MergeItem (const Item_ptr& item, const Item_ptr& ourItem);
 		void NotifyUpdates (int newItems, int updatedItems, const Channel_ptr& channel);
 	public slots:
 		void toggleChannelUnread (IDType_t channel, bool state);
@@ -107,6 +107,10 @@ namespace Aggregator
 		return {};
 	}
 
+	void DumbStorage::GetItemsIdentities (items_identities_t&, const IDType_t&) const
+	{
+	}
+
 	void DumbStorage::GetItems (items_container_t&, const IDType_t&) const
 	{
 	}
@@ -123,6 +127,10 @@ namespace Aggregator
 	{
 	}
 
+	void DumbStorage::StoreItems (const ItemsBatch&, const IDType_t&)
+	{
+	}
+
 	void DumbStorage::UpdateChannel (Channel_ptr)
 	{
 	}
@@ -184,6 +192,11 @@ namespace Aggregator
 		return {};
 	}
 
+	StorageBackend::search_results_t DumbStorage::SearchItems (const QString&, int) const
+	{
+		return {};
+	}
+
 	IDType_t DumbStorage::GetHighestID (const PoolType&) const
 	{
 		return {};
@@ -54,10 +54,12 @@ namespace Aggregator
 		boost::optional<IDType_t> FindItem (const QString&, const QString&, const IDType_t&) const;
 		boost::optional<IDType_t> FindItemByTitle (const QString&, const IDType_t&) const;
 		boost::optional<IDType_t> FindItemByLink (const QString&, const IDType_t&) const;
+		void GetItemsIdentities (items_identities_t&, const IDType_t&) const;
 		void GetItems (items_container_t&, const IDType_t&) const;
 		void AddFeed (Feed_ptr);
 		void AddChannel (Channel_ptr);
 		void AddItem (Item_ptr);
+		void StoreItems (const ItemsBatch&, const IDType_t&);
 		void UpdateChannel (Channel_ptr);
 		void UpdateChannel (const ChannelShort&);
 		void UpdateItem (Item_ptr);
@@ -72,6 +74,7 @@ namespace Aggregator
 		QList<ITagsManager::tag_id> GetItemTags (const IDType_t&);
 		void SetItemTags (const IDType_t&, const QList<ITagsManager::tag_id>&);
 		QList<IDType_t> GetItemsForTag (const ITagsManager::tag_id&);
+		search_results_t SearchItems (const QString&, int) const;
 		IDType_t GetHighestID (const PoolType&) const;
 	};
 }
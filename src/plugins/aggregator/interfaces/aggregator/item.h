@@ -378,6 +378,17 @@ namespace Aggregator
 	void Diff (const Item&, const Item&);
 
 	bool IsModified (Item_ptr, Item_ptr);
+
+	/** @brief Returns the hash of the item's contents.
+	 *
+	 * The hash covers all the data that comes from the feed itself but
+	 * not the IDs assigned to the item and its children, so the same
+	 * item parsed twice has the same hash.
+	 *
+	 * @param[in] item The item to hash.
+	 * @return The hex-encoded content hash.
+	 */
+	QByteArray GetContentHash (const Item& item);
 }
 }
 
@@ -31,6 +31,7 @@
 #include <boost/preprocessor/repeat.hpp>
 #include <boost/preprocessor/seq.hpp>
 #include <QDataStream>
+#include <QCryptographicHash>
 #include <QtDebug>
 #include "item.h"
 #include "core.h"
@@ -622,6 +623,16 @@ namespace Aggregator
 				SameSets (i1->MRSSEntries_, i2->MRSSEntries_));
 	}
 
+	QByteArray GetContentHash (const Item& item)
+	{
+		QByteArray serialized;
+		{
+			QDataStream out { &serialized, QIODevice::WriteOnly };
+			out << item;
+		}
+		return QCryptographicHash::hash (serialized, QCryptographicHash::Sha1).toHex ();
+	}
+
 #ifndef Q_CC_MSVC
 #define LC_DECLOP(Type) \
 				QDataStream& operator>> (QDataStream& in, QList<Type>& list) \
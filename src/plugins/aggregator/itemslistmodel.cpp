@@ -123,6 +123,7 @@ namespace Aggregator
 		CurrentChannel_ = channel;
 		CurrentRow_ = -1;
 		CurrentItems_.clear ();
+		Snippets_.clear ();
 		if (channel != static_cast<IDType_t> (-1))
 			GetSB ()->GetItems (CurrentItems_, channel);
 
@@ -136,6 +137,7 @@ namespace Aggregator
 		CurrentChannel_ = -1;
 		CurrentRow_ = -1;
 		CurrentItems_.clear ();
+		Snippets_.clear ();
 
 		const auto& sb = GetSB ();
 		for (const IDType_t& itemId : items)
@@ -144,6 +146,24 @@ namespace Aggregator
 		endResetModel ();
 	}
 
+	void ItemsListModel::Reset (const StorageBackend::search_results_t& results)
+	{
+		beginResetModel ();
+
+		CurrentChannel_ = -1;
+		CurrentRow_ = -1;
+		CurrentItems_.clear ();
+		Snippets_.clear ();
+
+		for (const auto& result : results)
+		{
+			CurrentItems_.push_back (result.Item_);
+			Snippets_ [result.Item_.ItemID_] = result.Snippet_;
+		}
+
+		endResetModel ();
+	}
+
 	void ItemsListModel::RemoveItems (const QSet<IDType_t>& ids)
 	{
 		if (ids.isEmpty ())
@@ -309,7 +329,14 @@ namespace Aggregator
 		else if (role == Qt::ToolTipRole &&
 				XmlSettingsManager::Instance ()->property ("ShowItemsTooltips").toBool ())
 		{
-			IDType_t id = CurrentItems_ [index.row ()].ItemID_;
+			const auto& itemShort = CurrentItems_ [index.row ()];
+			const auto snippetPos = Snippets_.find (itemShort.ItemID_);
+			if (snippetPos != Snippets_.end ())
+				return QString ("<qt><strong>%1</strong><br />%2</qt>")
+						.arg (itemShort.Title_)
+						.arg (*snippetPos);
+
+			IDType_t id = itemShort.ItemID_;
 			Item_ptr item = GetSB ()->GetItem (id);
 			QString result = QString ("<qt><strong>%1</strong><br />").arg (item->Title_);
 			if (item->Author_.size ())
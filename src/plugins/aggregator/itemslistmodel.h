@@ -32,6 +32,7 @@
 #include <QAbstractItemModel>
 #include <QStringList>
 #include <QSet>
+#include <QHash>
 #include <QPair>
 #include <QIcon>
 #include <QThreadStorage>
@@ -52,6 +53,7 @@ namespace Aggregator
 
 		QStringList ItemHeaders_;
 		items_shorts_t CurrentItems_;
+		QHash<IDType_t, QString> Snippets_;
 		int CurrentRow_ = -1;
 		IDType_t CurrentChannel_ = -1;
 
@@ -73,6 +75,7 @@ namespace Aggregator
 		QStringList GetCategories (int) const;
 		void Reset (const IDType_t&);
 		void Reset (const QList<IDType_t>&);
+		void Reset (const StorageBackend::search_results_t&);
 		void RemoveItems (const QSet<IDType_t>&);
 		void ItemDataUpdated (Item_ptr);
 
@@ -47,6 +47,7 @@
 #include <util/gui/clearlineeditaddon.h>
 #include <util/shortcuts/shortcutmanager.h>
 #include <util/util.h>
+#include <util/threads/futures.h>
 #include <interfaces/core/itagsmanager.h>
 #include <interfaces/core/ientitymanager.h>
 #include "core.h"
@@ -1498,15 +1499,30 @@ namespace Aggregator
 	void ItemsWidget::updateItemsFilter ()
 	{
 		const int section = Impl_->Ui_.SearchType_->currentIndex ();
+		const QString& text = Impl_->Ui_.SearchLine_->text ();
 		if (section == 4)
 		{
 			const auto& sb = Core::Instance ().MakeStorageBackendForThread ();
 			Impl_->CurrentItemsModel_->Reset (sb->GetItemsForTag ("_important"));
 		}
+		else if (section == 5 && !text.trimmed ().isEmpty ())
+		{
+			const int maxResults = 1000;
+
+			Util::Sequence (this, Core::Instance ().SearchItems (text, maxResults)) >>
+					[this, text] (const StorageBackend::search_results_t& results)
+					{
+						// The query might have been changed in the meantime.
+						if (Impl_->Ui_.SearchType_->currentIndex () != 5 ||
+								Impl_->Ui_.SearchLine_->text () != text)
+							return;
+
+						Impl_->CurrentItemsModel_->Reset (results);
+					};
+		}
 		else
 			CurrentChannelChanged (Impl_->LastSelectedChannel_);
 
-		const QString& text = Impl_->Ui_.SearchLine_->text ();
 		switch (section)
 		{
 		case 1:
@@ -1515,6 +1531,10 @@ namespace Aggregator
 		case 2:
 			Impl_->ItemsFilterModel_->setFilterRegExp (text);
 			break;
+		case 5:
+			// The storage has already done the filtering.
+			Impl_->ItemsFilterModel_->setFilterFixedString ({});
+			break;
 		default:
 			Impl_->ItemsFilterModel_->setFilterFixedString (text);
 			break;
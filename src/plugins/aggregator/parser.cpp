@@ -30,6 +30,7 @@
 #include "parser.h"
 #include <boost/optional.hpp>
 #include <QDomElement>
+#include <QXmlStreamReader>
 #include <QStringList>
 #include <QObject>
 #include <QtDebug>
@@ -66,22 +67,149 @@ namespace Aggregator
 	{
 	}
 
+	namespace
+	{
+		void FixupChannels (const channels_container_t& channels)
+		{
+			for (const auto& newChannel : channels)
+			{
+				if (newChannel->Link_.isEmpty ())
+				{
+					qWarning () << Q_FUNC_INFO
+						<< "detected empty link for"
+						<< newChannel->Title_;
+					newChannel->Link_ = "about:blank";
+				}
+				for (const auto& item : newChannel->Items_)
+					item->Title_ = item->Title_.trimmed ().simplified ();
+			}
+		}
+
+		QDomElement CreateElement (QDomDocument& doc, const QXmlStreamReader& reader)
+		{
+			auto elem = doc.createElementNS (reader.namespaceUri ().toString (),
+					reader.qualifiedName ().toString ());
+			for (const auto& attr : reader.attributes ())
+			{
+				if (attr.namespaceUri ().isEmpty ())
+					elem.setAttribute (attr.qualifiedName ().toString (),
+							attr.value ().toString ());
+				else
+					elem.setAttributeNS (attr.namespaceUri ().toString (),
+							attr.qualifiedName ().toString (),
+							attr.value ().toString ());
+			}
+			return elem;
+		}
+	}
+
 	channels_container_t Parser::ParseFeed (const QDomDocument& recent, const IDType_t& feedId) const
 	{
 		channels_container_t newes = Parse (recent, feedId);
-		for (const auto& newChannel : newes)
+		FixupChannels (newes);
+		return newes;
+	}
+
+	channels_container_t Parser::ParseFeed (QXmlStreamReader& reader,
+			QDomDocument& skeleton, const IDType_t& feedId) const
+	{
+		struct OpenChannel
+		{
+			QDomElement Elem_;
+			Channel_ptr Channel_;
+		};
+		QList<OpenChannel> openChannels;
+		bool hadChannels = false;
+
+		const auto openChannel = [&] (const QDomElement& elem)
 		{
-			if (newChannel->Link_.isEmpty ())
+			openChannels.append ({ elem, std::make_shared<Channel> (feedId) });
+			hadChannels = true;
+		};
+
+		channels_container_t channels;
+
+		auto current = skeleton.documentElement ();
+		if (GetElementRole (current) == ElementRole::Channel)
+			openChannel (current);
+
+		QDomElement item;
+
+		while (!reader.atEnd () && !current.isNull ())
+		{
+			switch (reader.readNext ())
+			{
+			case QXmlStreamReader::StartElement:
 			{
-				qWarning () << Q_FUNC_INFO
-					<< "detected empty link for"
-					<< newChannel->Title_;
-				newChannel->Link_ = "about:blank";
+				const auto& elem = CreateElement (skeleton, reader);
+				current.appendChild (elem);
+				current = elem;
+
+				if (!item.isNull ())
+					break;
+
+				switch (GetElementRole (elem))
+				{
+				case ElementRole::Channel:
+					openChannel (elem);
+					break;
+				case ElementRole::Item:
+					if (!openChannels.isEmpty ())
+						item = elem;
+					break;
+				case ElementRole::Other:
+					break;
+				}
+				break;
+			}
+			case QXmlStreamReader::Characters:
+				if (reader.isCDATA ())
+					current.appendChild (skeleton.createCDATASection (reader.text ().toString ()));
+				else if (!reader.isWhitespace ())
+					current.appendChild (skeleton.createTextNode (reader.text ().toString ()));
+				break;
+			case QXmlStreamReader::EndElement:
+			{
+				auto parent = current.parentNode ();
+				if (current == item)
+				{
+					const auto& chan = openChannels.last ().Channel_;
+					chan->Items_.push_back (Item_ptr (ParseItem (item, chan->ChannelID_)));
+					parent.removeChild (item);
+					item.clear ();
+				}
+				else if (!openChannels.isEmpty () && current == openChannels.last ().Elem_)
+				{
+					const auto open = openChannels.takeLast ();
+					FillChannel (open.Elem_, *open.Channel_);
+					FinalizeChannel (*open.Channel_);
+					channels.push_back (open.Channel_);
+				}
+				current = parent.toElement ();
+				break;
+			}
+			default:
+				break;
 			}
-			for (const auto& item : newChannel->Items_)
-				item->Title_ = item->Title_.trimmed ().simplified ();
 		}
-		return newes;
+
+		if (reader.hasError ())
+			return {};
+
+		if (!hadChannels)
+			return ParseFeed (skeleton, feedId);
+
+		FixupChannels (channels);
+		return channels;
+	}
+
+	Parser::ElementRole Parser::GetElementRole (const QDomElement&) const
+	{
+		return ElementRole::Other;
+	}
+
+	void Parser::FinalizeChannel (Channel&) const
+	{
 	}
 
 	namespace
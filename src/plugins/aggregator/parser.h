@@ -34,6 +34,8 @@
 #include <QDomDocument>
 #include "channel.h"
 
+class QXmlStreamReader;
+
 namespace LeechCraft
 {
 namespace Aggregator
@@ -62,7 +64,55 @@ namespace Aggregator
 			*/
 		virtual channels_container_t ParseFeed (const QDomDocument& document,
 				const IDType_t& feedId) const;
+
+		/** @brief Parses the document read by the given stream reader.
+			*
+			* Unlike the QDomDocument-based overload, this one never
+			* builds the DOM of the whole document. Only the elements
+			* outside of items are kept in the \em skeleton, while each
+			* item is parsed as soon as its closing tag is read and is
+			* dropped from the tree right away.
+			*
+			* Parsers that don't mark any elements as channels via
+			* GetElementRole() get the whole document in the skeleton
+			* and parse it via the DOM-based Parse() in the end.
+			*
+			* This function is reentrant and may be called from any
+			* thread.
+			*
+			* @param[in] reader The reader positioned right after the
+			* start of the root element.
+			* @param[in] skeleton The document containing just the root
+			* element, the same one CouldParse() has been called with.
+			* @param[in] feedId The ID of the parent feed.
+			* @return Container (channels_container_t) with new items,
+			* undefined if \em reader has an error in the end.
+			*/
+		channels_container_t ParseFeed (QXmlStreamReader& reader,
+				QDomDocument& skeleton, const IDType_t& feedId) const;
 	protected:
+		/** @brief The role of an element during stream parsing.
+			*/
+		enum class ElementRole
+		{
+			/** @brief The element is kept in the skeleton as is.
+				*/
+			Other,
+
+			/** @brief The element describes a channel.
+				*
+				* Its items are parsed via ParseItem() as they are
+				* read, and the channel itself is parsed via
+				* FillChannel() once its closing tag is read.
+				*/
+			Channel,
+
+			/** @brief The element is an item of the innermost
+				* channel.
+				*/
+			Item
+		};
+
 		static const QString DC_;
 		static const QString WFW_;
 		static const QString Atom_;
@@ -77,6 +127,31 @@ namespace Aggregator
 
 		virtual channels_container_t Parse (const QDomDocument&,
 				const IDType_t&) const = 0;
+
+		/** @brief Returns the role of the just opened element.
+			*
+			* The element is already attached to its parent, but its
+			* children haven't been read yet, so only its name,
+			* attributes and ancestors may be inspected.
+			*
+			* The default implementation returns ElementRole::Other.
+			*/
+		virtual ElementRole GetElementRole (const QDomElement&) const;
+
+		/** @brief Fills the channel metadata from its element.
+			*
+			* The element doesn't contain any items when called during
+			* stream parsing.
+			*/
+		virtual void FillChannel (const QDomElement&, Channel&) const = 0;
+		virtual Item* ParseItem (const QDomElement&, const IDType_t&) const = 0;
+
+		/** @brief Fixes up the channel after all its items are parsed.
+			*
+			* The default implementation does nothing.
+			*/
+		virtual void FinalizeChannel (Channel&) const;
+
 		QString GetDescription (const QDomElement&) const;
 		void GetDescription (const QDomElement&, QString&) const;
 		QString GetLink (const QDomElement&) const;
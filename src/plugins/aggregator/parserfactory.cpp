@@ -28,6 +28,8 @@
  **********************************************************************/
 
 #include <QtDebug>
+#include <QDomDocument>
+#include <QXmlStreamReader>
 #include "parserfactory.h"
 #include "parser.h"
 
@@ -61,6 +63,40 @@ namespace Aggregator
 			}
 		return result;
 	}
+
+	ParserFactory::ParseResult_t ParserFactory::Parse (QIODevice *device, const IDType_t& feedId) const
+	{
+		QXmlStreamReader reader (device);
+
+		const auto& makeXmlError = [&reader]
+		{
+			return ParseResult_t { XmlError { reader.errorString (), reader.lineNumber (), reader.columnNumber () } };
+		};
+
+		while (!reader.atEnd () && !reader.isStartElement ())
+			reader.readNext ();
+		if (reader.hasError ())
+			return makeXmlError ();
+		if (!reader.isStartElement ())
+			return ParseResult_t { UnknownFormat {} };
+
+		QDomDocument skeleton;
+		auto root = skeleton.createElementNS (reader.namespaceUri ().toString (),
+				reader.qualifiedName ().toString ());
+		for (const auto& attr : reader.attributes ())
+			root.setAttributeNS (attr.namespaceUri ().toString (),
+					attr.qualifiedName ().toString (), attr.value ().toString ());
+		skeleton.appendChild (root);
+
+		const auto parser = Return (skeleton);
+		if (!parser)
+			return ParseResult_t { UnknownFormat {} };
+
+		const auto& channels = parser->ParseFeed (reader, skeleton, feedId);
+		if (reader.hasError ())
+			return makeXmlError ();
+
+		return ParseResult_t { channels };
+	}
 }
 }
-
@@ -30,8 +30,11 @@
 #ifndef PLUGINS_AGGREGATOR_PARSERFACTORY_H
 #define PLUGINS_AGGREGATOR_PARSERFACTORY_H
 #include <QList>
+#include <boost/variant.hpp>
+#include "channel.h"
 
 class QDomDocument;
+class QIODevice;
 
 namespace LeechCraft
 {
@@ -44,9 +47,36 @@ namespace Aggregator
 		QList<Parser*> Parsers_;
 		ParserFactory ();
 	public:
+		struct XmlError
+		{
+			QString Message_;
+			qint64 Line_;
+			qint64 Column_;
+		};
+
+		struct UnknownFormat {};
+
+		using ParseResult_t = boost::variant<channels_container_t, XmlError, UnknownFormat>;
+
 		static ParserFactory& Instance ();
 		void Register (Parser*);
 		Parser* Return (const QDomDocument&) const;
+
+		/** @brief Parses the feed read from the given device.
+		 *
+		 * The document is read incrementally via QXmlStreamReader,
+		 * so the whole DOM of the document is never built for the
+		 * formats supporting stream parsing (see
+		 * Parser::GetElementRole()).
+		 *
+		 * This function is reentrant and is intended to be called from
+		 * a worker thread, once all the parsers are registered.
+		 *
+		 * @param[in] device The device to read the feed from.
+		 * @param[in] feedId The ID of the parent feed.
+		 * @return The parsed channels, or the parse error.
+		 */
+		ParseResult_t Parse (QIODevice *device, const IDType_t& feedId) const;
 	};
 }
 }
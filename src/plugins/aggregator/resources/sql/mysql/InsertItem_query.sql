@@ -1,5 +1,5 @@
 INSERT INTO items 
     (item_id, channel_id, title, url, description, author, category, guid, pub_date, 
-    unread, num_comments, comments_url, comments_page_url, latitude, longitude ) 
-        VALUES ( ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ?);
+    unread, num_comments, comments_url, comments_page_url, latitude, longitude, content_hash ) 
+        VALUES ( ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ? ,  ?);
 
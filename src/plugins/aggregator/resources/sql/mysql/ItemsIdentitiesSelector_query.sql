@@ -0,0 +1,3 @@
+SELECT item_id, title, url, content_hash 
+    FROM items 
+        WHERE channel_id = ? 
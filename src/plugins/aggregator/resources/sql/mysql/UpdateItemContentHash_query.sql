@@ -0,0 +1,3 @@
+UPDATE items 
+    SET content_hash = ? 
+        WHERE item_id = ? 
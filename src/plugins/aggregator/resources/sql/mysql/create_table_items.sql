@@ -13,11 +13,14 @@ CREATE TABLE items (
     comments_url TEXT, 
     comments_page_url TEXT, 
     latitude TEXT, 
-    longitude TEXT
+    longitude TEXT, 
+    content_hash TEXT
 );
 
 CREATE INDEX idx_items_channel_id ON items (channel_id);
 
+CREATE FULLTEXT INDEX idx_items_fulltext ON items (title, description, author);
+
 ALTER TABLE items ADD 
   FOREIGN KEY ( channel_id ) 
     REFERENCES channels ( channel_id )
@@ -65,10 +65,7 @@ namespace Aggregator
 		while (!channel.isNull ())
 		{
 			Channel_ptr chan (new Channel (feedId));
-
-			chan->Title_ = channel.firstChildElement ("title").text ().trimmed ();
-			chan->Description_ = channel.firstChildElement ("description").text ();
-			chan->Link_ = channel.firstChildElement ("link").text ();
+			FillChannel (channel, *chan);
 
 			auto& itemsList = chan->Items_;
 			itemsList.reserve (20);
@@ -79,13 +76,7 @@ namespace Aggregator
 				itemsList.push_back (Item_ptr (ParseItem (item, chan->ChannelID_)));
 				item = item.nextSiblingElement ("item");
 			}
-			if (!chan->LastBuild_.isValid () || chan->LastBuild_.isNull ())
-			{
-				if (!itemsList.empty ())
-					chan->LastBuild_ = itemsList.at (0)->PubDate_;
-				else
-					chan->LastBuild_ = QDateTime::currentDateTime ();
-			}
+			FinalizeChannel (*chan);
 
 			channels.push_back (chan);
 			channel = channel.nextSiblingElement ("channel");
@@ -93,6 +84,23 @@ namespace Aggregator
 		return channels;
 	}
 
+	Parser::ElementRole RSS091Parser::GetElementRole (const QDomElement& elem) const
+	{
+		const auto& parent = elem.parentNode ().toElement ();
+		if (elem.tagName () == "channel" && parent == parent.ownerDocument ().documentElement ())
+			return ElementRole::Channel;
+		if (elem.tagName () == "item" && parent.tagName () == "channel")
+			return ElementRole::Item;
+		return ElementRole::Other;
+	}
+
+	void RSS091Parser::FillChannel (const QDomElement& channel, Channel& chan) const
+	{
+		chan.Title_ = channel.firstChildElement ("title").text ().trimmed ();
+		chan.Description_ = channel.firstChildElement ("description").text ();
+		chan.Link_ = channel.firstChildElement ("link").text ();
+	}
+
 	Item* RSS091Parser::ParseItem (const QDomElement& item,
 			const IDType_t& channelId) const
 	{
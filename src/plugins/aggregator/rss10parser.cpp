@@ -65,14 +65,7 @@ namespace Aggregator
 		while (!channelDescr.isNull ())
 		{
 			Channel_ptr channel (new Channel (feedId));
-			channel->Title_ = channelDescr.firstChildElement ("title").text ().trimmed ();
-			channel->Link_ = channelDescr.firstChildElement ("link").text ();
-			channel->Description_ =
-				channelDescr.firstChildElement ("description").text ();
-			channel->PixmapURL_ =
-				channelDescr.firstChildElement ("image")
-				.firstChildElement ("url").text ();
-			channel->LastBuild_ = GetDCDateTime (channelDescr);
+			FillChannel (channelDescr, *channel);
 	
 			QDomElement itemsRoot = channelDescr.firstChildElement ("items");
 			QDomNodeList seqs = itemsRoot.elementsByTagNameNS (RDF_, "Seq");
@@ -96,32 +89,50 @@ namespace Aggregator
 			QString about = itemDescr.attributeNS (RDF_, "about");
 			if (item2Channel.contains (about))
 			{
-				Item_ptr item (new Item (item2Channel [about]->ChannelID_));
-				item->Title_ = itemDescr.firstChildElement ("title").text ();
-				item->Link_ = itemDescr.firstChildElement ("link").text ();
-				item->Description_ = itemDescr.firstChildElement ("description").text ();
-				GetDescription (itemDescr, item->Description_);
-	
-				item->Categories_ = GetAllCategories (itemDescr);
-				item->Author_ = GetAuthor (itemDescr);
-				item->PubDate_ = GetDCDateTime (itemDescr);
-				item->Unread_ = true;
-				item->NumComments_ = GetNumComments (itemDescr);
-				item->CommentsLink_ = GetCommentsRSS (itemDescr);
-				item->CommentsPageLink_ = GetCommentsLink (itemDescr);
-				item->Enclosures_ = GetEncEnclosures (itemDescr, item->ItemID_);
-				QPair<double, double> point = GetGeoPoint (itemDescr);
-				item->Latitude_ = point.first;
-				item->Longitude_ = point.second;
-				if (item->Guid_.isEmpty ())
-					item->Guid_ = "empty";
-	
-				item2Channel [about]->Items_.push_back (item);
+				const auto& channel = item2Channel [about];
+				channel->Items_.push_back (Item_ptr (ParseItem (itemDescr, channel->ChannelID_)));
 			}
 			itemDescr = itemDescr.nextSiblingElement ("item");
 		}
 	
 		return result;
 	}
+
+	void RSS10Parser::FillChannel (const QDomElement& channelDescr, Channel& channel) const
+	{
+		channel.Title_ = channelDescr.firstChildElement ("title").text ().trimmed ();
+		channel.Link_ = channelDescr.firstChildElement ("link").text ();
+		channel.Description_ =
+			channelDescr.firstChildElement ("description").text ();
+		channel.PixmapURL_ =
+			channelDescr.firstChildElement ("image")
+			.firstChildElement ("url").text ();
+		channel.LastBuild_ = GetDCDateTime (channelDescr);
+	}
+
+	Item* RSS10Parser::ParseItem (const QDomElement& itemDescr,
+			const IDType_t& channelId) const
+	{
+		Item *item = new Item (channelId);
+		item->Title_ = itemDescr.firstChildElement ("title").text ();
+		item->Link_ = itemDescr.firstChildElement ("link").text ();
+		item->Description_ = itemDescr.firstChildElement ("description").text ();
+		GetDescription (itemDescr, item->Description_);
+
+		item->Categories_ = GetAllCategories (itemDescr);
+		item->Author_ = GetAuthor (itemDescr);
+		item->PubDate_ = GetDCDateTime (itemDescr);
+		item->Unread_ = true;
+		item->NumComments_ = GetNumComments (itemDescr);
+		item->CommentsLink_ = GetCommentsRSS (itemDescr);
+		item->CommentsPageLink_ = GetCommentsLink (itemDescr);
+		item->Enclosures_ = GetEncEnclosures (itemDescr, item->ItemID_);
+		QPair<double, double> point = GetGeoPoint (itemDescr);
+		item->Latitude_ = point.first;
+		item->Longitude_ = point.second;
+		if (item->Guid_.isEmpty ())
+			item->Guid_ = "empty";
+		return item;
+	}
 }
 }
@@ -67,17 +67,7 @@ namespace Aggregator
 		while (!channel.isNull ())
 		{
 			Channel_ptr chan (new Channel (feedId));
-			chan->Title_ = channel.firstChildElement ("title").text ().trimmed ();
-			chan->Description_ = channel.firstChildElement ("description").text ();
-			chan->Link_ = GetLink (channel);
-			chan->LastBuild_ = RFC822TimeToQDateTime (channel.firstChildElement ("lastBuildDate").text ());
-			chan->Language_ = channel.firstChildElement ("language").text ();
-			chan->Author_ = GetAuthor (channel);
-			if (chan->Author_.isEmpty ())
-				chan->Author_ = channel.firstChildElement ("managingEditor").text ();
-			if (chan->Author_.isEmpty ())
-				chan->Author_ = channel.firstChildElement ("webMaster").text ();
-			chan->PixmapURL_ = channel.firstChildElement ("image").attribute ("url");
+			FillChannel (channel, *chan);
 
 			auto& itemsList = chan->Items_;
 			itemsList.reserve (20);
@@ -88,19 +78,38 @@ namespace Aggregator
 				itemsList.push_back (Item_ptr (ParseItem (item, chan->ChannelID_)));
 				item = item.nextSiblingElement ("item");
 			}
-			if (!chan->LastBuild_.isValid () || chan->LastBuild_.isNull ())
-			{
-				if (!itemsList.empty ())
-					chan->LastBuild_ = itemsList.at (0)->PubDate_;
-				else
-					chan->LastBuild_ = QDateTime::currentDateTime ();
-			}
+			FinalizeChannel (*chan);
 			channels.push_back (chan);
 			channel = channel.nextSiblingElement ("channel");
 		}
 		return channels;
 	}
 
+	Parser::ElementRole RSS20Parser::GetElementRole (const QDomElement& elem) const
+	{
+		const auto& parent = elem.parentNode ().toElement ();
+		if (elem.tagName () == "channel" && parent == parent.ownerDocument ().documentElement ())
+			return ElementRole::Channel;
+		if (elem.tagName () == "item" && parent.tagName () == "channel")
+			return ElementRole::Item;
+		return ElementRole::Other;
+	}
+
+	void RSS20Parser::FillChannel (const QDomElement& channel, Channel& chan) const
+	{
+		chan.Title_ = channel.firstChildElement ("title").text ().trimmed ();
+		chan.Description_ = channel.firstChildElement ("description").text ();
+		chan.Link_ = GetLink (channel);
+		chan.LastBuild_ = RFC822TimeToQDateTime (channel.firstChildElement ("lastBuildDate").text ());
+		chan.Language_ = channel.firstChildElement ("language").text ();
+		chan.Author_ = GetAuthor (channel);
+		if (chan.Author_.isEmpty ())
+			chan.Author_ = channel.firstChildElement ("managingEditor").text ();
+		if (chan.Author_.isEmpty ())
+			chan.Author_ = channel.firstChildElement ("webMaster").text ();
+		chan.PixmapURL_ = channel.firstChildElement ("image").attribute ("url");
+	}
+
 	Item* RSS20Parser::ParseItem (const QDomElement& item,
 			const IDType_t& channelId) const
 	{
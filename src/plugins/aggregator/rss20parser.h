@@ -46,6 +46,8 @@ namespace Aggregator
 	private:
 		channels_container_t Parse (const QDomDocument&,
 				const IDType_t&) const;
+		ElementRole GetElementRole (const QDomElement&) const;
+		void FillChannel (const QDomElement&, Channel&) const;
 		Item* ParseItem (const QDomElement&,
 				const IDType_t&) const;
 	};
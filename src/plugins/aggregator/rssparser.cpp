@@ -107,6 +107,17 @@ namespace Aggregator
 		return result.toLocalTime ();
 	}
 	
+	void RSSParser::FinalizeChannel (Channel& chan) const
+	{
+		if (chan.LastBuild_.isValid () && !chan.LastBuild_.isNull ())
+			return;
+
+		if (!chan.Items_.empty ())
+			chan.LastBuild_ = chan.Items_.at (0)->PubDate_;
+		else
+			chan.LastBuild_ = QDateTime::currentDateTime ();
+	}
+
 	QList<Enclosure> RSSParser::GetEnclosures (const QDomElement& entry, const IDType_t& item) const
 	{
 		QList<Enclosure> result;
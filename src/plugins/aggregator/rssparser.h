@@ -51,6 +51,11 @@ namespace Aggregator
 	protected:
 		QDateTime RFC822TimeToQDateTime (const QString&) const;
 		QList<Enclosure> GetEnclosures (const QDomElement&, const IDType_t&) const;
+
+		/** Falls back to the date of the first item or to the
+			* current date if the channel has no valid build date.
+			*/
+		void FinalizeChannel (Channel&) const;
 	};
 }
 }
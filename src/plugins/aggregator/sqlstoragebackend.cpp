@@ -49,6 +49,22 @@ namespace LeechCraft
 {
 namespace Aggregator
 {
+	namespace
+	{
+		const QString SearchDocument = "COALESCE (title, '') || ' ' || "
+				"COALESCE (description, '') || ' ' || "
+				"COALESCE (author, '')";
+
+		const QString ItemSearchFields = "items.item_id, "
+				"items.channel_id, "
+				"items.title, "
+				"items.url, "
+				"items.category, "
+				"items.pub_date, "
+				"items.unread, "
+				"items.description ";
+	}
+
 	SQLStorageBackend::SQLStorageBackend (StorageBackend::Type t, const QString& id)
 	: Type_ (t)
 	{
@@ -250,6 +266,15 @@ namespace Aggregator
 				"ORDER BY pub_date DESC, "
 				"title DESC");
 
+		ItemsIdentitiesSelector_ = QSqlQuery (DB_);
+		ItemsIdentitiesSelector_.prepare ("SELECT "
+				"item_id, "
+				"title, "
+				"url, "
+				"content_hash "
+				"FROM items "
+				"WHERE channel_id = :channel_id");
+
 		ItemFullSelector_ = QSqlQuery (DB_);
 		ItemFullSelector_.prepare ("SELECT "
 				"title, "
@@ -372,7 +397,8 @@ namespace Aggregator
 				"comments_url, "
 				"comments_page_url, "
 				"latitude, "
-				"longitude"
+				"longitude, "
+				"content_hash"
 				") VALUES ("
 				":item_id, "
 				":channel_id, "
@@ -388,7 +414,8 @@ namespace Aggregator
 				":comments_url, "
 				":comments_page_url, "
 				":latitude, "
-				":longitude"
+				":longitude, "
+				":content_hash"
 				");");
 
 		UpdateShortChannel_ = QSqlQuery (DB_);
@@ -465,6 +492,11 @@ namespace Aggregator
 				"longitude = :longitude "
 				"WHERE item_id = :item_id");
 
+		UpdateItemContentHash_ = QSqlQuery (DB_);
+		UpdateItemContentHash_.prepare ("UPDATE items SET "
+				"content_hash = :content_hash "
+				"WHERE item_id = :item_id");
+
 		ToggleChannelUnread_ = QSqlQuery (DB_);
 		ToggleChannelUnread_.prepare ("UPDATE items SET "
 				"unread = :unread "
@@ -779,6 +811,33 @@ namespace Aggregator
 		GetItemsForTag_ = QSqlQuery (DB_);
 		GetItemsForTag_.prepare ("SELECT item_id FROM items2tags "
 				"WHERE tag = :tag");
+
+		FullTextSearch_ = false;
+		ItemsSearcher_ = QSqlQuery (DB_);
+		switch (Type_)
+		{
+		case SBSQLite:
+			FullTextSearch_ = DB_.tables ().contains ("items_fts");
+			// Without the index the query depends on the number of words.
+			if (FullTextSearch_)
+				ItemsSearcher_.prepare ("SELECT " + ItemSearchFields +
+						"FROM items_fts "
+						"JOIN items ON items.item_id = items_fts.rowid "
+						"WHERE items_fts MATCH :query "
+						"ORDER BY items_fts.rank "
+						"LIMIT :limit");
+			break;
+		case SBPostgres:
+			FullTextSearch_ = true;
+			ItemsSearcher_.prepare ("SELECT " + ItemSearchFields +
+					"FROM items, plainto_tsquery ('simple', :query) search_query "
+					"WHERE to_tsvector ('simple', " + SearchDocument + ") @@ search_query "
+					"ORDER BY ts_rank (to_tsvector ('simple', " + SearchDocument + "), search_query) DESC "
+					"LIMIT :limit");
+			break;
+		case SBMysql:
+			break;
+		}
 	}
 
 	void SQLStorageBackend::GetFeedsIDs (ids_t& result) const
@@ -866,6 +925,102 @@ namespace Aggregator
 		}
 	}
 
+	namespace
+	{
+		QString MakeFTS5Query (const QString& query)
+		{
+			QStringList terms;
+			for (auto term : query.split (' ', QString::SkipEmptyParts))
+				terms << '"' + term.replace ('"', "\"\"") + '"';
+
+			// The query is typically still being typed.
+			if (!terms.isEmpty ())
+				terms.last () += '*';
+
+			return terms.join (' ');
+		}
+	}
+
+	StorageBackend::search_results_t SQLStorageBackend::SearchItems (const QString& query, int limit) const
+	{
+		if (query.trimmed ().isEmpty ())
+			return {};
+
+		if (Type_ == SBSQLite && !FullTextSearch_)
+			return SearchItemsByWords (query, limit);
+
+		switch (Type_)
+		{
+		case SBSQLite:
+			ItemsSearcher_.bindValue (":query", MakeFTS5Query (query));
+			break;
+		case SBPostgres:
+		case SBMysql:
+			ItemsSearcher_.bindValue (":query", query);
+			break;
+		}
+		ItemsSearcher_.bindValue (":limit", limit);
+
+		if (!ItemsSearcher_.exec ())
+		{
+			Util::DBLock::DumpError (ItemsSearcher_);
+			return {};
+		}
+
+		const auto& result = ReadSearchResults (ItemsSearcher_, query);
+		ItemsSearcher_.finish ();
+		return result;
+	}
+
+	StorageBackend::search_results_t SQLStorageBackend::SearchItemsByWords (const QString& query, int limit) const
+	{
+		const auto& words = query.split (' ', QString::SkipEmptyParts);
+
+		QStringList clauses;
+		for (int i = 0; i < words.size (); ++i)
+			clauses << SearchDocument + " LIKE :word" + QString::number (i);
+
+		QSqlQuery searcher (DB_);
+		searcher.prepare ("SELECT " + ItemSearchFields +
+				"FROM items "
+				"WHERE " + clauses.join (" AND ") + " "
+				"ORDER BY pub_date DESC "
+				"LIMIT :limit");
+		for (int i = 0; i < words.size (); ++i)
+			searcher.bindValue (":word" + QString::number (i), '%' + words.at (i) + '%');
+		searcher.bindValue (":limit", limit);
+
+		if (!searcher.exec ())
+		{
+			Util::DBLock::DumpError (searcher);
+			return {};
+		}
+
+		return ReadSearchResults (searcher, query);
+	}
+
+	StorageBackend::search_results_t SQLStorageBackend::ReadSearchResults (QSqlQuery& searcher,
+			const QString& query) const
+	{
+		search_results_t result;
+		while (searcher.next ())
+		{
+			const ItemShort sh
+			{
+				searcher.value (0).value<IDType_t> (),
+				searcher.value (1).value<IDType_t> (),
+				searcher.value (2).toString (),
+				searcher.value (3).toString (),
+				searcher.value (4).toString ()
+					.split ("<<<", QString::SkipEmptyParts),
+				searcher.value (5).toDateTime (),
+				searcher.value (6).toBool ()
+			};
+			result.push_back ({ sh, MakeSnippet (searcher.value (7).toString (), query) });
+		}
+		return result;
+	}
+
 	QList<IDType_t> SQLStorageBackend::GetItemsForTag (const ITagsManager::tag_id& tag)
 	{
 		QList<IDType_t> result;
@@ -1343,6 +1498,28 @@ namespace Aggregator
 		return item;
 	}
 
+	void SQLStorageBackend::GetItemsIdentities (items_identities_t& ids,
+			const IDType_t& channelId) const
+	{
+		ItemsIdentitiesSelector_.bindValue (":channel_id", channelId);
+
+		if (!ItemsIdentitiesSelector_.exec ())
+		{
+			Util::DBLock::DumpError (ItemsIdentitiesSelector_);
+			throw ItemGettingError ();
+		}
+
+		while (ItemsIdentitiesSelector_.next ())
+			ids.push_back ({
+					ItemsIdentitiesSelector_.value (0).value<IDType_t> (),
+					ItemsIdentitiesSelector_.value (1).toString (),
+					ItemsIdentitiesSelector_.value (2).toString (),
+					ItemsIdentitiesSelector_.value (3).toString ().toLatin1 ()
+				});
+
+		ItemsIdentitiesSelector_.finish ();
+	}
+
 	void SQLStorageBackend::GetItems (items_container_t& items,
 			const IDType_t& channelId) const
 	{
@@ -1509,6 +1686,26 @@ namespace Aggregator
 	}
 
 	void SQLStorageBackend::UpdateItem (Item_ptr item)
+	{
+		WriteItem (item);
+
+		try
+		{
+			IDType_t cid = item->ChannelID_;
+			Channel_ptr channel = GetChannel (cid,
+					FindParentFeedForChannel (cid));
+			emit itemDataUpdated (item, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< item->ChannelID_;
+		}
+	}
+
+	void SQLStorageBackend::WriteItem (const Item_ptr& item)
 	{
 		UpdateItem_.bindValue (":item_id", item->ItemID_);
 		UpdateItem_.bindValue (":description", item->Description_);
@@ -1541,21 +1738,22 @@ namespace Aggregator
 
 		WriteEnclosures (item->Enclosures_);
 		WriteMRSSEntries (item->MRSSEntries_);
+	}
 
-		try
-		{
-			IDType_t cid = item->ChannelID_;
-			Channel_ptr channel = GetChannel (cid,
-					FindParentFeedForChannel (cid));
-			emit itemDataUpdated (item, channel);
-			emit channelDataUpdated (channel);
-		}
-		catch (const ChannelNotFoundError&)
+	void SQLStorageBackend::WriteContentHash (const IDType_t& itemId, const QByteArray& hash)
+	{
+		UpdateItemContentHash_.bindValue (":item_id", itemId);
+		UpdateItemContentHash_.bindValue (":content_hash", QString::fromLatin1 (hash));
+
+		if (!UpdateItemContentHash_.exec ())
 		{
-			qWarning () << Q_FUNC_INFO
-				<< "channel not found"
-				<< item->ChannelID_;
+			Util::DBLock::DumpError (UpdateItemContentHash_);
+			throw std::runtime_error (qPrintable (QString (
+							"Failed to save content hash for item %1")
+						.arg (itemId)));
 		}
+
+		UpdateItemContentHash_.finish ();
 	}
 
 	void SQLStorageBackend::UpdateItem (const ItemShort& item)
@@ -1631,6 +1829,72 @@ namespace Aggregator
 	}
 
 	void SQLStorageBackend::AddItem (Item_ptr item)
+	{
+		InsertItem (item, GetContentHash (*item));
+
+		try
+		{
+			IDType_t cid = item->ChannelID_;
+			Channel_ptr channel = GetChannel (cid,
+					FindParentFeedForChannel (cid));
+			emit itemDataUpdated (item, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< item->ChannelID_;
+		}
+	}
+
+	void SQLStorageBackend::StoreItems (const ItemsBatch& batch, const IDType_t& channelId)
+	{
+		if (batch.Added_.isEmpty () &&
+				batch.Updated_.isEmpty () &&
+				batch.Rehashed_.isEmpty ())
+			return;
+
+		{
+			Util::DBLock lock (DB_);
+			lock.Init ();
+
+			for (const auto& added : batch.Added_)
+				InsertItem (added.Item_, added.ContentHash_);
+
+			for (const auto& updated : batch.Updated_)
+			{
+				WriteItem (updated.Item_);
+				WriteContentHash (updated.Item_->ItemID_, updated.ContentHash_);
+			}
+
+			for (const auto& pair : batch.Rehashed_)
+				WriteContentHash (pair.first, pair.second);
+
+			lock.Good ();
+		}
+
+		if (batch.Added_.isEmpty () && batch.Updated_.isEmpty ())
+			return;
+
+		try
+		{
+			const auto& channel = GetChannel (channelId, FindParentFeedForChannel (channelId));
+			for (const auto& added : batch.Added_)
+				emit itemDataUpdated (added.Item_, channel);
+			for (const auto& updated : batch.Updated_)
+				emit itemDataUpdated (updated.Item_, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< channelId;
+		}
+	}
+
+	void SQLStorageBackend::InsertItem (const Item_ptr& item, const QByteArray& hash)
 	{
 		InsertItem_.bindValue (":item_id", item->ItemID_);
 		InsertItem_.bindValue (":channel_id", item->ChannelID_);
@@ -1647,6 +1911,7 @@ namespace Aggregator
 		InsertItem_.bindValue (":comments_page_url", item->CommentsPageLink_);
 		InsertItem_.bindValue (":latitude", QString::number (item->Latitude_));
 		InsertItem_.bindValue (":longitude", QString::number (item->Longitude_));
+		InsertItem_.bindValue (":content_hash", QString::fromLatin1 (hash));
 
 		if (!InsertItem_.exec ())
 		{
@@ -1664,21 +1929,6 @@ namespace Aggregator
 
 		WriteEnclosures (item->Enclosures_);
 		WriteMRSSEntries (item->MRSSEntries_);
-
-		try
-		{
-			IDType_t cid = item->ChannelID_;
-			Channel_ptr channel = GetChannel (cid,
-					FindParentFeedForChannel (cid));
-			emit itemDataUpdated (item, channel);
-			emit channelDataUpdated (channel);
-		}
-		catch (const ChannelNotFoundError&)
-		{
-			qWarning () << Q_FUNC_INFO
-				<< "channel not found"
-				<< item->ChannelID_;
-		}
 	}
 
 	namespace
@@ -2028,7 +2278,8 @@ namespace Aggregator
 					"comments_url TEXT, "
 					"comments_page_url TEXT, "
 					"latitude TEXT, "
-					"longitude TEXT"
+					"longitude TEXT, "
+					"content_hash TEXT"
 					");").arg (GetBoolType ())))
 			{
 				LeechCraft::Util::DBLock::DumpError (query);
@@ -2345,9 +2596,121 @@ namespace Aggregator
 			}
 		}
 
+		if (!InitializeSearchIndex (tables))
+			qWarning () << Q_FUNC_INFO
+					<< "could not create full-text index, search would be slow";
+
 		return true;
 	}
 
+	bool SQLStorageBackend::InitializeSearchIndex (const QStringList& tables)
+	{
+		QSqlQuery query (DB_);
+		switch (Type_)
+		{
+		case SBSQLite:
+		{
+			if (!query.exec ("SELECT name FROM sqlite_master "
+						"WHERE type = 'trigger' AND name LIKE 'items_fts_%';"))
+			{
+				Util::DBLock::DumpError (query);
+				return false;
+			}
+
+			QStringList triggers;
+			while (query.next ())
+				triggers << query.value (0).toString ();
+
+			const QList<QPair<QString, QString>> triggerDefs
+			{
+				{
+					"items_fts_insert",
+					"CREATE TRIGGER IF NOT EXISTS items_fts_insert AFTER INSERT ON items BEGIN "
+						"INSERT INTO items_fts (rowid, title, description, author) "
+						"VALUES (NEW.item_id, NEW.title, NEW.description, NEW.author); "
+						"END;"
+				},
+				{
+					"items_fts_delete",
+					"CREATE TRIGGER IF NOT EXISTS items_fts_delete AFTER DELETE ON items BEGIN "
+						"INSERT INTO items_fts (items_fts, rowid, title, description, author) "
+						"VALUES ('delete', OLD.item_id, OLD.title, OLD.description, OLD.author); "
+						"END;"
+				},
+				{
+					"items_fts_update",
+					"CREATE TRIGGER IF NOT EXISTS items_fts_update AFTER UPDATE OF title, description, author ON items BEGIN "
+						"INSERT INTO items_fts (items_fts, rowid, title, description, author) "
+						"VALUES ('delete', OLD.item_id, OLD.title, OLD.description, OLD.author); "
+						"INSERT INTO items_fts (rowid, title, description, author) "
+						"VALUES (NEW.item_id, NEW.title, NEW.description, NEW.author); "
+						"END;"
+				}
+			};
+
+			/* A previous run might have been interrupted half-way, leaving
+			 * the table without some of the triggers. Whatever is missing
+			 * is (re)created, and the index is rebuilt if it could have
+			 * missed some changes to the items table.
+			 */
+			bool needRebuild = !tables.contains ("items_fts");
+			for (const auto& def : triggerDefs)
+				if (!triggers.contains (def.first))
+					needRebuild = true;
+
+			if (!needRebuild)
+				return true;
+
+			Util::DBLock lock (DB_);
+			try
+			{
+				lock.Init ();
+			}
+			catch (const std::runtime_error& e)
+			{
+				qWarning () << Q_FUNC_INFO << e.what ();
+				return false;
+			}
+
+			QStringList statements
+			{
+				"CREATE VIRTUAL TABLE IF NOT EXISTS items_fts USING fts5 ("
+					"title, "
+					"description, "
+					"author, "
+					"content = 'items', "
+					"content_rowid = 'item_id'"
+					");"
+			};
+			for (const auto& def : triggerDefs)
+				statements << def.second;
+			statements << "INSERT INTO items_fts (items_fts) VALUES ('rebuild');";
+
+			for (const auto& statement : statements)
+				if (!query.exec (statement))
+				{
+					Util::DBLock::DumpError (query);
+					return false;
+				}
+
+			lock.Good ();
+			return true;
+		}
+		case SBPostgres:
+			if (!query.exec ("CREATE INDEX IF NOT EXISTS idx_items_fts ON items "
+						"USING GIN (to_tsvector ('simple', " + SearchDocument + "));"))
+			{
+				Util::DBLock::DumpError (query);
+				return false;
+			}
+			return true;
+		case SBMysql:
+			break;
+		}
+
+		return false;
+	}
+
 	QByteArray SQLStorageBackend::SerializePixmap (const QImage& pixmap) const
 	{
 		QByteArray bytes;
@@ -2569,6 +2932,21 @@ namespace Aggregator
 
 			qDebug () << Q_FUNC_INFO << "syncing pools and exiting";
 		}
+		else if (version == 7)
+		{
+			// Tables recreated during the migration to version 6 already
+			// have this column.
+			if (!DB_.record ("items").contains ("content_hash"))
+			{
+				QSqlQuery updateQuery (DB_);
+				if (!updateQuery.exec ("ALTER TABLE items "
+							"ADD content_hash TEXT"))
+				{
+					Util::DBLock::DumpError (updateQuery);
+					return false;
+				}
+			}
+		}
 
 		lock.Good ();
 		return true;
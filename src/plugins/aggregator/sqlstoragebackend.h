@@ -125,6 +125,16 @@ namespace Aggregator
 							 * - channel_id
 							 */
 							ItemsShortSelector_,
+							/** Returns:
+							 * - item_id
+							 * - title
+							 * - url
+							 * - content_hash
+							 *
+							 * Binds:
+							 * - channel_id
+							 */
+							ItemsIdentitiesSelector_,
 							/** Returns:
 							 * - title
 							 * - url
@@ -242,6 +252,7 @@ namespace Aggregator
 							 * - comments_page_url
 							 * - latitude
 							 * - longitude
+							 * - content_hash
 							 */
 							InsertItem_,
 							/** Binds:
@@ -304,6 +315,11 @@ namespace Aggregator
 							 * - item_id
 							 */
 							UpdateItem_,
+							/** Binds:
+							 * - content_hash
+							 * - item_id
+							 */
+							UpdateItemContentHash_,
 							/** Binds:
 							 * - unread
 							 * - parents_hash
@@ -571,7 +587,24 @@ namespace Aggregator
 							 * Binds:
 							 * - tag
 							 */
-							GetItemsForTag_;
+							GetItemsForTag_,
+							/** Returns:
+							 * - item_id
+							 * - channel_id
+							 * - title
+							 * - url
+							 * - category
+							 * - pub_date
+							 * - unread
+							 * - description
+							 *
+							 * Binds:
+							 * - query
+							 * - limit
+							 */
+							ItemsSearcher_;
+
+		bool FullTextSearch_ = false;
 	public:
 		SQLStorageBackend (Type, const QString&);
 		virtual ~SQLStorageBackend ();
@@ -595,6 +628,7 @@ namespace Aggregator
 		virtual boost::optional<IDType_t> FindItem (const QString&, const QString&, const IDType_t&) const;
 		virtual boost::optional<IDType_t> FindItemByLink (const QString&, const IDType_t&) const;
 		virtual boost::optional<IDType_t> FindItemByTitle (const QString&, const IDType_t&) const;
+		virtual void GetItemsIdentities (items_identities_t&, const IDType_t&) const;
 		virtual void GetItems (items_container_t&,
 				const IDType_t&) const;
 
@@ -605,6 +639,7 @@ namespace Aggregator
 		virtual void UpdateItem (const ItemShort&);
 		virtual void AddChannel (Channel_ptr);
 		virtual void AddItem (Item_ptr);
+		virtual void StoreItems (const ItemsBatch&, const IDType_t&);
 		virtual void RemoveItems (const QSet<IDType_t>&);
 		virtual void RemoveChannel (const IDType_t&);
 		virtual void RemoveFeed (const IDType_t&);
@@ -616,6 +651,7 @@ namespace Aggregator
 		virtual QList<ITagsManager::tag_id> GetItemTags (const IDType_t&);
 		virtual void SetItemTags (const IDType_t&, const QList<ITagsManager::tag_id>&);
 		virtual QList<IDType_t> GetItemsForTag (const ITagsManager::tag_id&);
+		virtual search_results_t SearchItems (const QString&, int) const;
 
 		virtual IDType_t GetHighestID (const PoolType&) const;
 
@@ -623,6 +659,7 @@ namespace Aggregator
 		QString GetBoolType () const;
 		QString GetBlobType () const;
 		bool InitializeTables ();
+		bool InitializeSearchIndex (const QStringList&);
 		QByteArray SerializePixmap (const QImage&) const;
 		QImage UnserializePixmap (const QByteArray&) const;
 
@@ -645,11 +682,20 @@ namespace Aggregator
 
 		IDType_t FindParentFeedForChannel (const IDType_t&) const;
 		void FillItem (const QSqlQuery&, Item_ptr&) const;
+		void InsertItem (const Item_ptr&, const QByteArray&);
+		void WriteItem (const Item_ptr&);
+		void WriteContentHash (const IDType_t&, const QByteArray&);
 		void WriteEnclosures (const QList<Enclosure>&);
 		void GetEnclosures (const IDType_t&, QList<Enclosure>&) const;
 		void WriteMRSSEntries (const QList<MRSSEntry>&);
 		void GetMRSSEntries (const IDType_t&, QList<MRSSEntry>&) const;
 		IDType_t GetHighestID (const QString&, const QString&) const;
+
+		/** Searches for the items containing all the words of the query
+		 * when there is no full-text index to search.
+		 */
+		search_results_t SearchItemsByWords (const QString&, int) const;
+		search_results_t ReadSearchResults (QSqlQuery&, const QString&) const;
 	};
 }
 }
@@ -100,6 +100,12 @@ namespace Aggregator
 		ItemsShortSelector_ = QSqlQuery (DB_);
 		ItemsShortSelector_.prepare (StorageBackend::LoadQuery ("mysql", "ItemsShortSelector_query"));
 
+		ItemsSearcher_ = QSqlQuery (DB_);
+		ItemsSearcher_.prepare (StorageBackend::LoadQuery ("mysql", "ItemsSearcher_query"));
+
+		ItemsIdentitiesSelector_ = QSqlQuery (DB_);
+		ItemsIdentitiesSelector_.prepare (StorageBackend::LoadQuery ("mysql", "ItemsIdentitiesSelector_query"));
+
 		ItemFullSelector_ = QSqlQuery (DB_);
 		ItemFullSelector_.prepare (StorageBackend::LoadQuery ("mysql", "ItemFullSelector_query"));
 
@@ -145,6 +151,9 @@ namespace Aggregator
 		UpdateItem_ = QSqlQuery (DB_);
 		UpdateItem_.prepare (StorageBackend::LoadQuery ("mysql", "UpdateItem_query"));
 
+		UpdateItemContentHash_ = QSqlQuery (DB_);
+		UpdateItemContentHash_.prepare (StorageBackend::LoadQuery ("mysql", "UpdateItemContentHash_query"));
+
 		ToggleChannelUnread_ = QSqlQuery (DB_);
 		ToggleChannelUnread_.prepare (StorageBackend::LoadQuery ("mysql", "ToggleChannelUnread_query"));
 
@@ -634,6 +643,28 @@ namespace Aggregator
 		ItemsShortSelector_.finish ();
 	}
 
+	void SQLStorageBackendMysql::GetItemsIdentities (items_identities_t& ids,
+			const IDType_t& channelId) const
+	{
+		ItemsIdentitiesSelector_.bindValue (0, channelId);			//channel_id
+
+		if (!ItemsIdentitiesSelector_.exec ())
+		{
+			Util::DBLock::DumpError (ItemsIdentitiesSelector_);
+			throw ItemGettingError ();
+		}
+
+		while (ItemsIdentitiesSelector_.next ())
+			ids.push_back ({
+					ItemsIdentitiesSelector_.value (0).value<IDType_t> (),
+					ItemsIdentitiesSelector_.value (1).toString (),
+					ItemsIdentitiesSelector_.value (2).toString (),
+					ItemsIdentitiesSelector_.value (3).toString ().toLatin1 ()
+				});
+
+		ItemsIdentitiesSelector_.finish ();
+	}
+
 	int SQLStorageBackendMysql::GetUnreadItems (const IDType_t& channelId) const
 	{
 		int unread = 0;
@@ -834,6 +865,26 @@ namespace Aggregator
 	}
 
 	void SQLStorageBackendMysql::UpdateItem (Item_ptr item)
+	{
+		WriteItem (item);
+
+		try
+		{
+			IDType_t cid = item->ChannelID_;
+			Channel_ptr channel = GetChannel (cid,
+					FindParentFeedForChannel (cid));
+			emit itemDataUpdated (item, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< item->ChannelID_;
+		}
+	}
+
+	void SQLStorageBackendMysql::WriteItem (const Item_ptr& item)
 	{
 		UpdateItem_.bindValue (0, item->ItemID_);
 		UpdateItem_.bindValue (1, item->Description_);
@@ -866,21 +917,22 @@ namespace Aggregator
 
 		WriteEnclosures (item->Enclosures_);
 		WriteMRSSEntries (item->MRSSEntries_);
+	}
 
-		try
-		{
-			IDType_t cid = item->ChannelID_;
-			Channel_ptr channel = GetChannel (cid,
-					FindParentFeedForChannel (cid));
-			emit itemDataUpdated (item, channel);
-			emit channelDataUpdated (channel);
-		}
-		catch (const ChannelNotFoundError&)
+	void SQLStorageBackendMysql::WriteContentHash (const IDType_t& itemId, const QByteArray& hash)
+	{
+		UpdateItemContentHash_.bindValue (0, QString::fromLatin1 (hash));
+		UpdateItemContentHash_.bindValue (1, itemId);
+
+		if (!UpdateItemContentHash_.exec ())
 		{
-			qWarning () << Q_FUNC_INFO
-				<< "channel not found"
-				<< item->ChannelID_;
+			Util::DBLock::DumpError (UpdateItemContentHash_);
+			throw std::runtime_error (qPrintable (QString (
+							"Failed to save content hash for item %1")
+						.arg (itemId)));
 		}
+
+		UpdateItemContentHash_.finish ();
 	}
 
 	void SQLStorageBackendMysql::UpdateItem (const ItemShort& item)
@@ -961,6 +1013,72 @@ namespace Aggregator
 	}
 
 	void SQLStorageBackendMysql::AddItem (Item_ptr item)
+	{
+		InsertItem (item, GetContentHash (*item));
+
+		try
+		{
+			IDType_t cid = item->ChannelID_;
+			Channel_ptr channel = GetChannel (cid,
+					FindParentFeedForChannel (cid));
+			emit itemDataUpdated (item, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< item->ChannelID_;
+		}
+	}
+
+	void SQLStorageBackendMysql::StoreItems (const ItemsBatch& batch, const IDType_t& channelId)
+	{
+		if (batch.Added_.isEmpty () &&
+				batch.Updated_.isEmpty () &&
+				batch.Rehashed_.isEmpty ())
+			return;
+
+		{
+			Util::DBLock lock (DB_);
+			lock.Init ();
+
+			for (const auto& added : batch.Added_)
+				InsertItem (added.Item_, added.ContentHash_);
+
+			for (const auto& updated : batch.Updated_)
+			{
+				WriteItem (updated.Item_);
+				WriteContentHash (updated.Item_->ItemID_, updated.ContentHash_);
+			}
+
+			for (const auto& pair : batch.Rehashed_)
+				WriteContentHash (pair.first, pair.second);
+
+			lock.Good ();
+		}
+
+		if (batch.Added_.isEmpty () && batch.Updated_.isEmpty ())
+			return;
+
+		try
+		{
+			const auto& channel = GetChannel (channelId, FindParentFeedForChannel (channelId));
+			for (const auto& added : batch.Added_)
+				emit itemDataUpdated (added.Item_, channel);
+			for (const auto& updated : batch.Updated_)
+				emit itemDataUpdated (updated.Item_, channel);
+			emit channelDataUpdated (channel);
+		}
+		catch (const ChannelNotFoundError&)
+		{
+			qWarning () << Q_FUNC_INFO
+				<< "channel not found"
+				<< channelId;
+		}
+	}
+
+	void SQLStorageBackendMysql::InsertItem (const Item_ptr& item, const QByteArray& hash)
 	{
 		InsertItem_.bindValue (0, item->ItemID_);
 		InsertItem_.bindValue (1, item->ChannelID_);
@@ -977,6 +1095,7 @@ namespace Aggregator
 		InsertItem_.bindValue (12, item->CommentsPageLink_);
 		InsertItem_.bindValue (13, QString::number (item->Latitude_));
 		InsertItem_.bindValue (14, QString::number (item->Longitude_));
+		InsertItem_.bindValue (15, QString::fromLatin1 (hash));
 
 		if (!InsertItem_.exec ())
 		{
@@ -994,21 +1113,6 @@ namespace Aggregator
 
 		WriteEnclosures (item->Enclosures_);
 		WriteMRSSEntries (item->MRSSEntries_);
-
-		try
-		{
-			IDType_t cid = item->ChannelID_;
-			Channel_ptr channel = GetChannel (cid,
-					FindParentFeedForChannel (cid));
-			emit itemDataUpdated (item, channel);
-			emit channelDataUpdated (channel);
-		}
-		catch (const ChannelNotFoundError&)
-		{
-			qWarning () << Q_FUNC_INFO
-				<< "channel not found"
-				<< item->ChannelID_;
-		}
 	}
 
 	namespace
@@ -1229,6 +1333,48 @@ namespace Aggregator
 		return QList<IDType_t> ();
 	}
 
+	StorageBackend::search_results_t SQLStorageBackendMysql::SearchItems (const QString& query, int limit) const
+	{
+		if (query.trimmed ().isEmpty ())
+			return {};
+
+		QStringList terms;
+		for (auto term : query.split (' ', QString::SkipEmptyParts))
+			terms << "+\"" + term.remove ('"') + '"';
+		const auto& booleanQuery = terms.join (' ');
+
+		ItemsSearcher_.bindValue (0, booleanQuery);		//query
+		ItemsSearcher_.bindValue (1, booleanQuery);		//query, for ranking
+		ItemsSearcher_.bindValue (2, limit);				//limit
+
+		if (!ItemsSearcher_.exec ())
+		{
+			Util::DBLock::DumpError (ItemsSearcher_);
+			return {};
+		}
+
+		search_results_t result;
+		while (ItemsSearcher_.next ())
+		{
+			const ItemShort sh
+			{
+				ItemsSearcher_.value (0).value<IDType_t> (),
+				ItemsSearcher_.value (1).value<IDType_t> (),
+				ItemsSearcher_.value (2).toString (),
+				ItemsSearcher_.value (3).toString (),
+				ItemsSearcher_.value (4).toString ()
+					.split ("<<<", QString::SkipEmptyParts),
+				ItemsSearcher_.value (5).toDateTime (),
+				ItemsSearcher_.value (6).toBool ()
+			};
+			result.push_back ({ sh, MakeSnippet (ItemsSearcher_.value (7).toString (), query) });
+		}
+
+		ItemsSearcher_.finish ();
+
+		return result;
+	}
+
 	bool SQLStorageBackendMysql::UpdateFeedsStorage (int, int)
 	{
 		return true;
@@ -1241,6 +1387,31 @@ namespace Aggregator
 
 	bool SQLStorageBackendMysql::UpdateItemsStorage (int, int)
 	{
+		// Tables created before content hashes were introduced lack
+		// the corresponding column.
+		if (!DB_.record ("items").contains ("content_hash"))
+		{
+			QSqlQuery updateQuery (DB_);
+			if (!updateQuery.exec ("ALTER TABLE items ADD content_hash TEXT"))
+			{
+				Util::DBLock::DumpError (updateQuery);
+				return false;
+			}
+		}
+
+		// Likewise for the full-text index.
+		QSqlQuery indexQuery (DB_);
+		if (!indexQuery.exec ("SHOW INDEX FROM items WHERE Key_name = 'idx_items_fulltext'"))
+			Util::DBLock::DumpError (indexQuery);
+		else if (!indexQuery.next () &&
+				!indexQuery.exec ("CREATE FULLTEXT INDEX idx_items_fulltext "
+						"ON items (title, description, author)"))
+		{
+			Util::DBLock::DumpError (indexQuery);
+			qWarning () << Q_FUNC_INFO
+					<< "could not create full-text index, search would be unavailable";
+		}
+
 		bool success = true;
 		/* NOTE No versioning in MySQL yet, so just return true for now.
 		while (oldV < newV)
@@ -124,6 +124,31 @@ namespace Aggregator
 							*/
 							ItemsShortSelector_,
 							/** Returns:
+							* - item_id
+							* - title
+							* - url
+							* - content_hash
+							*
+							* Binds:
+							* - channel_id
+							*/
+							ItemsIdentitiesSelector_,
+							/** Returns:
+							* - item_id
+							* - channel_id
+							* - title
+							* - url
+							* - category
+							* - pub_date
+							* - unread
+							* - description
+							*
+							* Binds:
+							* - query
+							* - limit
+							*/
+							ItemsSearcher_,
+							/** Returns:
 							* - title
 							* - url
 							* - description
@@ -240,6 +265,7 @@ namespace Aggregator
 							* - comments_page_url
 							* - latitude
 							* - longitude
+							* - content_hash
 							*/
 							InsertItem_,
 							/** Binds:
@@ -293,6 +319,11 @@ namespace Aggregator
 							*/
 							UpdateItem_,
 							/** Binds:
+							* - content_hash
+							* - item_id
+							*/
+							UpdateItemContentHash_,
+							/** Binds:
 							* - unread
 							* - parents_hash
 							*/
@@ -561,6 +592,7 @@ namespace Aggregator
 		virtual boost::optional<IDType_t> FindItem (const QString&, const QString&, const IDType_t&) const;
 		virtual boost::optional<IDType_t> FindItemByLink (const QString&, const IDType_t&) const;
 		virtual boost::optional<IDType_t> FindItemByTitle (const QString&, const IDType_t&) const;
+		virtual void GetItemsIdentities (items_identities_t&, const IDType_t&) const;
 		virtual void GetItems (items_container_t&, const IDType_t&) const;
 
 		virtual void AddFeed (Feed_ptr);
@@ -570,6 +602,7 @@ namespace Aggregator
 		virtual void UpdateItem (const ItemShort&);
 		virtual void AddChannel (Channel_ptr);
 		virtual void AddItem (Item_ptr);
+		virtual void StoreItems (const ItemsBatch&, const IDType_t&);
 		virtual void RemoveItems (const QSet<IDType_t>&);
 		virtual void RemoveChannel (const IDType_t&);
 		virtual void RemoveFeed (const IDType_t&);
@@ -581,6 +614,7 @@ namespace Aggregator
 		virtual QList<ITagsManager::tag_id> GetItemTags (const IDType_t&);
 		virtual void SetItemTags (const IDType_t&, const QList<ITagsManager::tag_id>&);
 		virtual QList<IDType_t> GetItemsForTag (const ITagsManager::tag_id&);
+		virtual search_results_t SearchItems (const QString&, int) const;
 
 		virtual IDType_t GetHighestID (const PoolType&) const;
 
@@ -595,6 +629,9 @@ namespace Aggregator
 
 		IDType_t FindParentFeedForChannel (const IDType_t&) const;
 		void FillItem (const QSqlQuery&, Item_ptr&) const;
+		void InsertItem (const Item_ptr&, const QByteArray&);
+		void WriteItem (const Item_ptr&);
+		void WriteContentHash (const IDType_t&, const QByteArray&);
 		void WriteEnclosures (const QList<Enclosure>&);
 		void GetEnclosures (const IDType_t&, QList<Enclosure>&) const;
 		void WriteMRSSEntries (const QList<MRSSEntry>&);
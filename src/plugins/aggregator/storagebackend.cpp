@@ -29,7 +29,10 @@
 
 #include "storagebackend.h"
 #include <stdexcept>
+#include <algorithm>
 #include <QFile>
+#include <QRegExp>
+#include <QTextDocumentFragment>
 #include <QDebug>
 #include "sqlstoragebackend.h"
 #include "sqlstoragebackend_mysql.h"
@@ -57,6 +60,34 @@ namespace Aggregator
 		return file.readAll ();
 	}
 
+	QString StorageBackend::MakeSnippet (const QString& text, const QString& query)
+	{
+		const int contextSize = 60;
+
+		const auto& plain = QTextDocumentFragment::fromHtml (text).toPlainText ().simplified ();
+		const auto& words = query.split (' ', QString::SkipEmptyParts);
+
+		int firstPos = -1;
+		for (const auto& word : words)
+		{
+			const auto pos = plain.indexOf (word, 0, Qt::CaseInsensitive);
+			if (pos >= 0 && (firstPos < 0 || pos < firstPos))
+				firstPos = pos;
+		}
+
+		const auto start = std::max (0, firstPos - contextSize);
+		auto snippet = plain.mid (start, 2 * contextSize).toHtmlEscaped ();
+		for (const auto& word : words)
+			snippet.replace (QRegExp ("(" + QRegExp::escape (word.toHtmlEscaped ()) + ")", Qt::CaseInsensitive),
+					"<b>\\1</b>");
+
+		if (start > 0)
+			snippet.prepend ("...");
+		if (start + 2 * contextSize < plain.size ())
+			snippet.append ("...");
+		return snippet;
+	}
+
 	StorageBackend_ptr StorageBackend::Create (const QString& strType, const QString& id)
 	{
 		StorageBackend::Type type;
@@ -60,6 +60,66 @@ namespace Aggregator
 		struct FeedGettingError {};
 		struct FeedNotFoundError {};
 
+		/** @brief Identifying information about a stored item.
+		 *
+		 * @sa GetItemsIdentities()
+		 */
+		struct ItemIdentity
+		{
+			IDType_t ItemID_;
+			QString Title_;
+			QString Link_;
+			/** @brief The content hash of the last seen feed version of
+			 * the item, or an empty array if it's unknown.
+			 *
+			 * @sa GetContentHash()
+			 */
+			QByteArray ContentHash_;
+		};
+		using items_identities_t = std::vector<ItemIdentity>;
+
+		/** @brief An item along with the content hash of its feed version.
+		 */
+		struct HashedItem
+		{
+			Item_ptr Item_;
+			QByteArray ContentHash_;
+		};
+
+		/** @brief A set of changes to the items of a single channel.
+		 *
+		 * @sa StoreItems()
+		 */
+		struct ItemsBatch
+		{
+			/** @brief The new items to be inserted.
+			 */
+			QList<HashedItem> Added_;
+			/** @brief The already existing items to be rewritten.
+			 */
+			QList<HashedItem> Updated_;
+			/** @brief The IDs of already existing unmodified items whose
+			 * stored content hash should be replaced.
+			 */
+			QList<QPair<IDType_t, QByteArray>> Rehashed_;
+		};
+
+		/** @brief A single full-text search match.
+		 *
+		 * @sa SearchItems()
+		 */
+		struct ItemSearchResult
+		{
+			/** @brief Short information about the matched item.
+			 */
+			ItemShort Item_;
+			/** @brief A fragment of the item's text around the match,
+			 * with matched terms wrapped in \em b tags.
+			 */
+			QString Snippet_;
+		};
+		using search_results_t = QList<ItemSearchResult>;
+
 		enum Type
 		{
 			SBSQLite,
@@ -267,6 +327,21 @@ namespace Aggregator
 		virtual boost::optional<IDType_t> FindItemByLink (const QString& link,
 				const IDType_t& channel) const = 0;
 
+		/** @brief Returns identities of all items in the channel.
+		 *
+		 * This function fetches just enough information about the items
+		 * to match them against freshly fetched ones in memory, without
+		 * issuing per-item FindItem() and GetItem() calls.
+		 *
+		 * @param[out] ids The container to which identities of the items
+		 * would be appended.
+		 * @param[in] channelId The ID of the channel.
+		 *
+		 * @sa StoreItems()
+		 */
+		virtual void GetItemsIdentities (items_identities_t& ids,
+				const IDType_t& channelId) const = 0;
+
 		/** @brief Returns all items in the channel.
 		 *
 		 * Returns full information about all the items in the
@@ -316,6 +391,21 @@ namespace Aggregator
 		 */
 		virtual void AddItem (Item_ptr item) = 0;
 
+		/** @brief Stores a batch of changes to the channel's items.
+		 *
+		 * Inserts the added items, rewrites the updated ones and
+		 * replaces the content hashes of the rehashed ones, all inside
+		 * a single transaction if the backend supports it.
+		 *
+		 * This function emits itemDataUpdated() for each added or updated
+		 * item and channelDataUpdated() once after it finishes.
+		 *
+		 * @param[in] batch The changes to store.
+		 * @param[in] channelId The ID of the channel all the items in
+		 * the batch belong to.
+		 */
+		virtual void StoreItems (const ItemsBatch& batch, const IDType_t& channelId) = 0;
+
 		/** @brief Updates an already existing channel.
 		 *
 		 * If the specified channel doesn't exist in the storage, it should
@@ -443,12 +533,36 @@ namespace Aggregator
 		virtual void SetItemTags (const IDType_t& id, const QList<ITagsManager::tag_id>& tags) = 0;
 		virtual QList<IDType_t> GetItemsForTag (const ITagsManager::tag_id& tag) = 0;
 
+		/** @brief Searches titles, descriptions and authors of all the
+		 * stored items.
+		 *
+		 * The search is performed by the full-text index maintained by
+		 * the storage itself, so only the matching items are ever read.
+		 *
+		 * @param[in] query The words to search for, all of them should
+		 * be present in a matching item.
+		 * @param[in] limit Maximum number of results to return.
+		 * @return Matching items, the most relevant ones first.
+		 */
+		virtual search_results_t SearchItems (const QString& query, int limit) const = 0;
+
 		/** @brief Searches for highest id of given type in the database
 		 *
 		 * @param[in] type of id to find
 		 * @return highest channels id in the database or 0 if empty
 		 */
 		virtual IDType_t GetHighestID (const PoolType& type) const = 0;
+	protected:
+		/** @brief Makes a search snippet for backends lacking a native
+		 * one.
+		 *
+		 * @param[in] text The text to make the snippet of, possibly
+		 * containing HTML markup.
+		 * @param[in] query The search query.
+		 * @return A fragment of the \em text around the first matching
+		 * word, with matched words highlighted.
+		 */
+		static QString MakeSnippet (const QString& text, const QString& query);
 	signals:
 		/** @brief Notifies about updated channel information.
 		 *
@@ -0,0 +1,249 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "parsersbenchmark.h"
+#include <QtTest>
+#include <QDomDocument>
+#include <QXmlStreamWriter>
+#include "parserfactory.h"
+#include "parser.h"
+#include "rss20parser.h"
+#include "rss10parser.h"
+#include "rss091parser.h"
+#include "atom10parser.h"
+#include "atom03parser.h"
+
+QTEST_MAIN (LeechCraft::Aggregator::ParsersBenchmark)
+
+namespace LeechCraft
+{
+namespace Aggregator
+{
+	namespace
+	{
+		const int SynthItemsCount = 5000;
+
+		/* Real-world feeds are picked up from the directory pointed to
+		 * by this variable, if any. Synthetic feeds are used otherwise.
+		 */
+		const char * const CorpusVar = "LC_AGGREGATOR_FEEDS_CORPUS";
+
+		void WriteRSS20 (const QString& path)
+		{
+			QFile file { path };
+			QVERIFY (file.open (QIODevice::WriteOnly));
+
+			QXmlStreamWriter w { &file };
+			w.writeStartDocument ();
+			w.writeStartElement ("rss");
+			w.writeAttribute ("version", "2.0");
+			w.writeNamespace ("http://purl.org/dc/elements/1.1/", "dc");
+			w.writeNamespace ("http://search.yahoo.com/mrss/", "media");
+			w.writeStartElement ("channel");
+			w.writeTextElement ("title", "Synthetic RSS 2.0 channel");
+			w.writeTextElement ("link", "http://example.com/");
+			w.writeTextElement ("description", "Synthetic channel description");
+			for (int i = 0; i < SynthItemsCount; ++i)
+			{
+				w.writeStartElement ("item");
+				w.writeTextElement ("title", QString { "Item %1" }.arg (i));
+				w.writeTextElement ("link", QString { "http://example.com/items/%1" }.arg (i));
+				w.writeTextElement ("guid", QString { "urn:item:%1" }.arg (i));
+				w.writeTextElement ("pubDate", "Mon, 17 Oct 2016 10:00:00 +0300");
+				w.writeTextElement ("http://purl.org/dc/elements/1.1/", "creator", "Author");
+				w.writeTextElement ("category", "Category");
+				w.writeStartElement ("description");
+				w.writeCDATA (QString { "<p>Body of the item %1.</p>" }.arg (i).repeated (20));
+				w.writeEndElement ();
+				w.writeStartElement ("http://search.yahoo.com/mrss/", "content");
+				w.writeAttribute ("url", QString { "http://example.com/media/%1.ogg" }.arg (i));
+				w.writeAttribute ("type", "audio/ogg");
+				w.writeEndElement ();
+				w.writeEndElement ();
+			}
+			w.writeEndElement ();
+			w.writeEndElement ();
+			w.writeEndDocument ();
+		}
+
+		void WriteAtom10 (const QString& path)
+		{
+			QFile file { path };
+			QVERIFY (file.open (QIODevice::WriteOnly));
+
+			const QString ns { "http://www.w3.org/2005/Atom" };
+
+			QXmlStreamWriter w { &file };
+			w.writeStartDocument ();
+			w.writeDefaultNamespace (ns);
+			w.writeStartElement (ns, "feed");
+			w.writeTextElement (ns, "title", "Synthetic Atom 1.0 feed");
+			w.writeTextElement (ns, "updated", "2016-10-17T10:00:00+03:00");
+			w.writeEmptyElement (ns, "link");
+			w.writeAttribute ("href", "http://example.com/");
+			for (int i = 0; i < SynthItemsCount; ++i)
+			{
+				w.writeStartElement (ns, "entry");
+				w.writeTextElement (ns, "title", QString { "Entry %1" }.arg (i));
+				w.writeTextElement (ns, "id", QString { "urn:entry:%1" }.arg (i));
+				w.writeTextElement (ns, "updated", "2016-10-17T10:00:00+03:00");
+				w.writeEmptyElement (ns, "link");
+				w.writeAttribute ("href", QString { "http://example.com/entries/%1" }.arg (i));
+				w.writeStartElement (ns, "content");
+				w.writeAttribute ("type", "html");
+				w.writeCharacters (QString { "<p>Body of the entry %1.</p>" }.arg (i).repeated (20));
+				w.writeEndElement ();
+				w.writeEndElement ();
+			}
+			w.writeEndElement ();
+			w.writeEndDocument ();
+		}
+
+		channels_container_t ParseDom (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return {};
+
+			QDomDocument doc;
+			if (!doc.setContent (file.readAll (), true))
+				return {};
+
+			const auto parser = ParserFactory::Instance ().Return (doc);
+			if (!parser)
+				return {};
+
+			return parser->ParseFeed (doc, 0);
+		}
+
+		channels_container_t ParseStream (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return {};
+
+			const auto& result = ParserFactory::Instance ().Parse (&file, 0);
+			if (const auto channels = boost::get<channels_container_t> (&result))
+				return *channels;
+			return {};
+		}
+	}
+
+	void ParsersBenchmark::initTestCase ()
+	{
+		ParserFactory::Instance ().Register (&RSS20Parser::Instance ());
+		ParserFactory::Instance ().Register (&Atom10Parser::Instance ());
+		ParserFactory::Instance ().Register (&RSS091Parser::Instance ());
+		ParserFactory::Instance ().Register (&Atom03Parser::Instance ());
+		ParserFactory::Instance ().Register (&RSS10Parser::Instance ());
+
+		if (!qEnvironmentVariableIsSet (CorpusVar))
+		{
+			QVERIFY (SynthDir_.isValid ());
+			WriteRSS20 (SynthDir_.path () + "/rss20.xml");
+			WriteAtom10 (SynthDir_.path () + "/atom10.xml");
+		}
+	}
+
+	void ParsersBenchmark::PopulateFeeds ()
+	{
+		QTest::addColumn<QString> ("path");
+
+		const QDir dir { qEnvironmentVariableIsSet (CorpusVar) ?
+				QString::fromLocal8Bit (qgetenv (CorpusVar)) :
+				SynthDir_.path () };
+		for (const auto& info : dir.entryInfoList (QDir::Files, QDir::Name))
+			QTest::newRow (qPrintable (info.fileName ())) << info.filePath ();
+	}
+
+	void ParsersBenchmark::testEquivalence_data ()
+	{
+		PopulateFeeds ();
+	}
+
+	void ParsersBenchmark::testEquivalence ()
+	{
+		QFETCH (QString, path);
+
+		const auto& dom = ParseDom (path);
+		const auto& stream = ParseStream (path);
+
+		QCOMPARE (stream.size (), dom.size ());
+		for (size_t i = 0; i < dom.size (); ++i)
+		{
+			const auto& domChannel = dom.at (i);
+			const auto& streamChannel = stream.at (i);
+			QCOMPARE (streamChannel->Title_, domChannel->Title_);
+			QCOMPARE (streamChannel->Link_, domChannel->Link_);
+			QCOMPARE (streamChannel->Description_, domChannel->Description_);
+			QCOMPARE (streamChannel->Items_.size (), domChannel->Items_.size ());
+
+			for (size_t j = 0; j < domChannel->Items_.size (); ++j)
+			{
+				const auto& domItem = domChannel->Items_.at (j);
+				const auto& streamItem = streamChannel->Items_.at (j);
+				QCOMPARE (streamItem->Title_, domItem->Title_);
+				QCOMPARE (streamItem->Link_, domItem->Link_);
+				QCOMPARE (streamItem->Guid_, domItem->Guid_);
+				QCOMPARE (streamItem->PubDate_, domItem->PubDate_);
+				QCOMPARE (streamItem->Description_, domItem->Description_);
+				QCOMPARE (streamItem->Categories_, domItem->Categories_);
+				QCOMPARE (streamItem->Enclosures_.size (), domItem->Enclosures_.size ());
+				QCOMPARE (streamItem->MRSSEntries_.size (), domItem->MRSSEntries_.size ());
+			}
+		}
+	}
+
+	void ParsersBenchmark::benchmarkDom_data ()
+	{
+		PopulateFeeds ();
+	}
+
+	void ParsersBenchmark::benchmarkDom ()
+	{
+		QFETCH (QString, path);
+		QBENCHMARK {
+			ParseDom (path);
+		}
+	}
+
+	void ParsersBenchmark::benchmarkStream_data ()
+	{
+		PopulateFeeds ();
+	}
+
+	void ParsersBenchmark::benchmarkStream ()
+	{
+		QFETCH (QString, path);
+		QBENCHMARK {
+			ParseStream (path);
+		}
+	}
+}
+}
@@ -176,6 +176,11 @@ namespace Azoth
 	, NumUnreadMsgs_ (Core::Instance ().GetUnreadCount (GetEntry<ICLEntry> ()))
 	, CDF_ (new ContactDropFilter (entryId, this))
 	, TypeTimer_ (new QTimer (this))
+	, ShowStatusChangesEvents_ (XmlSettingsManager::Instance ().Bind<bool> ("ShowStatusChangesEvents"))
+	, ShowStatusChangesEventsInPrivates_ (XmlSettingsManager::Instance ().Bind<bool> ("ShowStatusChangesEventsInPrivates"))
+	, ShowJoinsLeaves_ (XmlSettingsManager::Instance ().Bind<bool> ("ShowJoinsLeaves"))
+	, ShowEndConversations_ (XmlSettingsManager::Instance ().Bind<bool> ("ShowEndConversations"))
+	, SeparateMUCEventLogWindow_ (XmlSettingsManager::Instance ().Bind<bool> ("SeparateMUCEventLogWindow"))
 	{
 		Ui_.setupUi (this);
 		Ui_.View_->page ()->setNetworkAccessManager (nam);
@@ -225,6 +230,14 @@ namespace Azoth
 				SIGNAL (chatWindowSearchRequested (QString)),
 				this,
 				SLOT (handleChatWindowSearch (QString)));
+		connect (Ui_.View_,
+				SIGNAL (scrolledToTop ()),
+				this,
+				SLOT (handleViewScrolledToTop ()));
+		connect (Ui_.View_,
+				SIGNAL (scrolledToBottom ()),
+				this,
+				SLOT (handleViewScrolledToBottom ()));
 
 		TypeTimer_->setInterval (2000);
 		connect (TypeTimer_,
@@ -753,18 +766,19 @@ namespace Azoth
 		me->SetMUCSubject (Ui_.SubjEdit_->toPlainText ());
 	}
 
-	void ChatTab::on_View__loadFinished (bool)
+	namespace
 	{
-		Q_FOREACH (IMessage *msg, HistoryMessages_)
-			AppendMessage (msg);
+		const int MessagesWindowStep = 100;
 
-		ICLEntry *e = GetEntry<ICLEntry> ();
-		if (!e)
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "null entry";
-			return;
-		}
+		/* The view is only reloaded to drop the messages scrolled out of
+		 * view once more than this many of them are rendered.
+		 */
+		const int MaxRenderedMessages = 5 * MessagesWindowStep;
+	}
+
+	QList<IMessage*> ChatTab::GetViewMessages () const
+	{
+		const auto e = GetEntry<ICLEntry> ();
 
 		auto messages = e->GetAllMessages ();
 
@@ -777,8 +791,31 @@ namespace Azoth
 						{ return left->GetDateTime () < right->GetDateTime (); });
 		}
 
-		for (const auto msg : messages)
-			AppendMessage (msg);
+		return HistoryMessages_ + messages;
+	}
+
+	void ChatTab::on_View__loadFinished (bool)
+	{
+		if (!GetEntry<ICLEntry> ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "null entry";
+			return;
+		}
+
+		const auto& messages = GetViewMessages ();
+
+		/* Only the last few screenfuls of messages are rendered, and
+		 * older ones are added once the view is scrolled to the top.
+		 * Explicitly requested history is always shown in full though.
+		 */
+		const auto window = ShownWindows_ * MessagesWindowStep;
+		HiddenMessages_ = HistoryMessages_.isEmpty () ?
+				std::max (0, messages.size () - window) :
+				0;
+		AppendMessages (messages.mid (HiddenMessages_));
+
+		const auto frame = Ui_.View_->page ()->mainFrame ();
 
 		QFile scrollerJS (":/plugins/azoth/resources/scripts/scrollers.js");
 		if (!scrollerJS.open (QIODevice::ReadOnly))
@@ -787,9 +824,17 @@ namespace Azoth
 					<< scrollerJS.errorString ();
 		else
 		{
-			Ui_.View_->page ()->mainFrame ()->evaluateJavaScript (scrollerJS.readAll ());
-			Ui_.View_->page ()->mainFrame ()->evaluateJavaScript ("InstallEventListeners(); ScrollToBottom();");
+			frame->evaluateJavaScript (scrollerJS.readAll ());
+			if (ScrollFromBottom_ < 0)
+				frame->evaluateJavaScript ("InstallEventListeners(); ScrollToBottom();");
+			else
+			{
+				frame->evaluateJavaScript ("InstallEventListeners();");
+				frame->setScrollPosition ({ 0, frame->contentsSize ().height () - ScrollFromBottom_ });
+				frame->evaluateJavaScript ("TestScroll();");
+			}
 		}
+		ScrollFromBottom_ = -1;
 
 		emit hookThemeReloaded (Util::DefaultHookProxy_ptr (new Util::DefaultHookProxy),
 				this, Ui_.View_, GetEntry<QObject> ());
@@ -854,8 +899,6 @@ namespace Azoth
 		if (!entry)
 			return;
 
-		ScrollbackPos_ = 0;
-
 		const auto grace = XmlSettingsManager::Instance ()
 				.property ("ChatClearGraceTime").toInt ();
 		const auto& upTo = grace ? QDateTime::currentDateTime ().addSecs (-grace) : QDateTime {};
@@ -863,23 +906,128 @@ namespace Azoth
 
 		qDeleteAll (HistoryMessages_);
 		HistoryMessages_.clear ();
+		PagedHistoryCount_ = 0;
 		qDeleteAll (CoreMessages_);
 		CoreMessages_.clear ();
 		DummyMsgManager::Instance ().ClearMessages (GetCLEntry ());
 		LastDateTime_ = QDateTime ();
+		ShownWindows_ = 1;
+		HistoryPageRequested_ = false;
+		HistoryExhausted_ = false;
 		PrepareTheme ();
 	}
 
-	void ChatTab::handleHistoryBack ()
+	void ChatTab::handleViewScrolledToTop ()
 	{
-		ScrollbackPos_ += 50;
-		qDeleteAll (HistoryMessages_);
-		HistoryMessages_.clear ();
+		if (ScrollFromBottom_ >= 0)
+			return;
+
+		ShowOlderMessages ();
+	}
+
+	void ChatTab::handleViewScrolledToBottom ()
+	{
+		if (ScrollFromBottom_ >= 0 || HistoryPageRequested_)
+			return;
+
+		if (GetViewMessages ().size () - HiddenMessages_ <= MaxRenderedMessages)
+			return;
+
+		/* The older windows and history pages are out of view now, so
+		 * they are dropped and only the last window is kept rendered.
+		 */
+		qDeleteAll (HistoryMessages_.mid (0, PagedHistoryCount_));
+		HistoryMessages_ = HistoryMessages_.mid (PagedHistoryCount_);
+		PagedHistoryCount_ = 0;
+		HistoryExhausted_ = false;
+		ShownWindows_ = 1;
+
 		qDeleteAll (CoreMessages_);
 		CoreMessages_.clear ();
-		DummyMsgManager::Instance ().ClearMessages (GetCLEntry ());
 		LastDateTime_ = QDateTime ();
-		RequestLogs (ScrollbackPos_);
+		PrepareTheme ();
+	}
+
+	void ChatTab::ShowOlderMessages ()
+	{
+		if (HistoryPageRequested_)
+			return;
+
+		if (HiddenMessages_)
+		{
+			ShowHiddenWindow ();
+			return;
+		}
+
+		if (HistoryExhausted_)
+			return;
+
+		/* Everything the entry keeps in memory is already shown, so the
+		 * page preceding the oldest shown message is requested from the
+		 * history plugins.
+		 */
+		const auto& messages = GetViewMessages ();
+		HistoryPageAnchor_ = messages.isEmpty () ?
+				QDateTime::currentDateTime () :
+				messages.first ()->GetDateTime ();
+		HistoryPageRequested_ = RequestLogsBefore (HistoryPageAnchor_, MessagesWindowStep);
+		if (!HistoryPageRequested_)
+			HistoryExhausted_ = true;
+	}
+
+	void ChatTab::ShowHiddenWindow ()
+	{
+		const auto& messages = GetViewMessages ();
+		const auto newHidden = std::max (0, HiddenMessages_ - MessagesWindowStep);
+
+		const bool isActiveChat = Core::Instance ()
+				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
+
+		/* The older messages are prepared as if they were appended to
+		 * an empty view, and the state used by the further appends is
+		 * restored afterwards.
+		 */
+		const auto lastDateTime = LastDateTime_;
+		const auto lastLink = LastLink_;
+		LastDateTime_ = QDateTime ();
+
+		ChatMsgAppendList_t batch;
+		for (const auto msg : messages.mid (newHidden, HiddenMessages_ - newHidden))
+			PrepareAppend (msg, isActiveChat, batch);
+		if (const auto firstShown = messages.value (HiddenMessages_))
+			PrepareDaySeparator (firstShown, isActiveChat, batch);
+
+		LastDateTime_ = lastDateTime;
+		LastLink_ = lastLink;
+
+		const auto frame = Ui_.View_->page ()->mainFrame ();
+		const auto& heightJS = "document.documentElement.scrollHeight";
+		const auto oldHeight = frame->evaluateJavaScript (heightJS).toInt ();
+		const auto oldPos = frame->scrollPosition ().y ();
+
+		++ShownWindows_;
+
+		if (!Core::Instance ().PrependMessagesByTemplate (frame, batch))
+		{
+			// The style can't prepend, so the view is rebuilt instead.
+			ScrollFromBottom_ = frame->contentsSize ().height () - oldPos;
+
+			qDeleteAll (CoreMessages_);
+			CoreMessages_.clear ();
+			LastDateTime_ = QDateTime ();
+			PrepareTheme ();
+			return;
+		}
+
+		HiddenMessages_ = newHidden;
+
+		const auto newHeight = frame->evaluateJavaScript (heightJS).toInt ();
+		frame->setScrollPosition ({ 0, oldPos + newHeight - oldHeight });
+	}
+
+	void ChatTab::handleHistoryBack ()
+	{
+		ShowOlderMessages ();
 	}
 
 	void ChatTab::handleRichTextToggled ()
@@ -1353,6 +1501,20 @@ namespace Azoth
 		SetChatPartState (CPSPaused);
 	}
 
+	namespace
+	{
+		bool IsShownAlready (IMessage *msg, const QList<IMessage*>& rMsgs)
+		{
+			return std::any_of (rMsgs.begin (), rMsgs.end (),
+					[msg] (IMessage *tMsg)
+					{
+						return tMsg->GetDirection () == msg->GetDirection () &&
+								tMsg->GetBody () == msg->GetBody () &&
+								std::abs (tMsg->GetDateTime ().secsTo (msg->GetDateTime ())) < 5;
+					});
+		}
+	}
+
 	void ChatTab::handleGotLastMessages (QObject *entryObj, const QList<QObject*>& messages)
 	{
 		if (entryObj != GetEntry<QObject> ())
@@ -1367,14 +1529,11 @@ namespace Azoth
 			const auto msg = qobject_cast<IMessage*> (msgObj);
 			const auto& dt = msg->GetDateTime ();
 
-			if (std::any_of (rMsgs.begin (), rMsgs.end (),
-					[msg] (IMessage *tMsg)
-					{
-						return tMsg->GetDirection () == msg->GetDirection () &&
-								tMsg->GetBody () == msg->GetBody () &&
-								std::abs (tMsg->GetDateTime ().secsTo (msg->GetDateTime ())) < 5;
-					}))
+			if (IsShownAlready (msg, rMsgs))
+			{
+				delete msgObj;
 				continue;
+			}
 
 			if (HistoryMessages_.isEmpty () ||
 					HistoryMessages_.last ()->GetDateTime () <= dt)
@@ -1396,6 +1555,61 @@ namespace Azoth
 				SLOT (handleGotLastMessages (QObject*, const QList<QObject*>&)));
 	}
 
+	void ChatTab::handleGotMessagesBefore (QObject *entryObj,
+			const QDateTime& before, const QList<QObject*>& messages)
+	{
+		if (entryObj != GetEntry<QObject> ())
+			return;
+
+		disconnect (sender (),
+				SIGNAL (gotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&)),
+				this,
+				SLOT (handleGotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&)));
+
+		if (!HistoryPageRequested_ || before != HistoryPageAnchor_)
+		{
+			qDeleteAll (messages);
+			return;
+		}
+		HistoryPageRequested_ = false;
+
+		if (messages.isEmpty ())
+		{
+			HistoryExhausted_ = true;
+			return;
+		}
+
+		const auto& oldest = qobject_cast<IMessage*> (messages.first ())->GetDateTime ();
+		const auto& shown = GetViewMessages ();
+
+		QList<IMessage*> page;
+		for (const auto msgObj : messages)
+		{
+			const auto msg = qobject_cast<IMessage*> (msgObj);
+			if (IsShownAlready (msg, shown))
+				delete msgObj;
+			else
+				page << msg;
+		}
+
+		if (page.isEmpty ())
+		{
+			// The whole page is already shown, so the next one is tried.
+			if (oldest < HistoryPageAnchor_)
+			{
+				HistoryPageAnchor_ = oldest;
+				HistoryPageRequested_ = RequestLogsBefore (HistoryPageAnchor_, MessagesWindowStep);
+			}
+			HistoryExhausted_ = !HistoryPageRequested_;
+			return;
+		}
+
+		HistoryMessages_ = page + HistoryMessages_;
+		PagedHistoryCount_ += page.size ();
+		HiddenMessages_ = page.size ();
+		ShowHiddenWindow ();
+	}
+
 	void ChatTab::handleSendButtonVisible ()
 	{
 		Ui_.SendButton_->setVisible (XmlSettingsManager::Instance ()
@@ -1792,7 +2006,7 @@ namespace Azoth
 				this, "handleMinLinesHeightChanged");
 	}
 
-	void ChatTab::RequestLogs (int num)
+	bool ChatTab::RequestLogs (int num)
 	{
 		ICLEntry *entry = GetEntry<ICLEntry> ();
 		if (!entry)
@@ -1800,7 +2014,7 @@ namespace Azoth
 			qWarning () << Q_FUNC_INFO
 					<< "null entry for"
 					<< EntryID_;
-			return;
+			return false;
 		}
 
 		QObject *entryObj = entry->GetQObject ();
@@ -1808,6 +2022,7 @@ namespace Azoth
 		const QObjectList& histories = Core::Instance ().GetProxy ()->
 				GetPluginsManager ()->GetAllCastableRoots<IHistoryPlugin*> ();
 
+		bool requested = false;
 		Q_FOREACH (QObject *histObj, histories)
 		{
 			IHistoryPlugin *hist = qobject_cast<IHistoryPlugin*> (histObj);
@@ -1821,7 +2036,46 @@ namespace Azoth
 					Qt::UniqueConnection);
 
 			hist->RequestLastMessages (entryObj, num);
+			requested = true;
 		}
+		return requested;
+	}
+
+	bool ChatTab::RequestLogsBefore (const QDateTime& before, int num)
+	{
+		const auto entry = GetEntry<ICLEntry> ();
+		if (!entry)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "null entry for"
+					<< EntryID_;
+			return false;
+		}
+
+		const auto entryObj = entry->GetQObject ();
+
+		const auto& histories = Core::Instance ().GetProxy ()->
+				GetPluginsManager ()->GetAllCastableRoots<IHistoryPlugin*> ();
+
+		/* Pages from several history plugins can't be merged by a single
+		 * anchor, so only the first one keeping the history is asked.
+		 */
+		for (const auto histObj : histories)
+		{
+			const auto hist = qobject_cast<IHistoryPlugin*> (histObj);
+			if (!hist->IsHistoryEnabledFor (entryObj))
+				continue;
+
+			connect (histObj,
+					SIGNAL (gotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&)),
+					this,
+					SLOT (handleGotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&)),
+					Qt::UniqueConnection);
+
+			hist->RequestMessagesBefore (entryObj, before, num);
+			return true;
+		}
+		return false;
 	}
 
 	namespace
@@ -1833,6 +2087,25 @@ namespace Azoth
 	}
 
 	void ChatTab::AppendMessage (IMessage *msg)
+	{
+		AppendMessages ({ msg });
+	}
+
+	void ChatTab::AppendMessages (const QList<IMessage*>& messages)
+	{
+		const bool isActiveChat = Core::Instance ()
+				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
+
+		ChatMsgAppendList_t batch;
+		for (const auto msg : messages)
+			PrepareAppend (msg, isActiveChat, batch);
+
+		if (!Core::Instance ().AppendMessagesByTemplate (Ui_.View_->page ()->mainFrame (), batch))
+			qWarning () << Q_FUNC_INFO
+					<< "unhandled append message :(";
+	}
+
+	void ChatTab::PrepareAppend (IMessage *msg, bool isActiveChat, ChatMsgAppendList_t& batch)
 	{
 		ICLEntry *other = qobject_cast<ICLEntry*> (msg->OtherPart ());
 		if (!other && msg->OtherPart ())
@@ -1855,22 +2128,22 @@ namespace Azoth
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantStatusChange &&
 				(!parent || parent->GetEntryType () == ICLEntry::EntryType::MUC) &&
-				!XmlSettingsManager::Instance ().property ("ShowStatusChangesEvents").toBool ())
+				!ShowStatusChangesEvents_.Get ())
 			return;
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantStatusChange &&
 				(!parent || parent->GetEntryType () != ICLEntry::EntryType::MUC) &&
-				!XmlSettingsManager::Instance ().property ("ShowStatusChangesEventsInPrivates").toBool ())
+				!ShowStatusChangesEventsInPrivates_.Get ())
 			return;
 
 		if ((msg->GetMessageSubType () == IMessage::SubType::ParticipantJoin ||
 					msg->GetMessageSubType () == IMessage::SubType::ParticipantLeave) &&
-				!XmlSettingsManager::Instance ().property ("ShowJoinsLeaves").toBool ())
+				!ShowJoinsLeaves_.Get ())
 			return;
 
 		if (msg->GetMessageSubType () == IMessage::SubType::ParticipantEndedConversation)
 		{
-			if (!XmlSettingsManager::Instance ().property ("ShowEndConversations").toBool ())
+			if (!ShowEndConversations_.Get ())
 				return;
 			else if (other)
 				msg->SetBody (tr ("%1 ended the conversation.")
@@ -1884,7 +2157,7 @@ namespace Azoth
 		if (proxy->IsCancelled ())
 			return;
 
-		if (XmlSettingsManager::Instance ().property ("SeparateMUCEventLogWindow").toBool () &&
+		if (SeparateMUCEventLogWindow_.Get () &&
 				(!parent || parent->GetEntryType () == ICLEntry::EntryType::MUC) &&
 				(msg->GetMessageType () != IMessage::Type::MUCMessage &&
 					msg->GetMessageType () != IMessage::Type::ServiceMessage))
@@ -1897,11 +2170,27 @@ namespace Azoth
 				return;
 		}
 
-		QWebFrame *frame = Ui_.View_->page ()->mainFrame ();
+		PrepareDaySeparator (msg, isActiveChat, batch);
 
-		const bool isActiveChat = Core::Instance ()
-				.GetChatTabsManager ()->IsActiveChat (GetEntry<ICLEntry> ());
+		LastDateTime_ = msg->GetDateTime ();
+
+		ChatMsgAppendInfo info
+		{
+			Core::Instance ().IsHighlightMessage (msg),
+			isActiveChat,
+			ToggleRichText_->isChecked ()
+		};
+
+		const auto& links = FormatterProxyObject {}.FindLinks (msg->GetBody ());
+		if (!links.isEmpty ())
+			LastLink_ = links.last ();
 
+		batch.append ({ msg->GetQObject (), info });
+	}
+
+	void ChatTab::PrepareDaySeparator (IMessage *msg, bool isActiveChat, ChatMsgAppendList_t& batch)
+	{
+		const auto parent = qobject_cast<ICLEntry*> (msg->ParentCLEntry ());
 		if (!LastDateTime_.isNull () && !IsSameDay (LastDateTime_, msg) && parent)
 		{
 			auto datetime = msg->GetDateTime ();
@@ -1918,27 +2207,9 @@ namespace Azoth
 				isActiveChat,
 				ToggleRichText_->isChecked ()
 			};
-			Core::Instance ().AppendMessageByTemplate (frame, coreMessage, coreInfo);
+			batch.append ({ coreMessage, coreInfo });
 			CoreMessages_ << coreMessage;
 		}
-
-		LastDateTime_ = msg->GetDateTime ();
-
-		ChatMsgAppendInfo info
-		{
-			Core::Instance ().IsHighlightMessage (msg),
-			isActiveChat,
-			ToggleRichText_->isChecked ()
-		};
-
-		const auto& links = FormatterProxyObject {}.FindLinks (msg->GetBody ());
-		if (!links.isEmpty ())
-			LastLink_ = links.last ();
-
-		if (!Core::Instance ().AppendMessageByTemplate (frame,
-				msg->GetQObject (), info))
-			qWarning () << Q_FUNC_INFO
-					<< "unhandled append message :(";
 	}
 
 	QString ChatTab::ReformatTitle ()
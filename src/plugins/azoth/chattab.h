@@ -39,7 +39,9 @@
 #include <interfaces/idndtab.h>
 #include <interfaces/ihaverecoverabletabs.h>
 #include <interfaces/iwkfontssettable.h>
+#include <xmlsettingsdialog/boundsetting.h>
 #include "interfaces/azoth/azothcommon.h"
+#include "interfaces/azoth/ichatstyleresourcesource.h"
 #include "ui_chattab.h"
 
 class QTextBrowser;
@@ -99,12 +101,20 @@ namespace Azoth
 
 		bool HadHighlight_ = false;
 		int NumUnreadMsgs_ = 0;
-		int ScrollbackPos_ = 0;
 
 		QList<IMessage*> HistoryMessages_;
+		int PagedHistoryCount_ = 0;
 		QDateTime LastDateTime_;
 		QList<CoreMessage*> CoreMessages_;
 
+		int ShownWindows_ = 1;
+		int HiddenMessages_ = 0;
+		int ScrollFromBottom_ = -1;
+
+		QDateTime HistoryPageAnchor_;
+		bool HistoryPageRequested_ = false;
+		bool HistoryExhausted_ = false;
+
 		QIcon TabIcon_;
 		bool IsMUC_ = false;
 		int PreviousTextHeight_ = 0;
@@ -126,6 +136,12 @@ namespace Azoth
 		QImage LastAvatar_;
 
 		Util::DefaultScopeGuard AvatarChangeSubscription_;
+
+		const Util::BoundSetting<bool> ShowStatusChangesEvents_;
+		const Util::BoundSetting<bool> ShowStatusChangesEventsInPrivates_;
+		const Util::BoundSetting<bool> ShowJoinsLeaves_;
+		const Util::BoundSetting<bool> ShowEndConversations_;
+		const Util::BoundSetting<bool> SeparateMUCEventLogWindow_;
 	public:
 		static void SetParentMultiTabs (QObject*);
 		static void SetChatTabClassInfo (const TabClassInfo&);
@@ -201,6 +217,8 @@ namespace Azoth
 		void on_SubjectButton__toggled (bool);
 		void on_SubjChange__released ();
 		void on_View__loadFinished (bool);
+		void handleViewScrolledToTop ();
+		void handleViewScrolledToBottom ();
 		void handleHistoryBack ();
 		void handleRichTextToggled ();
 		void handleQuoteSelection ();
@@ -227,6 +245,7 @@ namespace Azoth
 		void typeTimeout ();
 
 		void handleGotLastMessages (QObject*, const QList<QObject*>&);
+		void handleGotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&);
 
 		void handleSendButtonVisible ();
 		void handleMinLinesHeightChanged ();
@@ -249,7 +268,8 @@ namespace Azoth
 		void InitMsgEdit ();
 		void RegisterSettings ();
 
-		void RequestLogs (int);
+		bool RequestLogs (int);
+		bool RequestLogsBefore (const QDateTime&, int);
 
 		void UpdateTextHeight ();
 		void SetChatPartState (ChatPartState);
@@ -258,6 +278,28 @@ namespace Azoth
 		 */
 		void AppendMessage (IMessage*);
 
+		/** Appends the messages to the message view area in a single
+		 * batch.
+		 */
+		void AppendMessages (const QList<IMessage*>&);
+		void PrepareAppend (IMessage*, bool isActiveChat, ChatMsgAppendList_t&);
+		void PrepareDaySeparator (IMessage*, bool isActiveChat, ChatMsgAppendList_t&);
+
+		/** Shows the previous window of hidden messages above the ones
+		 * already in the view, keeping the scroll position.
+		 */
+		void ShowHiddenWindow ();
+
+		/** Shows the next older window of messages, requesting it from
+		 * the history plugins if everything in memory is already shown.
+		 */
+		void ShowOlderMessages ();
+
+		/** Returns all the messages that may be shown in the view, in
+		 * chronological order.
+		 */
+		QList<IMessage*> GetViewMessages () const;
+
 		/** Updates the tab icon and other usages of state icon from the
 		 * TabIcon_.
 		 */
@@ -29,6 +29,9 @@
 
 #include "chattabwebview.h"
 #include <QContextMenuEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QWebFrame>
 #include <QWebHitTestResult>
 #include <QPointer>
 #include <QMenu>
@@ -68,7 +71,11 @@ namespace Azoth
 	void ChatTabWebView::mouseReleaseEvent (QMouseEvent *e)
 	{
 		if (e->button () != Qt::MiddleButton)
-			return QWebView::mouseReleaseEvent (e);
+		{
+			QWebView::mouseReleaseEvent (e);
+			CheckScrolledToEdge ();
+			return;
+		}
 
 		const auto r = page ()->mainFrame ()->hitTestContent (e->pos ());
 		if (r.linkUrl ().isEmpty ())
@@ -77,6 +84,18 @@ namespace Azoth
 		emit linkClicked (r.linkUrl (), false);
 	}
 
+	void ChatTabWebView::wheelEvent (QWheelEvent *e)
+	{
+		QWebView::wheelEvent (e);
+		CheckScrolledToEdge ();
+	}
+
+	void ChatTabWebView::keyPressEvent (QKeyEvent *e)
+	{
+		QWebView::keyPressEvent (e);
+		CheckScrolledToEdge ();
+	}
+
 	void ChatTabWebView::contextMenuEvent (QContextMenuEvent *e)
 	{
 		QPointer<QMenu> menu (new QMenu (this));
@@ -126,6 +145,16 @@ namespace Azoth
 		menu->exec (mapToGlobal (e->pos ()));
 	}
 
+	void ChatTabWebView::CheckScrolledToEdge ()
+	{
+		const auto frame = page ()->mainFrame ();
+		const auto value = frame->scrollBarValue (Qt::Vertical);
+		if (value == frame->scrollBarMinimum (Qt::Vertical))
+			emit scrolledToTop ();
+		else if (value == frame->scrollBarMaximum (Qt::Vertical))
+			emit scrolledToBottom ();
+	}
+
 	void ChatTabWebView::HandleNick (QMenu *menu, const QUrl& nickUrl)
 	{
 #if QT_VERSION < 0x050000
@@ -46,8 +46,11 @@ namespace Azoth
 		void SetQuoteAction (QAction*);
 	protected:
 		void mouseReleaseEvent (QMouseEvent*);
+		void wheelEvent (QWheelEvent*);
+		void keyPressEvent (QKeyEvent*);
 		void contextMenuEvent (QContextMenuEvent*);
 	private:
+		void CheckScrolledToEdge ();
 		void HandleNick (QMenu*, const QUrl&);
 		void HandleURL (QMenu*, const QUrl&);
 		void HandleDataFilters (QMenu*, const QString&);
@@ -61,6 +64,9 @@ namespace Azoth
 	signals:
 		void linkClicked (const QUrl&, bool);
 		void chatWindowSearchRequested (const QString&);
+
+		void scrolledToTop ();
+		void scrolledToBottom ();
 	};
 }
 }
@@ -224,6 +224,9 @@ namespace Azoth
 	, UnreadQueueManager_ (new UnreadQueueManager)
 	, CustomChatStyleManager_ (new CustomChatStyleManager)
 	, HistorySyncer_ (std::make_shared<HistorySyncer> ())
+	, HighlightNicksInBody_ (XmlSettingsManager::Instance ().Bind<bool> ("HighlightNicksInBody"))
+	, SmileIcons_ (XmlSettingsManager::Instance ().Bind<QString> ("SmileIcons"))
+	, RequireSpaceBeforeSmiles_ (XmlSettingsManager::Instance ().Bind<bool> ("RequireSpaceBeforeSmiles"))
 	{
 		FillANFields ();
 
@@ -796,6 +799,42 @@ namespace Azoth
 		return src->AppendMessage (frame, message, info);
 	}
 
+	bool Core::AppendMessagesByTemplate (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		if (messages.isEmpty ())
+			return true;
+
+		const auto msg = qobject_cast<IMessage*> (messages.first ().first);
+		IChatStyleResourceSource *src = GetCurrentChatStyle (msg->ParentCLEntry ());
+		if (!src)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "empty result for"
+					<< messages.first ().first;
+			return false;
+		}
+
+		return src->AppendMessages (frame, messages);
+	}
+
+	bool Core::PrependMessagesByTemplate (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		if (messages.isEmpty ())
+			return true;
+
+		const auto msg = qobject_cast<IMessage*> (messages.first ().first);
+		IChatStyleResourceSource *src = GetCurrentChatStyle (msg->ParentCLEntry ());
+		if (!src)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "empty result for"
+					<< messages.first ().first;
+			return false;
+		}
+
+		return src->PrependMessages (frame, messages);
+	}
+
 	void Core::FrameFocused (QObject *entry, QWebFrame *frame)
 	{
 		IChatStyleResourceSource *src = GetCurrentChatStyle (entry);
@@ -950,7 +989,7 @@ namespace Azoth
 		body = HandleSmiles (body);
 
 		if (msg->GetMessageType () == IMessage::Type::MUCMessage &&
-				XmlSettingsManager::Instance ().property ("HighlightNicksInBody").toBool ())
+				HighlightNicksInBody_.Get ())
 			HighlightNicks (body, msg, colors);
 
 		proxy.reset (new Util::DefaultHookProxy);
@@ -965,8 +1004,7 @@ namespace Azoth
 
 	QString Core::HandleSmiles (QString body)
 	{
-		const QString& pack = XmlSettingsManager::Instance ()
-				.property ("SmileIcons").toString ();
+		const auto& pack = SmileIcons_.Get ();
 
 		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
 		emit hookGonnaHandleSmiles (proxy, body, pack);
@@ -983,8 +1021,7 @@ namespace Azoth
 		if (!src)
 			return body;
 
-		const bool requireSpace = XmlSettingsManager::Instance ()
-				.property ("RequireSpaceBeforeSmiles").toBool ();
+		const bool requireSpace = RequireSpaceBeforeSmiles_.Get ();
 
 		const QString& img = QString ("<img src=\"%2\" title=\"%1\" />");
 		QMap<int, QString> pos2smile;
@@ -38,6 +38,7 @@
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/an/ianemitter.h>
 #include <interfaces/iinfo.h>
+#include <xmlsettingsdialog/boundsetting.h>
 #include "interfaces/azoth/iclentry.h"
 #include "interfaces/azoth/azothcommon.h"
 #include "interfaces/azoth/imucentry.h"
@@ -139,6 +140,10 @@ namespace Azoth
 		std::shared_ptr<NotificationsManager> NotificationsManager_;
 		std::shared_ptr<HistorySyncer> HistorySyncer_;
 
+		const Util::BoundSetting<bool> HighlightNicksInBody_;
+		const Util::BoundSetting<QString> SmileIcons_;
+		const Util::BoundSetting<bool> RequireSpaceBeforeSmiles_;
+
 		Core ();
 	public:
 		enum CLRoles
@@ -260,6 +265,8 @@ namespace Azoth
 		QUrl GetSelectedChatTemplateURL (QObject*) const;
 
 		bool AppendMessageByTemplate (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
+		bool AppendMessagesByTemplate (QWebFrame*, const ChatMsgAppendList_t&);
+		bool PrependMessagesByTemplate (QWebFrame*, const ChatMsgAppendList_t&);
 
 		void FrameFocused (QObject*, QWebFrame*);
 
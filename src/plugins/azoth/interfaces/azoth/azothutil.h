@@ -29,10 +29,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <QList>
 #include <QDateTime>
+#include <QVariant>
 #include <QtDebug>
 #include <interfaces/azoth/imessage.h>
+#include <interfaces/azoth/iproxyobject.h>
 
 namespace LeechCraft
 {
@@ -104,6 +107,98 @@ namespace AzothUtil
 				break;
 		}
 	}
+
+	/** @brief Removes the oldest messages beyond the given limit.
+	 *
+	 * This function erases the oldest messages from the \em messages
+	 * list so that no more than \em maxCount messages are left. The
+	 * last message in the list is never erased, even if \em maxCount is
+	 * zero, since it's usually the one just added and yet to be
+	 * announced via ICLEntry::gotMessage(). A non-positive \em maxCount
+	 * means there is no limit.
+	 *
+	 * The erased messages are also removed from the \em unread list, if
+	 * it's given.
+	 *
+	 * The messages are only removed from the lists, not deleted, and
+	 * the caller takes the ownership of them.
+	 *
+	 * @param[inout] messages The list of messages to trim, sorted
+	 * according to the message timestamp in ascending order.
+	 * @param[in] maxCount The maximum number of messages to keep.
+	 * @param[inout] unread The list of unread messages, which is a
+	 * subset of \em messages, or nullptr.
+	 * @return The removed messages.
+	 *
+	 * @sa StandardTrimMessages()
+	 */
+	template<typename T>
+	QList<T*> TrimMessages (QList<T*>& messages, int maxCount, QList<T*> *unread = nullptr)
+	{
+		if (maxCount <= 0)
+			return {};
+
+		const auto excess = std::min (messages.size () - maxCount, messages.size () - 1);
+		if (excess <= 0)
+			return {};
+
+		const auto& removed = messages.mid (0, excess);
+		messages.erase (messages.begin (), messages.begin () + excess);
+
+		if (unread)
+			for (const auto msg : removed)
+				unread->removeOne (msg);
+
+		return removed;
+	}
+
+	/** @brief Standard function to bound the number of kept messages.
+	 *
+	 * This function is a standard implementation of the in-memory
+	 * messages retention policy, to be called by ICLEntry
+	 * implementations each time a message is added to their list of
+	 * messages. It deletes the oldest messages from the \em messages
+	 * list so that no more than the number of messages configured by
+	 * the user in Azoth settings are kept, and the just added message is
+	 * always kept. Older messages are still available via the history
+	 * plugins.
+	 *
+	 * Unread messages are erased as well: Azoth only keeps the first
+	 * unread message and its timestamp for each entry, so the erased
+	 * messages are still known to be unread, and the chat tab pages them
+	 * in from the history.
+	 *
+	 * The list of \em messages is assumed to be sorted according to the
+	 * message timestamp in ascending order.
+	 *
+	 * @param[inout] messages The list of messages to trim.
+	 * @param[in] proxy The Azoth proxy object passed to the plugin.
+	 * @param[inout] unread The entry's own list of unread messages, if
+	 * any, to remove the erased messages from.
+	 * @tparam T The type of the message object, which should be
+	 * implementing the IMessage interface.
+	 *
+	 * @sa TrimMessages(), StandardPurgeMessages()
+	 */
+	template<typename T>
+	void StandardTrimMessages (QList<T*>& messages, IProxyObject *proxy,
+			QList<T*> *unread = nullptr)
+	{
+		const auto maxCount = proxy->GetSettingsManager ()->
+				property ("MaxRetainedMessages").toInt ();
+
+		for (const auto msgObj : TrimMessages (messages, maxCount, unread))
+		{
+			if (detail::GetIMessage (msgObj))
+				delete msgObj;
+			else
+				qWarning () << Q_FUNC_INFO
+						<< "unable to cast"
+						<< msgObj
+						<< "to IMessage; just blindly removing it and hoping for the best";
+		}
+	}
+}
 }
 }
 }
@@ -29,9 +29,12 @@
 
 #ifndef PLUGINS_AZOTH_INTERFACES_ICHATSTYLERESOURCESOURCE_H
 #define PLUGINS_AZOTH_INTERFACES_ICHATSTYLERESOURCESOURCE_H
+#include <QList>
+#include <QPair>
 #include "iresourceplugin.h"
 
 class QUrl;
+class QObject;
 
 namespace LeechCraft
 {
@@ -56,6 +59,12 @@ namespace Azoth
 		bool UseRichTextBody_;
 	};
 
+	/** @brief A list of messages along with their additional parameters.
+	 *
+	 * @sa IChatStyleResourceSource::AppendMessages()
+	 */
+	typedef QList<QPair<QObject*, ChatMsgAppendInfo>> ChatMsgAppendList_t;
+
 	/** @brief Interface for chat style resource loaders and handlers.
 	 *
 	 * This interface should be implemented by resource sources that are
@@ -130,6 +139,66 @@ namespace Azoth
 		virtual bool AppendMessage (QWebFrame *frame, QObject *message,
 				const ChatMsgAppendInfo& info) = 0;
 
+		/** @brief Appends a batch of messages to the chat view.
+		 *
+		 * This function is called whenever several messages should be
+		 * appended to the chat view at once, for example, when the chat
+		 * view is (re)loaded. The messages should be appended in the
+		 * order they are listed in.
+		 *
+		 * Styles are encouraged to reimplement this function to update
+		 * the document once for the whole batch instead of doing it
+		 * for each message.
+		 *
+		 * The default implementation simply calls AppendMessage() for
+		 * each message.
+		 *
+		 * @param[in] frame The chat view frame.
+		 * @param[in] messages The messages to be appended along with
+		 * their additional info structures.
+		 * @return true if all messages have been appended successfully,
+		 * false otherwise.
+		 *
+		 * @sa AppendMessage()
+		 */
+		virtual bool AppendMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+		{
+			bool result = true;
+			for (const auto& pair : messages)
+				result = AppendMessage (frame, pair.first, pair.second) && result;
+			return result;
+		}
+
+		/** @brief Prepends a batch of older messages to the chat view.
+		 *
+		 * This function is called when the chat view is scrolled to the
+		 * top and older messages are to be shown above the ones already
+		 * in the view. The messages are listed in chronological order,
+		 * so the last one should end up right above the message that
+		 * was first in the view before the call.
+		 *
+		 * Prepending shouldn't affect the state used to append further
+		 * messages, like the last message sender.
+		 *
+		 * The default implementation does nothing and returns false,
+		 * in which case the chat view is reloaded with the older
+		 * messages instead.
+		 *
+		 * @param[in] frame The chat view frame.
+		 * @param[in] messages The messages to be prepended along with
+		 * their additional info structures.
+		 * @return true if the messages have been prepended, false if
+		 * the view hasn't been modified.
+		 *
+		 * @sa AppendMessages()
+		 */
+		virtual bool PrependMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+		{
+			Q_UNUSED (frame)
+			Q_UNUSED (messages)
+			return false;
+		}
+
 		/** @brief Notifies about a frame obtaining user input focus.
 		 *
 		 * This function is called whenever a given frame receives user
@@ -160,6 +229,6 @@ namespace Azoth
 }
 
 Q_DECLARE_INTERFACE (LeechCraft::Azoth::IChatStyleResourceSource,
-		"org.Deviant.LeechCraft.Azoth.IChatStyleResourceSource/1.0")
+		"org.Deviant.LeechCraft.Azoth.IChatStyleResourceSource/2.0")
 
 #endif
@@ -119,6 +119,26 @@ namespace Azoth
 		 */
 		virtual void RequestLastMessages (QObject *entry, int num) = 0;
 
+		/** @brief Requests a page of messages preceding the given date.
+		 *
+		 * This method requests up to num messages from the chat log with
+		 * the entry that were sent before the given date, which is
+		 * typically the date of the oldest message already shown. This
+		 * allows fetching older history page by page without requesting
+		 * the already retrieved messages again.
+		 *
+		 * This method is asynchronous, and the result is expected to be
+		 * emitted via the gotMessagesBefore() signal.
+		 *
+		 * @param[in] entry The entry for which to query the history
+		 * (implements ICLEntry).
+		 * @param[in] before The date the messages should precede.
+		 * @param[in] num The maximum number of messages to retrieve.
+		 *
+		 * @sa gotMessagesBefore()
+		 */
+		virtual void RequestMessagesBefore (QObject *entry, const QDateTime& before, int num) = 0;
+
 		using MaxTimestampResult_t = Util::Either<QString, QDateTime>;
 
 		virtual QFuture<MaxTimestampResult_t> RequestMaxTimestamp (IAccount *acc) = 0;
@@ -153,9 +173,27 @@ namespace Azoth
 		 * @sa RequestLastMessages()
 		 */
 		virtual void gotLastMessages (QObject *entry, const QList<QObject*>& messages) = 0;
+
+		/** @brief Notifies about a page of messages preceding a date.
+		 *
+		 * This signal should be emitted as the result of the call to
+		 * RequestMessagesBefore(), with the messages ordered from the
+		 * oldest to the newest. An empty list means there are no older
+		 * messages.
+		 *
+		 * @note This function is expected to be a signal.
+		 *
+		 * @param[out] entry The entry passed to RequestMessagesBefore().
+		 * @param[out] before The date passed to RequestMessagesBefore().
+		 * @param[out] messages The retrieved messages.
+		 *
+		 * @sa RequestMessagesBefore()
+		 */
+		virtual void gotMessagesBefore (QObject *entry,
+				const QDateTime& before, const QList<QObject*>& messages) = 0;
 	};
 }
 }
 
 Q_DECLARE_INTERFACE (LeechCraft::Azoth::IHistoryPlugin,
-		"org.Deviant.LeechCraft.Azoth.IHistoryPlugin/1.0")
+		"org.Deviant.LeechCraft.Azoth.IHistoryPlugin/2.0")
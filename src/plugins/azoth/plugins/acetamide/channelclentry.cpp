@@ -318,6 +318,7 @@ namespace Acetamide
 	void ChannelCLEntry::HandleMessage (ChannelPublicMessage *msg)
 	{
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_, Core::Instance ().GetPluginProxy ());
 		emit gotMessage (msg);
 	}
 
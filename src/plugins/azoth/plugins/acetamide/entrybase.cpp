@@ -129,6 +129,7 @@ namespace Acetamide
 		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_, proxy);
 		emit gotMessage (msg);
 	}
 
@@ -29,7 +29,9 @@
 
 #include "serverparticipantentry.h"
 #include <QAction>
+#include <interfaces/azoth/azothutil.h>
 #include "clientconnection.h"
+#include "core.h"
 #include "ircaccount.h"
 #include "ircserverclentry.h"
 #include "ircmessage.h"
@@ -94,6 +96,7 @@ namespace Acetamide
 	{
 		for (const auto message : messages)
 			AllMessages_ << qobject_cast<IMessage*> (message);
+		AzothUtil::StandardTrimMessages (AllMessages_, Core::Instance ().GetPluginProxy ());
 	}
 
 };
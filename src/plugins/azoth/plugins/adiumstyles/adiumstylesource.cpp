@@ -273,6 +273,107 @@ namespace AdiumStyles
 
 	bool AdiumStyleSource::AppendMessage (QWebFrame *frame,
 			QObject *msgObj, const ChatMsgAppendInfo& info)
+	{
+		return AppendMessages (frame, { { msgObj, info } });
+	}
+
+	bool AdiumStyleSource::AppendMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		bool result = true;
+
+		QString commands;
+		QList<QPair<QString, QString>> stateUpdates;
+		for (const auto& pair : messages)
+		{
+			const auto& command = MakeAppendCommand (frame, pair.first, pair.second, stateUpdates);
+			if (command.isEmpty ())
+				result = false;
+			commands += command;
+		}
+
+		if (!commands.isEmpty ())
+			frame->evaluateJavaScript (commands);
+
+		for (const auto& update : stateUpdates)
+		{
+			QWebElement elem = frame->findFirstElement (update.first);
+			elem.setInnerXml (update.second);
+		}
+
+		return result;
+	}
+
+	bool AdiumStyleSource::PrependMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		QString bodies;
+		QList<QPair<QString, QString>> stateUpdates;
+		for (const auto& pair : messages)
+		{
+			const auto& body = MakeMessageBody (frame, pair.first, pair.second,
+					Placement::Prepend, stateUpdates);
+			if (body.isEmpty ())
+				return false;
+			bodies += body;
+		}
+
+		if (bodies.isEmpty ())
+			return true;
+
+		frame->evaluateJavaScript (QString ("document.getElementById(\"Chat\")"
+					".insertAdjacentHTML(\"afterbegin\", \"%1\");")
+				.arg (bodies));
+
+		for (const auto& update : stateUpdates)
+		{
+			QWebElement elem = frame->findFirstElement (update.first);
+			elem.setInnerXml (update.second);
+		}
+
+		return true;
+	}
+
+	QString AdiumStyleSource::MakeAppendCommand (QWebFrame *frame, QObject *msgObj,
+			const ChatMsgAppendInfo& info, QList<QPair<QString, QString>>& stateUpdates)
+	{
+		IMessage *msg = qobject_cast<IMessage*> (msgObj);
+		if (!msg)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< msgObj
+					<< "doesn't implement IMessage";
+			return {};
+		}
+
+		const bool in = GetMsgDirection (msg) == IMessage::Direction::In;
+
+		QObject *kindaSender = in ? msg->OtherPart () : reinterpret_cast<QObject*> (42);
+
+		const bool isSlashMe = msg->GetBody ().trimmed ().startsWith ("/me ");
+		const bool alwaysNotNext = isSlashMe ||
+				!(msg->GetMessageType () == IMessage::Type::ChatMessage || msg->GetMessageType () == IMessage::Type::MUCMessage);
+		const bool isNextMsg = !alwaysNotNext &&
+				Frame2LastContact_.contains (frame) &&
+				kindaSender == Frame2LastContact_ [frame];
+
+		if (msg->GetMessageType () != IMessage::Type::MUCMessage &&
+				msg->GetMessageType () != IMessage::Type::ChatMessage)
+			Frame2LastContact_.remove (frame);
+		else if (!isNextMsg && !alwaysNotNext)
+			Frame2LastContact_ [frame] = kindaSender;
+		else if (alwaysNotNext)
+			Frame2LastContact_.remove (frame);
+
+		const auto& body = MakeMessageBody (frame, msgObj, info,
+				isNextMsg ? Placement::AppendNext : Placement::Append, stateUpdates);
+		if (body.isEmpty ())
+			return {};
+
+		const QString& command = isNextMsg ? "appendNextMessage(\"%1\");" : "appendMessage(\"%1\");";
+		return command.arg (body);
+	}
+
+	QString AdiumStyleSource::MakeMessageBody (QWebFrame *frame, QObject *msgObj,
+			const ChatMsgAppendInfo& info, Placement placement, QList<QPair<QString, QString>>& stateUpdates)
 	{
 		IMessage *msg = qobject_cast<IMessage*> (msgObj);
 		if (!msg)
@@ -280,7 +381,7 @@ namespace AdiumStyles
 			qWarning () << Q_FUNC_INFO
 					<< msgObj
 					<< "doesn't implement IMessage";
-			return false;
+			return {};
 		}
 
 		const QString& pack = Frame2Pack_ [frame];
@@ -290,7 +391,7 @@ namespace AdiumStyles
 					<< "empty pack for"
 					<< msgObj
 					<< msg->OtherPart ();
-			return false;
+			return {};
 		}
 
 		connect (msgObj,
@@ -299,15 +400,8 @@ namespace AdiumStyles
 				SLOT (handleMessageDestroyed ()));
 
 		const bool in = GetMsgDirection (msg) == IMessage::Direction::In;
-
-		QObject *kindaSender = in ? msg->OtherPart () : reinterpret_cast<QObject*> (42);
-
 		const bool isSlashMe = msg->GetBody ().trimmed ().startsWith ("/me ");
-		const bool alwaysNotNext = isSlashMe ||
-				!(msg->GetMessageType () == IMessage::Type::ChatMessage || msg->GetMessageType () == IMessage::Type::MUCMessage);
-		const bool isNextMsg = !alwaysNotNext &&
-				Frame2LastContact_.contains (frame) &&
-				kindaSender == Frame2LastContact_ [frame];
+		const bool isNextMsg = placement == Placement::AppendNext;
 
 		const QString& root = pack + "/Contents/Resources/";
 		const QString& prefix = root +
@@ -324,14 +418,6 @@ namespace AdiumStyles
 		else
 			filename = "Action.html";
 
-		if (msg->GetMessageType () != IMessage::Type::MUCMessage &&
-				msg->GetMessageType () != IMessage::Type::ChatMessage)
-			Frame2LastContact_.remove (frame);
-		else if (!isNextMsg && !alwaysNotNext)
-			Frame2LastContact_ [frame] = kindaSender;
-		else if (alwaysNotNext)
-			Frame2LastContact_.remove (frame);
-
 		QStringList templCands;
 		templCands << (prefix + filename);
 		if (filename == "Action.html")
@@ -352,7 +438,7 @@ namespace AdiumStyles
 					<< "unable to load content template for"
 					<< pack
 					<< prefix;
-			return false;
+			return {};
 		}
 
 		if (!content->open (QIODevice::ReadOnly))
@@ -362,11 +448,19 @@ namespace AdiumStyles
 					<< pack
 					<< prefix
 					<< content->errorString ();
-			return false;
+			return {};
 		}
 
 		QString templ = QString::fromUtf8 (content->readAll ());
 		FixSelfClosing (templ);
+
+		/* appendNextMessage() puts the message in place of the first
+		 * insertion point in the document, so the prepended messages
+		 * shouldn't bring their own ones.
+		 */
+		if (placement == Placement::Prepend)
+			templ.remove (QRegExp ("<div\\s+id=\"insert\"\\s*>\\s*</div>"));
+
 		QString bodyS = ParseMsgTemplate (templ, prefix, frame, msgObj, info);
 		QString body;
 		body.reserve (bodyS.size () * 1.2);
@@ -395,9 +489,6 @@ namespace AdiumStyles
 			}
 		}
 
-		const QString& command = isNextMsg ? "appendNextMessage(\"%1\");" : "appendMessage(\"%1\");";
-		frame->evaluateJavaScript (command.arg (body));
-
 		if (templ.contains ("%stateElementId%"))
 		{
 			const auto advMsg = qobject_cast<IAdvancedMessage*> (msgObj);
@@ -422,11 +513,10 @@ namespace AdiumStyles
 
 			const QString& selector = QString ("*[id=\"delivery_state_%1\"]")
 					.arg (GetMessageID (msgObj));
-			QWebElement elem = frame->findFirstElement (selector);
-			elem.setInnerXml (replacement);
+			stateUpdates.append ({ selector, replacement });
 		}
 
-		return true;
+		return body;
 	}
 
 	void AdiumStyleSource::FrameFocused (QWebFrame*)
@@ -81,6 +81,8 @@ namespace AdiumStyles
 		QString GetHTMLTemplate (const QString&,
 				const QString&, QObject*, QWebFrame*) const;
 		bool AppendMessage (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
+		bool AppendMessages (QWebFrame*, const ChatMsgAppendList_t&);
+		bool PrependMessages (QWebFrame*, const ChatMsgAppendList_t&);
 		void FrameFocused (QWebFrame*);
 		QStringList GetVariantsForPack (const QString&);
 	private:
@@ -90,6 +92,21 @@ namespace AdiumStyles
 		QString ParseMsgTemplate (QString templ, const QString& path,
 				QWebFrame*, QObject*, const ChatMsgAppendInfo&);
 		QString GetMessageID (QObject*);
+		QString MakeAppendCommand (QWebFrame*, QObject*,
+				const ChatMsgAppendInfo&, QList<QPair<QString, QString>>&);
+
+		enum class Placement
+		{
+			Append,
+			AppendNext,
+			Prepend
+		};
+
+		/** Returns the message HTML escaped for a JS string literal, or
+		 * an empty string on error.
+		 */
+		QString MakeMessageBody (QWebFrame*, QObject*, const ChatMsgAppendInfo&,
+				Placement, QList<QPair<QString, QString>>&);
 	private slots:
 		void handleMessageDelivered ();
 		void handleMessageDestroyed ();
@@ -37,6 +37,7 @@
 #include <util/util.h>
 #include <interfaces/azoth/iprotocol.h>
 #include <interfaces/azoth/iaccount.h>
+#include <interfaces/azoth/iproxyobject.h>
 #include "cmwrapper.h"
 #include "accountwrapper.h"
 #include "protowrapper.h"
@@ -117,6 +118,7 @@ namespace Astrality
 
 	void Plugin::initPlugin (QObject *proxy)
 	{
+		AzothProxy_ = qobject_cast<IProxyObject*> (proxy);
 	}
 
 	void Plugin::handleListNames (Tp::PendingOperation *op)
@@ -126,7 +128,7 @@ namespace Astrality
 
 		Q_FOREACH (const QString& cmName, psl->result ())
 		{
-			auto cmw = new CMWrapper (cmName, Proxy_, this);
+			auto cmw = new CMWrapper (cmName, Proxy_, AzothProxy_, this);
 			Wrappers_ << cmw;
 
 			connect (cmw,
@@ -42,6 +42,8 @@ namespace LeechCraft
 {
 namespace Azoth
 {
+class IProxyObject;
+
 namespace Astrality
 {
 	class CMWrapper;
@@ -55,6 +57,7 @@ namespace Astrality
 		Q_INTERFACES (IInfo IPlugin2 LeechCraft::Azoth::IProtocolPlugin);
 
 		ICoreProxy_ptr Proxy_;
+		IProxyObject *AzothProxy_ = nullptr;
 		QList<CMWrapper*> Wrappers_;
 	public:
 		void Init (ICoreProxy_ptr);
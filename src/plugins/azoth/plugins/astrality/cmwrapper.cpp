@@ -39,10 +39,12 @@ namespace Azoth
 {
 namespace Astrality
 {
-	CMWrapper::CMWrapper (const QString& cmName, const ICoreProxy_ptr& proxy, QObject *parent)
+	CMWrapper::CMWrapper (const QString& cmName, const ICoreProxy_ptr& proxy,
+			IProxyObject *azothProxy, QObject *parent)
 	: QObject (parent)
 	, CM_ (Tp::ConnectionManager::create (cmName))
 	, Proxy_ (proxy)
+	, AzothProxy_ (azothProxy)
 	{
 		connect (CM_->becomeReady (),
 				SIGNAL (finished (Tp::PendingOperation*)),
@@ -77,7 +79,7 @@ namespace Astrality
 			if (proto == "jabber" || proto == "irc")
 				continue;
 
-			auto pw = new ProtoWrapper (CM_, proto, Proxy_, this);
+			auto pw = new ProtoWrapper (CM_, proto, Proxy_, AzothProxy_, this);
 			ProtoWrappers_ << pw;
 			newProtoWrappers << pw;
 		}
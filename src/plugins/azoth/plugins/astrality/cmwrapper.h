@@ -38,6 +38,8 @@ namespace LeechCraft
 {
 namespace Azoth
 {
+class IProxyObject;
+
 namespace Astrality
 {
 	class ProtoWrapper;
@@ -50,8 +52,9 @@ namespace Astrality
 		QList<ProtoWrapper*> ProtoWrappers_;
 
 		const ICoreProxy_ptr Proxy_;
+		IProxyObject * const AzothProxy_;
 	public:
-		CMWrapper (const QString&, const ICoreProxy_ptr&, QObject* = 0);
+		CMWrapper (const QString&, const ICoreProxy_ptr&, IProxyObject*, QObject* = 0);
 
 		QList<QObject*> GetProtocols () const;
 	private slots:
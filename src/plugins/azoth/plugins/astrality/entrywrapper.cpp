@@ -35,6 +35,7 @@
 #include "accountwrapper.h"
 #include "astralityutil.h"
 #include "msgwrapper.h"
+#include "protowrapper.h"
 #include "vcarddialog.h"
 
 namespace LeechCraft
@@ -85,6 +86,9 @@ namespace Astrality
 	void EntryWrapper::HandleMessage (MsgWrapper *msg)
 	{
 		AllMessages_ << msg;
+
+		const auto proto = qobject_cast<ProtoWrapper*> (AW_->GetParentProtocol ());
+		AzothUtil::StandardTrimMessages (AllMessages_, proto->GetAzothProxy ());
 		emit gotMessage (msg);
 	}
 
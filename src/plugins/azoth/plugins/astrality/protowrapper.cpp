@@ -44,11 +44,13 @@ namespace Azoth
 namespace Astrality
 {
 	ProtoWrapper::ProtoWrapper (Tp::ConnectionManagerPtr cm,
-			const QString& protoName, const ICoreProxy_ptr& proxy, QObject *parent)
+			const QString& protoName, const ICoreProxy_ptr& proxy,
+			IProxyObject *azothProxy, QObject *parent)
 	: QObject (parent)
 	, CM_ (cm)
 	, ProtoName_ (protoName)
 	, Proxy_ (proxy)
+	, AzothProxy_ (azothProxy)
 	, ProtoInfo_ (CM_->protocol (ProtoName_))
 	{
 		const auto& sb = QDBusConnection::sessionBus ();
@@ -93,6 +95,11 @@ namespace Astrality
 		}
 	}
 
+	IProxyObject* ProtoWrapper::GetAzothProxy () const
+	{
+		return AzothProxy_;
+	}
+
 	QVariantMap ProtoWrapper::GetParamsFromWidgets (const QList<QWidget*>& widgets) const
 	{
 		QVariantMap params;
@@ -42,6 +42,8 @@ namespace LeechCraft
 {
 namespace Azoth
 {
+class IProxyObject;
+
 namespace Astrality
 {
 	class AccountWrapper;
@@ -55,6 +57,7 @@ namespace Astrality
 		Tp::ConnectionManagerPtr CM_;
 		const QString ProtoName_;
 		const ICoreProxy_ptr Proxy_;
+		IProxyObject * const AzothProxy_;
 		const Tp::ProtocolInfo ProtoInfo_;
 
 		Tp::AccountManagerPtr AM_;
@@ -62,10 +65,13 @@ namespace Astrality
 		QList<AccountWrapper*> Accounts_;
 		QMap<Tp::PendingAccount*, AccountWrapper::Settings> PendingSettings_;
 	public:
-		ProtoWrapper (Tp::ConnectionManagerPtr, const QString&, const ICoreProxy_ptr&, QObject*);
+		ProtoWrapper (Tp::ConnectionManagerPtr, const QString&,
+				const ICoreProxy_ptr&, IProxyObject*, QObject*);
 
 		void Release ();
 
+		IProxyObject* GetAzothProxy () const;
+
 		QVariantMap GetParamsFromWidgets (const QList<QWidget*>&) const;
 		AccountWrapper::Settings GetSettingsFromWidgets (const QList<QWidget*>&) const;
 
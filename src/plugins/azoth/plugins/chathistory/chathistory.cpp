@@ -172,9 +172,34 @@ namespace ChatHistory
 		const auto account = entry->GetParentAccount ();
 		const QString& accId = account->GetAccountID ();
 		const QString& entryId = entry->GetEntryID ();
-		Util::Sequence (this, StorageMgr_->GetChatLogs (accId, entryId, 0, num)) >>
-				std::bind (&Plugin::HandleGotChatLogs,
-						this, QPointer<QObject> { entryObj }, std::placeholders::_1);
+		Util::Sequence (this, StorageMgr_->GetChatLogs (accId, entryId, 0, PageDirection::Older, num)) >>
+				[this, entryPtr = QPointer<QObject> { entryObj }] (const ChatLogsResult_t& result)
+				{
+					if (const auto& logs = MakeHistoryMessages (entryPtr, result))
+						emit gotLastMessages (entryPtr, *logs);
+				};
+	}
+
+	void Plugin::RequestMessagesBefore (QObject *entryObj, const QDateTime& before, int num)
+	{
+		ICLEntry *entry = qobject_cast<ICLEntry*> (entryObj);
+		if (!entry)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< entryObj
+					<< "doesn't implement ICLEntry";
+			return;
+		}
+
+		const auto account = entry->GetParentAccount ();
+		const QString& accId = account->GetAccountID ();
+		const QString& entryId = entry->GetEntryID ();
+		Util::Sequence (this, StorageMgr_->GetChatLogsBefore (accId, entryId, before, num)) >>
+				[this, before, entryPtr = QPointer<QObject> { entryObj }] (const ChatLogsResult_t& result)
+				{
+					if (const auto& logs = MakeHistoryMessages (entryPtr, result))
+						emit gotMessagesBefore (entryPtr, before, *logs);
+				};
 	}
 
 	QFuture<Plugin::MaxTimestampResult_t> Plugin::RequestMaxTimestamp (IAccount *acc)
@@ -282,7 +307,7 @@ namespace ChatHistory
 		StorageMgr_->Process (message);
 	}
 
-	void Plugin::HandleGotChatLogs (const QPointer<QObject>& entryObj,
+	boost::optional<QList<QObject*>> Plugin::MakeHistoryMessages (const QPointer<QObject>& entryObj,
 			const ChatLogsResult_t& result)
 	{
 		if (!entryObj)
@@ -290,7 +315,7 @@ namespace ChatHistory
 			qWarning () << Q_FUNC_INFO
 					<< entryObj
 					<< "is dead already";
-			return;
+			return {};
 		}
 
 		if (const auto err = result.MaybeLeft ())
@@ -298,7 +323,7 @@ namespace ChatHistory
 			qWarning () << Q_FUNC_INFO
 					<< "unable to request logs:"
 					<< *err;
-			return;
+			return {};
 		}
 
 		auto mucEntry = qobject_cast<IMUCEntry*> (entryObj);
@@ -307,7 +332,7 @@ namespace ChatHistory
 				QObjectList ();
 
 		QList<QObject*> logs;
-		for (const auto& item : result.GetRight ())
+		for (const auto& item : result.GetRight ().Items_)
 		{
 			QObject *participantObj = nullptr;
 			for (auto part : parts)
@@ -329,7 +354,7 @@ namespace ChatHistory
 			logs << msg;
 		}
 
-		emit gotLastMessages (entryObj, logs);
+		return logs;
 	}
 
 	void Plugin::handlePushButton (const QString& name)
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <boost/optional.hpp>
 #include <QObject>
 #include <QAction>
 #include <interfaces/iinfo.h>
@@ -112,12 +113,13 @@ namespace ChatHistory
 		// IHistoryPlugin
 		bool IsHistoryEnabledFor (QObject*) const;
 		void RequestLastMessages (QObject*, int);
+		void RequestMessagesBefore (QObject*, const QDateTime&, int);
 		QFuture<MaxTimestampResult_t> RequestMaxTimestamp (IAccount*);
 		void AddRawMessages (const QString&, const QString&, const QString&, const QList<HistoryItem>&);
 	private:
 		void InitWidget (ChatHistoryWidget*);
 
-		void HandleGotChatLogs (const QPointer<QObject>&, const ChatLogsResult_t&);
+		boost::optional<QList<QObject*>> MakeHistoryMessages (const QPointer<QObject>&, const ChatLogsResult_t&);
 	public slots:
 		void initPlugin (QObject*);
 
@@ -146,6 +148,7 @@ namespace ChatHistory
 		void raiseTab (QWidget*);
 
 		void gotLastMessages (QObject*, const QList<QObject*>&);
+		void gotMessagesBefore (QObject*, const QDateTime&, const QList<QObject*>&);
 
 		void gotActions (QList<QAction*>, LeechCraft::ActionsEmbedPlace);
 
@@ -255,7 +255,7 @@ namespace ChatHistory
 	}
 
 	void ChatHistoryWidget::HandleGotChatLogs (const QString& accountId,
-			const QString& entryId, const ChatLogsResult_t& result)
+			const QString& entryId, qint64 anchor, const ChatLogsResult_t& result)
 	{
 		const auto& selEntry = Ui_.Contacts_->selectionModel ()->
 				currentIndex ().data (MRIDRole).toString ();
@@ -264,9 +264,6 @@ namespace ChatHistory
 				entryId != selEntry)
 			return;
 
-		Amount_ = 0;
-		Ui_.HistView_->clear ();
-
 		auto& formatter = Params_.PluginProxy_->GetFormatterProxy ();
 
 		const auto entry = qobject_cast<ICLEntry*> (Params_.PluginProxy_->GetEntry (entryId, accountId));
@@ -284,6 +281,17 @@ namespace ChatHistory
 			return;
 		}
 
+		const auto& page = result.GetRight ();
+
+		/* Paging past either end of the history keeps the current page.
+		 */
+		if (page.Items_.isEmpty () && anchor > 0)
+			return;
+
+		Ui_.HistView_->clear ();
+		PageFirstRowID_ = page.RowIDs_.value (0);
+		PageLastRowID_ = page.RowIDs_.value (page.RowIDs_.size () - 1);
+
 		const auto& ourName = entry ?
 				entry->GetParentAccount ()->GetOurNick () :
 				QString ();
@@ -297,9 +305,11 @@ namespace ChatHistory
 		const auto& colors = formatter.GenerateColors ("hash", bgColor);
 
 		int scrollPos = -1;
+		QString searchFragment;
 
-		for (const auto& logItem : result.GetRight ())
+		for (int i = 0; i < page.Items_.size (); ++i)
 		{
+			const auto& logItem = page.Items_.at (i);
 			const bool isChat = logItem.Type_ == IMessage::Type::ChatMessage;
 			const bool isIncoming = logItem.Dir_ == IMessage::Direction::In;
 
@@ -352,7 +362,7 @@ namespace ChatHistory
 
 			html += postNick + ' ' + msgText;
 
-			const bool isSearchRes = SearchResultPosition_ == PerPageAmount_ - ++Amount_;
+			const bool isSearchRes = page.RowIDs_.at (i) == HighlightRowID_;
 			if (isChat && !isSearchRes)
 			{
 				const auto& color = formatter.GetNickColor (isIncoming ? remoteName : ourName, colors);
@@ -362,6 +372,11 @@ namespace ChatHistory
 			else if (isSearchRes)
 			{
 				scrollPos = Ui_.HistView_->document ()->characterCount ();
+				if (!SearchResultMatches_.isEmpty ())
+				{
+					const auto& match = SearchResultMatches_.first ();
+					searchFragment = logItem.Message_.mid (match.first, match.second);
+				}
 
 				html.prepend ("<font color='#FF7E00'>");
 				html += "</font>";
@@ -374,6 +389,14 @@ namespace ChatHistory
 		{
 			QTextCursor cur (Ui_.HistView_->document ());
 			cur.setPosition (scrollPos);
+
+			if (!searchFragment.isEmpty ())
+			{
+				const auto& found = Ui_.HistView_->document ()->find (searchFragment, scrollPos);
+				if (!found.isNull ())
+					cur = found;
+			}
+
 			Ui_.HistView_->setTextCursor (cur);
 			Ui_.HistView_->ensureCursorVisible ();
 		}
@@ -394,18 +417,18 @@ namespace ChatHistory
 			return;
 		}
 
-		const auto position = result.GetRight ();
+		const auto hit = result.GetRight ();
 
-		if (!position)
+		if (!hit)
 		{
-			if (!(FindBox_->GetFlags () & ChatFindBox::FindWrapsAround) || !SearchShift_)
+			if (!(FindBox_->GetFlags () & ChatFindBox::FindWrapsAround) || !SearchAnchor_)
 				QMessageBox::warning (this,
 						"LeechCraft",
 						tr ("No more search results for %1.")
 							.arg ("<em>" + PreviousSearchText_ + "</em>"));
 			else
 			{
-				SearchShift_ = 0;
+				SearchAnchor_ = 0;
 
 				const auto& e = Util::MakeNotification ("Azoth ChatHistory",
 						tr ("No more search results for %1, searching from the beginning now.")
@@ -446,9 +469,39 @@ namespace ChatHistory
 				}
 		}
 
-		Backpages_ = *position / PerPageAmount_;
-		SearchResultPosition_ = *position % PerPageAmount_;
-		RequestLogs ();
+		SearchAnchor_ = hit->RowID_;
+		HighlightRowID_ = hit->RowID_;
+		SearchResultMatches_ = hit->Matches_;
+		RequestLogs (hit->RowID_ + 1, PageDirection::Older);
+	}
+
+	void ChatHistoryWidget::HandleGotDatePosition (const QString& accountId,
+			const QString& entryId, const SearchResult_t& result)
+	{
+		if (accountId != CurrentAccount_ ||
+				entryId != CurrentEntry_)
+			return;
+
+		if (const auto err = result.MaybeLeft ())
+		{
+			QMessageBox::critical (this,
+					"LeechCraft",
+					tr ("Unable to perform the search.") + " " + *err);
+			return;
+		}
+
+		SearchResultMatches_.clear ();
+
+		const auto hit = result.GetRight ();
+		if (!hit)
+		{
+			HighlightRowID_ = -1;
+			RequestLogs ();
+			return;
+		}
+
+		HighlightRowID_ = hit->RowID_;
+		RequestLogs (hit->RowID_ - 1, PageDirection::Newer);
 	}
 
 	void ChatHistoryWidget::HandleGotDaysForSheet (const QString& accountId,
@@ -493,10 +546,9 @@ namespace ChatHistory
 		CurrentEntry_ = index.data (MRIDRole).toString ();
 		if (!ContactSelectedAsGlobSearch_)
 		{
-			SearchShift_ = 0;
+			SearchAnchor_ = 0;
 			PreviousSearchText_.clear ();
-			Backpages_ = 0;
-			SearchResultPosition_ = -1;
+			HighlightRowID_ = -1;
 		}
 		ContactSelectedAsGlobSearch_ = false;
 
@@ -523,7 +575,7 @@ namespace ChatHistory
 
 		Util::Sequence (this,
 				Params_.StorageMgr_->Search (CurrentAccount_, CurrentEntry_, QDateTime { date })) >>
-				std::bind (&ChatHistoryWidget::HandleGotSearchPosition,
+				std::bind (&ChatHistoryWidget::HandleGotDatePosition,
 						this, CurrentAccount_, CurrentEntry_, _1);
 	}
 
@@ -534,43 +586,39 @@ namespace ChatHistory
 		if (text.isEmpty ())
 		{
 			PreviousSearchText_.clear ();
-			Backpages_ = 0;
-			SearchResultPosition_ = -1;
+			HighlightRowID_ = -1;
 			RequestLogs ();
 			return;
 		}
 
+		/* A new search always starts from the most recent message.
+		 */
 		if (text != PreviousSearchText_)
 		{
-			SearchShift_ = 0;
+			SearchAnchor_ = 0;
 			PreviousSearchText_ = text;
+			flags &= ~ChatFindBox::FindBackwards;
 		}
-		else if (!(flags & ChatFindBox::FindBackwards))
-			++SearchShift_;
-		else
-			SearchShift_ = std::max (SearchShift_ - 1, 0);
 
 		RequestSearch (flags);
 	}
 
 	void ChatHistoryWidget::previousHistory ()
 	{
-		if (Amount_ < PerPageAmount_)
+		if (PageFirstRowID_ <= 0)
 			return;
 
-		++Backpages_;
-		SearchResultPosition_ = -1;
-		RequestLogs ();
+		HighlightRowID_ = -1;
+		RequestLogs (PageFirstRowID_, PageDirection::Older);
 	}
 
 	void ChatHistoryWidget::nextHistory ()
 	{
-		if (Backpages_ <= 0)
+		if (PageLastRowID_ <= 0)
 			return;
 
-		--Backpages_;
-		SearchResultPosition_ = -1;
-		RequestLogs ();
+		HighlightRowID_ = -1;
+		RequestLogs (PageLastRowID_, PageDirection::Newer);
 	}
 
 	void ChatHistoryWidget::clearHistory ()
@@ -594,7 +642,6 @@ namespace ChatHistory
 			ContactsModel_->removeRow (item->row ());
 		}
 
-		Backpages_ = 0;
 		RequestLogs ();
 	}
 
@@ -650,18 +697,20 @@ namespace ChatHistory
 						this, CurrentAccount_, CurrentEntry_, year, month, _1);
 	}
 
-	void ChatHistoryWidget::RequestLogs ()
+	void ChatHistoryWidget::RequestLogs (qint64 anchor, PageDirection dir)
 	{
 		const auto& future = Params_.StorageMgr_->GetChatLogs (CurrentAccount_,
-				CurrentEntry_, Backpages_, PerPageAmount_);
+				CurrentEntry_, anchor, dir, PerPageAmount_);
 		Util::Sequence (this, future) >>
-				std::bind (&ChatHistoryWidget::HandleGotChatLogs, this, CurrentAccount_, CurrentEntry_, _1);
+				std::bind (&ChatHistoryWidget::HandleGotChatLogs,
+						this, CurrentAccount_, CurrentEntry_, anchor, _1);
 	}
 
 	void ChatHistoryWidget::RequestSearch (ChatFindBox::FindFlags flags)
 	{
 		const auto& future = Params_.StorageMgr_->Search (CurrentAccount_, CurrentEntry_,
-				PreviousSearchText_, SearchShift_,
+				PreviousSearchText_, SearchAnchor_,
+				flags & ChatFindBox::FindBackwards,
 				flags & ChatFindBox::FindCaseSensitively);
 		Util::Sequence (this, future) >>
 				std::bind (&ChatHistoryWidget::HandleGotSearchPosition,
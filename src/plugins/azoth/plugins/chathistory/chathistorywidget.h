@@ -77,10 +77,11 @@ namespace ChatHistory
 
 		QStandardItemModel *ContactsModel_;
 		QSortFilterProxyModel *SortFilter_;
-		int Backpages_ = 0;
-		int Amount_ = 0;
-		int SearchShift_ = 0;
-		int SearchResultPosition_ = -1;
+		qint64 PageFirstRowID_ = 0;
+		qint64 PageLastRowID_ = 0;
+		qint64 SearchAnchor_ = 0;
+		qint64 HighlightRowID_ = -1;
+		QList<QPair<int, int>> SearchResultMatches_;
 		bool ContactSelectedAsGlobSearch_ = false;
 		QString CurrentAccount_;
 		QString CurrentEntry_;
@@ -108,8 +109,9 @@ namespace ChatHistory
 	private:
 		void HandleGotOurAccounts (const QStringList&);
 		void HandleGotUsersForAccount (const QString&, const UsersForAccountResult_t&);
-		void HandleGotChatLogs (const QString&, const QString&, const ChatLogsResult_t&);
+		void HandleGotChatLogs (const QString&, const QString&, qint64, const ChatLogsResult_t&);
 		void HandleGotSearchPosition (const QString&, const QString&, const SearchResult_t&);
+		void HandleGotDatePosition (const QString&, const QString&, const SearchResult_t&);
 		void HandleGotDaysForSheet (const QString&, const QString&, int, int, const DaysResult_t&);
 	private slots:
 		void on_AccountBox__currentIndexChanged (int);
@@ -130,7 +132,7 @@ namespace ChatHistory
 
 		void ShowLoading ();
 		void UpdateDates ();
-		void RequestLogs ();
+		void RequestLogs (qint64 anchor = 0, PageDirection = PageDirection::Older);
 		void RequestSearch (ChatFindBox::FindFlags);
 	signals:
 		void removeSelf (QWidget*);
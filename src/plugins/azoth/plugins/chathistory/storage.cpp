@@ -29,11 +29,13 @@
 
 #include "storage.h"
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <QStringList>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QDir>
+#include <QTimer>
 #include <QtDebug>
 #include <util/db/dblock.h>
 #include <util/db/util.h>
@@ -51,10 +53,12 @@ namespace Azoth
 {
 namespace ChatHistory
 {
-	Storage::RawSearchResult::RawSearchResult (qint32 entryId, qint32 accountId, qint64 rowId)
+	Storage::RawSearchResult::RawSearchResult (qint32 entryId, qint32 accountId, qint64 rowId,
+			const QList<QPair<int, int>>& matches)
 	: EntryID_ { entryId }
 	, AccountID_ { accountId }
 	, RowID_ { rowId }
+	, Matches_ { matches }
 	{
 	}
 
@@ -63,6 +67,83 @@ namespace ChatHistory
 		return RowID_ < 0 || !EntryID_ || !AccountID_;
 	}
 
+	namespace
+	{
+		/* The results are always decided by the same LIKE/GLOB match
+		 * against azoth_history.Message, with or without the full text
+		 * index, so both paths return exactly the same messages. The
+		 * trigram index only preselects the candidate rows: its phrase
+		 * match is case-insensitive for the whole Unicode range while the
+		 * LIKE/GLOB match is case-insensitive for ASCII only (or
+		 * case-sensitive), so it never rejects a row the match would accept.
+		 *
+		 * The rows that are not indexed yet (see BackfillSearchIndex())
+		 * are scanned the old way, so that the results are complete while
+		 * the index is being built.
+		 *
+		 * Ranked searches are ordered by bm25() with the row ID breaking
+		 * the ties, the other ones by the row ID only. Either way the
+		 * results are paged by the key of the previous hit instead of an
+		 * offset, so getting the next one doesn't rescan the preceding ones.
+		 */
+		QString MakeSearchQuery (bool fts, const QStringList& fields, PageDirection dir, bool ranked)
+		{
+			auto makeFilter = [&fields] (const QString& table, const QString& prefix)
+			{
+				QStringList conds { "1" };
+				for (const auto& field : fields)
+					conds << table + field + " = :" + prefix + field.toLower ();
+				return conds.join (" AND ");
+			};
+
+			auto makeMatch = [] (const QString& table, const QString& prefix)
+			{
+				return "((" + table + "Message LIKE :" + prefix + "text AND :" + prefix + "insensitive) "
+						"OR (" + table + "Message GLOB :" + prefix + "ctext AND :" + prefix + "sensitive))";
+			};
+
+			const bool older = dir == PageDirection::Older;
+			const QString cmp = older ? "<" : ">";
+			const QString order = older ? "DESC" : "ASC";
+
+			if (!fts)
+				return "SELECT rowid AS RowId, Id, AccountID, Message FROM azoth_history "
+						"WHERE " + makeFilter ({}, "like_") + " "
+						"AND " + makeMatch ({}, "like_") + " "
+						"AND RowId " + cmp + " :anchor "
+						"ORDER BY RowId " + order + " "
+						"LIMIT 1;";
+
+			QString keyset = "RowId " + cmp + " :anchor";
+			QString ordering = "RowId " + order;
+			if (ranked)
+			{
+				const QString rankCmp = older ? ">" : "<";
+				keyset = "(Rank " + rankCmp + " :rank OR (Rank = :rank AND " + keyset + "))";
+				ordering = "Rank " + QString { older ? "ASC" : "DESC" } + ", " + ordering;
+			}
+
+			return "SELECT RowId, Id, AccountID, Message FROM ("
+					"	SELECT azoth_history.rowid AS RowId, azoth_history.Id AS Id, "
+					"		azoth_history.AccountID AS AccountID, azoth_history.Message AS Message, "
+					"		bm25(azoth_history_fts) AS Rank "
+					"	FROM azoth_history_fts JOIN azoth_history ON azoth_history.rowid = azoth_history_fts.rowid "
+					"	WHERE azoth_history_fts MATCH :fts_query "
+					"		AND azoth_history_fts.rowid > :fts_pending "
+					"		AND " + makeFilter ("azoth_history.", "fts_") + " "
+					"		AND " + makeMatch ("azoth_history.", "fts_") + " "
+					"	UNION ALL "
+					"	SELECT rowid, Id, AccountID, Message, 0 FROM azoth_history "
+					"	WHERE rowid <= :like_pending "
+					"		AND " + makeFilter ({}, "like_") + " "
+					"		AND " + makeMatch ({}, "like_") +
+					") "
+					"WHERE " + keyset + " "
+					"ORDER BY " + ordering + " "
+					"LIMIT 1;";
+		}
+	}
+
 	Storage::Storage (QObject *parent)
 	: QObject (parent)
 	, DB_ (std::make_shared<QSqlDatabase> (QSqlDatabase::addDatabase ("QSQLITE",
@@ -143,17 +224,12 @@ namespace ChatHistory
 		UsersForAccountGetter_.prepare ("SELECT DISTINCT azoth_acc2users2.UserId, EntryID FROM azoth_users, azoth_acc2users2 "
 				"WHERE azoth_acc2users2.UserId = azoth_users.Id AND azoth_acc2users2.AccountID = :account_id;");
 
-		RowID2Pos_ = QSqlQuery (*DB_);
-		RowID2Pos_.prepare ("SELECT COUNT(1) FROM azoth_history "
-				"WHERE Id = :entry_id "
-				"AND AccountID = :account_id "
-				"AND rowid > :rowid");
-
-		Date2Pos_ = QSqlQuery (*DB_);
-		Date2Pos_.prepare ("SELECT COUNT(1) FROM azoth_history "
+		Date2RowID_ = QSqlQuery (*DB_);
+		Date2RowID_.prepare ("SELECT rowid FROM azoth_history "
 				"WHERE Id = :entry_id "
 				"AND AccountID = :account_id "
-				"AND Date >= :date");
+				"AND Date >= :date "
+				"ORDER BY Date ASC, rowid ASC LIMIT 1");
 
 		GetMonthDates_ = QSqlQuery (*DB_);
 		GetMonthDates_.prepare ("SELECT Date FROM azoth_history "
@@ -162,36 +238,59 @@ namespace ChatHistory
 				"AND Date >= :lower_date "
 				"AND Date <= :upper_date");
 
-		LogsSearcher_ = QSqlQuery (*DB_);
-		LogsSearcher_.prepare ("SELECT Rowid FROM azoth_history "
-				"WHERE Id = :inner_entry_id "
-				"AND AccountID = :inner_account_id "
-				"AND ((Message LIKE :text AND :insensitive) OR (Message GLOB :ctext AND :sensitive)) "
-				"ORDER BY Rowid DESC "
-				"LIMIT 1 OFFSET :offset;");
-
-		LogsSearcherWOContact_ = QSqlQuery (*DB_);
-		LogsSearcherWOContact_.prepare ("SELECT Date, Id FROM azoth_history "
-				"WHERE AccountID = :account_id "
-				"AND Date = (SELECT Date FROM azoth_history "
-				"	WHERE AccountID = :inner_account_id "
-				"	AND ((Message LIKE :text AND :insensitive) OR (Message GLOB :ctext AND :sensitive)) "
-				"	ORDER BY Rowid DESC "
-				"	LIMIT 1 OFFSET :offset);");
-
-		LogsSearcherWOContactAccount_ = QSqlQuery (*DB_);
-		LogsSearcherWOContactAccount_.prepare ("SELECT Date, Id, AccountID FROM azoth_history "
-				"WHERE Date = (SELECT Date FROM azoth_history "
-				"	WHERE ((Message LIKE :text AND :insensitive) OR (Message GLOB :ctext AND :sensitive)) "
-				"	ORDER BY Rowid DESC "
-				"	LIMIT 1 OFFSET :offset);");
-
-		HistoryGetter_ = QSqlQuery (*DB_);
-		HistoryGetter_.prepare ("SELECT Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy "
+		auto prepareSearcher = [this] (Searcher& searcher, const QStringList& fields, bool ranked)
+		{
+			searcher.Ranked_ = ranked;
+
+			searcher.Older_ = QSqlQuery (*DB_);
+			searcher.Older_.prepare (MakeSearchQuery (FullTextSearch_, fields, PageDirection::Older, ranked));
+
+			searcher.Newer_ = QSqlQuery (*DB_);
+			searcher.Newer_.prepare (MakeSearchQuery (FullTextSearch_, fields, PageDirection::Newer, ranked));
+		};
+		prepareSearcher (LogsSearcher_, { "Id", "AccountID" }, false);
+		prepareSearcher (LogsSearcherWOContact_, { "AccountID" }, true);
+		prepareSearcher (LogsSearcherWOContactAccount_, {}, true);
+
+		if (FullTextSearch_)
+		{
+			SearchIndexBackfiller_ = QSqlQuery (*DB_);
+			SearchIndexBackfiller_.prepare ("INSERT INTO azoth_history_fts (rowid, Message) "
+					"SELECT rowid, Message FROM azoth_history "
+					"WHERE rowid > :lower AND rowid <= :upper;");
+
+			SearchIndexStateUpdater_ = QSqlQuery (*DB_);
+			SearchIndexStateUpdater_.prepare ("UPDATE azoth_history_fts_state SET Pending = :pending;");
+
+			AnchorRankGetter_ = QSqlQuery (*DB_);
+			AnchorRankGetter_.prepare ("SELECT bm25(azoth_history_fts) FROM azoth_history_fts "
+					"WHERE azoth_history_fts MATCH :fts_query "
+					"AND rowid = :anchor AND rowid > :pending;");
+		}
+
+		HistoryGetterOlder_ = QSqlQuery (*DB_);
+		HistoryGetterOlder_.prepare ("SELECT rowid, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy "
 				"FROM azoth_history "
 				"WHERE Id = :entry_id "
 				"AND AccountID = :account_id "
-				"ORDER BY Rowid DESC LIMIT :limit OFFSET :offset;");
+				"AND rowid < :anchor "
+				"ORDER BY rowid DESC LIMIT :limit;");
+
+		HistoryGetterNewer_ = QSqlQuery (*DB_);
+		HistoryGetterNewer_.prepare ("SELECT rowid, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy "
+				"FROM azoth_history "
+				"WHERE Id = :entry_id "
+				"AND AccountID = :account_id "
+				"AND rowid > :anchor "
+				"ORDER BY rowid ASC LIMIT :limit;");
+
+		HistoryGetterBefore_ = QSqlQuery (*DB_);
+		HistoryGetterBefore_.prepare ("SELECT rowid, Date, Direction, Message, Variant, Type, RichMessage, EscapePolicy "
+				"FROM azoth_history "
+				"WHERE Id = :entry_id "
+				"AND AccountID = :account_id "
+				"AND Date < :before "
+				"ORDER BY Date DESC, rowid DESC LIMIT :limit;");
 
 		HistoryClearer_ = QSqlQuery (*DB_);
 		HistoryClearer_.prepare ("DELETE FROM azoth_history WHERE Id = :entry_id AND AccountID = :account_id;");
@@ -233,6 +332,9 @@ namespace ChatHistory
 
 		PrepareEntryCache ();
 
+		if (FullTextSearch_ && SearchIndexPending_ > 0)
+			QTimer::singleShot (0, this, [this] { BackfillSearchIndex (); });
+
 		return InitializationResult_t::Right ({});
 	}
 
@@ -327,9 +429,121 @@ namespace ChatHistory
 		if (!hadAcc2User)
 			RegenUsersCache ();
 
+		InitializeSearchIndex ();
+
 		lock.Good ();
 	}
 
+	void Storage::InitializeSearchIndex ()
+	{
+		FullTextSearch_ = false;
+
+		QSqlQuery query { *DB_ };
+		if (!DB_->tables ().contains ("azoth_history_fts"))
+		{
+			if (!query.exec ("CREATE VIRTUAL TABLE azoth_history_fts USING fts5 ("
+						"Message, "
+						"content = 'azoth_history', "
+						"content_rowid = 'rowid', "
+						"tokenize = 'trigram'"
+						");"))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "FTS5 is unavailable, falling back to full scan search";
+				Util::DBLock::DumpError (query);
+				return;
+			}
+
+			/* The rows that are already in the history are indexed lazily,
+			 * in chunks going from the most recent ones, so Pending holds the
+			 * largest rowid that is not indexed yet. The rows inserted from
+			 * now on are indexed by the trigger right away.
+			 */
+			const QStringList queries
+			{
+				"CREATE TABLE azoth_history_fts_state (Pending INTEGER);",
+				"INSERT INTO azoth_history_fts_state (Pending) "
+					"SELECT COALESCE(MAX(rowid), 0) FROM azoth_history;",
+				"CREATE TRIGGER azoth_history_fts_ai AFTER INSERT ON azoth_history BEGIN "
+					"INSERT INTO azoth_history_fts (rowid, Message) VALUES (new.rowid, new.Message); "
+					"END;",
+				"CREATE TRIGGER azoth_history_fts_ad AFTER DELETE ON azoth_history "
+					"WHEN old.rowid > (SELECT Pending FROM azoth_history_fts_state) BEGIN "
+					"INSERT INTO azoth_history_fts (azoth_history_fts, rowid, Message) "
+					"VALUES ('delete', old.rowid, old.Message); "
+					"END;"
+			};
+			for (const auto& str : queries)
+				if (!query.exec (str))
+				{
+					Util::DBLock::DumpError (query);
+					throw std::runtime_error ("Unable to create full text index for `azoth_history`.");
+				}
+		}
+
+		if (!query.exec ("SELECT Pending FROM azoth_history_fts_state;") ||
+				!query.next ())
+		{
+			Util::DBLock::DumpError (query);
+			throw std::runtime_error ("Unable to get full text index state for `azoth_history`.");
+		}
+
+		SearchIndexPending_ = query.value (0).value<qint64> ();
+		FullTextSearch_ = true;
+	}
+
+	void Storage::BackfillSearchIndex ()
+	{
+		if (SearchIndexPending_ <= 0)
+			return;
+
+		/* Small enough chunks not to delay the requests scheduled meanwhile
+		 * for too long.
+		 */
+		const qint64 chunkSize = 5000;
+		const auto lower = std::max<qint64> (SearchIndexPending_ - chunkSize, 0);
+
+		{
+			Util::DBLock lock (*DB_);
+			try
+			{
+				lock.Init ();
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to start transaction:"
+						<< e.what ();
+				return;
+			}
+
+			SearchIndexBackfiller_.bindValue (":lower", lower);
+			SearchIndexBackfiller_.bindValue (":upper", SearchIndexPending_);
+			if (!SearchIndexBackfiller_.exec ())
+			{
+				Util::DBLock::DumpError (SearchIndexBackfiller_);
+				return;
+			}
+
+			SearchIndexStateUpdater_.bindValue (":pending", lower);
+			if (!SearchIndexStateUpdater_.exec ())
+			{
+				Util::DBLock::DumpError (SearchIndexStateUpdater_);
+				return;
+			}
+
+			lock.Good ();
+		}
+
+		SearchIndexPending_ = lower;
+
+		if (SearchIndexPending_ > 0)
+			QTimer::singleShot (100, this, [this] { BackfillSearchIndex (); });
+		else
+			qDebug () << Q_FUNC_INFO
+					<< "history search index is complete";
+	}
+
 	void Storage::UpdateTables ()
 	{
 		QSqlQuery query { *DB_ };
@@ -512,10 +726,105 @@ namespace ChatHistory
 		{
 			return std::shared_ptr<void> (nullptr, [&query] (void*) { query.finish (); });
 		}
+
+		/* The trigram index can't match less than three characters, and
+		 * its phrase query has no idea about LIKE or GLOB wildcards.
+		 */
+		bool CanUseIndex (const QString& text, bool cs)
+		{
+			if (text.size () < 3)
+				return false;
+
+			const auto& wildcards = cs ? QString { "*?[" } : QString { "%_" };
+			return std::none_of (text.begin (), text.end (),
+					[&wildcards] (QChar c) { return wildcards.contains (c); });
+		}
+
+		QString MakeFTSQuery (QString text)
+		{
+			text.replace ('"', "\"\"");
+			return '"' + text + '"';
+		}
+
+		QList<QPair<int, int>> FindMatches (const QString& message, const QString& text, bool cs)
+		{
+			QList<QPair<int, int>> result;
+			if (text.isEmpty ())
+				return result;
+
+			const auto sensitivity = cs ? Qt::CaseSensitive : Qt::CaseInsensitive;
+			for (int pos = message.indexOf (text, 0, sensitivity); pos >= 0;
+					pos = message.indexOf (text, pos + text.size (), sensitivity))
+				result.append ({ pos, text.size () });
+			return result;
+		}
+	}
+
+	Storage::RawSearchResult Storage::RunSearch (Searcher& searcher, const QString& text,
+			qint64 anchor, bool backwards, bool cs)
+	{
+		auto& query = backwards ? searcher.Newer_ : searcher.Older_;
+
+		double rank = backwards ?
+				std::numeric_limits<double>::max () :
+				std::numeric_limits<double>::lowest ();
+		if (anchor <= 0)
+			anchor = backwards ? 0 : std::numeric_limits<qint64>::max ();
+
+		QStringList prefixes { "like_" };
+		if (FullTextSearch_)
+		{
+			prefixes << "fts_";
+
+			/* If the index can't serve the query, all the rows are
+			 * scanned the old way.
+			 */
+			const auto pending = CanUseIndex (text, cs) ?
+					SearchIndexPending_ :
+					std::numeric_limits<qint64>::max ();
+			const auto& ftsQuery = MakeFTSQuery (text);
+			query.bindValue (":fts_query", ftsQuery);
+			query.bindValue (":fts_pending", pending);
+			query.bindValue (":like_pending", pending);
+
+			if (searcher.Ranked_)
+			{
+				if (anchor != 0 && anchor != std::numeric_limits<qint64>::max ())
+					rank = GetAnchorRank (ftsQuery, anchor, pending);
+				query.bindValue (":rank", rank);
+			}
+		}
+
+		for (const auto& prefix : prefixes)
+		{
+			query.bindValue (':' + prefix + "text", '%' + text + '%');
+			query.bindValue (':' + prefix + "ctext", '*' + text + '*');
+			query.bindValue (':' + prefix + "sensitive", static_cast<int> (cs));
+			query.bindValue (':' + prefix + "insensitive", static_cast<int> (!cs));
+		}
+		query.bindValue (":anchor", anchor);
+
+		if (!query.exec ())
+		{
+			Util::DBLock::DumpError (query);
+			return {};
+		}
+		auto guard = CleanupQueryGuard (query);
+
+		if (!query.next ())
+			return {};
+
+		return
+		{
+			query.value (1).toInt (),
+			query.value (2).toInt (),
+			query.value (0).value<qint64> (),
+			FindMatches (query.value (3).toString (), text, cs)
+		};
 	}
 
 	Storage::RawSearchResult Storage::SearchImpl (const QString& accountId,
-			const QString& entryId, const QString& text, int shift, bool cs)
+			const QString& entryId, const QString& text, qint64 anchor, bool backwards, bool cs)
 	{
 		if (!Accounts_.contains (accountId))
 		{
@@ -538,35 +847,19 @@ namespace ChatHistory
 
 		const qint32 intEntryId = Users_ [entryId];
 		const qint32 intAccId = Accounts_ [accountId];
-		LogsSearcher_.bindValue (":entry_id", intEntryId);
-		LogsSearcher_.bindValue (":account_id", intAccId);
-		LogsSearcher_.bindValue (":inner_entry_id", intEntryId);
-		LogsSearcher_.bindValue (":inner_account_id", intAccId);
-		LogsSearcher_.bindValue (":text", '%' + text + '%');
-		LogsSearcher_.bindValue (":ctext", '*' + text + '*');
-		LogsSearcher_.bindValue (":sensitive", static_cast<int> (cs));
-		LogsSearcher_.bindValue (":insensitive", static_cast<int> (!cs));
-		LogsSearcher_.bindValue (":offset", shift);
-		if (!LogsSearcher_.exec ())
-		{
-			Util::DBLock::DumpError (LogsSearcher_);
-			return {};
-		}
-		auto guard = CleanupQueryGuard (LogsSearcher_);
-
-		if (!LogsSearcher_.next ())
+		auto& query = backwards ? LogsSearcher_.Newer_ : LogsSearcher_.Older_;
+		query.bindValue (":like_id", intEntryId);
+		query.bindValue (":like_accountid", intAccId);
+		if (FullTextSearch_)
 		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to move to the next entry";
-			Util::DBLock::DumpError (LogsSearcher_);
-			return {};
+			query.bindValue (":fts_id", intEntryId);
+			query.bindValue (":fts_accountid", intAccId);
 		}
-
-		return { intEntryId, intAccId, LogsSearcher_.value (0).value<qint64> () };
+		return RunSearch (LogsSearcher_, text, anchor, backwards, cs);
 	}
 
 	Storage::RawSearchResult Storage::SearchImpl (const QString& accountId,
-			const QString& text, int shift, bool cs)
+			const QString& text, qint64 anchor, bool backwards, bool cs)
 	{
 		if (!Accounts_.contains (accountId))
 		{
@@ -579,108 +872,57 @@ namespace ChatHistory
 		}
 
 		const qint32 intAccId = Accounts_ [accountId];
-		LogsSearcherWOContact_.bindValue (":account_id", intAccId);
-		LogsSearcherWOContact_.bindValue (":inner_account_id", intAccId);
-		LogsSearcherWOContact_.bindValue (":text", '%' + text + '%');
-		LogsSearcherWOContact_.bindValue (":ctext", '*' + text + '*');
-		LogsSearcherWOContact_.bindValue (":sensitive", static_cast<int> (cs));
-		LogsSearcherWOContact_.bindValue (":insensitive", static_cast<int> (!cs));
-		LogsSearcherWOContact_.bindValue (":offset", shift);
-		if (!LogsSearcherWOContact_.exec ())
-		{
-			Util::DBLock::DumpError (LogsSearcherWOContact_);
-			return RawSearchResult ();
-		}
-
-		if (!LogsSearcherWOContact_.next ())
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to move to the next entry";
-			return RawSearchResult ();
-		}
-
-		auto guard = CleanupQueryGuard (LogsSearcherWOContact_);
-
-		return
-		{
-			LogsSearcherWOContact_.value (1).toInt (),
-			intAccId,
-			LogsSearcherWOContact_.value (0).value<qint64> ()
-		};
+		auto& query = backwards ? LogsSearcherWOContact_.Newer_ : LogsSearcherWOContact_.Older_;
+		query.bindValue (":like_accountid", intAccId);
+		if (FullTextSearch_)
+			query.bindValue (":fts_accountid", intAccId);
+		return RunSearch (LogsSearcherWOContact_, text, anchor, backwards, cs);
 	}
 
-	Storage::RawSearchResult Storage::SearchImpl (const QString& text, int shift, bool cs)
+	Storage::RawSearchResult Storage::SearchImpl (const QString& text, qint64 anchor, bool backwards, bool cs)
 	{
-		LogsSearcherWOContactAccount_.bindValue (":text", '%' + text + '%');
-		LogsSearcherWOContactAccount_.bindValue (":ctext", '*' + text + '*');
-		LogsSearcherWOContactAccount_.bindValue (":sensitive", static_cast<int> (cs));
-		LogsSearcherWOContactAccount_.bindValue (":insensitive", static_cast<int> (!cs));
-		LogsSearcherWOContactAccount_.bindValue (":offset", shift);
-		if (!LogsSearcherWOContactAccount_.exec ())
-		{
-			Util::DBLock::DumpError (LogsSearcherWOContactAccount_);
-			return RawSearchResult ();
-		}
-
-		if (!LogsSearcherWOContactAccount_.next ())
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to move to the next entry";
-			return RawSearchResult ();
-		}
-
-		auto guard = CleanupQueryGuard (LogsSearcherWOContactAccount_);
-
-		return
-		{
-			LogsSearcherWOContactAccount_.value (1).toInt (),
-			LogsSearcherWOContactAccount_.value (2).toInt (),
-			LogsSearcherWOContactAccount_.value (0).value<qint64> ()
-		};
+		return RunSearch (LogsSearcherWOContactAccount_, text, anchor, backwards, cs);
 	}
 
-	SearchResult_t Storage::SearchRowIdImpl (qint32 accountId, qint32 entryId, qint64 rowId)
+	double Storage::GetAnchorRank (const QString& ftsQuery, qint64 anchor, qint64 pending)
 	{
-		RowID2Pos_.bindValue (":rowid", rowId);
-		RowID2Pos_.bindValue (":account_id", accountId);
-		RowID2Pos_.bindValue (":entry_id", entryId);
-		if (!RowID2Pos_.exec ())
+		AnchorRankGetter_.bindValue (":fts_query", ftsQuery);
+		AnchorRankGetter_.bindValue (":anchor", anchor);
+		AnchorRankGetter_.bindValue (":pending", pending);
+		if (!AnchorRankGetter_.exec ())
 		{
-			Util::DBLock::DumpError (RowID2Pos_);
-			return SearchResult_t::Left ("Unable to execute search query.");
+			Util::DBLock::DumpError (AnchorRankGetter_);
+			return 0;
 		}
+		auto guard = CleanupQueryGuard (AnchorRankGetter_);
 
-		if (!RowID2Pos_.next ())
-			return SearchResult_t::Right ({});
-
-		const int index = RowID2Pos_.value (0).toInt ();
-		RowID2Pos_.finish ();
+		/* The anchor is either an unindexed row or a row found by the
+		 * scan, and those are all ranked the same.
+		 */
+		if (!AnchorRankGetter_.next ())
+			return 0;
 
-		return SearchResult_t::Right (index);
+		return AnchorRankGetter_.value (0).toDouble ();
 	}
 
 	SearchResult_t Storage::SearchDateImpl (qint32 accountId, qint32 entryId, const QDateTime& dt)
 	{
-		Date2Pos_.bindValue (":date", dt);
-		Date2Pos_.bindValue (":account_id", accountId);
-		Date2Pos_.bindValue (":entry_id", entryId);
-		if (!Date2Pos_.exec ())
+		Date2RowID_.bindValue (":date", dt);
+		Date2RowID_.bindValue (":account_id", accountId);
+		Date2RowID_.bindValue (":entry_id", entryId);
+		if (!Date2RowID_.exec ())
 		{
-			Util::DBLock::DumpError (Date2Pos_);
+			Util::DBLock::DumpError (Date2RowID_);
 			return SearchResult_t::Left ("Unable to execute search query.");
 		}
 
-		if (!Date2Pos_.next ())
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to navigate to next record";
-			return SearchResult_t::Left ("Unable to navigate to the search results.");
-		}
+		if (!Date2RowID_.next ())
+			return SearchResult_t::Right ({});
 
-		const int index = Date2Pos_.value (0).toInt ();
-		Date2Pos_.finish ();
+		const auto rowId = Date2RowID_.value (0).value<qint64> ();
+		Date2RowID_.finish ();
 
-		return SearchResult_t::Right (index);
+		return SearchResult_t::Right (SearchHit { rowId, {} });
 	}
 
 	boost::optional<int> Storage::GetAllHistoryCount ()
@@ -942,10 +1184,29 @@ namespace ChatHistory
 					IMessage::EscapePolicy::NoEscape :
 					IMessage::EscapePolicy::Escape;
 		}
+
+		ChatLogsPage ReadLogsPage (QSqlQuery& query)
+		{
+			ChatLogsPage result;
+			while (query.next ())
+			{
+				result.RowIDs_ << query.value (0).value<qint64> ();
+				result.Items_.push_back ({
+						query.value (1).toDateTime (),
+						GetMsgDirection (query.value (2)),
+						query.value (3).toString (),
+						query.value (4).toString (),
+						GetMsgType (query.value (5)),
+						query.value (6).toString (),
+						GetMsgEscapePolicy (query.value (7))
+					});
+			}
+			return result;
+		}
 	}
 
 	ChatLogsResult_t Storage::GetChatLogs (const QString& accountId,
-			const QString& entryId, int backpages, int amount)
+			const QString& entryId, qint64 anchor, PageDirection dir, int amount)
 	{
 		if (!Accounts_.contains (accountId))
 		{
@@ -966,49 +1227,92 @@ namespace ChatHistory
 			return ChatLogsResult_t::Left ("Unknown user.");
 		}
 
-		HistoryGetter_.bindValue (":entry_id", Users_ [entryId]);
-		HistoryGetter_.bindValue (":account_id", Accounts_ [accountId]);
-		HistoryGetter_.bindValue (":limit", amount);
-		HistoryGetter_.bindValue (":offset", amount * backpages);
+		auto& query = dir == PageDirection::Older ? HistoryGetterOlder_ : HistoryGetterNewer_;
+		if (dir == PageDirection::Older && anchor <= 0)
+			anchor = std::numeric_limits<qint64>::max ();
 
-		if (!HistoryGetter_.exec ())
+		query.bindValue (":entry_id", Users_ [entryId]);
+		query.bindValue (":account_id", Accounts_ [accountId]);
+		query.bindValue (":anchor", anchor);
+		query.bindValue (":limit", amount);
+
+		if (!query.exec ())
 		{
-			Util::DBLock::DumpError (HistoryGetter_);
+			Util::DBLock::DumpError (query);
 			return ChatLogsResult_t::Left ("Unable to execute the SQL query.");
 		}
 
-		LogList_t result;
-		while (HistoryGetter_.next ())
-			result.push_back ({
-					HistoryGetter_.value (0).toDateTime (),
-					GetMsgDirection (HistoryGetter_.value (1)),
-					HistoryGetter_.value (2).toString (),
-					HistoryGetter_.value (3).toString (),
-					GetMsgType (HistoryGetter_.value (4)),
-					HistoryGetter_.value (5).toString (),
-					GetMsgEscapePolicy (HistoryGetter_.value (6))
-				});
+		auto result = ReadLogsPage (query);
+
+		/* A page that runs into the most recent message is shown as the
+		 * full last page instead.
+		 */
+		if (dir == PageDirection::Newer && result.Items_.size () < amount)
+			return GetChatLogs (accountId, entryId, 0, PageDirection::Older, amount);
+
+		if (dir == PageDirection::Older)
+		{
+			std::reverse (result.Items_.begin (), result.Items_.end ());
+			std::reverse (result.RowIDs_.begin (), result.RowIDs_.end ());
+		}
+
+		return ChatLogsResult_t::Right (result);
+	}
+
+	ChatLogsResult_t Storage::GetChatLogsBefore (const QString& accountId,
+			const QString& entryId, const QDateTime& before, int amount)
+	{
+		if (!Accounts_.contains (accountId))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "Accounts_ doesn't contain"
+					<< accountId
+					<< "; raw contents"
+					<< Accounts_;
+			return ChatLogsResult_t::Left ("Unknown account.");
+		}
+		if (!Users_.contains (entryId))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "Users_ doesn't contain"
+					<< entryId
+					<< "; raw contents"
+					<< Users_;
+			return ChatLogsResult_t::Left ("Unknown user.");
+		}
+
+		HistoryGetterBefore_.bindValue (":entry_id", Users_ [entryId]);
+		HistoryGetterBefore_.bindValue (":account_id", Accounts_ [accountId]);
+		HistoryGetterBefore_.bindValue (":before", before);
+		HistoryGetterBefore_.bindValue (":limit", amount);
 
-		std::reverse (result.begin (), result.end ());
+		if (!HistoryGetterBefore_.exec ())
+		{
+			Util::DBLock::DumpError (HistoryGetterBefore_);
+			return ChatLogsResult_t::Left ("Unable to execute the SQL query.");
+		}
 
+		auto result = ReadLogsPage (HistoryGetterBefore_);
+		std::reverse (result.Items_.begin (), result.Items_.end ());
+		std::reverse (result.RowIDs_.begin (), result.RowIDs_.end ());
 		return ChatLogsResult_t::Right (result);
 	}
 
 	SearchResult_t Storage::Search (const QString& accountId,
-			const QString& entryId, const QString& text, int shift, bool cs)
+			const QString& entryId, const QString& text, qint64 anchor, bool backwards, bool cs)
 	{
 		RawSearchResult res;
 		if (!accountId.isEmpty () && !entryId.isEmpty ())
-			res = SearchImpl (accountId, entryId, text, shift, cs);
+			res = SearchImpl (accountId, entryId, text, anchor, backwards, cs);
 		else if (!accountId.isEmpty ())
-			res = SearchImpl (accountId, text, shift, cs);
+			res = SearchImpl (accountId, text, anchor, backwards, cs);
 		else
-			res = SearchImpl (text, shift, cs);
+			res = SearchImpl (text, anchor, backwards, cs);
 
 		if (res.IsEmpty ())
 			return SearchResult_t::Right ({});
 
-		return SearchRowIdImpl (res.AccountID_, res.EntryID_, res.RowID_);
+		return SearchResult_t::Right (SearchHit { res.RowID_, res.Matches_ });
 	}
 
 	SearchResult_t Storage::SearchDate (const QString& account, const QString& entry, const QDateTime& dt)
@@ -63,13 +63,23 @@ namespace ChatHistory
 		QSqlQuery MessageDumper_;
 		QSqlQuery MessageDumperFuzzy_;
 		QSqlQuery UsersForAccountGetter_;
-		QSqlQuery RowID2Pos_;
-		QSqlQuery Date2Pos_;
+		QSqlQuery Date2RowID_;
 		QSqlQuery GetMonthDates_;
-		QSqlQuery LogsSearcher_;
-		QSqlQuery LogsSearcherWOContact_;
-		QSqlQuery LogsSearcherWOContactAccount_;
-		QSqlQuery HistoryGetter_;
+		struct Searcher
+		{
+			QSqlQuery Older_;
+			QSqlQuery Newer_;
+			bool Ranked_ = false;
+		};
+		Searcher LogsSearcher_;
+		Searcher LogsSearcherWOContact_;
+		Searcher LogsSearcherWOContactAccount_;
+		QSqlQuery SearchIndexBackfiller_;
+		QSqlQuery SearchIndexStateUpdater_;
+		QSqlQuery AnchorRankGetter_;
+		QSqlQuery HistoryGetterOlder_;
+		QSqlQuery HistoryGetterNewer_;
+		QSqlQuery HistoryGetterBefore_;
 		QSqlQuery HistoryClearer_;
 		QSqlQuery UserClearer_;
 		QSqlQuery EntryCacheSetter_;
@@ -81,14 +91,19 @@ namespace ChatHistory
 
 		QHash<qint32, QString> EntryCache_;
 
+		bool FullTextSearch_ = false;
+		qint64 SearchIndexPending_ = 0;
+
 		struct RawSearchResult
 		{
 			qint32 EntryID_ = 0;
 			qint32 AccountID_ = 0;
 			qint64 RowID_ = -1;
+			QList<QPair<int, int>> Matches_;
 
 			RawSearchResult () = default;
-			RawSearchResult (qint32 entryId, qint32 accountId, qint64 rowId);
+			RawSearchResult (qint32 entryId, qint32 accountId, qint64 rowId,
+					const QList<QPair<int, int>>& matches = {});
 
 			bool IsEmpty () const;
 		};
@@ -114,13 +129,25 @@ namespace ChatHistory
 		QStringList GetOurAccounts () const;
 		UsersForAccountResult_t GetUsersForAccount (const QString&);
 		ChatLogsResult_t GetChatLogs (const QString& accountId,
-				const QString& entryId, int backpages, int amount);
+				const QString& entryId, qint64 anchor, PageDirection, int amount);
+
+		/** Returns up to amount most recent messages dated strictly
+		 * before the given date, oldest first.
+		 */
+		ChatLogsResult_t GetChatLogsBefore (const QString& accountId,
+				const QString& entryId, const QDateTime& before, int amount);
 
 		void AddMessages (const QString& accountId, const QString& entryId,
 				const QString& visibleName, const QList<LogItem>&, bool fuzzy);
 
+		/** Returns the closest message matching the text that precedes
+		 * the anchor row, or follows it if backwards is true.
+		 *
+		 * A non-positive anchor starts the search from the most recent
+		 * message (or from the oldest one if backwards is true).
+		 */
 		SearchResult_t Search (const QString& accountId, const QString& entryId,
-				const QString& text, int shift, bool cs);
+				const QString& text, qint64 anchor, bool backwards, bool cs);
 		SearchResult_t SearchDate (const QString& accountId,
 				const QString& entryId, const QDateTime& dt);
 
@@ -133,6 +160,8 @@ namespace ChatHistory
 	private:
 		void InitializeTables ();
 		void UpdateTables ();
+		void InitializeSearchIndex ();
+		void BackfillSearchIndex ();
 
 		QHash<QString, qint32> GetUsers ();
 		qint32 GetUserID (const QString&);
@@ -144,11 +173,13 @@ namespace ChatHistory
 		qint32 GetAccountID (const QString&);
 		void AddAccount (const QString& id);
 		RawSearchResult SearchImpl (const QString& accountId, const QString& entryId,
-				const QString& text, int shift, bool cs);
-		RawSearchResult SearchImpl (const QString& accountId, const QString& text, int shift, bool cs);
-		RawSearchResult SearchImpl (const QString& text, int shift, bool cs);
+				const QString& text, qint64 anchor, bool backwards, bool cs);
+		RawSearchResult SearchImpl (const QString& accountId, const QString& text,
+				qint64 anchor, bool backwards, bool cs);
+		RawSearchResult SearchImpl (const QString& text, qint64 anchor, bool backwards, bool cs);
+		RawSearchResult RunSearch (Searcher&, const QString& text, qint64 anchor, bool backwards, bool cs);
+		double GetAnchorRank (const QString& ftsQuery, qint64 anchor, qint64 pending);
 
-		SearchResult_t SearchRowIdImpl (qint32, qint32, qint64);
 		SearchResult_t SearchDateImpl (qint32, qint32, const QDateTime&);
 	};
 }
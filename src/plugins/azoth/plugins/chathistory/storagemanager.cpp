@@ -176,16 +176,22 @@ namespace ChatHistory
 	}
 
 	QFuture<ChatLogsResult_t> StorageManager::GetChatLogs (const QString& accountId,
-			const QString& entryId, int backpages, int amount)
+			const QString& entryId, qint64 anchor, PageDirection dir, int amount)
 	{
-		return StorageThread_->Schedule (&Storage::GetChatLogs, accountId, entryId, backpages, amount);
+		return StorageThread_->Schedule (&Storage::GetChatLogs, accountId, entryId, anchor, dir, amount);
+	}
+
+	QFuture<ChatLogsResult_t> StorageManager::GetChatLogsBefore (const QString& accountId,
+			const QString& entryId, const QDateTime& before, int amount)
+	{
+		return StorageThread_->Schedule (&Storage::GetChatLogsBefore, accountId, entryId, before, amount);
 	}
 
 	QFuture<SearchResult_t> StorageManager::Search (const QString& accountId, const QString& entryId,
-			const QString& text, int shift, bool cs)
+			const QString& text, qint64 anchor, bool backwards, bool cs)
 	{
 		return StorageThread_->Schedule (&Storage::Search,
-				accountId, entryId, text, shift, cs);
+				accountId, entryId, text, anchor, backwards, cs);
 	}
 
 	QFuture<SearchResult_t> StorageManager::Search (const QString& accountId, const QString& entryId, const QDateTime& dt)
@@ -57,10 +57,12 @@ namespace ChatHistory
 		QFuture<UsersForAccountResult_t> GetUsersForAccount (const QString&);
 
 		QFuture<ChatLogsResult_t> GetChatLogs (const QString& accountId, const QString& entryId,
-				int backpages, int amount);
+				qint64 anchor, PageDirection, int amount);
+		QFuture<ChatLogsResult_t> GetChatLogsBefore (const QString& accountId, const QString& entryId,
+				const QDateTime& before, int amount);
 
 		QFuture<SearchResult_t> Search (const QString& accountId, const QString& entryId,
-				const QString& text, int shift, bool cs);
+				const QString& text, qint64 anchor, bool backwards, bool cs);
 		QFuture<SearchResult_t> Search (const QString& accountId, const QString& entryId, const QDateTime& dt);
 
 		QFuture<DaysResult_t> GetDaysForSheet (const QString& accountId, const QString& entryId, int year, int month);
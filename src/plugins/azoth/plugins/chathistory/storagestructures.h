@@ -31,6 +31,7 @@
 
 #include <boost/optional.hpp>
 #include <QStringList>
+#include <QPair>
 #include <util/sll/either.h>
 #include <interfaces/azoth/imessage.h>
 #include <interfaces/azoth/ihistoryplugin.h>
@@ -52,9 +53,48 @@ namespace ChatHistory
 
 	using UsersForAccountResult_t = Util::Either<QString, UsersForAccount>;
 
-	using ChatLogsResult_t = Util::Either<QString, LogList_t>;
+	/** The direction of a history page relative to its anchor row.
+	 */
+	enum class PageDirection
+	{
+		/** The messages preceding the anchor row.
+		 */
+		Older,
+
+		/** The messages following the anchor row.
+		 */
+		Newer
+	};
+
+	struct ChatLogsPage
+	{
+		/** The messages of the page in chronological order.
+		 */
+		LogList_t Items_;
+
+		/** The row IDs of the Items_, to be used as the anchors for
+		 * the adjacent pages.
+		 */
+		QList<qint64> RowIDs_;
+	};
+
+	using ChatLogsResult_t = Util::Either<QString, ChatLogsPage>;
+
+	struct SearchHit
+	{
+		/** The row ID of the found message, to be used both as the
+		 * anchor of the page showing it and as the anchor of the next
+		 * search.
+		 */
+		qint64 RowID_;
+
+		/** The offsets and lengths of the matched fragments in the
+		 * message's plain text, if known.
+		 */
+		QList<QPair<int, int>> Matches_;
+	};
 
-	using SearchResult_t = Util::Either<QString, boost::optional<int>>;
+	using SearchResult_t = Util::Either<QString, boost::optional<SearchHit>>;
 
 	using DaysResult_t = Util::Either<QString, QList<int>>;
 }
@@ -58,6 +58,16 @@ namespace Metacontacts
 		return c;
 	}
 
+	void Core::SetPluginProxy (IProxyObject *proxy)
+	{
+		PluginProxy_ = proxy;
+	}
+
+	IProxyObject* Core::GetPluginProxy () const
+	{
+		return PluginProxy_;
+	}
+
 	void Core::SetMetaAccount (MetaAccount *acc)
 	{
 		if (!acc)
@@ -37,6 +37,7 @@ namespace LeechCraft
 namespace Azoth
 {
 class ICLEntry;
+class IProxyObject;
 
 namespace Metacontacts
 {
@@ -49,6 +50,8 @@ namespace Metacontacts
 
 		bool SaveEntriesScheduled_;
 
+		IProxyObject *PluginProxy_ = nullptr;
+
 		MetaAccount *Account_;
 		QList<MetaEntry*> Entries_;
 
@@ -59,6 +62,9 @@ namespace Metacontacts
 	public:
 		static Core& Instance ();
 
+		void SetPluginProxy (IProxyObject*);
+		IProxyObject* GetPluginProxy () const;
+
 		void SetMetaAccount (MetaAccount*);
 		QList<QObject*> GetEntries () const;
 
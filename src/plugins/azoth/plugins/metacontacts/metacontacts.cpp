@@ -32,6 +32,7 @@
 #include <QAction>
 #include <util/util.h>
 #include <interfaces/azoth/iclentry.h>
+#include <interfaces/azoth/iproxyobject.h>
 #include "metaprotocol.h"
 #include "core.h"
 
@@ -104,6 +105,11 @@ namespace Metacontacts
 		return result;
 	}
 
+	void Plugin::initPlugin (QObject *proxy)
+	{
+		Core::Instance ().SetPluginProxy (qobject_cast<IProxyObject*> (proxy));
+	}
+
 	void Plugin::hookAddingCLEntryBegin (IHookProxy_ptr proxy, QObject *entry)
 	{
 		if (Core::Instance ().HandleRealEntryAddBegin (entry))
@@ -72,6 +72,8 @@ namespace Metacontacts
 		QObject* GetQObject ();
 		QList<QObject*> GetProtocols () const;
 	public slots:
+		void initPlugin (QObject*);
+
 		void hookAddingCLEntryBegin (LeechCraft::IHookProxy_ptr proxy,
 				QObject *entry);
 		void hookDnDEntry2Entry (LeechCraft::IHookProxy_ptr,
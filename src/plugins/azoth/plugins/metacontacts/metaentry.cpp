@@ -36,6 +36,8 @@
 #include <QtDebug>
 #include <util/sll/qtutil.h>
 #include <util/util.h>
+#include <interfaces/azoth/azothutil.h>
+#include <interfaces/azoth/iproxyobject.h>
 #include "metaaccount.h"
 #include "metamessage.h"
 #include "managecontactsdialog.h"
@@ -403,6 +405,10 @@ namespace Metacontacts
 		}
 
 		MetaMessage *message = new MetaMessage (msgObj, this);
+		connect (msgObj,
+				SIGNAL (destroyed (QObject*)),
+				this,
+				SLOT (handleRealMessageDestroyed (QObject*)));
 
 		const bool shouldSort = !Messages_.isEmpty () &&
 				Messages_.last ()->GetDateTime () > msg->GetDateTime ();
@@ -415,9 +421,32 @@ namespace Metacontacts
 						return left->GetDateTime () < right->GetDateTime ();
 					});
 
+		const auto maxCount = Core::Instance ().GetPluginProxy ()->
+				GetSettingsManager ()->property ("MaxRetainedMessages").toInt ();
+		const auto& trimmed = AzothUtil::TrimMessages (Messages_, maxCount);
+		qDeleteAll (trimmed);
+
+		// An out-of-order message may be older than the retained ones.
+		if (trimmed.contains (message))
+			return;
+
 		emit gotMessage (message);
 	}
 
+	void MetaEntry::handleRealMessageDestroyed (QObject *msgObj)
+	{
+		for (auto i = Messages_.begin (); i != Messages_.end (); ++i)
+		{
+			const auto metaMsg = dynamic_cast<MetaMessage*> (*i);
+			if (metaMsg->GetOriginalMessageObj () != msgObj)
+				continue;
+
+			Messages_.erase (i);
+			delete metaMsg;
+			return;
+		}
+	}
+
 	void MetaEntry::handleRealStatusChanged (const EntryStatus& status, const QString& var)
 	{
 		ICLEntry *entry = qobject_cast<ICLEntry*> (sender ());
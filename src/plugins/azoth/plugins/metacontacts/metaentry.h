@@ -112,6 +112,7 @@ namespace Metacontacts
 		void SetNewEntryList (const QList<QObject*>&, bool readdRemoved);
 	private slots:
 		void handleRealGotMessage (QObject*);
+		void handleRealMessageDestroyed (QObject*);
 		void handleRealStatusChanged (const EntryStatus&, const QString&);
 		void handleRealVariantsChanged (QStringList, QObject* = 0);
 		void handleRealNameChanged (const QString&);
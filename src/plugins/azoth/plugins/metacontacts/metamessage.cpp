@@ -109,6 +109,11 @@ namespace Metacontacts
 	{
 		return Message_;
 	}
+
+	QObject* MetaMessage::GetOriginalMessageObj () const
+	{
+		return MessageObj_;
+	}
 }
 }
 }
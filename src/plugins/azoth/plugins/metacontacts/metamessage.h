@@ -66,6 +66,7 @@ namespace Metacontacts
 		void SetDateTime (const QDateTime&);
 
 		IMessage* GetOriginalMessage () const;
+		QObject* GetOriginalMessageObj () const;
 	};
 }
 }
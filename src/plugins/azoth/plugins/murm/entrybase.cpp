@@ -59,6 +59,8 @@ namespace Murm
 	void EntryBase::Store (VkMessage *msg)
 	{
 		Messages_ << msg;
+		AzothUtil::StandardTrimMessages (Messages_,
+				Account_->GetParentProtocol ()->GetAzothProxy ());
 		emit gotMessage (msg);
 	}
 
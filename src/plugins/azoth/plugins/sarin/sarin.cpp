@@ -30,6 +30,7 @@
 #include "sarin.h"
 #include <QIcon>
 #include <interfaces/azoth/iclentry.h>
+#include <interfaces/azoth/iproxyobject.h>
 #include "toxprotocol.h"
 
 namespace LeechCraft
@@ -90,6 +91,11 @@ namespace Sarin
 	{
 		return { Proto_.get () };
 	}
+
+	void Plugin::initPlugin (QObject *proxy)
+	{
+		Proto_->SetAzothProxy (qobject_cast<IProxyObject*> (proxy));
+	}
 }
 }
 }
@@ -67,6 +67,8 @@ namespace Sarin
 
 		QObject* GetQObject ();
 		QList<QObject*> GetProtocols () const;
+	public slots:
+		void initPlugin (QObject*);
 	signals:
 		void gotNewProtocols (const QList<QObject*>&);
 	};
@@ -31,6 +31,7 @@
 #include <QImage>
 #include <interfaces/azoth/azothutil.h>
 #include "toxaccount.h"
+#include "toxprotocol.h"
 #include "chatmessage.h"
 
 namespace LeechCraft
@@ -183,6 +184,9 @@ namespace Sarin
 	void ToxContact::HandleMessage (ChatMessage *msg)
 	{
 		AllMessages_ << msg;
+
+		const auto proto = qobject_cast<ToxProtocol*> (Acc_->GetParentProtocol ());
+		AzothUtil::StandardTrimMessages (AllMessages_, proto->GetAzothProxy ());
 		emit gotMessage (msg);
 	}
 
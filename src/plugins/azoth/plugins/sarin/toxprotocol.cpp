@@ -138,6 +138,16 @@ namespace Sarin
 		return CoreProxy_;
 	}
 
+	void ToxProtocol::SetAzothProxy (IProxyObject *proxy)
+	{
+		AzothProxy_ = proxy;
+	}
+
+	IProxyObject* ToxProtocol::GetAzothProxy () const
+	{
+		return AzothProxy_;
+	}
+
 	void ToxProtocol::LoadAccounts ()
 	{
 		QSettings settings { QSettings::IniFormat, QSettings::UserScope,
@@ -37,6 +37,8 @@ namespace LeechCraft
 {
 namespace Azoth
 {
+class IProxyObject;
+
 namespace Sarin
 {
 	class ToxAccount;
@@ -50,6 +52,7 @@ namespace Sarin
 		const ICoreProxy_ptr CoreProxy_;
 
 		QObject * const ParentProtocol_;
+		IProxyObject *AzothProxy_ = nullptr;
 
 		QList<ToxAccount*> Accounts_;
 	public:
@@ -70,6 +73,9 @@ namespace Sarin
 		void RemoveAccount (QObject* account) override;
 
 		const ICoreProxy_ptr& GetCoreProxy () const;
+
+		void SetAzothProxy (IProxyObject*);
+		IProxyObject* GetAzothProxy () const;
 	private:
 		void LoadAccounts ();
 		void InitConnections (ToxAccount*);
@@ -140,15 +140,13 @@ namespace StandardStyles
 		}
 	}
 
-	bool StandardStyleSource::AppendMessage (QWebFrame *frame,
-			QObject *msgObj, const ChatMsgAppendInfo& info)
+	QString StandardStyleSource::FormatMessage (QWebFrame *frame,
+			QObject *msgObj, const ChatMsgAppendInfo& info, const QList<QColor>& colors)
 	{
 		QObject *azothSettings = Proxy_->GetSettingsManager ();
-		const auto& colors = CreateColors (frame->metaData ().value ("coloring"), frame);
 		auto& formatter = Proxy_->GetFormatterProxy ();
 
 		const bool isHighlightMsg = info.IsHighlightMsg_;
-		const bool isActiveChat = info.IsActiveChat_;
 
 		const QString& msgId = GetMessageID (msgObj);
 
@@ -311,26 +309,71 @@ namespace StandardStyles
 					.arg (msgId));
 		string.append (body);
 
-		QWebElement elem = frame->findFirstElement ("body");
+		return QString ("<div class='%1' style='word-wrap: break-word;'>%2</div>")
+					.arg (divClass)
+					.arg (string);
+	}
+
+	bool StandardStyleSource::AppendMessage (QWebFrame *frame,
+			QObject *msgObj, const ChatMsgAppendInfo& info)
+	{
+		return AppendMessages (frame, { { msgObj, info } });
+	}
+
+	bool StandardStyleSource::AppendMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		const auto& colors = CreateColors (frame->metaData ().value ("coloring"), frame);
 
-		if (msg->GetMessageType () == IMessage::Type::ChatMessage ||
-			msg->GetMessageType () == IMessage::Type::MUCMessage)
+		const QString separator { "<hr class=\"lastSeparator\" />" };
+		int separatorPos = -1;
+
+		QString html;
+		for (const auto& pair : messages)
 		{
-			const auto isRead = Proxy_->IsMessageRead (msgObj);
-			if (!isActiveChat &&
-					!isRead && IsLastMsgRead_.value (frame, false))
+			const auto msgObj = pair.first;
+			const auto msg = qobject_cast<IMessage*> (msgObj);
+
+			if (msg->GetMessageType () == IMessage::Type::ChatMessage ||
+				msg->GetMessageType () == IMessage::Type::MUCMessage)
 			{
-				auto hr = elem.findFirst ("hr[class=\"lastSeparator\"]");
-				if (!hr.isNull ())
-					hr.removeFromDocument ();
-				elem.appendInside ("<hr class=\"lastSeparator\" />");
+				const auto isRead = Proxy_->IsMessageRead (msgObj);
+				if (!pair.second.IsActiveChat_ &&
+						!isRead && IsLastMsgRead_.value (frame, false))
+				{
+					if (separatorPos >= 0)
+						html.remove (separatorPos, separator.size ());
+					separatorPos = html.size ();
+					html += separator;
+				}
+				IsLastMsgRead_ [frame] = isRead;
 			}
-			IsLastMsgRead_ [frame] = isRead;
+
+			html += FormatMessage (frame, msgObj, pair.second, colors);
 		}
 
-		elem.appendInside (QString ("<div class='%1' style='word-wrap: break-word;'>%2</div>")
-					.arg (divClass)
-					.arg (string));
+		QWebElement elem = frame->findFirstElement ("body");
+		if (separatorPos >= 0)
+		{
+			auto hr = elem.findFirst ("hr[class=\"lastSeparator\"]");
+			if (!hr.isNull ())
+				hr.removeFromDocument ();
+		}
+
+		elem.appendInside (html);
+		return true;
+	}
+
+	bool StandardStyleSource::PrependMessages (QWebFrame *frame, const ChatMsgAppendList_t& messages)
+	{
+		const auto& colors = CreateColors (frame->metaData ().value ("coloring"), frame);
+
+		// The "last read" separator only makes sense for the new messages,
+		// so it's neither inserted nor tracked here.
+		QString html;
+		for (const auto& pair : messages)
+			html += FormatMessage (frame, pair.first, pair.second, colors);
+
+		frame->findFirstElement ("body").prependInside (html);
 		return true;
 	}
 
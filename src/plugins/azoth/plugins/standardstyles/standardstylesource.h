@@ -73,9 +73,12 @@ namespace StandardStyles
 		QString GetHTMLTemplate (const QString&,
 				const QString&, QObject*, QWebFrame*) const;
 		bool AppendMessage (QWebFrame*, QObject*, const ChatMsgAppendInfo&);
+		bool AppendMessages (QWebFrame*, const ChatMsgAppendList_t&);
+		bool PrependMessages (QWebFrame*, const ChatMsgAppendList_t&);
 		void FrameFocused (QWebFrame*);
 		QStringList GetVariantsForPack (const QString&);
 	private:
+		QString FormatMessage (QWebFrame*, QObject*, const ChatMsgAppendInfo&, const QList<QColor>&);
 		QList<QColor> CreateColors (const QString&, QWebFrame*);
 		QString GetMessageID (QObject*);
 		QString GetStatusImage (const QString&);
@@ -96,6 +96,8 @@ namespace Vader
 	void MRIMBuddy::HandleMessage (MRIMMessage *msg)
 	{
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_,
+				A_->GetParentProtocol ()->GetAzothProxy ());
 		emit gotMessage (msg);
 	}
 
@@ -32,6 +32,8 @@
 #include <QtDebug>
 #include <util/xpc/util.h>
 #include <interfaces/core/ientitymanager.h>
+#include <interfaces/azoth/azothutil.h>
+#include <interfaces/azoth/iproxyobject.h>
 #include "account.h"
 #include "util.h"
 #include "convimmessage.h"
@@ -220,6 +222,8 @@ namespace VelvetBird
 	void Buddy::Store (ConvIMMessage *msg)
 	{
 		Messages_ << msg;
+		AzothUtil::StandardTrimMessages (Messages_,
+				Account_->GetParentProtocol ()->GetAzothProxy ());
 		emit gotMessage (msg);
 	}
 
@@ -42,9 +42,10 @@ namespace Azoth
 {
 namespace VelvetBird
 {
-	Protocol::Protocol (PurplePlugin *plug, ICoreProxy_ptr proxy, QObject *parent)
+	Protocol::Protocol (PurplePlugin *plug, ICoreProxy_ptr proxy, IProxyObject *azothProxy, QObject *parent)
 	: QObject (parent)
 	, Proxy_ (proxy)
+	, AzothProxy_ (azothProxy)
 	, PPlug_ (plug)
 	{
 	}
@@ -156,6 +157,11 @@ namespace VelvetBird
 	{
 		return Proxy_;
 	}
+
+	IProxyObject* Protocol::GetAzothProxy () const
+	{
+		return AzothProxy_;
+	}
 }
 }
 }
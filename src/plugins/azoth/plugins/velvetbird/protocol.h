@@ -43,6 +43,8 @@ struct Entity;
 
 namespace Azoth
 {
+class IProxyObject;
+
 namespace VelvetBird
 {
 	class Account;
@@ -54,11 +56,12 @@ namespace VelvetBird
 		Q_INTERFACES (LeechCraft::Azoth::IProtocol)
 
 		ICoreProxy_ptr Proxy_;
+		IProxyObject * const AzothProxy_;
 		PurplePlugin *PPlug_;
 
 		QList<Account*> Accounts_;
 	public:
-		Protocol (PurplePlugin*, ICoreProxy_ptr, QObject* = 0);
+		Protocol (PurplePlugin*, ICoreProxy_ptr, IProxyObject*, QObject* = 0);
 
 		void Release ();
 
@@ -77,6 +80,7 @@ namespace VelvetBird
 		void PushAccount (PurpleAccount*);
 
 		ICoreProxy_ptr GetCoreProxy () const;
+		IProxyObject* GetAzothProxy () const;
 	signals:
 		void accountAdded (QObject*);
 		void accountRemoved (QObject*);
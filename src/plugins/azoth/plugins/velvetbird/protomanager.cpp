@@ -309,6 +309,11 @@ namespace VelvetBird
 	{
 	}
 
+	void ProtoManager::SetAzothProxy (IProxyObject *proxy)
+	{
+		AzothProxy_ = proxy;
+	}
+
 	void ProtoManager::PluginsAvailable ()
 	{
 		purple_debug_set_enabled (true);
@@ -347,7 +352,7 @@ namespace VelvetBird
 			auto item = static_cast<PurplePlugin*> (protos->data);
 			protos = protos->next;
 
-			const auto& proto = std::make_shared<Protocol> (item, Proxy_);
+			const auto& proto = std::make_shared<Protocol> (item, Proxy_, AzothProxy_);
 			const auto& purpleId = proto->GetPurpleID ();
 
 			if (purpleId == "prpl-jabber" || purpleId == "prpl-irc")
@@ -40,6 +40,8 @@ struct Entity;
 
 namespace Azoth
 {
+class IProxyObject;
+
 namespace VelvetBird
 {
 	class Protocol;
@@ -49,10 +51,13 @@ namespace VelvetBird
 		Q_OBJECT
 
 		ICoreProxy_ptr Proxy_;
+		IProxyObject *AzothProxy_ = nullptr;
 		QList<std::shared_ptr<Protocol>> Protocols_;
 	public:
 		ProtoManager (ICoreProxy_ptr, QObject*);
 
+		void SetAzothProxy (IProxyObject*);
+
 		void PluginsAvailable ();
 
 		void Release ();
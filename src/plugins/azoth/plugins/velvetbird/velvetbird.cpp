@@ -29,6 +29,7 @@
 
 #include "velvetbird.h"
 #include <QIcon>
+#include <interfaces/azoth/iproxyobject.h>
 #include "protomanager.h"
 
 namespace LeechCraft
@@ -106,8 +107,10 @@ namespace VelvetBird
 		return ProtoMgr_ ? ProtoMgr_->GetProtoObjs () : QList<QObject*> ();
 	}
 
-	void Plugin::initPlugin (QObject*)
+	void Plugin::initPlugin (QObject *proxy)
 	{
+		if (ProtoMgr_)
+			ProtoMgr_->SetAzothProxy (qobject_cast<IProxyObject*> (proxy));
 	}
 }
 }
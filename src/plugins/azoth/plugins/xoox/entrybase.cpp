@@ -563,7 +563,7 @@ namespace Xoox
 		const auto proxy = Account_->GetParentProtocol ()->GetProxyObject ();
 		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
-		AllMessages_ << msg;
+		StoreMessage (msg);
 		emit gotMessage (msg);
 	}
 
@@ -869,6 +869,14 @@ namespace Xoox
 		return Variant2Version_ [var];
 	}
 
+	void EntryBase::StoreMessage (GlooxMessage *msg)
+	{
+		AllMessages_ << msg;
+
+		const auto proxy = Account_->GetParentProtocol ()->GetProxyObject ();
+		AzothUtil::StandardTrimMessages (AllMessages_, proxy, &UnreadMessages_);
+	}
+
 	void EntryBase::HandleUserActivity (const UserActivity *activity, const QString& variant)
 	{
 		if (activity->GetGeneral () == UserActivity::GeneralEmpty)
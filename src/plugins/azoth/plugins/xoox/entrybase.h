@@ -222,6 +222,8 @@ namespace Xoox
 
 		QByteArray GetVariantVerString (const QString&) const;
 		QXmppVersionIq GetClientVersion (const QString&) const;
+	protected:
+		void StoreMessage (GlooxMessage*);
 	private:
 		void HandleUserActivity (const UserActivity*, const QString&);
 		void HandleUserMood (const UserMood*, const QString&);
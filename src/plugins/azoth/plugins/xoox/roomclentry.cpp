@@ -578,10 +578,11 @@ namespace Xoox
 
 	void RoomCLEntry::HandleMessage (RoomPublicMessage *msg)
 	{
-		Account_->GetParentProtocol ()->GetProxyObject ()->
-				GetFormatterProxy ().PreprocessMessage (msg);
+		const auto proxy = Account_->GetParentProtocol ()->GetProxyObject ();
+		proxy->GetFormatterProxy ().PreprocessMessage (msg);
 
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_, proxy);
 		emit gotMessage (msg);
 	}
 
@@ -109,7 +109,7 @@ namespace Xoox
 			const QString&, const QString& body)
 	{
 		const auto msg = RoomHandler_->CreateMessage (type, Nick_, body);
-		AllMessages_ << msg;
+		StoreMessage (msg);
 		return msg;
 	}
 
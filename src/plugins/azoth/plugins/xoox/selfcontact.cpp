@@ -115,7 +115,7 @@ namespace Xoox
 			const QString& variant, const QString& text)
 	{
 		const auto msg = Account_->CreateMessage (type, variant, text, GetJID ());
-		AllMessages_ << msg;
+		StoreMessage (msg);
 		return msg;
 	}
 
@@ -75,6 +75,7 @@ namespace Zheet
 	void MSNBuddyEntry::HandleMessage (MSNMessage *msg)
 	{
 		AllMessages_ << msg;
+		AzothUtil::StandardTrimMessages (AllMessages_, Core::Instance ().GetPluginProxy ());
 		emit gotMessage (msg);
 	}
 
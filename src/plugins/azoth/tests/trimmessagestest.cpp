@@ -0,0 +1,117 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "trimmessagestest.h"
+#include <memory>
+#include <vector>
+#include <QtTest>
+#include <interfaces/azoth/azothutil.h>
+
+QTEST_MAIN (LeechCraft::Azoth::TrimMessagesTest)
+
+namespace LeechCraft
+{
+namespace Azoth
+{
+	namespace
+	{
+		struct Messages
+		{
+			std::vector<std::unique_ptr<QObject>> Storage_;
+			QList<QObject*> List_;
+
+			explicit Messages (int count)
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					Storage_.emplace_back (new QObject);
+					List_ << Storage_.back ().get ();
+				}
+			}
+
+			QList<QObject*> Last (int count) const
+			{
+				return List_.mid (List_.size () - count);
+			}
+		};
+	}
+
+	void TrimMessagesTest::testUnlimited ()
+	{
+		Messages msgs { 10 };
+		auto list = msgs.List_;
+
+		QVERIFY (AzothUtil::TrimMessages (list, 0).isEmpty ());
+		QCOMPARE (list, msgs.List_);
+	}
+
+	void TrimMessagesTest::testBelowLimit ()
+	{
+		Messages msgs { 10 };
+		auto list = msgs.List_;
+
+		QVERIFY (AzothUtil::TrimMessages (list, 10).isEmpty ());
+		QCOMPARE (list, msgs.List_);
+	}
+
+	void TrimMessagesTest::testTrimsOldest ()
+	{
+		Messages msgs { 10 };
+		auto list = msgs.List_;
+
+		const auto& removed = AzothUtil::TrimMessages (list, 3);
+		QCOMPARE (list, msgs.Last (3));
+		QCOMPARE (removed, msgs.List_.mid (0, 7));
+	}
+
+	void TrimMessagesTest::testKeepsLast ()
+	{
+		Messages msgs { 2 };
+		auto list = msgs.List_;
+
+		QVERIFY (AzothUtil::TrimMessages (list, 1).size () == 1);
+		QCOMPARE (list, msgs.Last (1));
+	}
+
+	void TrimMessagesTest::testAllUnread ()
+	{
+		// Every kept message is unread, and the just added one is yet
+		// to be marked as such.
+		Messages msgs { 6 };
+		auto list = msgs.List_;
+		auto unread = msgs.List_.mid (0, 5);
+
+		const auto& removed = AzothUtil::TrimMessages (list, 5, &unread);
+		QCOMPARE (removed, msgs.List_.mid (0, 1));
+		QCOMPARE (list, msgs.Last (5));
+		QVERIFY (list.contains (msgs.List_.last ()));
+		QCOMPARE (unread, msgs.List_.mid (1, 4));
+	}
+}
+}
@@ -35,11 +35,6 @@
 #include "core.h"
 #include "chattabsmanager.h"
 
-uint qHash (const QPointer<QObject>& ptr)
-{
-	return qHash (ptr.data ());
-}
-
 namespace LeechCraft
 {
 namespace Azoth
@@ -51,25 +46,32 @@ namespace Azoth
 
 	QObject* UnreadQueueManager::GetFirstUnreadMessage (QObject* entryObj) const
 	{
-		return Entry2FirstUnread_.value (entryObj);
+		return Entry2Unread_.value (entryObj).FirstUnread_;
 	}
 
 	void UnreadQueueManager::AddMessage (QObject *msgObj)
 	{
 		const auto msg = qobject_cast<IMessage*> (msgObj);
 		const auto entryObj = msg->ParentCLEntry ();
-		if (!Queue_.contains (entryObj))
-		{
-			Queue_ << entryObj;
-			Entry2FirstUnread_ [entryObj] = msgObj;
-		}
+		if (Entry2Unread_.contains (entryObj))
+			return;
 
-		UnreadMessages_ << msgObj;
+		Queue_ << entryObj;
+		Entry2Unread_ [entryObj] = { msgObj, msg->GetDateTime () };
 	}
 
 	bool UnreadQueueManager::IsMessageRead (QObject *msgObj) const
 	{
-		return !UnreadMessages_.contains (msgObj);
+		const auto msg = qobject_cast<IMessage*> (msgObj);
+		if (!msg)
+			return true;
+
+		const auto pos = Entry2Unread_.find (msg->ParentCLEntry ());
+		if (pos == Entry2Unread_.end ())
+			return true;
+
+		return pos->FirstUnread_ != msgObj &&
+				msg->GetDateTime () < pos->Since_;
 	}
 
 	void UnreadQueueManager::ShowNext ()
@@ -96,12 +98,7 @@ namespace Azoth
 	void UnreadQueueManager::clearMessagesForEntry (QObject *entryObj)
 	{
 		Queue_.removeAll (entryObj);
-
-		for (auto pos = UnreadMessages_.begin (); pos != UnreadMessages_.end (); )
-			if (!*pos || qobject_cast<IMessage*> (*pos)->ParentCLEntry () == entryObj)
-				pos = UnreadMessages_.erase (pos);
-			else
-				++pos;
+		Entry2Unread_.remove (entryObj);
 
 		emit messagesCleared (entryObj);
 	}
@@ -30,8 +30,8 @@
 #pragma once
 
 #include <QObject>
-#include <QSet>
-#include <QMap>
+#include <QHash>
+#include <QDateTime>
 #include <QPointer>
 
 namespace LeechCraft
@@ -43,9 +43,18 @@ namespace Azoth
 		Q_OBJECT
 
 		QList<QPointer<QObject>> Queue_;
-		QSet<QPointer<QObject>> UnreadMessages_;
 
-		QMap<QObject*, QPointer<QObject>> Entry2FirstUnread_;
+		/* Only the first unread message of each entry is tracked: every
+		 * message that came after it is unread too. This way the state
+		 * doesn't grow with the number of unread messages, and entries
+		 * are free to delete the messages they don't want to keep.
+		 */
+		struct UnreadAnchor
+		{
+			QPointer<QObject> FirstUnread_;
+			QDateTime Since_;
+		};
+		QHash<QObject*, UnreadAnchor> Entry2Unread_;
 	public:
 		UnreadQueueManager (QObject* = 0);
 
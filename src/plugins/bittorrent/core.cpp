@@ -102,6 +102,8 @@
 #include "notifymanager.h"
 #include "sessionsettingsmanager.h"
 #include "cachedstatuskeeper.h"
+#include "resumedatastore.h"
+#include "sessionstore.h"
 
 Q_DECLARE_METATYPE (QMenu*)
 Q_DECLARE_METATYPE (QToolBar*)
@@ -121,7 +123,6 @@ namespace BitTorrent
 	Core::Core ()
 	: StatusKeeper_ { new CachedStatusKeeper { this } }
 	, NotifyManager_ { new NotifyManager { this } }
-	, FinishedTimer_ { new QTimer }
 	, WarningWatchdog_ { new QTimer }
 	{
 		setObjectName ("BitTorrent Core");
@@ -264,12 +265,6 @@ namespace BitTorrent
 			tr ("Ratio")
 		};
 
-		connect (FinishedTimer_.get (),
-				SIGNAL (timeout ()),
-				this,
-				SLOT (checkFinished ()));
-		FinishedTimer_->start (10000);
-
 		connect (WarningWatchdog_.get (),
 				SIGNAL (timeout ()),
 				this,
@@ -285,6 +280,9 @@ namespace BitTorrent
 				this,
 				SLOT (writeSettings ()));
 
+		ResumeDataStore_ = std::make_shared<ResumeDataStore> (Util::CreateIfNotExists ("bittorrent"));
+		SessionStore_ = std::make_shared<SessionStore> (Util::CreateIfNotExists ("bittorrent"));
+
 		RestoreTorrents ();
 	}
 
@@ -293,8 +291,9 @@ namespace BitTorrent
 		Session_->pause ();
 		writeSettings ();
 
-		FinishedTimer_.reset ();
 		WarningWatchdog_.reset ();
+		ResumeDataStore_.reset ();
+		SessionStore_.reset ();
 
 		qDeleteAll (children ());
 
@@ -1000,6 +999,8 @@ namespace BitTorrent
 
 		beginInsertRows ({}, Handles_.size (), Handles_.size ());
 		Handles_ << tmp;
+		Handles_.last ().SavePath_ = path;
+		ReindexHandles (Handles_.size () - 1);
 		endInsertRows ();
 
 		return tmp.ID_;
@@ -1085,8 +1086,12 @@ namespace BitTorrent
 				newId,
 				params
 			});
+		Handles_.last ().SavePath_ = path;
+		ReindexHandles (Handles_.size () - 1);
 		endInsertRows ();
 
+		SessionStore_->WriteTorrentFile (torrentFileName, contents);
+
 		if (tryLive)
 		{
 			LiveStreamManager_->EnableOn (handle);
@@ -1118,8 +1123,11 @@ namespace BitTorrent
 
 		beginRemoveRows (QModelIndex (), pos, pos);
 		Session_->remove_torrent (Handles_.at (pos).Handle_, roptions);
+		ResumeDataStore_->Remove (Handles_.at (pos).TorrentFileName_);
 		int id = Handles_.at (pos).ID_;
+		HandleIndex_.Remove (Handles_.at (pos).Handle_);
 		Handles_.removeAt (pos);
+		ReindexHandles (pos);
 		Proxy_->FreeID (id);
 		endRemoveRows ();
 
@@ -1134,7 +1142,6 @@ namespace BitTorrent
 
 		Handles_.at (pos).Handle_.pause ();
 		Handles_.at (pos).Handle_.auto_managed (false);
-		checkFinished ();
 	}
 
 	void Core::ResumeTorrent (int pos)
@@ -1145,7 +1152,6 @@ namespace BitTorrent
 		Handles_.at (pos).Handle_.resume ();
 		Handles_ [pos].State_ = TSIdle;
 		Handles_.at (pos).Handle_.auto_managed (Handles_.at (pos).AutoManaged_);
-		checkFinished ();
 	}
 
 	void Core::ForceReannounce (int pos)
@@ -1471,23 +1477,11 @@ namespace BitTorrent
 			return;
 		}
 
-		const auto& filePath = Util::CreateIfNotExists ("bittorrent")
-				.filePath (torrent->TorrentFileName_ + ".resume");
-		QFile file { filePath };
-
-		if (!file.open (QIODevice::WriteOnly))
-		{
-			qWarning () << QString ("Could not open file %1 for write: %2")
-				.arg (file.fileName ())
-				.arg (file.errorString ());
-			return;
-		}
-
-		std::deque<char> outbuf;
+		std::vector<char> outbuf;
 		libtorrent::bencode (std::back_inserter (outbuf), *a.resume_data.get ());
 
-		for (size_t i = 0; i < outbuf.size (); ++i)
-			file.write (&outbuf.at (i), 1);
+		ResumeDataStore_->Save (torrent->TorrentFileName_,
+				QByteArray (outbuf.data (), outbuf.size ()));
 	}
 
 	void Core::HandleMetadata (const libtorrent::metadata_received_alert& a)
@@ -1519,6 +1513,7 @@ namespace BitTorrent
 		libtorrent::entry e;
 		e ["info"] = infoE;
 		libtorrent::bencode (std::back_inserter (torrent->TorrentFileContents_), e);
+		SessionStore_->WriteTorrentFile (torrent->TorrentFileName_, torrent->TorrentFileContents_);
 
 		qDebug () << "HandleMetadata"
 			<< std::distance (Handles_.begin (), torrent)
@@ -1546,6 +1541,7 @@ namespace BitTorrent
 			}
 
 			const auto row = std::distance (Handles_.begin (), pos);
+			UpdateTorrentState (row, status);
 			emit dataChanged (index (row, 0), index (row, columnCount () - 1));
 		}
 	}
@@ -1585,6 +1581,7 @@ namespace BitTorrent
 			Handles_.at (*i).Handle_.queue_position_up ();
 			std::swap (Handles_ [*i],
 					Handles_ [*i - 1]);
+			ReindexHandles (*i - 1, *i + 1);
 
 			emit dataChanged (index (*i - 1, 0),
 					index (*i, columnCount () - 1));
@@ -1607,6 +1604,7 @@ namespace BitTorrent
 			Handles_.at (*i).Handle_.queue_position_down ();
 			std::swap (Handles_ [*i],
 					Handles_ [*i + 1]);
+			ReindexHandles (*i, *i + 2);
 
 			emit dataChanged (index (*i, 0),
 					index (*i + 1, columnCount () - 1));
@@ -1700,14 +1698,34 @@ namespace BitTorrent
 
 	auto Core::FindHandle (const libtorrent::torrent_handle& h) -> HandleDict_t::iterator
 	{
-		return std::find_if (Handles_.begin (), Handles_.end (),
-				[&h] (const TorrentStruct& ts) { return ts.Handle_ == h; });
+		const auto row = HandleIndex_.Find (h);
+		return row >= 0 ? Handles_.begin () + row : Handles_.end ();
 	}
 
 	auto Core::FindHandle (const libtorrent::torrent_handle& h) const -> HandleDict_t::const_iterator
 	{
-		return std::find_if (Handles_.begin (), Handles_.end (),
-				[&h] (const TorrentStruct& ts) { return ts.Handle_ == h; });
+		const auto row = HandleIndex_.Find (h);
+		return row >= 0 ? Handles_.begin () + row : Handles_.end ();
+	}
+
+	void Core::ReindexHandles (int from, int to)
+	{
+		HandleIndex_.Reindex (Handles_,
+				[] (const TorrentStruct& ts) { return ts.Handle_; },
+				from, to);
+	}
+
+	void Core::UpdateTorrentState (int row, const libtorrent::torrent_status& status)
+	{
+		auto& torrent = Handles_ [row];
+		const auto oldState = torrent.State_;
+		torrent.State_ = GetNextState (oldState, status);
+
+		if (oldState == TSDownloading && torrent.State_ == TSSeeding)
+		{
+			HandleSingleFinished (row);
+			ScheduleSave ();
+		}
 	}
 
 	void Core::MoveToTop (int row)
@@ -1720,6 +1738,7 @@ namespace BitTorrent
 
 		beginInsertRows (QModelIndex (), 0, 0);
 		Handles_.push_front (tmp);
+		ReindexHandles (0, row + 1);
 		endInsertRows ();
 	}
 
@@ -1733,9 +1752,36 @@ namespace BitTorrent
 
 		beginInsertRows (QModelIndex (), Handles_.size (), Handles_.size ());
 		Handles_.push_back (tmp);
+		ReindexHandles (row);
 		endInsertRows ();
 	}
 
+	namespace
+	{
+		QList<TorrentRecord> LoadLegacyRecords (QSettings& settings)
+		{
+			QList<TorrentRecord> result;
+
+			int torrents = settings.beginReadArray ("AddedTorrents");
+			for (int i = 0; i < torrents; ++i)
+			{
+				settings.setArrayIndex (i);
+
+				TorrentRecord record;
+				record.Filename_ = settings.value ("Filename").toString ();
+				record.SavePath_ = settings.value ("SavePath").toString ();
+				record.Tags_ = settings.value ("Tags").toStringList ();
+				record.Parameters_ = settings.value ("Parameters").toInt ();
+				record.AutoManaged_ = settings.value ("AutoManaged", true).toBool ();
+				record.Priorities_ = settings.value ("Priorities").toByteArray ();
+				result << record;
+			}
+			settings.endArray ();
+
+			return result;
+		}
+	}
+
 	void Core::RestoreTorrents ()
 	{
 		const auto& torrentsDir = Util::CreateIfNotExists ("bittorrent");
@@ -1743,14 +1789,15 @@ namespace BitTorrent
 		QSettings settings (QCoreApplication::organizationName (),
 				QCoreApplication::applicationName () + "_Torrent");
 		settings.beginGroup ("Core");
-		int torrents = settings.beginReadArray ("AddedTorrents");
-		qDebug () << Q_FUNC_INFO << "gonna restore" << torrents << "torrents";
-		for (int i = 0; i < torrents; ++i)
+
+		const auto& records = SessionStore_->Exists () ?
+				SessionStore_->Load () :
+				LoadLegacyRecords (settings);
+		qDebug () << Q_FUNC_INFO << "gonna restore" << records.size () << "torrents";
+		for (const auto& record : records)
 		{
-			settings.setArrayIndex (i);
-			const auto& pathStr = settings.value ("SavePath").toString ();
-			const auto& path = std::string (pathStr.toUtf8 ().constData ());
-			QString filename = settings.value ("Filename").toString ();
+			const auto& path = std::string (record.SavePath_.toUtf8 ().constData ());
+			const auto& filename = record.Filename_;
 			QFile torrent (torrentsDir.filePath (filename));
 			if (!torrent.open (QIODevice::ReadOnly))
 			{
@@ -1767,17 +1814,10 @@ namespace BitTorrent
 				continue;
 			}
 
-			QFile resumeDataFile (torrentsDir.filePath (filename + ".resume"));
-			QByteArray resumed;
-			if (resumeDataFile.open (QIODevice::ReadOnly))
-			{
-				resumed = resumeDataFile.readAll ();
-				resumeDataFile.close ();
-			}
+			const auto& resumed = ResumeDataStore_->Load (filename);
 
-			bool automanaged = settings.value ("AutoManaged", true).toBool ();
-			TaskParameters taskParameters = static_cast<TaskParameters> (settings
-						.value ("Parameters").toInt ());
+			const auto automanaged = record.AutoManaged_;
+			const auto taskParameters = static_cast<TaskParameters> (record.Parameters_);
 
 			auto handle = RestoreSingleTorrent (data,
 					resumed,
@@ -1793,8 +1833,7 @@ namespace BitTorrent
 			}
 
 			std::vector<int> priorities;
-			QByteArray prioritiesLine = settings.value ("Priorities").toByteArray ();
-			std::copy (prioritiesLine.begin (), prioritiesLine.end (),
+			std::copy (record.Priorities_.begin (), record.Priorities_.end (),
 					std::back_inserter (priorities));
 
 			if (priorities.empty ())
@@ -1820,15 +1859,16 @@ namespace BitTorrent
 					handle,
 					data,
 					filename,
-					settings.value ("Tags").toStringList (),
+					record.Tags_,
 					automanaged,
 					Proxy_->GetID (),
 					taskParameters
 				});
+			Handles_.last ().SavePath_ = record.SavePath_;
+			ReindexHandles (Handles_.size () - 1);
 			endInsertRows ();
 			qDebug () << "restored a torrent";
 		}
-		settings.endArray ();
 
 		int filters = settings.beginReadArray ("IPFilter");
 		for (int i = 0; i < filters; ++i)
@@ -1982,6 +2022,20 @@ namespace BitTorrent
 		emit taskFinished (torrent.ID_);
 	}
 
+	void Core::HandleStorageMoved (const libtorrent::storage_moved_alert& a)
+	{
+		const auto pos = FindHandle (a.handle);
+		if (pos == Handles_.end ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown handle";
+			return;
+		}
+
+		pos->SavePath_ = QString::fromUtf8 (a.path.c_str ());
+		ScheduleSave ();
+	}
+
 	void Core::HandleFileRenamed (const libtorrent::file_renamed_alert& a)
 	{
 		const auto pos = FindHandle (a.handle);
@@ -2047,15 +2101,12 @@ namespace BitTorrent
 	{
 		SaveScheduled_ = false;
 
-		const auto& torrentsDir = Util::CreateIfNotExists ("bittorrent");
+		if (!SessionStore_)
+			return;
 
-		QSettings settings (QCoreApplication::organizationName (),
-				QCoreApplication::applicationName () + "_Torrent");
-		settings.beginGroup ("Core");
-		settings.beginWriteArray ("AddedTorrents");
+		QList<TorrentRecord> records;
 		for (int i = 0; i < Handles_.size (); ++i)
 		{
-			settings.setArrayIndex (i);
 			if (!CheckValidity (i))
 			{
 				qWarning () << Q_FUNC_INFO
@@ -2063,7 +2114,9 @@ namespace BitTorrent
 					<< i;
 				continue;
 			}
-			if (Handles_.at (i).TorrentFileName_.isEmpty ())
+
+			const auto& torrent = Handles_.at (i);
+			if (torrent.TorrentFileName_.isEmpty ())
 			{
 				qWarning () << Q_FUNC_INFO
 					<< "empty file name"
@@ -2074,41 +2127,20 @@ namespace BitTorrent
 			CurrentTorrent_ = i;
 			try
 			{
-				QFile file_info (torrentsDir.filePath (Handles_.at (i).TorrentFileName_));
-				if (!file_info.open (QIODevice::WriteOnly))
-					ShowError (QString ("Cannot write settings! "
-								"Cannot open file %1 for write!")
-							.arg (Handles_.at (i).TorrentFileName_));
-				else
-				{
-					file_info.write (Handles_.at (i).TorrentFileContents_);
-					file_info.close ();
-
-					const auto& handle = Handles_.at (i).Handle_;
-					if (handle.need_save_resume_data ())
-						handle.save_resume_data ();
-
-					const auto& savePath = StatusKeeper_->GetStatus (handle,
-								libtorrent::torrent_handle::query_save_path).save_path;
-					settings.setValue ("SavePath",
-							QString::fromUtf8 (savePath.c_str ()));
-					settings.setValue ("Filename",
-							Handles_.at (i).TorrentFileName_);
-					settings.setValue ("Tags",
-							Handles_.at (i).Tags_);
-					settings.setValue ("ID",
-							Handles_.at (i).ID_);
-					settings.setValue ("Parameters",
-							static_cast<int> (Handles_.at (i).Parameters_));
-					settings.setValue ("AutoManaged",
-							Handles_.at (i).AutoManaged_);
-
-					QByteArray prioritiesLine;
-					std::copy (Handles_.at (i).FilePriorities_.begin (),
-							Handles_.at (i).FilePriorities_.end (),
-							std::back_inserter (prioritiesLine));
-					settings.setValue ("Priorities", prioritiesLine);
-				}
+				const auto& handle = torrent.Handle_;
+				if (handle.need_save_resume_data ())
+					handle.save_resume_data ();
+
+				TorrentRecord record;
+				record.Filename_ = torrent.TorrentFileName_;
+				record.SavePath_ = torrent.SavePath_;
+				record.Tags_ = torrent.Tags_;
+				record.Parameters_ = static_cast<int> (torrent.Parameters_);
+				record.AutoManaged_ = torrent.AutoManaged_;
+				std::copy (torrent.FilePriorities_.begin (),
+						torrent.FilePriorities_.end (),
+						std::back_inserter (record.Priorities_));
+				records << record;
 			}
 			catch (const std::exception& e)
 			{
@@ -2120,7 +2152,16 @@ namespace BitTorrent
 			}
 			CurrentTorrent_ = oldCurrent;
 		}
-		settings.endArray ();
+
+		SessionStore_->Sync (records);
+
+		QSettings settings (QCoreApplication::organizationName (),
+				QCoreApplication::applicationName () + "_Torrent");
+		settings.beginGroup ("Core");
+
+		// The torrents list has been migrated to the session journal.
+		if (settings.contains ("AddedTorrents/size"))
+			settings.remove ("AddedTorrents");
 
 		settings.beginWriteArray ("IPFilter");
 		settings.remove ("");
@@ -2151,48 +2192,6 @@ namespace BitTorrent
 		queryLibtorrentForWarnings ();
 	}
 
-	void Core::checkFinished ()
-	{
-		for (int i = 0; i < Handles_.size (); ++i)
-		{
-			if (Handles_.at (i).State_ == TSSeeding)
-				continue;
-
-			const auto& status = Handles_.at (i).Handle_.status (0);
-			libtorrent::torrent_status::state_t state = status.state;
-
-			if (status.paused)
-			{
-				Handles_ [i].State_ = TSIdle;
-				continue;
-			}
-
-			switch (state)
-			{
-				case libtorrent::torrent_status::queued_for_checking:
-				case libtorrent::torrent_status::checking_files:
-				case libtorrent::torrent_status::checking_resume_data:
-				case libtorrent::torrent_status::allocating:
-				case libtorrent::torrent_status::downloading_metadata:
-					Handles_ [i].State_ = TSPreparing;
-					break;
-				case libtorrent::torrent_status::downloading:
-					Handles_ [i].State_ = TSDownloading;
-					break;
-				case libtorrent::torrent_status::finished:
-				case libtorrent::torrent_status::seeding:
-					TorrentState oldState = Handles_ [i].State_;
-					Handles_ [i].State_ = TSSeeding;
-					if (oldState == TSDownloading)
-					{
-						HandleSingleFinished (i);
-						ScheduleSave ();
-					}
-					break;
-			}
-		}
-	}
-
 	struct SimpleDispatcher
 	{
 		mutable bool NeedToLog_ = true;
@@ -2232,6 +2231,8 @@ namespace BitTorrent
 					.arg (GetTorrentName (a.handle))
 					.arg (QString::fromUtf8 (a.path.c_str ()));
 			IEM_->HandleEntity (Util::MakeNotification ("BitTorrent", text, PInfo_));
+
+			Core::Instance ()->HandleStorageMoved (a);
 		}
 
 		void operator() (const libtorrent::storage_moved_failed_alert& a) const
@@ -42,12 +42,15 @@
 #include <libtorrent/torrent_info.hpp>
 #include <libtorrent/torrent_handle.hpp>
 #include <libtorrent/session_status.hpp>
+#include <boost/functional/hash.hpp>
 #include <interfaces/iinfo.h>
 #include <interfaces/structures.h>
 #include <util/tags/tagscompletionmodel.h>
 #include "torrentinfo.h"
 #include "fileinfo.h"
 #include "peerinfo.h"
+#include "torrentstate.h"
+#include "rowindex.h"
 
 class QTimer;
 class QDomElement;
@@ -79,6 +82,8 @@ namespace BitTorrent
 	class LiveStreamManager;
 	class SessionSettingsManager;
 	class CachedStatusKeeper;
+	class ResumeDataStore;
+	class SessionStore;
 	struct NewTorrentParams;
 
 	using BanRange_t = QPair<QString, QString>;
@@ -87,20 +92,16 @@ namespace BitTorrent
 	{
 		Q_OBJECT
 
-		enum TorrentState
-		{
-			TSIdle,
-			TSPreparing,
-			TSDownloading,
-			TSSeeding
-		};
-
 		struct TorrentStruct
 		{
 			std::vector<int> FilePriorities_ = {};
 			libtorrent::torrent_handle Handle_;
 			QByteArray TorrentFileContents_ = {};
 			QString TorrentFileName_ = {};
+			/** The save path, kept up to date on storage moves so that
+				* saving the session doesn't query each torrent for it.
+				*/
+			QString SavePath_ = {};
 			TorrentState State_ = TSIdle;
 			double Ratio_ = 0;
 			/** Holds the IDs of tags of the torrent.
@@ -162,10 +163,13 @@ namespace BitTorrent
 
 		typedef QList<TorrentStruct> HandleDict_t;
 		HandleDict_t Handles_;
+		RowIndex<libtorrent::torrent_handle, boost::hash<libtorrent::torrent_handle>> HandleIndex_;
 		QList<QString> Headers_;
 		mutable int CurrentTorrent_ = -1;
-		std::shared_ptr<QTimer> FinishedTimer_, WarningWatchdog_;
+		std::shared_ptr<QTimer> WarningWatchdog_;
 		std::shared_ptr<LiveStreamManager> LiveStreamManager_;
+		std::shared_ptr<ResumeDataStore> ResumeDataStore_;
+		std::shared_ptr<SessionStore> SessionStore_;
 		QString ExternalAddress_;
 		bool SaveScheduled_ = false;
 		QToolBar *Toolbar_ = nullptr;
@@ -330,6 +334,7 @@ namespace BitTorrent
 
 		void SaveResumeData (const libtorrent::save_resume_data_alert&) const;
 		void HandleMetadata (const libtorrent::metadata_received_alert&);
+		void HandleStorageMoved (const libtorrent::storage_moved_alert&);
 		void PieceRead (const libtorrent::read_piece_alert&);
 		void UpdateStatus (const std::vector<libtorrent::torrent_status>&);
 
@@ -344,6 +349,8 @@ namespace BitTorrent
 	private:
 		HandleDict_t::iterator FindHandle (const libtorrent::torrent_handle&);
 		HandleDict_t::const_iterator FindHandle (const libtorrent::torrent_handle&) const;
+		void ReindexHandles (int from = 0, int to = -1);
+		void UpdateTorrentState (int, const libtorrent::torrent_status&);
 
 		void MoveToTop (int);
 		void MoveToBottom (int);
@@ -375,7 +382,6 @@ namespace BitTorrent
 		void ShowError (const QString&);
 	private slots:
 		void writeSettings ();
-		void checkFinished ();
 		void scrape ();
 	public slots:
 		void queryLibtorrentForWarnings ();
@@ -0,0 +1,144 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#include "resumedatastore.h"
+#include <QSaveFile>
+#include <QTimer>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	namespace
+	{
+		QString GetResumeFileName (const QString& torrentFileName)
+		{
+			return torrentFileName + ".resume";
+		}
+	}
+
+	ResumeDataWriter::ResumeDataWriter (const QDir& dir)
+	: Dir_ { dir }
+	{
+	}
+
+	void ResumeDataWriter::Write (const QHash<QString, QByteArray>& data)
+	{
+		for (auto i = data.begin (), end = data.end (); i != end; ++i)
+		{
+			QSaveFile file { Dir_.filePath (GetResumeFileName (i.key ())) };
+			if (!file.open (QIODevice::WriteOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "could not open"
+						<< file.fileName ()
+						<< "for write:"
+						<< file.errorString ();
+				continue;
+			}
+
+			file.write (*i);
+			if (!file.commit ())
+				qWarning () << Q_FUNC_INFO
+						<< "could not save"
+						<< file.fileName ()
+						<< file.errorString ();
+		}
+	}
+
+	void ResumeDataWriter::Remove (const QString& torrentFileName)
+	{
+		QFile file { Dir_.filePath (GetResumeFileName (torrentFileName)) };
+		if (file.exists () && !file.remove ())
+			qWarning () << Q_FUNC_INFO
+					<< "could not remove"
+					<< file.fileName ()
+					<< file.errorString ();
+	}
+
+	ResumeDataStore::ResumeDataStore (const QDir& dir, QObject *parent)
+	: QObject { parent }
+	, Dir_ { dir }
+	, Thread_ { std::make_shared<Util::WorkerThread<ResumeDataWriter>> (dir) }
+	{
+		Thread_->SetAutoQuit (true);
+		Thread_->start (QThread::LowestPriority);
+	}
+
+	ResumeDataStore::~ResumeDataStore ()
+	{
+		Flush ().waitForFinished ();
+	}
+
+	void ResumeDataStore::Save (const QString& torrentFileName, const QByteArray& data)
+	{
+		Pending_ [torrentFileName] = data;
+
+		if (FlushScheduled_)
+			return;
+
+		FlushScheduled_ = true;
+
+		// Resume data for all the torrents is typically requested at once,
+		// so wait for the rest of it to arrive before writing.
+		const int flushDelay = 1000;
+		QTimer::singleShot (flushDelay, this, [this] { Flush (); });
+	}
+
+	QByteArray ResumeDataStore::Load (const QString& torrentFileName) const
+	{
+		const auto pos = Pending_.find (torrentFileName);
+		if (pos != Pending_.end ())
+			return *pos;
+
+		QFile file { Dir_.filePath (GetResumeFileName (torrentFileName)) };
+		if (!file.open (QIODevice::ReadOnly))
+			return {};
+
+		return file.readAll ();
+	}
+
+	void ResumeDataStore::Remove (const QString& torrentFileName)
+	{
+		Pending_.remove (torrentFileName);
+		Thread_->ScheduleImpl (&ResumeDataWriter::Remove, torrentFileName);
+	}
+
+	QFuture<void> ResumeDataStore::Flush ()
+	{
+		FlushScheduled_ = false;
+
+		QHash<QString, QByteArray> pending;
+		std::swap (pending, Pending_);
+		return Thread_->ScheduleImpl (&ResumeDataWriter::Write, pending);
+	}
+}
+}
@@ -0,0 +1,102 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include <QDir>
+#include <QHash>
+#include <QByteArray>
+#include <util/threads/workerthreadbase.h>
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	class ResumeDataWriter
+	{
+		const QDir Dir_;
+	public:
+		ResumeDataWriter (const QDir&);
+
+		void Write (const QHash<QString, QByteArray>&);
+		void Remove (const QString&);
+	};
+
+	/** @brief Persists torrents' resume data off the GUI thread.
+	 *
+	 * Save requests are collected for a short while before being written
+	 * out in a batch by a dedicated thread, and only the most recent
+	 * resume data is written if the same torrent's data is saved several
+	 * times meanwhile. Each file is replaced atomically, so a crash in
+	 * the middle of a write never leaves a truncated resume file behind.
+	 */
+	class ResumeDataStore : public QObject
+	{
+		const QDir Dir_;
+		const std::shared_ptr<Util::WorkerThread<ResumeDataWriter>> Thread_;
+
+		QHash<QString, QByteArray> Pending_;
+		bool FlushScheduled_ = false;
+	public:
+		ResumeDataStore (const QDir& dir, QObject *parent = nullptr);
+		~ResumeDataStore ();
+
+		/** @brief Schedules saving the bencoded resume data.
+		 *
+		 * @param[in] torrentFileName The file name of the torrent the
+		 * data belongs to.
+		 * @param[in] data The bencoded resume data.
+		 */
+		void Save (const QString& torrentFileName, const QByteArray& data);
+
+		/** @brief Returns the resume data previously saved for the torrent.
+		 *
+		 * @param[in] torrentFileName The file name of the torrent.
+		 * @return The bencoded resume data, or an empty array if there
+		 * is none.
+		 */
+		QByteArray Load (const QString& torrentFileName) const;
+
+		/** @brief Removes the resume data of the torrent.
+		 *
+		 * The pending save of the data, if any, is dropped, and the file
+		 * is removed after the writes already in progress, so it is
+		 * never written back afterwards.
+		 *
+		 * @param[in] torrentFileName The file name of the torrent.
+		 */
+		void Remove (const QString& torrentFileName);
+	private:
+		QFuture<void> Flush ();
+	};
+}
+}
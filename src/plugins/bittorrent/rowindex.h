@@ -0,0 +1,86 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <unordered_map>
+#include <functional>
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	/** Maps the keys of the items of a list-like container to their
+	 * row numbers, so that looking an item up by its key doesn't need
+	 * a linear scan.
+	 *
+	 * The index doesn't track the container by itself: the owner is
+	 * expected to call Reindex() for the affected range of rows (and
+	 * Remove() for the removed keys) after any structural change.
+	 */
+	template<typename Key, typename Hash = std::hash<Key>>
+	class RowIndex
+	{
+		std::unordered_map<Key, int, Hash> Key2Row_;
+	public:
+		/** Updates the rows in [from; to) of the given container.
+		 *
+		 * If to is negative, the rows up to the end of the container
+		 * are updated.
+		 */
+		template<typename Cont, typename KeyGetter>
+		void Reindex (const Cont& cont, KeyGetter&& getter, int from = 0, int to = -1)
+		{
+			if (to < 0 || to > cont.size ())
+				to = cont.size ();
+			for (int i = from; i < to; ++i)
+				Key2Row_ [getter (cont.at (i))] = i;
+		}
+
+		void Remove (const Key& key)
+		{
+			Key2Row_.erase (key);
+		}
+
+		void Clear ()
+		{
+			Key2Row_.clear ();
+		}
+
+		/** Returns the row of the item with the given key, or -1 if
+		 * there is no such item.
+		 */
+		int Find (const Key& key) const
+		{
+			const auto pos = Key2Row_.find (key);
+			return pos == Key2Row_.end () ? -1 : pos->second;
+		}
+	};
+}
+}
@@ -0,0 +1,479 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "sessionstore.h"
+#include <algorithm>
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	bool operator== (const TorrentRecord& r1, const TorrentRecord& r2)
+	{
+		return r1.Filename_ == r2.Filename_ &&
+				r1.SavePath_ == r2.SavePath_ &&
+				r1.Tags_ == r2.Tags_ &&
+				r1.Parameters_ == r2.Parameters_ &&
+				r1.AutoManaged_ == r2.AutoManaged_ &&
+				r1.Priorities_ == r2.Priorities_;
+	}
+
+	bool operator!= (const TorrentRecord& r1, const TorrentRecord& r2)
+	{
+		return !(r1 == r2);
+	}
+
+	QDataStream& operator<< (QDataStream& out, const TorrentRecord& r)
+	{
+		return out << r.Filename_
+				<< r.SavePath_
+				<< r.Tags_
+				<< static_cast<qint32> (r.Parameters_)
+				<< r.AutoManaged_
+				<< r.Priorities_;
+	}
+
+	QDataStream& operator>> (QDataStream& in, TorrentRecord& r)
+	{
+		qint32 params = 0;
+		in >> r.Filename_
+				>> r.SavePath_
+				>> r.Tags_
+				>> params
+				>> r.AutoManaged_
+				>> r.Priorities_;
+		r.Parameters_ = params;
+		return in;
+	}
+
+	namespace
+	{
+		const QString JournalName = "session.journal";
+		const QString JournalBackupName = "session.journal.bak";
+
+		const quint32 JournalMagic = 0x4c43534a;
+		const quint8 JournalVersion = 1;
+
+		/* The journal isn't compacted until it has at least this many
+		 * entries, and twice as many entries as there are torrents.
+		 */
+		const int CompactThreshold = 256;
+
+		enum class Op : quint8
+		{
+			Upsert,
+			Remove,
+			Order
+		};
+
+		QDataStream& operator<< (QDataStream& out, Op op)
+		{
+			return out << static_cast<quint8> (op);
+		}
+
+		void SetupStream (QDataStream& stream)
+		{
+			stream.setVersion (QDataStream::Qt_5_0);
+		}
+
+		template<typename T>
+		void WriteEntry (QDataStream& out, Op op, const T& data)
+		{
+			QByteArray payload;
+			{
+				QDataStream entryOut { &payload, QIODevice::WriteOnly };
+				SetupStream (entryOut);
+				entryOut << op << data;
+			}
+
+			out << static_cast<quint32> (payload.size ())
+					<< qChecksum (payload.constData (), payload.size ());
+			out.writeRawData (payload.constData (), payload.size ());
+		}
+
+		bool BackupJournal (const QDir& dir)
+		{
+			const auto& backupPath = dir.filePath (JournalBackupName);
+			if (QFile::exists (backupPath) && !QFile::remove (backupPath))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to remove the previous backup"
+						<< backupPath;
+				return false;
+			}
+
+			if (!QFile::copy (dir.filePath (JournalName), backupPath))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to back up the journal to"
+						<< backupPath;
+				return false;
+			}
+
+			qWarning () << Q_FUNC_INFO
+					<< "the damaged journal has been kept as"
+					<< backupPath;
+			return true;
+		}
+	}
+
+	SessionStore::SessionStore (const QDir& dir)
+	: Dir_ { dir }
+	{
+	}
+
+	bool SessionStore::Exists () const
+	{
+		return Dir_.exists (JournalName);
+	}
+
+	QList<TorrentRecord> SessionStore::Load ()
+	{
+		Records_.clear ();
+		Order_.clear ();
+		JournalEntries_ = 0;
+		Frozen_ = false;
+
+		QFile file { Dir_.filePath (JournalName) };
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return {};
+		}
+
+		QDataStream in { &file };
+		SetupStream (in);
+
+		quint32 magic = 0;
+		quint8 version = 0;
+		in >> magic >> version;
+		if (magic != JournalMagic || version != JournalVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown journal format"
+					<< magic
+					<< version;
+
+			// Don't append to a file we can't read, but don't lose it either.
+			file.close ();
+			if (BackupJournal (Dir_))
+				QFile::remove (file.fileName ());
+			else
+				Frozen_ = true;
+			return {};
+		}
+
+		/* A damaged entry at the very end is what a crash in the middle
+		 * of an append leaves behind, and it's just dropped. Anything
+		 * else means entries we could not parse, so the original journal
+		 * is kept aside before it's rewritten.
+		 */
+		bool truncatedTail = false;
+		bool damaged = false;
+
+		while (!in.atEnd ())
+		{
+			quint32 size = 0;
+			quint16 checksum = 0;
+			in >> size >> checksum;
+			if (in.status () != QDataStream::Ok ||
+					size > static_cast<quint64> (file.bytesAvailable ()))
+			{
+				truncatedTail = true;
+				break;
+			}
+
+			QByteArray payload (static_cast<int> (size), 0);
+			in.readRawData (payload.data (), payload.size ());
+
+			if (qChecksum (payload.constData (), payload.size ()) != checksum ||
+					!ReadEntry (payload))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "skipping a corrupt journal entry after"
+						<< JournalEntries_
+						<< "entries";
+				damaged = true;
+				continue;
+			}
+
+			++JournalEntries_;
+		}
+
+		if (truncatedTail || damaged)
+			qWarning () << Q_FUNC_INFO
+					<< "the journal is"
+					<< (damaged ? "damaged" : "truncated")
+					<< "after"
+					<< JournalEntries_
+					<< "entries";
+
+		QList<TorrentRecord> result;
+		QSet<QString> seen;
+		for (const auto& filename : Order_)
+			if (Records_.contains (filename) && !seen.contains (filename))
+			{
+				result << Records_ [filename];
+				seen << filename;
+			}
+
+		for (const auto& record : Records_)
+			if (!seen.contains (record.Filename_))
+				result << record;
+
+		Order_.clear ();
+		for (const auto& record : result)
+			Order_ << record.Filename_;
+
+		file.close ();
+
+		if (damaged && !BackupJournal (Dir_))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "not touching the journal until it is backed up";
+			Frozen_ = true;
+			return result;
+		}
+
+		if (truncatedTail || damaged ||
+				JournalEntries_ > std::max (CompactThreshold, 2 * Records_.size ()))
+			Compact ();
+
+		return result;
+	}
+
+	void SessionStore::Sync (const QList<TorrentRecord>& records)
+	{
+		QByteArray journal;
+		QDataStream out { &journal, QIODevice::WriteOnly };
+		SetupStream (out);
+
+		int entries = 0;
+
+		QStringList order;
+		QSet<QString> present;
+		for (const auto& record : records)
+		{
+			order << record.Filename_;
+			present << record.Filename_;
+
+			const auto pos = Records_.find (record.Filename_);
+			if (pos == Records_.end () || *pos != record)
+			{
+				WriteEntry (out, Op::Upsert, record);
+				++entries;
+			}
+		}
+
+		QStringList removed;
+		for (auto i = Records_.begin (), end = Records_.end (); i != end; ++i)
+			if (!present.contains (i.key ()))
+			{
+				WriteEntry (out, Op::Remove, i.key ());
+				removed << i.key ();
+				++entries;
+			}
+
+		if (order != Order_)
+		{
+			WriteEntry (out, Op::Order, order);
+			++entries;
+		}
+
+		if (!entries)
+			return;
+
+		if (Frozen_)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "the journal is damaged and could not be backed up, not saving";
+			return;
+		}
+
+		const bool appended = Append (journal);
+
+		for (const auto& record : records)
+			Records_ [record.Filename_] = record;
+		for (const auto& filename : removed)
+			Records_.remove (filename);
+		Order_ = order;
+
+		JournalEntries_ += entries;
+
+		// A failed append might have left a partial entry behind.
+		if (!appended || JournalEntries_ > std::max (CompactThreshold, 2 * Records_.size ()))
+			Compact ();
+	}
+
+	bool SessionStore::WriteTorrentFile (const QString& filename, const QByteArray& contents) const
+	{
+		QSaveFile file { Dir_.filePath (filename) };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not open"
+					<< file.fileName ()
+					<< "for write:"
+					<< file.errorString ();
+			return false;
+		}
+
+		file.write (contents);
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not save"
+					<< file.fileName ()
+					<< file.errorString ();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool SessionStore::Append (const QByteArray& entries)
+	{
+		QFile file { Dir_.filePath (JournalName) };
+		const bool isNew = !file.exists ();
+		if (!file.open (QIODevice::WriteOnly | QIODevice::Append))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not open"
+					<< file.fileName ()
+					<< "for append:"
+					<< file.errorString ();
+			return false;
+		}
+
+		if (isNew)
+		{
+			QDataStream out { &file };
+			SetupStream (out);
+			out << JournalMagic << JournalVersion;
+		}
+
+		if (file.write (entries) != entries.size () || !file.flush ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not write journal entries to"
+					<< file.fileName ()
+					<< file.errorString ();
+			return false;
+		}
+
+		return true;
+	}
+
+	void SessionStore::Compact ()
+	{
+		QSaveFile file { Dir_.filePath (JournalName) };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not open"
+					<< file.fileName ()
+					<< "for write:"
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		SetupStream (out);
+		out << JournalMagic << JournalVersion;
+		for (const auto& filename : Order_)
+			WriteEntry (out, Op::Upsert, Records_ [filename]);
+		WriteEntry (out, Op::Order, Order_);
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "could not save"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		JournalEntries_ = Order_.size () + 1;
+	}
+
+	bool SessionStore::ReadEntry (QDataStream& in)
+	{
+		quint8 op = 0;
+		in >> op;
+
+		switch (static_cast<Op> (op))
+		{
+		case Op::Upsert:
+		{
+			TorrentRecord record;
+			in >> record;
+			if (in.status () == QDataStream::Ok)
+				Records_ [record.Filename_] = record;
+			break;
+		}
+		case Op::Remove:
+		{
+			QString filename;
+			in >> filename;
+			if (in.status () == QDataStream::Ok)
+				Records_.remove (filename);
+			break;
+		}
+		case Op::Order:
+		{
+			QStringList order;
+			in >> order;
+			if (in.status () == QDataStream::Ok)
+				Order_ = order;
+			break;
+		}
+		default:
+			in.setStatus (QDataStream::ReadCorruptData);
+			break;
+		}
+
+		return in.status () == QDataStream::Ok;
+	}
+
+	bool SessionStore::ReadEntry (const QByteArray& payload)
+	{
+		QDataStream in { payload };
+		SetupStream (in);
+		return ReadEntry (in) && in.atEnd ();
+	}
+}
+}
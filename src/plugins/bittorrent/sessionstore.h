@@ -0,0 +1,127 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QDir>
+#include <QHash>
+#include <QStringList>
+#include <QByteArray>
+
+class QDataStream;
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	/** @brief The persistent metadata of a single torrent in the session.
+	 */
+	struct TorrentRecord
+	{
+		QString Filename_;
+		QString SavePath_;
+		QStringList Tags_;
+		int Parameters_ = 0;
+		bool AutoManaged_ = true;
+		QByteArray Priorities_;
+	};
+
+	bool operator== (const TorrentRecord&, const TorrentRecord&);
+	bool operator!= (const TorrentRecord&, const TorrentRecord&);
+
+	QDataStream& operator<< (QDataStream&, const TorrentRecord&);
+	QDataStream& operator>> (QDataStream&, TorrentRecord&);
+
+	/** @brief Journaled storage of the session's torrents list.
+	 *
+	 * The list of torrents is kept in an append-only journal: syncing
+	 * the store with the current session only appends the records of
+	 * the torrents that have been added, changed or removed since the
+	 * previous sync, so the cost of a save depends on the size of the
+	 * change rather than on the size of the session. The journal is
+	 * compacted into a snapshot once it grows much larger than the
+	 * session itself.
+	 *
+	 * The .torrent files are stored alongside the journal and are
+	 * written only once, when the torrent is added.
+	 */
+	class SessionStore
+	{
+		const QDir Dir_;
+
+		QHash<QString, TorrentRecord> Records_;
+		QStringList Order_;
+		int JournalEntries_ = 0;
+		bool Frozen_ = false;
+	public:
+		SessionStore (const QDir& dir);
+
+		/** @brief Checks whether the journal has ever been written.
+		 *
+		 * If it hasn't, the session should be restored from the legacy
+		 * settings-based storage.
+		 */
+		bool Exists () const;
+
+		/** @brief Reads the journal and returns the records in order.
+		 *
+		 * A truncated trailing entry (say, after a crash in the middle
+		 * of a write) is ignored. Corrupt entries in the middle are
+		 * skipped, and the journal is copied to session.journal.bak
+		 * before being compacted, so nothing that could not be parsed is
+		 * lost.
+		 */
+		QList<TorrentRecord> Load ();
+
+		/** @brief Brings the journal in sync with the given records.
+		 *
+		 * Only the differences from the previously synced state are
+		 * written.
+		 *
+		 * @param[in] records The records of the torrents in the session,
+		 * in the order of their queue positions.
+		 */
+		void Sync (const QList<TorrentRecord>& records);
+
+		/** @brief Writes the .torrent file of a newly added torrent.
+		 *
+		 * @param[in] filename The name of the torrent file.
+		 * @param[in] contents The bencoded contents of the file.
+		 * @return Whether the file has been written successfully.
+		 */
+		bool WriteTorrentFile (const QString& filename, const QByteArray& contents) const;
+	private:
+		bool Append (const QByteArray&);
+		void Compact ();
+
+		bool ReadEntry (QDataStream&);
+		bool ReadEntry (const QByteArray&);
+	};
+}
+}
@@ -0,0 +1,150 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "sessionstoretest.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include "sessionstore.h"
+
+QTEST_MAIN (LeechCraft::BitTorrent::SessionStoreTest)
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	namespace
+	{
+		const QString JournalName = "session.journal";
+		const QString BackupName = "session.journal.bak";
+
+		TorrentRecord MakeRecord (const QString& name)
+		{
+			TorrentRecord record;
+			record.Filename_ = name + ".torrent";
+			record.SavePath_ = "/tmp/" + name;
+			record.Tags_ = QStringList { name };
+			record.Priorities_ = QByteArray (4, 1);
+			return record;
+		}
+
+		QStringList GetNames (const QList<TorrentRecord>& records)
+		{
+			QStringList result;
+			for (const auto& record : records)
+				result << record.Filename_;
+			return result;
+		}
+
+		QByteArray ReadJournal (const QDir& dir)
+		{
+			QFile file { dir.filePath (JournalName) };
+			file.open (QIODevice::ReadOnly);
+			return file.readAll ();
+		}
+
+		void WriteJournal (const QDir& dir, const QByteArray& data)
+		{
+			QFile file { dir.filePath (JournalName) };
+			file.open (QIODevice::WriteOnly);
+			file.write (data);
+		}
+
+		/* Writes a journal with two appends: the first one adds "a", the
+		 * second one adds "b".
+		 */
+		void PrepareJournal (const QDir& dir)
+		{
+			SessionStore store { dir };
+			store.Sync ({ MakeRecord ("a") });
+			store.Sync ({ MakeRecord ("a"), MakeRecord ("b") });
+		}
+	}
+
+	void SessionStoreTest::testRoundTrip ()
+	{
+		QTemporaryDir tmp;
+		const QDir dir { tmp.path () };
+		PrepareJournal (dir);
+
+		SessionStore store { dir };
+		QVERIFY (store.Exists ());
+
+		const auto& records = store.Load ();
+		QCOMPARE (GetNames (records), (QStringList { "a.torrent", "b.torrent" }));
+		QVERIFY (records.at (0) == MakeRecord ("a"));
+		QVERIFY (records.at (1) == MakeRecord ("b"));
+		QVERIFY (!dir.exists (BackupName));
+	}
+
+	void SessionStoreTest::testTruncatedTail ()
+	{
+		QTemporaryDir tmp;
+		const QDir dir { tmp.path () };
+		PrepareJournal (dir);
+
+		auto journal = ReadJournal (dir);
+		journal.chop (3);
+		WriteJournal (dir, journal);
+
+		SessionStore store { dir };
+		QCOMPARE (GetNames (store.Load ()), (QStringList { "a.torrent", "b.torrent" }));
+		QVERIFY (!dir.exists (BackupName));
+
+		SessionStore reloaded { dir };
+		QCOMPARE (GetNames (reloaded.Load ()), (QStringList { "a.torrent", "b.torrent" }));
+	}
+
+	void SessionStoreTest::testCorruptEntry ()
+	{
+		QTemporaryDir tmp;
+		const QDir dir { tmp.path () };
+		PrepareJournal (dir);
+
+		const auto& original = ReadJournal (dir);
+
+		// Damage the name of "a" in the very first entry.
+		auto journal = original;
+		const auto pos = journal.indexOf (QByteArray ("\0a\0.\0t", 6));
+		QVERIFY (pos > 0);
+		journal [pos + 1] = 'z';
+		WriteJournal (dir, journal);
+
+		SessionStore store { dir };
+		QCOMPARE (GetNames (store.Load ()), (QStringList { "b.torrent" }));
+
+		QVERIFY (dir.exists (BackupName));
+		QFile backup { dir.filePath (BackupName) };
+		QVERIFY (backup.open (QIODevice::ReadOnly));
+		QCOMPARE (backup.readAll (), journal);
+
+		SessionStore reloaded { dir };
+		QCOMPARE (GetNames (reloaded.Load ()), (QStringList { "b.torrent" }));
+	}
+}
+}
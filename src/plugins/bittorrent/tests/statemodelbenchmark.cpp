@@ -0,0 +1,282 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "statemodelbenchmark.h"
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <QtTest>
+#include <QList>
+#include "torrentstate.h"
+#include "rowindex.h"
+
+QTEST_MAIN (LeechCraft::BitTorrent::StateModelBenchmark)
+
+namespace LeechCraft
+{
+namespace BitTorrent
+{
+	namespace
+	{
+		/* Share of torrents whose status changes between two ticks of
+		 * the update timer, which is what libtorrent reports in a
+		 * state_update_alert.
+		 */
+		const int ChangedPerMille = 20;
+
+		struct FakeTorrent
+		{
+			int Handle_;
+			TorrentState State_;
+		};
+
+		struct FakeStatus
+		{
+			int Handle_;
+			libtorrent::torrent_status Status_;
+		};
+
+		libtorrent::torrent_status MakeStatus (libtorrent::torrent_status::state_t state, bool paused = false)
+		{
+			libtorrent::torrent_status status;
+			status.state = state;
+			status.paused = paused;
+			return status;
+		}
+
+		QList<FakeTorrent> MakeTorrents (int count)
+		{
+			QList<FakeTorrent> result;
+			result.reserve (count);
+			for (int i = 0; i < count; ++i)
+				result.append ({ i * 7 + 1, TSDownloading });
+			return result;
+		}
+
+		std::vector<FakeStatus> MakeChanged (const QList<FakeTorrent>& torrents)
+		{
+			std::vector<FakeStatus> result;
+			const int step = std::max (1000 / ChangedPerMille, 1);
+			for (int i = 0; i < torrents.size (); i += step)
+				result.push_back ({
+						torrents.at (i).Handle_,
+						MakeStatus (i % 2 ?
+								libtorrent::torrent_status::seeding :
+								libtorrent::torrent_status::downloading)
+					});
+			return result;
+		}
+
+		void PopulateCounts ()
+		{
+			QTest::addColumn<int> ("count");
+
+			for (int count : { 100, 1000, 5000, 20000 })
+				QTest::newRow (QString::number (count).toLatin1 ()) << count;
+		}
+
+		auto GetHandle = [] (const FakeTorrent& t) { return t.Handle_; };
+
+		/* Models the libtorrent session thread: each call is posted to
+		 * another thread and the caller blocks until it has been run
+		 * there, which is what torrent_handle::status() and popping the
+		 * alerts do.
+		 */
+		class FakeSession
+		{
+			std::mutex Mutex_;
+			std::condition_variable Cond_;
+			std::function<void ()> Pending_;
+			bool Done_ = false;
+			bool Stop_ = false;
+
+			std::thread Thread_;
+		public:
+			FakeSession ()
+			: Thread_ { [this] { Run (); } }
+			{
+			}
+
+			~FakeSession ()
+			{
+				{
+					std::lock_guard<std::mutex> guard { Mutex_ };
+					Stop_ = true;
+				}
+				Cond_.notify_all ();
+				Thread_.join ();
+			}
+
+			template<typename F>
+			auto Call (F f) -> decltype (f ())
+			{
+				decltype (f ()) result;
+
+				std::unique_lock<std::mutex> lock { Mutex_ };
+				Pending_ = [&] { result = f (); };
+				Done_ = false;
+				Cond_.notify_all ();
+				Cond_.wait (lock, [this] { return Done_; });
+
+				return result;
+			}
+		private:
+			void Run ()
+			{
+				std::unique_lock<std::mutex> lock { Mutex_ };
+				while (true)
+				{
+					Cond_.wait (lock, [this] { return Stop_ || Pending_; });
+					if (Stop_)
+						return;
+
+					Pending_ ();
+					Pending_ = {};
+					Done_ = true;
+					Cond_.notify_all ();
+				}
+			}
+		};
+	}
+
+	void StateModelBenchmark::testStateTransitions ()
+	{
+		QCOMPARE (GetNextState (TSIdle, MakeStatus (libtorrent::torrent_status::checking_files)), TSPreparing);
+		QCOMPARE (GetNextState (TSPreparing, MakeStatus (libtorrent::torrent_status::downloading)), TSDownloading);
+		QCOMPARE (GetNextState (TSDownloading, MakeStatus (libtorrent::torrent_status::downloading, true)), TSIdle);
+		QCOMPARE (GetNextState (TSDownloading, MakeStatus (libtorrent::torrent_status::finished)), TSSeeding);
+		QCOMPARE (GetNextState (TSSeeding, MakeStatus (libtorrent::torrent_status::downloading, true)), TSSeeding);
+	}
+
+	void StateModelBenchmark::testRowIndex ()
+	{
+		auto torrents = MakeTorrents (100);
+		RowIndex<int> index;
+		index.Reindex (torrents, GetHandle);
+
+		auto check = [&]
+		{
+			for (int i = 0; i < torrents.size (); ++i)
+				QCOMPARE (index.Find (torrents.at (i).Handle_), i);
+		};
+		check ();
+
+		index.Remove (torrents.at (10).Handle_);
+		const auto removed = torrents.takeAt (10).Handle_;
+		index.Reindex (torrents, GetHandle, 10);
+		check ();
+		QCOMPARE (index.Find (removed), -1);
+
+		std::swap (torrents [20], torrents [21]);
+		index.Reindex (torrents, GetHandle, 20, 22);
+		check ();
+
+		torrents.push_front (torrents.takeAt (50));
+		index.Reindex (torrents, GetHandle, 0, 51);
+		check ();
+
+		torrents.push_back (torrents.takeAt (30));
+		index.Reindex (torrents, GetHandle, 30);
+		check ();
+	}
+
+	void StateModelBenchmark::benchmarkPolling_data ()
+	{
+		PopulateCounts ();
+	}
+
+	/* Mirrors the former behaviour: every tick the status of each
+	 * torrent is fetched from the session thread and its state is
+	 * recomputed, and each reported status is matched to its row by a
+	 * linear scan.
+	 */
+	void StateModelBenchmark::benchmarkPolling ()
+	{
+		QFETCH (int, count);
+
+		auto torrents = MakeTorrents (count);
+		const auto& polled = MakeStatus (libtorrent::torrent_status::downloading);
+		const auto& changed = MakeChanged (torrents);
+
+		FakeSession session;
+
+		QBENCHMARK
+		{
+			for (auto& torrent : torrents)
+			{
+				const auto& status = session.Call ([&polled] { return polled; });
+				torrent.State_ = GetNextState (torrent.State_, status);
+			}
+
+			const auto& reported = session.Call ([&changed] { return changed; });
+			for (const auto& status : reported)
+			{
+				const auto pos = std::find_if (torrents.begin (), torrents.end (),
+						[&status] (const FakeTorrent& t) { return t.Handle_ == status.Handle_; });
+				QVERIFY (pos != torrents.end ());
+			}
+		}
+	}
+
+	void StateModelBenchmark::benchmarkAlerts_data ()
+	{
+		PopulateCounts ();
+	}
+
+	void StateModelBenchmark::benchmarkAlerts ()
+	{
+		QFETCH (int, count);
+
+		auto torrents = MakeTorrents (count);
+		RowIndex<int> index;
+		index.Reindex (torrents, GetHandle);
+		const auto& changed = MakeChanged (torrents);
+
+		FakeSession session;
+
+		/* The changed statuses are delivered in a single alert, popped
+		 * from the session thread once per tick.
+		 */
+		QBENCHMARK
+		{
+			const auto& reported = session.Call ([&changed] { return changed; });
+			for (const auto& status : reported)
+			{
+				const auto row = index.Find (status.Handle_);
+				QVERIFY (row >= 0);
+
+				auto& torrent = torrents [row];
+				torrent.State_ = GetNextState (torrent.State_, status.Status_);
+			}
+		}
+	}
+}
+}
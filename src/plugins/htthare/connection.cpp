@@ -28,6 +28,7 @@
  **********************************************************************/
 
 #include "connection.h"
+#include <chrono>
 #include <QtDebug>
 #include "requesthandler.h"
 
@@ -35,14 +36,25 @@ namespace LeechCraft
 {
 namespace HttHare
 {
+	namespace
+	{
+		const auto IdleTimeout = std::chrono::seconds { 15 };
+		const auto MaxRequests = 100;
+
+		const auto MaxHeaderSize = 16 * 1024;
+	}
+
 	Connection::Connection (boost::asio::io_service& service,
-			const StorageManager& stMgr, IconResolver *resolver, TrManager *trMgr)
+			const StorageManager& stMgr, IconResolver *resolver,
+			DirListingCache *listingCache, TrManager *trMgr)
 	: Strand_ { service }
 	, Socket_ { service }
+	, IdleTimer_ { service }
 	, StorageMgr_ (stMgr)
 	, IconResolver_ { resolver }
+	, ListingCache_ { listingCache }
 	, TrManager_ { trMgr }
-	, Buf_ { 2 * 1024 }
+	, Buf_ { MaxHeaderSize }
 	{
 	}
 
@@ -61,6 +73,11 @@ namespace HttHare
 		return IconResolver_;
 	}
 
+	DirListingCache* Connection::GetDirListingCache () const
+	{
+		return ListingCache_;
+	}
+
 	TrManager* Connection::GetTrManager () const
 	{
 		return TrManager_;
@@ -74,6 +91,39 @@ namespace HttHare
 	void Connection::Start ()
 	{
 		auto conn = shared_from_this ();
+		Strand_.dispatch ([conn] { conn->ReadRequest (); });
+	}
+
+	bool Connection::CanKeepAlive () const
+	{
+		return HandledRequests_ < MaxRequests;
+	}
+
+	void Connection::FinishResponse (bool keepAlive)
+	{
+		auto conn = shared_from_this ();
+		Strand_.dispatch ([conn, keepAlive]
+				{
+					if (keepAlive && conn->Socket_.is_open ())
+						conn->ReadRequest ();
+					else
+						conn->Close ();
+				});
+	}
+
+	void Connection::ReadRequest ()
+	{
+		auto conn = shared_from_this ();
+
+		IdleTimer_.expires_from_now (IdleTimeout);
+		IdleTimer_.async_wait (Strand_.wrap ([conn] (const boost::system::error_code& ec)
+					{
+						if (ec != boost::asio::error::operation_aborted)
+							conn->Close ();
+					}));
+
+		// Pipelined requests may already be in the buffer, in which
+		// case the handler is invoked right away.
 		boost::asio::async_read_until (Socket_,
 				Buf_,
 				std::string { "\r\n\r\n" },
@@ -81,15 +131,38 @@ namespace HttHare
 					{ conn->HandleHeader (ec, transferred); }));
 	}
 
-	void Connection::HandleHeader (const boost::system::error_code&, unsigned long transferred)
+	void Connection::HandleHeader (const boost::system::error_code& ec, unsigned long transferred)
 	{
+		IdleTimer_.cancel ();
+
+		if (ec)
+		{
+			if (ec != boost::asio::error::eof &&
+					ec != boost::asio::error::operation_aborted)
+				qWarning () << Q_FUNC_INFO
+						<< ec.message ().c_str ();
+			Close ();
+			return;
+		}
+
 		QByteArray data;
 		data.resize (transferred);
 
 		std::istream istr (&Buf_);
 		istr.read (data.data (), transferred);
 
-		RequestHandler { shared_from_this () } (data);
+		++HandledRequests_;
+
+		(*std::make_shared<RequestHandler> (shared_from_this ())) (data);
+	}
+
+	void Connection::Close ()
+	{
+		IdleTimer_.cancel ();
+
+		boost::system::error_code ec;
+		Socket_.shutdown (boost::asio::socket_base::shutdown_both, ec);
+		Socket_.close (ec);
 	}
 }
 }
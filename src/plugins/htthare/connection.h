@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 namespace LeechCraft
 {
@@ -38,20 +39,34 @@ namespace HttHare
 {
 	class StorageManager;
 	class IconResolver;
+	class DirListingCache;
 	class TrManager;
 
+	/** @brief A persistent HTTP connection.
+	 *
+	 * Requests are read and handled one by one on the connection's
+	 * strand, so responses to pipelined requests are sent in the order
+	 * the requests came. The connection is closed after it's been idle
+	 * for a while or after a certain number of requests, or once a
+	 * response can't be followed by another one.
+	 */
 	class Connection : public std::enable_shared_from_this<Connection>
 	{
 		boost::asio::io_service::strand Strand_;
 		boost::asio::ip::tcp::socket Socket_;
+		boost::asio::steady_timer IdleTimer_;
 
 		const StorageManager& StorageMgr_;
 		IconResolver * const IconResolver_;
+		DirListingCache * const ListingCache_;
 		TrManager * const TrManager_;
 
 		boost::asio::streambuf Buf_;
+
+		int HandledRequests_ = 0;
 	public:
-		Connection (boost::asio::io_service&, const StorageManager&, IconResolver*, TrManager*);
+		Connection (boost::asio::io_service&, const StorageManager&,
+				IconResolver*, DirListingCache*, TrManager*);
 
 		Connection (const Connection&) = delete;
 		Connection& operator= (const Connection&) = delete;
@@ -59,13 +74,28 @@ namespace HttHare
 		boost::asio::ip::tcp::socket& GetSocket ();
 		boost::asio::io_service::strand& GetStrand ();
 		IconResolver* GetIconResolver () const;
+		DirListingCache* GetDirListingCache () const;
 		TrManager* GetTrManager () const;
 
 		const StorageManager& GetStorageManager () const;
 
 		void Start ();
+
+		/** @brief Whether another request could follow the current one.
+		 */
+		bool CanKeepAlive () const;
+
+		/** @brief Called once the response to the current request is
+		 * fully written.
+		 *
+		 * The next request is read if keepAlive is true, otherwise the
+		 * connection is closed. This function is thread-safe.
+		 */
+		void FinishResponse (bool keepAlive);
 	private:
+		void ReadRequest ();
 		void HandleHeader (const boost::system::error_code&, unsigned long);
+		void Close ();
 	};
 
 	typedef std::shared_ptr<Connection> Connection_ptr;
@@ -0,0 +1,244 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "dirlistingcache.h"
+#include <algorithm>
+#include <QFileInfo>
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QtDebug>
+#include <util/sys/mimedetector.h>
+#include "iconresolver.h"
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	namespace
+	{
+		const auto MaxListingAge = std::chrono::seconds { 30 };
+		const auto MaxListings = 256;
+		const auto MaxPagesPerListing = 8;
+	}
+
+	QByteArray DirListing::GetETag (const QByteArray& key) const
+	{
+		QCryptographicHash hash { QCryptographicHash::Md5 };
+		hash.addData (Digest_);
+		hash.addData (key);
+		return "W/\"" + hash.result ().toHex () + "\"";
+	}
+
+	QByteArray DirListing::GetPage (const QByteArray& key, const std::function<QByteArray ()>& render) const
+	{
+		{
+			QMutexLocker locker { &PagesLock_ };
+			const auto pos = Pages_.find (key);
+			if (pos != Pages_.end ())
+				return *pos;
+		}
+
+		const auto& page = render ();
+
+		QMutexLocker locker { &PagesLock_ };
+		if (Pages_.size () >= MaxPagesPerListing)
+			Pages_.clear ();
+		Pages_ [key] = page;
+		return page;
+	}
+
+	DirListingCache::DirListingCache (IconResolver *resolver, QObject *parent)
+	: QObject { parent }
+	, IconResolver_ { resolver }
+	, Watcher_ { new QFileSystemWatcher { this } }
+	{
+		connect (Watcher_,
+				SIGNAL (directoryChanged (QString)),
+				this,
+				SLOT (handleDirectoryChanged (QString)));
+	}
+
+	DirListing_cptr DirListingCache::Get (const QString& path, const QFileInfo& fi)
+	{
+		std::shared_ptr<DirListing> previous;
+
+		{
+			QMutexLocker locker { &Lock_ };
+			const auto pos = Listings_.find (path);
+			if (pos != Listings_.end ())
+			{
+				pos->LastAccess_ = ++AccessCounter_;
+				if (IsFresh (*pos->Listing_, fi))
+					return pos->Listing_;
+
+				previous = pos->Listing_;
+			}
+		}
+
+		const auto& listing = Build (path, fi);
+
+		if (previous &&
+				!previous->HasFallbackIcons_ &&
+				previous->Digest_ == listing->Digest_)
+		{
+			QMutexLocker locker { &previous->PagesLock_ };
+			listing->Pages_ = previous->Pages_;
+		}
+
+		Put (path, listing);
+
+		if (!previous)
+			QMetaObject::invokeMethod (this,
+					"watch",
+					Qt::QueuedConnection,
+					Q_ARG (QString, path));
+
+		return listing;
+	}
+
+	bool DirListingCache::IsFresh (const DirListing& listing, const QFileInfo& fi) const
+	{
+		if (listing.LastModified_ != fi.lastModified ())
+			return false;
+
+		if (std::chrono::steady_clock::now () - listing.Built_ > MaxListingAge)
+			return false;
+
+		return !listing.HasFallbackIcons_ ||
+				listing.IconsGeneration_ == IconResolver_->GetGeneration ();
+	}
+
+	std::shared_ptr<DirListing> DirListingCache::Build (const QString& path, const QFileInfo& fi) const
+	{
+		auto listing = std::make_shared<DirListing> ();
+		listing->LastModified_ = fi.lastModified ();
+		listing->Built_ = std::chrono::steady_clock::now ();
+
+		// The generation is taken before any icons are requested, so an
+		// icon rendered in the meantime results in a rebuild.
+		listing->IconsGeneration_ = IconResolver_->GetGeneration ();
+
+		QByteArray digestData;
+		QDataStream digestStream { &digestData, QIODevice::WriteOnly };
+
+		Util::MimeDetector detector;
+		for (const auto& entry : QDir { path }.entryInfoList (QDir::AllEntries | QDir::NoDot,
+					QDir::Name | QDir::DirsFirst))
+		{
+			const QString mime = detector (entry.filePath ());
+			listing->Entries_.append ({ entry.fileName (), entry.size (), entry.created (), mime });
+
+			if (!listing->Icons_.contains (mime))
+			{
+				bool isFallback = false;
+				const auto& icon = IconResolver_->GetIcon (mime, isFallback);
+				listing->Icons_ [mime] = icon;
+				listing->HasFallbackIcons_ = listing->HasFallbackIcons_ || isFallback;
+
+				digestStream << mime << qHash (icon);
+			}
+
+			digestStream << entry.fileName ()
+					<< entry.size ()
+					<< entry.created ()
+					<< mime;
+		}
+
+		listing->Digest_ = QCryptographicHash::hash (digestData, QCryptographicHash::Md5);
+
+		return listing;
+	}
+
+	void DirListingCache::Put (const QString& path, const std::shared_ptr<DirListing>& listing)
+	{
+		QMutexLocker locker { &Lock_ };
+
+		if (!Listings_.contains (path) && Listings_.size () >= MaxListings)
+		{
+			const auto lru = std::min_element (Listings_.begin (), Listings_.end (),
+					[] (const CachedListing& left, const CachedListing& right)
+						{ return left.LastAccess_ < right.LastAccess_; });
+			QMetaObject::invokeMethod (this,
+					"unwatch",
+					Qt::QueuedConnection,
+					Q_ARG (QString, lru.key ()));
+			Listings_.erase (lru);
+		}
+
+		Listings_ [path] = { listing, ++AccessCounter_ };
+	}
+
+	void DirListingCache::watch (const QString& path)
+	{
+		{
+			QMutexLocker locker { &Lock_ };
+			if (!Listings_.contains (path))
+				return;
+		}
+
+		if (Watched_.contains (path))
+			return;
+
+		if (!Watcher_->addPath (path))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "cannot watch"
+					<< path;
+			return;
+		}
+
+		Watched_ << path;
+	}
+
+	void DirListingCache::unwatch (const QString& path)
+	{
+		{
+			QMutexLocker locker { &Lock_ };
+			if (Listings_.contains (path))
+				return;
+		}
+
+		if (Watched_.remove (path))
+			Watcher_->removePath (path);
+	}
+
+	void DirListingCache::handleDirectoryChanged (const QString& path)
+	{
+		{
+			QMutexLocker locker { &Lock_ };
+			Listings_.remove (path);
+		}
+
+		if (Watched_.remove (path))
+			Watcher_->removePath (path);
+	}
+}
+}
@@ -0,0 +1,143 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QDateTime>
+
+class QFileInfo;
+class QFileSystemWatcher;
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	class IconResolver;
+
+	/** @brief A snapshot of a directory's contents.
+	 *
+	 * The snapshot is immutable once built, except for the pages
+	 * rendered from it, which are cached per their representation key.
+	 */
+	struct DirListing
+	{
+		struct Entry
+		{
+			QString Name_;
+			qint64 Size_;
+			QDateTime Created_;
+			QString Mime_;
+		};
+
+		QList<Entry> Entries_;
+		QHash<QString, QByteArray> Icons_;
+
+		QDateTime LastModified_;
+		QByteArray Digest_;
+
+		std::chrono::steady_clock::time_point Built_;
+		quint64 IconsGeneration_ = 0;
+		bool HasFallbackIcons_ = false;
+
+		mutable QMutex PagesLock_;
+		mutable QHash<QByteArray, QByteArray> Pages_;
+
+		/** @brief Returns the entity tag of a page rendered from this
+		 * snapshot.
+		 *
+		 * @param[in] key The key identifying the representation, like
+		 * the URL and the languages the page is translated to.
+		 */
+		QByteArray GetETag (const QByteArray& key) const;
+
+		/** @brief Returns the page for the given key, rendering it via
+		 * render if it isn't cached yet.
+		 */
+		QByteArray GetPage (const QByteArray& key, const std::function<QByteArray ()>& render) const;
+	};
+
+	typedef std::shared_ptr<const DirListing> DirListing_cptr;
+
+	/** @brief Caches directory listings between requests.
+	 *
+	 * Listings are invalidated by a filesystem watcher, by the mtime of
+	 * the directory changing, and after a short while anyway, since the
+	 * watcher doesn't notice files changing their size. A rebuilt
+	 * listing keeps its digest and rendered pages if nothing changed.
+	 *
+	 * The object itself lives in the GUI thread, while Get() may be
+	 * called from any thread.
+	 */
+	class DirListingCache : public QObject
+	{
+		Q_OBJECT
+
+		IconResolver * const IconResolver_;
+		QFileSystemWatcher * const Watcher_;
+		QSet<QString> Watched_;
+
+		struct CachedListing
+		{
+			std::shared_ptr<DirListing> Listing_;
+			quint64 LastAccess_;
+		};
+
+		QMutex Lock_;
+		QHash<QString, CachedListing> Listings_;
+		quint64 AccessCounter_ = 0;
+	public:
+		DirListingCache (IconResolver*, QObject* = 0);
+
+		/** @brief Returns the listing of the given directory.
+		 *
+		 * This function is thread-safe.
+		 *
+		 * @param[in] path The path to the directory.
+		 * @param[in] fi The file info for path, fresh enough to check
+		 * whether the cached listing is still valid.
+		 */
+		DirListing_cptr Get (const QString& path, const QFileInfo& fi);
+	private:
+		bool IsFresh (const DirListing&, const QFileInfo&) const;
+		std::shared_ptr<DirListing> Build (const QString&, const QFileInfo&) const;
+		void Put (const QString&, const std::shared_ptr<DirListing>&);
+	private slots:
+		void watch (const QString&);
+		void unwatch (const QString&);
+		void handleDirectoryChanged (const QString&);
+	};
+}
+}
@@ -37,25 +37,73 @@ namespace LeechCraft
 {
 namespace HttHare
 {
+	namespace
+	{
+		QByteArray RenderIcon (QString mimetype)
+		{
+			mimetype.replace ('/', '-');
+			auto icon = QIcon::fromTheme (mimetype);
+			if (icon.isNull ())
+			{
+				mimetype.replace ("x-", "");
+				icon = QIcon::fromTheme (mimetype);
+			}
+
+			if (icon.isNull ())
+				icon = QIcon::fromTheme ("application-octet-stream");
+
+			return Util::GetAsBase64Src (icon.pixmap (IconResolver::IconSize, IconResolver::IconSize).toImage ()).toLatin1 ();
+		}
+	}
+
 	IconResolver::IconResolver (QObject *parent)
 	: QObject (parent)
+	, Fallback_ (RenderIcon ("application/octet-stream"))
 	{
+		for (const auto& mime : { "inode/directory", "text/plain" })
+			Cache_ [mime] = RenderIcon (mime);
 	}
 
-	void IconResolver::resolveMime (QString mimetype, QByteArray& image, int dim)
+	QByteArray IconResolver::GetIcon (const QString& mime, bool& isFallback)
 	{
-		mimetype.replace ('/', '-');
-		auto icon = QIcon::fromTheme (mimetype);
-		if (icon.isNull ())
 		{
-			mimetype.replace ("x-", "");
-			icon = QIcon::fromTheme (mimetype);
+			QReadLocker locker { &Lock_ };
+			const auto pos = Cache_.find (mime);
+			if (pos != Cache_.end ())
+			{
+				isFallback = false;
+				return *pos;
+			}
 		}
 
-		if (icon.isNull ())
-			icon = QIcon::fromTheme ("application-octet-stream");
+		isFallback = true;
+
+		QWriteLocker locker { &Lock_ };
+		if (!Pending_.contains (mime) && !Cache_.contains (mime))
+		{
+			Pending_ << mime;
+			QMetaObject::invokeMethod (this,
+					"resolveMime",
+					Qt::QueuedConnection,
+					Q_ARG (QString, mime));
+		}
+
+		return Fallback_;
+	}
+
+	quint64 IconResolver::GetGeneration () const
+	{
+		return Generation_;
+	}
+
+	void IconResolver::resolveMime (const QString& mime)
+	{
+		const auto& image = RenderIcon (mime);
 
-		image = Util::GetAsBase64Src (icon.pixmap (dim, dim).toImage ()).toLatin1 ();
+		QWriteLocker locker { &Lock_ };
+		Cache_ [mime] = image;
+		Pending_.remove (mime);
+		++Generation_;
 	}
 }
 }
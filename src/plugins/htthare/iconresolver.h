@@ -29,21 +29,59 @@
 
 #pragma once
 
+#include <atomic>
 #include <QObject>
-
-class QImage;
+#include <QHash>
+#include <QSet>
+#include <QReadWriteLock>
 
 namespace LeechCraft
 {
 namespace HttHare
 {
+	/** @brief Renders mime type icons as data URIs.
+	 *
+	 * Icons can only be rendered in the GUI thread, so they are kept in a
+	 * cache that the server threads read without waiting for the GUI
+	 * event loop. An icon missing from the cache is scheduled for
+	 * rendering, and the generic one is returned meanwhile.
+	 */
 	class IconResolver : public QObject
 	{
 		Q_OBJECT
+
+		mutable QReadWriteLock Lock_;
+		QHash<QString, QByteArray> Cache_;
+		QSet<QString> Pending_;
+
+		QByteArray Fallback_;
+
+		std::atomic<quint64> Generation_ { 0 };
 	public:
+		static constexpr int IconSize = 16;
+
 		IconResolver (QObject* = 0);
-	public slots:
-		void resolveMime (QString, QByteArray&, int);
+
+		/** @brief Returns the icon for the given mime type.
+		 *
+		 * This function is thread-safe and never blocks on the GUI
+		 * thread.
+		 *
+		 * @param[in] mime The mime type of the icon.
+		 * @param[out] isFallback Whether the generic icon is returned
+		 * since the right one isn't rendered yet.
+		 * @return The icon as a base64-encoded data URI.
+		 */
+		QByteArray GetIcon (const QString& mime, bool& isFallback);
+
+		/** @brief Returns the number of icons rendered so far.
+		 *
+		 * Anything built with fallback icons should be rebuilt once the
+		 * generation changes.
+		 */
+		quint64 GetGeneration () const;
+	private slots:
+		void resolveMime (const QString&);
 	};
 }
 }
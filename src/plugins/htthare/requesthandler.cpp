@@ -48,12 +48,13 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QDateTime>
+#include <QLocale>
 #include <util/util.h>
 #include <util/sys/mimedetector.h>
-#include <util/sll/util.h>
 #include "connection.h"
 #include "storagemanager.h"
 #include "iconresolver.h"
+#include "dirlistingcache.h"
 #include "trmanager.h"
 
 namespace LeechCraft
@@ -93,6 +94,8 @@ namespace HttHare
 			Headers_ [line.left (colonPos)] = line.mid (colonPos + 1).trimmed ();
 		}
 
+		KeepAlive_ = Conn_->CanKeepAlive () && IsKeepAliveRequested (req.value (2));
+
 #ifdef QT_DEBUG
 		qDebug () << Q_FUNC_INFO << "got request";
 		qDebug () << req << Url_;
@@ -109,6 +112,21 @@ namespace HttHare
 					"Method " + verb + " not supported by this server.");
 	}
 
+	bool RequestHandler::IsKeepAliveRequested (const QByteArray& version) const
+	{
+		// The request body isn't read, so the next request couldn't be
+		// found in the stream if there is one.
+		if (Headers_.contains ("Transfer-Encoding") ||
+				Headers_.value ("Content-Length", "0").toLongLong ())
+			return false;
+
+		const auto& connection = Headers_.value ("Connection").toLower ();
+		if (version == "HTTP/1.1")
+			return !connection.contains ("close");
+		else
+			return connection.contains ("keep-alive");
+	}
+
 	QString RequestHandler::Tr (const char *msg)
 	{
 		auto locales = Headers_ ["Accept-Language"].split (',');
@@ -156,50 +174,20 @@ namespace HttHare
 					.replace ('.', '_')
 					.replace ('+', '_');
 		}
-
-		const auto IconSize = 16;
 	}
 
-	QByteArray RequestHandler::MakeDirResponse (const QFileInfo& fi, const QString& path, const QUrl& url)
+	QByteArray RequestHandler::MakeDirResponse (const DirListing& listing, const QFileInfo& fi, const QUrl& url)
 	{
-		const auto& entries = QDir { path }
-				.entryInfoList (QDir::AllEntries | QDir::NoDot,
-						QDir::Name | QDir::DirsFirst);
-
-		struct MimeInfo
-		{
-			QString MimeType_;
-		};
-		QHash<QString, QByteArray> mimeCache;
-		QList<MimeInfo> mimes;
-		Util::MimeDetector detector;
-		for (const auto& entry : entries)
-		{
-			const auto& type = detector (entry.filePath ());
-
-			if (!mimeCache.contains (type))
-			{
-				QByteArray image;
-				QMetaObject::invokeMethod (Conn_->GetIconResolver (),
-						"resolveMime",
-						Qt::BlockingQueuedConnection,
-						Q_ARG (QString, type),
-						Q_ARG (QByteArray&, image),
-						Q_ARG (int, IconSize));
-				mimeCache [type] = image;
-			}
-
-			mimes.append ({ type });
-		}
+		const auto iconSize = IconResolver::IconSize;
 
 		QString result;
 		result += "<html><head><title>" + fi.fileName () + "</title><style>";
-		for (auto pos = mimeCache.begin (); pos != mimeCache.end (); ++pos)
+		for (auto pos = listing.Icons_.begin (); pos != listing.Icons_.end (); ++pos)
 		{
 			result += "." + NormalizeClass (pos.key ()) + " {";
 			result += "background-image: url('" + pos.value () + "');";
 			result += "background-repeat: no-repeat;";
-			result += "padding-left: " + QString::number (IconSize + 4) + ";";
+			result += "padding-left: " + QString::number (iconSize + 4) + ";";
 			result += "}";
 		}
 		result += "</style></head><body><h1>" + Tr ("Listing of %1").arg (url.toString ()) + "</h1>";
@@ -209,16 +197,14 @@ namespace HttHare
 					.arg (Tr ("Size"))
 					.arg (Tr ("Created"));
 
-		for (int i = 0; i < entries.size (); ++i)
+		for (const auto& item : listing.Entries_)
 		{
-			const auto& item = entries.at (i);
-
-			auto link = QUrl::toPercentEncoding (item.fileName (), {}, "'");
+			auto link = QUrl::toPercentEncoding (item.Name_, {}, "'");
 
-			result += "<tr><td class=" + NormalizeClass (mimes.at (i).MimeType_) + "><a href='";
-			result += link + "'>" + item.fileName () + "</a></td>";
-			result += "<td>" + Util::MakePrettySize (item.size ()) + "</td>";
-			result += "<td>" + item.created ().toString (Qt::SystemLocaleShortDate) + "</td></tr>";
+			result += "<tr><td class=" + NormalizeClass (item.Mime_) + "><a href='";
+			result += link + "'>" + item.Name_ + "</a></td>";
+			result += "<td>" + Util::MakePrettySize (item.Size_) + "</td>";
+			result += "<td>" + item.Created_.toString (Qt::SystemLocaleShortDate) + "</td></tr>";
 		}
 
 		result += "</table></body></html>";
@@ -226,6 +212,71 @@ namespace HttHare
 		return result.toUtf8 ();
 	}
 
+	namespace
+	{
+		const auto HttpDateFormat = "ddd, dd MMM yyyy hh:mm:ss 'GMT'";
+
+		QByteArray ToHttpDate (const QDateTime& dt)
+		{
+			return QLocale::c ().toString (dt.toUTC (), HttpDateFormat).toLatin1 ();
+		}
+
+		QDateTime FromHttpDate (const QString& str)
+		{
+			auto dt = QLocale::c ().toDateTime (str.trimmed (), HttpDateFormat);
+			dt.setTimeSpec (Qt::UTC);
+			return dt;
+		}
+
+		QByteArray StripWeakness (QByteArray etag)
+		{
+			etag = etag.trimmed ();
+			if (etag.startsWith ("W/"))
+				etag.remove (0, 2);
+			return etag;
+		}
+
+		QByteArray MakeFileETag (const QFileInfo& fi)
+		{
+			return '"' + QByteArray::number (fi.size (), 16) +
+					'-' + QByteArray::number (fi.lastModified ().toMSecsSinceEpoch (), 16) + '"';
+		}
+	}
+
+	void RequestHandler::AddValidators (const QByteArray& etag, const QDateTime& lastModified)
+	{
+		ResponseHeaders_.append ({ "ETag", etag });
+		ResponseHeaders_.append ({ "Last-Modified", ToHttpDate (lastModified) });
+	}
+
+	bool RequestHandler::IsNotModified (const QByteArray& etag, const QDateTime& lastModified) const
+	{
+		const auto& inm = Headers_.value ("If-None-Match").toLatin1 ();
+		if (!inm.isEmpty ())
+		{
+			if (inm.trimmed () == "*")
+				return true;
+
+			const auto& stripped = StripWeakness (etag);
+			for (const auto& tag : inm.split (','))
+				if (StripWeakness (tag) == stripped)
+					return true;
+
+			return false;
+		}
+
+		const auto& ims = Headers_.value ("If-Modified-Since");
+		if (ims.isEmpty ())
+			return false;
+
+		const auto& since = FromHttpDate (ims);
+		if (!since.isValid ())
+			return false;
+
+		// HTTP dates have the precision of a second.
+		return lastModified.toUTC ().toTime_t () <= since.toTime_t ();
+	}
+
 	namespace
 	{
 		QList<QPair<qint64, qint64>> ParseRanges (QString str, qint64 fullSize)
@@ -446,10 +497,22 @@ namespace HttHare
 	{
 		if (Url_.path ().endsWith ('/'))
 		{
-			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+			const auto& listing = Conn_->GetDirListingCache ()->Get (path, fi);
+			const auto& key = Url_.toEncoded () + '\n' + Headers_.value ("Accept-Language").toUtf8 ();
+			const auto& etag = listing->GetETag (key);
 
 			ResponseHeaders_.append ({ "Content-Type", "text/html; charset=utf-8" });
-			ResponseBody_ = MakeDirResponse (fi, path, Url_);
+			ResponseHeaders_.append ({ "Vary", "Accept-Language, Accept-Encoding" });
+			AddValidators (etag, listing->LastModified_);
+
+			if (IsNotModified (etag, listing->LastModified_))
+				ResponseLine_ = "HTTP/1.1 304 Not Modified\r\n";
+			else
+			{
+				ResponseLine_ = "HTTP/1.1 200 OK\r\n";
+				ResponseBody_ = listing->GetPage (key,
+						[this, &listing, &fi] { return MakeDirResponse (*listing, fi, Url_); });
+			}
 
 			DefaultWrite (verb);
 		}
@@ -460,7 +523,9 @@ namespace HttHare
 			auto url = Url_;
 			url.setPath (url.path () + '/');
 			ResponseHeaders_.append ({ "Location", url.toString ().toUtf8 () });
-			ResponseBody_ = MakeDirResponse (fi, path, url);
+
+			const auto& listing = Conn_->GetDirListingCache ()->Get (path, fi);
+			ResponseBody_ = MakeDirResponse (*listing, fi, url);
 
 			DefaultWrite (verb);
 		}
@@ -473,6 +538,16 @@ namespace HttHare
 		const auto& mime = Util::MimeDetector {} (path);
 		ResponseHeaders_.append ({ "Content-Type", mime });
 
+		const auto& etag = MakeFileETag (fi);
+		AddValidators (etag, fi.lastModified ());
+
+		if (IsNotModified (etag, fi.lastModified ()))
+		{
+			ResponseLine_ = "HTTP/1.1 304 Not Modified\r\n";
+			DefaultWrite (verb);
+			return;
+		}
+
 		if (ranges.isEmpty ())
 		{
 			ResponseLine_ = "HTTP/1.1 200 OK\r\n";
@@ -490,22 +565,30 @@ namespace HttHare
 		}
 
 		auto c = Conn_;
+		auto self = shared_from_this ();
 		boost::asio::async_write (c->GetSocket (),
 				ToBuffers (verb),
-				c->GetStrand ().wrap ([c, path, verb, ranges] (boost::system::error_code ec, ulong) mutable -> void
+				c->GetStrand ().wrap ([self, c, path, verb, ranges] (boost::system::error_code ec, ulong) mutable -> void
 					{
 						if (ec)
+						{
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
+							c->FinishResponse (false);
+							return;
+						}
 
 						auto& s = c->GetSocket ();
 
-						auto shutdownGuard = Util::MakeScopeGuard ([&s, &ec]
-								{ s.shutdown (boost::asio::socket_base::shutdown_both, ec); }).Shared ();
-
 						if (verb != Verb::Get)
+						{
+							c->FinishResponse (self->KeepAlive_);
 							return;
+						}
 
+						// The headers promising the body are already sent,
+						// so the only way to report an error is to close
+						// the connection.
 						auto file = std::make_shared<QFile> (path);
 						if (!file->open (QIODevice::ReadOnly))
 						{
@@ -513,6 +596,7 @@ namespace HttHare
 									<< "cannot open file"
 									<< path
 									<< file->errorString ();
+							c->FinishResponse (false);
 							return;
 						}
 
@@ -530,7 +614,8 @@ namespace HttHare
 							0,
 							headRange,
 							ranges,
-							[c, shutdownGuard] (boost::system::error_code, ulong) {}
+							[self, c] (boost::system::error_code ec, ulong)
+								{ c->FinishResponse (self->KeepAlive_ && !ec); }
 						} (ec, 0);
 					}));
 	}
@@ -538,16 +623,16 @@ namespace HttHare
 	void RequestHandler::DefaultWrite (Verb verb)
 	{
 		auto c = Conn_;
+		auto self = shared_from_this ();
 		boost::asio::async_write (c->GetSocket (),
 				ToBuffers (verb),
-				c->GetStrand ().wrap ([c] (const boost::system::error_code& ec, ulong)
+				c->GetStrand ().wrap ([self, c] (const boost::system::error_code& ec, ulong)
 					{
 						if (ec)
 							qWarning () << Q_FUNC_INFO
 									<< ec.message ().c_str ();
 
-						boost::system::error_code iec;
-						c->GetSocket ().shutdown (boost::asio::socket_base::shutdown_both, iec);
+						c->FinishResponse (self->KeepAlive_ && !ec);
 					}));
 	}
 
@@ -586,9 +671,14 @@ namespace HttHare
 			ResponseBody_.remove (0, 4);
 		}
 
-		if (!hasContentLength)
+		// A 304 response has no body, and its Content-Length would
+		// describe the omitted representation rather than the message.
+		const bool isNotModified = ResponseLine_.startsWith ("HTTP/1.1 304");
+		if (!hasContentLength && !isNotModified)
 			ResponseHeaders_.append ({ "Content-Length", QByteArray::number (ResponseBody_.size ()) });
 
+		ResponseHeaders_.append ({ "Connection", KeepAlive_ ? "keep-alive" : "close" });
+
 		CookedRH_.clear ();
 		for (const auto& pair : ResponseHeaders_)
 			CookedRH_ += pair.first + ": " + pair.second + "\r\n";
@@ -37,15 +37,17 @@
 #include <QCoreApplication>
 
 class QFileInfo;
+class QDateTime;
 
 namespace LeechCraft
 {
 namespace HttHare
 {
 	class Connection;
+	struct DirListing;
 	typedef std::shared_ptr<Connection> Connection_ptr;
 
-	class RequestHandler
+	class RequestHandler : public std::enable_shared_from_this<RequestHandler>
 	{
 		Q_DECLARE_TR_FUNCTIONS (LeechCraft::HttHare::RequestHandler)
 
@@ -54,6 +56,8 @@ namespace HttHare
 		QUrl Url_;
 		QMap<QString, QString> Headers_;
 
+		bool KeepAlive_ = false;
+
 		QByteArray ResponseLine_;
 		QList<QPair<QByteArray, QByteArray>> ResponseHeaders_;
 		QByteArray CookedRH_;
@@ -71,8 +75,13 @@ namespace HttHare
 	private:
 		QString Tr (const char*);
 
+		bool IsKeepAliveRequested (const QByteArray& version) const;
+
 		void ErrorResponse (int, const QByteArray&, const QByteArray& = QByteArray ());
-		QByteArray MakeDirResponse (const QFileInfo&, const QString&, const QUrl&);
+		QByteArray MakeDirResponse (const DirListing&, const QFileInfo&, const QUrl&);
+
+		void AddValidators (const QByteArray& etag, const QDateTime& lastModified);
+		bool IsNotModified (const QByteArray& etag, const QDateTime& lastModified) const;
 
 		void HandleRequest (Verb);
 		void WriteDir (const QString&, const QFileInfo&, Verb);
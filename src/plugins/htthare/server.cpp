@@ -32,6 +32,7 @@
 #include <QtDebug>
 #include "connection.h"
 #include "iconresolver.h"
+#include "dirlistingcache.h"
 #include "trmanager.h"
 
 namespace LeechCraft
@@ -41,7 +42,8 @@ namespace HttHare
 	namespace ip = boost::asio::ip;
 
 	Server::Server (const QList<QPair<QString, QString>>& addresses)
-	: IconResolver_ { new IconResolver  }
+	: IconResolver_ { new IconResolver }
+	, ListingCache_ { new DirListingCache { IconResolver_ } }
 	, TrManager_ { new TrManager }
 	{
 		ip::tcp::resolver resolver { IoService_ };
@@ -76,6 +78,10 @@ namespace HttHare
 	{
 		if (!IoService_.stopped ())
 			Stop ();
+
+		delete ListingCache_;
+		delete IconResolver_;
+		delete TrManager_;
 	}
 
 	void Server::Start ()
@@ -97,7 +103,7 @@ namespace HttHare
 
 	void Server::StartAccept ()
 	{
-		Connection_ptr connection { new Connection { IoService_, StorageMgr_, IconResolver_, TrManager_ } };
+		Connection_ptr connection { new Connection { IoService_, StorageMgr_, IconResolver_, ListingCache_, TrManager_ } };
 
 		for (auto& acceptor : Acceptors_)
 			acceptor->async_accept (connection->GetSocket (),
@@ -0,0 +1,383 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "loadtest.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <random>
+#include <boost/asio.hpp>
+#include <QtTest>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QTemporaryDir>
+#include "server.h"
+
+QTEST_MAIN (LeechCraft::HttHare::LoadTest)
+
+Q_DECLARE_METATYPE (std::function<QByteArray (int)>)
+
+namespace LeechCraft
+{
+namespace HttHare
+{
+	namespace ip = boost::asio::ip;
+
+	namespace
+	{
+		const qint64 FileSize = 8 * 1024 * 1024;
+		const qint64 RangeSize = 64 * 1024;
+		const int ListingSize = 500;
+
+		const QByteArray Host { "127.0.0.1" };
+
+		QByteArray GetPort ()
+		{
+			const auto& port = qgetenv ("LC_HTTHARE_LOADTEST_PORT");
+			return port.isEmpty () ? QByteArray { "14899" } : port;
+		}
+
+		int GetRequestsCount ()
+		{
+			const auto count = qgetenv ("LC_HTTHARE_LOADTEST_REQUESTS").toInt ();
+			return count > 0 ? count : 5000;
+		}
+
+		using Clock_t = std::chrono::steady_clock;
+
+		class Client
+		{
+			boost::asio::io_service Svc_;
+			ip::tcp::socket Sock_ { Svc_ };
+			ip::tcp::endpoint Endpoint_;
+			boost::asio::streambuf Buf_;
+
+			QByteArray LastHeader_;
+		public:
+			Client ()
+			{
+				ip::tcp::resolver resolver { Svc_ };
+				Endpoint_ = *resolver.resolve ({ Host.constData (), GetPort ().constData () });
+			}
+
+			bool IsConnected () const
+			{
+				return Sock_.is_open ();
+			}
+
+			void Connect ()
+			{
+				Buf_.consume (Buf_.size ());
+				Sock_.connect (Endpoint_);
+				Sock_.set_option (ip::tcp::no_delay { true });
+			}
+
+			void Disconnect ()
+			{
+				boost::system::error_code ec;
+				Sock_.close (ec);
+			}
+
+			void Send (const QByteArray& data)
+			{
+				boost::asio::write (Sock_, boost::asio::buffer (data.constData (), data.size ()));
+			}
+
+			/** Reads a response and returns whether the connection stays
+			 * open after it.
+			 */
+			bool ReadResponse (bool isHead)
+			{
+				const auto headerSize = boost::asio::read_until (Sock_, Buf_, std::string { "\r\n\r\n" });
+
+				QByteArray header;
+				header.resize (headerSize);
+				std::istream istr { &Buf_ };
+				istr.read (header.data (), headerSize);
+				LastHeader_ = header;
+				header = header.toLower ();
+
+				const auto isNotModified = header.startsWith ("http/1.1 304");
+				if (!header.startsWith ("http/1.1 200") &&
+						!header.startsWith ("http/1.1 206") &&
+						!isNotModified)
+					throw std::runtime_error { "unexpected response: " + header.left (header.indexOf ('\r')).toStdString () };
+
+				qint64 length = 0;
+				const auto clPos = header.indexOf ("content-length:");
+				if (clPos >= 0)
+				{
+					const auto start = clPos + 15;
+					length = header.mid (start, header.indexOf ('\r', start) - start).trimmed ().toLongLong ();
+				}
+
+				if (!isHead && !isNotModified)
+				{
+					const auto buffered = static_cast<qint64> (Buf_.size ());
+					if (length > buffered)
+						boost::asio::read (Sock_, Buf_, boost::asio::transfer_exactly (length - buffered));
+					Buf_.consume (length);
+				}
+
+				return !header.contains ("connection: close");
+			}
+
+			QByteArray GetLastHeader (const QByteArray& name) const
+			{
+				for (const auto& line : LastHeader_.split ('\n'))
+				{
+					const auto colonPos = line.indexOf (':');
+					if (colonPos > 0 && !qstricmp (line.left (colonPos).constData (), name.constData ()))
+						return line.mid (colonPos + 1).trimmed ();
+				}
+				return {};
+			}
+		};
+
+		enum class Mode
+		{
+			NewConnections,
+			KeepAlive,
+			Pipelined
+		};
+
+		struct WorkerResult
+		{
+			std::vector<double> Latencies_;
+			QString Error_;
+		};
+
+		WorkerResult RunWorker (Mode mode, int requests, int depth,
+				const std::function<QByteArray (int)>& makeRequest, bool isHead)
+		{
+			WorkerResult result;
+			result.Latencies_.reserve (requests);
+
+			try
+			{
+				Client client;
+
+				int done = 0;
+				while (done < requests)
+				{
+					const auto start = Clock_t::now ();
+
+					if (!client.IsConnected ())
+						client.Connect ();
+
+					const auto batch = std::min (depth, requests - done);
+
+					QByteArray data;
+					for (int i = 0; i < batch; ++i)
+						data += makeRequest (done + i);
+					client.Send (data);
+
+					for (int i = 0; i < batch; ++i)
+					{
+						const auto keepAlive = client.ReadResponse (isHead);
+
+						const std::chrono::duration<double, std::milli> elapsed = Clock_t::now () - start;
+						result.Latencies_.push_back (elapsed.count ());
+						++done;
+
+						// The rest of the batch, if any, is resent on a new connection.
+						if (!keepAlive || mode == Mode::NewConnections)
+						{
+							client.Disconnect ();
+							break;
+						}
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				result.Error_ = QString::fromUtf8 (e.what ());
+			}
+
+			return result;
+		}
+	}
+
+	void LoadTest::initTestCase ()
+	{
+		File_ = std::make_shared<QTemporaryFile> (QDir::homePath () + "/.lc_htthare_loadtest_XXXXXX");
+		QVERIFY (File_->open ());
+
+		std::mt19937 gen;
+		QByteArray chunk;
+		chunk.resize (1024 * 1024);
+		for (auto& c : chunk)
+			c = static_cast<char> (gen ());
+		for (qint64 written = 0; written < FileSize; written += chunk.size ())
+			QCOMPARE (File_->write (chunk), static_cast<qint64> (chunk.size ()));
+		QVERIFY (File_->flush ());
+
+		Dir_ = std::make_shared<QTemporaryDir> (QDir::homePath () + "/.lc_htthare_loadtest_XXXXXX");
+		QVERIFY (Dir_->isValid ());
+		for (int i = 0; i < ListingSize; ++i)
+		{
+			QFile file { Dir_->path () + "/file" + QString::number (i) + (i % 2 ? ".txt" : ".dat") };
+			QVERIFY (file.open (QIODevice::WriteOnly));
+			file.write (QByteArray::number (i));
+		}
+
+		const QPair<QString, QString> address { QString::fromLatin1 (Host), QString::fromLatin1 (GetPort ()) };
+		Server_ = std::make_shared<Server> (QList<QPair<QString, QString>> { address });
+		Server_->Start ();
+
+		Client client;
+		client.Connect ();
+		client.Send ("HEAD " + GetDirPath () + " HTTP/1.1\r\nHost: " + Host + "\r\n\r\n");
+		client.ReadResponse (true);
+		DirETag_ = client.GetLastHeader ("ETag");
+		QVERIFY (!DirETag_.isEmpty ());
+	}
+
+	QByteArray LoadTest::GetDirPath () const
+	{
+		return "/" + QFileInfo { Dir_->path () }.fileName ().toUtf8 () + "/";
+	}
+
+	void LoadTest::cleanupTestCase ()
+	{
+		Server_.reset ();
+		File_.reset ();
+		Dir_.reset ();
+	}
+
+	void LoadTest::benchmarkRequests_data ()
+	{
+		QTest::addColumn<int> ("mode");
+		QTest::addColumn<int> ("clients");
+		QTest::addColumn<bool> ("isHead");
+		QTest::addColumn<std::function<QByteArray (int)>> ("makeRequest");
+
+		const auto& path = "/" + QFileInfo { File_->fileName () }.fileName ().toUtf8 ();
+
+		const auto& makeGet = [] (const QByteArray& verb, const QByteArray& path, const QByteArray& extra)
+		{
+			return [=] (int)
+			{
+				return verb + " " + path + " HTTP/1.1\r\n"
+						"Host: " + Host + "\r\n" + extra + "\r\n";
+			};
+		};
+
+		const auto& makeRange = [path] (const QByteArray& extra)
+		{
+			return [=] (int idx)
+			{
+				const auto offset = (idx * 7919 * RangeSize) % (FileSize - RangeSize);
+				return "GET " + path + " HTTP/1.1\r\n"
+						"Host: " + Host + "\r\n"
+						"Range: bytes=" + QByteArray::number (offset) + "-" +
+							QByteArray::number (offset + RangeSize - 1) + "\r\n" +
+						extra + "\r\n";
+			};
+		};
+
+		const QByteArray close { "Connection: close\r\n" };
+
+		struct ModeInfo
+		{
+			const char *Name_;
+			Mode Mode_;
+			QByteArray Extra_;
+		};
+		const QList<ModeInfo> modes
+		{
+			{ "close", Mode::NewConnections, close },
+			{ "keepalive", Mode::KeepAlive, {} },
+			{ "pipelined", Mode::Pipelined, {} }
+		};
+
+		for (const auto& mode : modes)
+			for (const auto clients : { 1, 8 })
+			{
+				const auto& suffix = QByteArray { mode.Name_ } + "/" + QByteArray::number (clients);
+				QTest::newRow ("head/" + suffix)
+						<< static_cast<int> (mode.Mode_) << clients << true
+						<< std::function<QByteArray (int)> { makeGet ("HEAD", path, mode.Extra_) };
+				QTest::newRow ("range/" + suffix)
+						<< static_cast<int> (mode.Mode_) << clients << false
+						<< std::function<QByteArray (int)> { makeRange (mode.Extra_) };
+				QTest::newRow ("listing/" + suffix)
+						<< static_cast<int> (mode.Mode_) << clients << false
+						<< std::function<QByteArray (int)> { makeGet ("GET", GetDirPath (), mode.Extra_) };
+				QTest::newRow ("listing-conditional/" + suffix)
+						<< static_cast<int> (mode.Mode_) << clients << false
+						<< std::function<QByteArray (int)> { makeGet ("GET", GetDirPath (),
+								mode.Extra_ + "If-None-Match: " + DirETag_ + "\r\n") };
+			}
+	}
+
+	void LoadTest::benchmarkRequests ()
+	{
+		QFETCH (int, mode);
+		QFETCH (int, clients);
+		QFETCH (bool, isHead);
+		QFETCH (std::function<QByteArray (int)>, makeRequest);
+
+		const auto requests = GetRequestsCount ();
+		const auto perClient = requests / clients;
+		const auto depth = static_cast<Mode> (mode) == Mode::Pipelined ? 8 : 1;
+
+		const auto start = Clock_t::now ();
+
+		std::vector<std::future<WorkerResult>> futures;
+		for (int i = 0; i < clients; ++i)
+			futures.push_back (std::async (std::launch::async, RunWorker,
+					static_cast<Mode> (mode), perClient, depth, makeRequest, isHead));
+
+		std::vector<double> latencies;
+		for (auto& future : futures)
+		{
+			const auto& result = future.get ();
+			QVERIFY2 (result.Error_.isEmpty (), qPrintable (result.Error_));
+			latencies.insert (latencies.end (), result.Latencies_.begin (), result.Latencies_.end ());
+		}
+
+		const std::chrono::duration<double> elapsed = Clock_t::now () - start;
+
+		QCOMPARE (static_cast<int> (latencies.size ()), perClient * clients);
+		std::sort (latencies.begin (), latencies.end ());
+
+		const auto percentile = [&latencies] (double p)
+		{
+			const auto pos = static_cast<size_t> (latencies.size () * p);
+			return latencies.at (std::min (latencies.size () - 1, pos));
+		};
+
+		qDebug () << QTest::currentDataTag ()
+				<< latencies.size () / elapsed.count () << "req/s;"
+				<< "p50" << percentile (0.5) << "ms;"
+				<< "p99" << percentile (0.99) << "ms";
+	}
+}
+}
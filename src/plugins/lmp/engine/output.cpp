@@ -82,6 +82,7 @@ namespace LMP
 	, Converter_ (gst_element_factory_make ("audioconvert", "convert"))
 	, Sink_ (gst_element_factory_make ("autoaudiosink", "audio_sink"))
 	, SaveVolumeScheduled_ (false)
+	, VolumeExponent_ (XmlSettingsManager::Instance ().Bind<double> ("VolumeExponent"))
 	{
 		gst_bin_add_many (GST_BIN (Bin_), Equalizer_, Volume_, Converter_, Sink_, nullptr);
 		gst_element_link_many (Equalizer_, Volume_, Converter_, Sink_, nullptr);
@@ -117,7 +118,7 @@ namespace LMP
 	{
 		gdouble value = 1;
 		g_object_get (G_OBJECT (Volume_), "volume", &value, nullptr);
-		const auto exp = XmlSettingsManager::Instance ().property ("VolumeExponent").toDouble ();
+		const auto exp = VolumeExponent_.Get ();
 		if (exp != 1)
 			value = std::pow (value, 1 / exp);
 		return value;
@@ -143,7 +144,7 @@ namespace LMP
 
 	void Output::setVolume (double volume)
 	{
-		const auto exp = XmlSettingsManager::Instance ().property ("VolumeExponent").toDouble ();
+		const auto exp = VolumeExponent_.Get ();
 		if (exp != 1)
 			volume = std::pow (volume, exp);
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QObject>
+#include <xmlsettingsdialog/boundsetting.h>
 #include "pathelement.h"
 
 typedef struct _GstElement GstElement;
@@ -53,6 +54,9 @@ namespace LMP
 		GstElement *Sink_;
 
 		bool SaveVolumeScheduled_;
+
+		// GetVolume() is also called from GStreamer threads.
+		const Util::BoundSetting<double> VolumeExponent_;
 	public:
 		Output (QObject* = 0);
 
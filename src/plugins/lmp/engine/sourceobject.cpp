@@ -142,6 +142,8 @@ namespace LMP
 				cat == Category::Notification ? 0.05 : 1,
 				BusDrainMutex_,
 				BusDrainWC_))
+	, EnableTagsRecoding_ (XmlSettingsManager::Instance ().Bind<bool> ("EnableTagsRecoding"))
+	, TagsRecodingRegion_ (XmlSettingsManager::Instance ().Bind<QString> ("TagsRecodingRegion"))
 	, OldState_ (SourceState::Stopped)
 	{
 		g_signal_connect (Dec_, "about-to-finish", G_CALLBACK (CbAboutToFinish), this);
@@ -615,11 +617,10 @@ namespace LMP
 	void SourceObject::HandleTagMsg (GstMessage *msg)
 	{
 		const auto oldMetadata = Metadata_;
-		const auto& region = XmlSettingsManager::Instance ()
-				.property ("TagsRecodingRegion").toString ();
-		const bool isEnabled = XmlSettingsManager::Instance ()
-				.property ("EnableTagsRecoding").toBool ();
-		if (!GstUtil::ParseTagMessage (msg, Metadata_, isEnabled ? region : QString ()))
+		const auto& region = EnableTagsRecoding_.Get () ?
+				TagsRecodingRegion_.Get () :
+				QString ();
+		if (!GstUtil::ParseTagMessage (msg, Metadata_, region))
 			return;
 
 		auto merge = [this] (const QString& oldName, const QString& stdName, bool emptyOnly)
@@ -39,6 +39,7 @@
 #include <QWaitCondition>
 #include "interfaces/lmp/isourceobject.h"
 #include "interfaces/lmp/ipath.h"
+#include <xmlsettingsdialog/boundsetting.h>
 #include "util/lmp/gstutil.h"
 #include "audiosource.h"
 #include "pathelement.h"
@@ -151,6 +152,9 @@ namespace LMP
 		MsgPopThread *PopThread_;
 		GstUtil::TagMap_t Metadata_;
 
+		const Util::BoundSetting<bool> EnableTagsRecoding_;
+		const Util::BoundSetting<QString> TagsRecodingRegion_;
+
 		HandlerContainer<SyncHandler_f> SyncHandlers_;
 		HandlerContainer<AsyncHandler_f> AsyncHandlers_;
 	public:
@@ -36,6 +36,7 @@
 #include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QtDebug>
 #include <util/sll/either.h>
 #include <util/xpc/util.h>
@@ -68,6 +69,10 @@ namespace LMP
 				SIGNAL (finished ()),
 				this,
 				SLOT (handleScanFinished ()));
+		connect (Watcher_,
+				SIGNAL (resultsReadyAt (int, int)),
+				this,
+				SLOT (handleScanResults (int, int)));
 		connect (Watcher_,
 				SIGNAL (progressValueChanged (int)),
 				this,
@@ -159,48 +164,54 @@ namespace LMP
 
 			LocalCollectionStorage storage;
 
-			const auto& paths = storage.GetTracksPaths ();
+			QHash<QString, QDateTime> storedMTimes;
+			try
+			{
+				storedMTimes = storage.GetMTimes ();
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "error getting mtimes"
+						<< e.what ();
+			}
+
+			QList<QPair<QString, QDateTime>> updatedMTimes;
 
 			const auto& allInfos = RecIterateInfo (path, symLinks);
 			for (const auto& info : allInfos)
 			{
 				const auto& trackPath = info.absoluteFilePath ();
 				const auto& mtime = info.lastModified ();
-				try
+
+				const auto storedPos = storedMTimes.constFind (trackPath);
+				if (storedPos != storedMTimes.constEnd ())
 				{
-					const auto& storedDt = storage.GetMTime (trackPath);
+					const auto& storedDt = *storedPos;
 					if (storedDt.isValid () &&
 							std::abs (storedDt.msecsTo (mtime)) < 1500)
 					{
 						result.UnchangedFiles_ << trackPath;
 						continue;
 					}
-				}
-				catch (const std::exception& e)
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "error getting mtime"
-							<< trackPath
-							<< e.what ();
-				}
 
-				if (paths.contains (trackPath))
-				{
-					try
-					{
-						storage.SetMTime (trackPath, mtime);
-					}
-					catch (const std::exception& e)
-					{
-						qWarning () << Q_FUNC_INFO
-								<< "error setting mtime"
-								<< trackPath
-								<< e.what ();
-					}
+					updatedMTimes.append ({ trackPath, mtime });
 				}
+
 				result.ChangedFiles_ << trackPath;
 			}
 
+			try
+			{
+				storage.SetMTimes (updatedMTimes);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "error setting mtimes"
+						<< e.what ();
+			}
+
 			return result;
 		};
 		Util::Sequence (this, QtConcurrent::run (worker)) >>
@@ -677,9 +688,13 @@ namespace LMP
 		auto resolver = Core::Instance ().GetLocalFileResolver ();
 
 		emit scanStarted (newPaths.size ());
+		ScanTimer_.start ();
+
+		// Fast audio properties are good enough for the collection,
+		// while Accurate ones may require reading the whole file.
 		auto worker = [resolver] (const QString& path)
 		{
-			return resolver->ResolveInfo (path).ToRight ([] (const ResolveError& error)
+			return resolver->ScanInfo (path, TagLib::AudioProperties::Fast).ToRight ([] (const ResolveError& error)
 					{
 						qWarning () << Q_FUNC_INFO
 								<< "error resolving media info for"
@@ -719,29 +734,57 @@ namespace LMP
 			Scan (rootPath, true);
 	}
 
-	void LocalCollection::handleScanFinished ()
+	void LocalCollection::CommitScannedInfos ()
+	{
+		if (ScannedNewInfos_.isEmpty ())
+			return;
+
+		const auto& newArts = Storage_->AddToCollection (ScannedNewInfos_);
+		ScannedNewInfos_.clear ();
+		HandleNewArtists (newArts);
+	}
+
+	void LocalCollection::handleScanResults (int begin, int end)
 	{
-		auto future = Watcher_->future ();
-		QList<MediaInfo> newInfos, existingInfos;
-		for (const auto& info : future)
+		for (int i = begin; i < end; ++i)
 		{
+			const auto& info = Watcher_->resultAt (i);
 			const auto& path = info.LocalPath_;
 			if (path.isEmpty ())
 				continue;
 
 			if (PresentPaths_.contains (path))
-				existingInfos << info;
+				ScannedExistingInfos_ << info;
 			else
 			{
-				newInfos << info;
+				ScannedNewInfos_ << info;
 				PresentPaths_ += path;
 			}
 		}
 
+		if (ScannedNewInfos_.size () >= ScanCommitBatchSize)
+			CommitScannedInfos ();
+	}
+
+	void LocalCollection::handleScanFinished ()
+	{
+		const auto filesCount = Watcher_->future ().resultCount ();
+		const auto msecs = std::max<qint64> (ScanTimer_.elapsed (), 1);
+		qDebug () << Q_FUNC_INFO
+				<< "scanned"
+				<< filesCount
+				<< "files in"
+				<< msecs
+				<< "ms,"
+				<< filesCount * 1000 / msecs
+				<< "files/sec";
+
 		emit scanFinished ();
 
-		auto newArts = Storage_->AddToCollection (newInfos);
-		HandleNewArtists (newArts);
+		CommitScannedInfos ();
+
+		QList<MediaInfo> existingInfos;
+		std::swap (existingInfos, ScannedExistingInfos_);
 
 		if (!NewPathsQueue_.isEmpty ())
 			InitiateScan (NewPathsQueue_.takeFirst ());
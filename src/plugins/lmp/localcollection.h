@@ -34,6 +34,7 @@
 #include <QSet>
 #include <QFutureWatcher>
 #include <QIcon>
+#include <QElapsedTimer>
 #include "interfaces/lmp/collectiontypes.h"
 #include "interfaces/lmp/ilocalcollection.h"
 #include "mediainfo.h"
@@ -84,6 +85,11 @@ namespace LMP
 		QFutureWatcher<MediaInfo> *Watcher_;
 		QList<QSet<QString>> NewPathsQueue_;
 
+		static constexpr int ScanCommitBatchSize = 500;
+		QList<MediaInfo> ScannedNewInfos_;
+		QList<MediaInfo> ScannedExistingInfos_;
+		QElapsedTimer ScanTimer_;
+
 		int UpdateNewArtists_ = 0;
 		int UpdateNewAlbums_ = 0;
 		int UpdateNewTracks_ = 0;
@@ -163,8 +169,10 @@ namespace LMP
 		void CheckRemovedFiles (const QSet<QString>& scanned, const QString& root);
 
 		void InitiateScan (const QSet<QString>&);
+		void CommitScannedInfos ();
 		void RescanOnLoad ();
 	private slots:
+		void handleScanResults (int, int);
 		void handleScanFinished ();
 		void saveRootPaths ();
 	signals:
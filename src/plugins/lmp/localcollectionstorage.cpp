@@ -364,6 +364,33 @@ namespace LMP
 		}
 	}
 
+	QHash<QString, QDateTime> LocalCollectionStorage::GetMTimes ()
+	{
+		QSqlQuery query { DB_ };
+		if (!query.exec ("SELECT tracks.Path, fileTimes.MTime FROM tracks "
+				"LEFT OUTER JOIN fileTimes ON tracks.Id = fileTimes.TrackID;"))
+		{
+			Util::DBLock::DumpError (query);
+			throw std::runtime_error ("cannot get files mtimes");
+		}
+
+		QHash<QString, QDateTime> result;
+		while (query.next ())
+			result [query.value (0).toString ()] = query.value (1).toDateTime ();
+		return result;
+	}
+
+	void LocalCollectionStorage::SetMTimes (const QList<QPair<QString, QDateTime>>& mtimes)
+	{
+		Util::DBLock lock { DB_ };
+		lock.Init ();
+
+		for (const auto& pair : mtimes)
+			SetMTime (pair.first, pair.second);
+
+		lock.Good ();
+	}
+
 	const int LovedStateID = 1;
 	const int BannedStateID = 2;
 
@@ -117,6 +117,12 @@ namespace LMP
 		QDateTime GetMTime (const QString&);
 		void SetMTime (const QString&, const QDateTime&);
 
+		/** Returns the stored modification times of all the tracks.
+		 * The tracks without a stored mtime map to a null QDateTime.
+		 */
+		QHash<QString, QDateTime> GetMTimes ();
+		void SetMTimes (const QList<QPair<QString, QDateTime>>&);
+
 		void SetTrackLoved (int);
 		void SetTrackBanned (int);
 		void ClearTrackLovedBanned (int);
@@ -43,10 +43,16 @@ namespace LMP
 {
 	TagLib::FileRef LocalFileResolver::GetFileRef (const QString& file) const
 	{
+		return GetFileRef (file, TagLib::AudioProperties::Accurate);
+	}
+
+	TagLib::FileRef LocalFileResolver::GetFileRef (const QString& file,
+			TagLib::AudioProperties::ReadStyle style) const
+	{
 #ifdef Q_OS_WIN32
-		return TagLib::FileRef (reinterpret_cast<const wchar_t*> (file.utf16 ()));
+		return TagLib::FileRef (reinterpret_cast<const wchar_t*> (file.utf16 ()), true, style);
 #else
-		return TagLib::FileRef (file.toUtf8 ().constData (), true, TagLib::AudioProperties::Accurate);
+		return TagLib::FileRef (file.toUtf8 ().constData (), true, style);
 #endif
 	}
 
@@ -64,9 +70,25 @@ namespace LMP
 			}
 		}
 
-		QMutexLocker tlLocker (&TaglibMutex_);
+		const auto& result = ScanInfo (file, TagLib::AudioProperties::Accurate);
+		if (result.IsRight ())
+		{
+			QWriteLocker locker (&CacheLock_);
+			if (Cache_.size () > 200)
+				Cache_.clear ();
+			Cache_ [file] = qMakePair (modified, result.GetRight ());
+		}
+		return result;
+	}
+
+	LocalFileResolver::ResolveResult_t LocalFileResolver::ScanInfo (const QString& file,
+			TagLib::AudioProperties::ReadStyle style)
+	{
+		// TagLib is fine with different files being read in parallel,
+		// only the tags writers need exclusive access.
+		QReadLocker tlLocker (&TaglibLock_);
 
-		auto r = GetFileRef (file);
+		auto r = GetFileRef (file, style);
 		auto tag = r.tag ();
 		if (!tag)
 			return ResolveResult_t::Left ({ file, "cannot get audio tags" });
@@ -95,18 +117,12 @@ namespace LMP
 			static_cast<qint32> (tag->year ()),
 			static_cast<qint32> (tag->track ())
 		};
-		{
-			QWriteLocker locker (&CacheLock_);
-			if (Cache_.size () > 200)
-				Cache_.clear ();
-			Cache_ [file] = qMakePair (modified, info);
-		}
 		return ResolveResult_t::Right (info);
 	}
 
-	QMutex& LocalFileResolver::GetMutex ()
+	QReadWriteLock& LocalFileResolver::GetLock ()
 	{
-		return TaglibMutex_;
+		return TaglibLock_;
 	}
 
 	void LocalFileResolver::flushCache ()
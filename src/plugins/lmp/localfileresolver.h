@@ -33,9 +33,9 @@
 #include <QObject>
 #include <QHash>
 #include <QReadWriteLock>
-#include <QMutex>
 #include <QDateTime>
 #include <taglib/fileref.h>
+#include <taglib/audioproperties.h>
 #include "interfaces/lmp/itagresolver.h"
 #include "mediainfo.h"
 
@@ -49,15 +49,22 @@ namespace LMP
 		Q_OBJECT
 		Q_INTERFACES (LeechCraft::LMP::ITagResolver)
 
-		QMutex TaglibMutex_;
+		QReadWriteLock TaglibLock_;
 		QReadWriteLock CacheLock_;
 		QHash<QString, QPair<QDateTime, MediaInfo>> Cache_;
 	public:
 		using QObject::QObject;
 
 		TagLib::FileRef GetFileRef (const QString&) const;
+		TagLib::FileRef GetFileRef (const QString&, TagLib::AudioProperties::ReadStyle) const;
 		ResolveResult_t ResolveInfo (const QString&);
-		QMutex& GetMutex ();
+
+		/** Resolves the file bypassing the cache, so that bulk
+		 * collection scans neither thrash it nor serialize on it.
+		 */
+		ResolveResult_t ScanInfo (const QString&, TagLib::AudioProperties::ReadStyle);
+
+		QReadWriteLock& GetLock ();
 	private slots:
 		void flushCache ();
 	};
@@ -861,6 +861,26 @@ namespace Monocle
 		emit pagesVisibilityChanged (rects);
 	}
 
+	void DocumentTab::PrefetchPages (int current, int previous)
+	{
+		if (current < 0 || previous < 0 || current == previous)
+			return;
+
+		const auto direction = current > previous ? 1 : -1;
+		const auto edge = direction > 0 ? Qt::TopEdge : Qt::BottomEdge;
+		const auto length = Ui_.PagesView_->viewport ()->height ();
+
+		const auto count = 2 * LayoutManager_->GetLayoutModeCount ();
+		for (int i = 1; i <= count; ++i)
+		{
+			const auto idx = current + direction * i;
+			if (idx < 0 || idx >= Pages_.size ())
+				break;
+
+			Pages_.at (idx)->Prefetch (edge, length);
+		}
+	}
+
 	void DocumentTab::handleLoaderReady (const IDocument_ptr& document, const QString& path)
 	{
 		if (!document || !document->IsValid ())
@@ -1255,6 +1275,8 @@ namespace Monocle
 		if (PrevCurrentPage_ == current && !force)
 			return;
 
+		PrefetchPages (current, PrevCurrentPage_);
+
 		PrevCurrentPage_ = current;
 		emit currentPageChanged (current);
 	}
@@ -114,7 +114,7 @@ namespace Monocle
 
 		bool SaveStateScheduled_;
 
-		int PrevCurrentPage_;
+		int PrevCurrentPage_ = -1;
 
 		struct OnloadData
 		{
@@ -167,6 +167,7 @@ namespace Monocle
 		QString GetSelectionText () const;
 
 		void RegenPageVisibility ();
+		void PrefetchPages (int, int);
 	private slots:
 		void handleLoaderReady (const IDocument_ptr&, const QString&);
 
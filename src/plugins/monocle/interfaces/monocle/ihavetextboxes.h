@@ -0,0 +1,98 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include <QtPlugin>
+
+namespace LeechCraft
+{
+namespace Monocle
+{
+	/** @brief Describes a single word on a page along with its position.
+	 *
+	 * @sa IHaveTextBoxes
+	 */
+	struct TextBox
+	{
+		/** @brief The text of the box, typically a single word.
+		 */
+		QString Text_;
+
+		/** @brief The bounding rectangle of the box in page coordinates.
+		 *
+		 * That is, from 0 to page width and page height correspondingly
+		 * as returned by IDocument::GetPageSize().
+		 */
+		QRectF Rect_;
+
+		/** @brief Whether the box is followed by a whitespace.
+		 */
+		bool SpaceAfter_;
+	};
+
+	/** @brief Interface for documents supporting text layout extraction.
+	 *
+	 * This interface should be implemented by the documents of formats
+	 * that can provide the text of a page split into boxes (typically
+	 * words) with their positions. Monocle uses this to build a
+	 * full-text index of the document in the background, so that
+	 * searching doesn't have to query the document for each search
+	 * string.
+	 *
+	 * @note GetTextBoxes() is called from a background thread, and it
+	 * may run concurrently with other methods of the document, so the
+	 * implementation should take care of the necessary synchronization.
+	 *
+	 * @sa ISearchableDocument, IHaveTextContent
+	 */
+	class IHaveTextBoxes
+	{
+	public:
+		/** @brief Virtual destructor.
+		 */
+		virtual ~IHaveTextBoxes () {}
+
+		/** @brief Returns the text boxes at the given page.
+		 *
+		 * The boxes should be returned in reading order.
+		 *
+		 * @param[in] page The index of the page to query.
+		 * @return The list of text boxes at the \em page.
+		 */
+		virtual QList<TextBox> GetTextBoxes (int page) = 0;
+	};
+}
+}
+
+Q_DECLARE_INTERFACE (LeechCraft::Monocle::IHaveTextBoxes,
+		"org.LeechCraft.Monocle.IHaveTextBoxes/1.0")
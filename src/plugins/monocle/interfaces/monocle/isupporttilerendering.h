@@ -0,0 +1,83 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+class QImage;
+class QRect;
+
+namespace LeechCraft
+{
+namespace Monocle
+{
+	/** @brief Interface for documents supporting rendering page regions.
+	 *
+	 * This interface should be implemented by IDocument objects that
+	 * can render just a part of a page faster (or using less memory)
+	 * than rendering the whole page via IDocument::RenderPage() and
+	 * cropping the result.
+	 *
+	 * Monocle uses this interface to only render the visible tiles of
+	 * a page at high zoom levels.
+	 *
+	 * Tiles are rendered in separate threads if the backend plugin
+	 * returns true from IBackendPlugin::IsThreaded(), so this method
+	 * should be thread-safe in that case.
+	 *
+	 * @sa IDocument, IBackendPlugin::IsThreaded()
+	 */
+	class ISupportTileRendering
+	{
+	public:
+		virtual ~ISupportTileRendering () {}
+
+		/** @brief Renders the given region of the given page.
+		 *
+		 * The \em tile rectangle is in the coordinates of the page
+		 * rendered at the given \em xScale and \em yScale, so the
+		 * result of this function should be equal to the following:
+		 * \code
+			RenderPage (page, xScale, yScale).copy (tile);
+		   \endcode
+		 *
+		 * @param[in] page The index of the page to render.
+		 * @param[in] xScale The scale of the <em>x</em> axis.
+		 * @param[in] yScale The scale of the <em>y</em> axis.
+		 * @param[in] tile The region of the scaled page to render.
+		 * @return The rendering of the given region.
+		 *
+		 * @sa IDocument::RenderPage()
+		 */
+		virtual QImage RenderPageTile (int page, double xScale, double yScale, const QRect& tile) = 0;
+	};
+}
+}
+
+Q_DECLARE_INTERFACE (LeechCraft::Monocle::ISupportTileRendering,
+		"org.LeechCraft.Monocle.ISupportTileRendering/1.0")
@@ -62,7 +62,7 @@ namespace Monocle
 				IHaveRecoverableTabs
 				IHaveShortcuts)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle" FILE "manifest.json")
 
 		Util::XmlSettingsDialog_ptr XSD_;
 
@@ -28,11 +28,15 @@
  **********************************************************************/
 
 #include "pagegraphicsitem.h"
+#include <algorithm>
 #include <limits>
 #include <cmath>
 #include <QtDebug>
 #include <QtConcurrentRun>
 #include <QFutureWatcher>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
 #include <QGraphicsSceneMouseEvent>
 #include <QCursor>
 #include <QApplication>
@@ -40,6 +44,8 @@
 #include <QGraphicsView>
 #include <QMenu>
 #include <QWidgetAction>
+#include "interfaces/monocle/ibackendplugin.h"
+#include "interfaces/monocle/isupporttilerendering.h"
 #include "core.h"
 #include "pixmapcachemanager.h"
 #include "arbitraryrotationwidget.h"
@@ -49,23 +55,36 @@ namespace LeechCraft
 {
 namespace Monocle
 {
+	namespace
+	{
+		const int TileSize = 512;
+
+		/* The low-resolution rendering of the whole page used as a
+		 * placeholder until the tiles at the current scale are ready.
+		 */
+		const int PreviewTile = -1;
+		const int PreviewMaxDimension = 256;
+	}
+
 	PageGraphicsItem::PageGraphicsItem (IDocument_ptr doc, int page, QGraphicsItem *parent)
-	: QGraphicsPixmapItem (parent)
+	: QGraphicsItem (parent)
 	, Doc_ (doc)
 	, PageNum_ (page)
+	, IsThreaded_ (qobject_cast<IBackendPlugin*> (doc->GetBackendPlugin ())->IsThreaded ())
+	, SupportsTiles_ (qobject_cast<ISupportTileRendering*> (doc->GetQObject ()))
+	, Generation_ (std::make_shared<std::atomic<int>> (0))
 	{
-		setTransformationMode (Qt::SmoothTransformation);
-		setShapeMode (QGraphicsPixmapItem::BoundingRectShape);
-		setPixmap (QPixmap (Doc_->GetPageSize (page)));
+		setFlag (ItemUsesExtendedStyleOption);
 		setAcceptHoverEvents (true);
 	}
 
 	PageGraphicsItem::~PageGraphicsItem ()
 	{
-		Core::Instance ().GetPixmapCacheManager ()->PixmapDeleted (this);
+		++*Generation_;
 
-		if (RenderFuture_)
-			RenderFuture_->waitForFinished ();
+		const auto cacheMgr = Core::Instance ().GetPixmapCacheManager ();
+		for (auto i = Tiles_.begin (); i != Tiles_.end (); ++i)
+			cacheMgr->TileDropped (this, i.key ());
 	}
 
 	void PageGraphicsItem::SetLayoutManager (PagesLayoutManager *manager)
@@ -84,15 +103,12 @@ namespace Monocle
 			std::abs (ys - YScale_) < std::numeric_limits<double>::epsilon ())
 			return;
 
+		prepareGeometryChange ();
+
 		XScale_ = xs;
 		YScale_ = ys;
 
-		Invalid_ = true;
-
-		if (IsDisplayed ())
-			update ();
-		else
-			prepareGeometryChange ();
+		DropTiles (false);
 
 		for (const auto& info : Item2RectInfo_)
 			info.Setter_ (MapFromDoc (info.DocRect_));
@@ -137,45 +153,64 @@ namespace Monocle
 		Item2RectInfo_.remove (item);
 	}
 
-	void PageGraphicsItem::ClearPixmap ()
+	void PageGraphicsItem::UpdatePixmap ()
+	{
+		DropTiles (true);
+		if (IsDisplayed ())
+			update ();
+	}
+
+	void PageGraphicsItem::Prefetch (Qt::Edge edge, qreal length)
 	{
-		setPixmap (QPixmap { QSize { 1, 1 } });
+		if (NeedsPreview ())
+			RequestTile (PreviewTile);
+
+		QRectF band { QPointF {}, GetScaledSize () };
+		switch (edge)
+		{
+		case Qt::TopEdge:
+			band.setHeight (std::min (length, band.height ()));
+			break;
+		case Qt::BottomEdge:
+			band.setTop (std::max (0., band.bottom () - length));
+			break;
+		case Qt::LeftEdge:
+			band.setWidth (std::min (length, band.width ()));
+			break;
+		case Qt::RightEdge:
+			band.setLeft (std::max (0., band.right () - length));
+			break;
+		}
 
-		Invalid_ = true;
+		for (const auto tile : GetTiles (band))
+			RequestTile (tile);
 	}
 
-	void PageGraphicsItem::UpdatePixmap ()
+	void PageGraphicsItem::EvictTile (int tile)
 	{
-		Invalid_ = true;
-		if (IsDisplayed ())
-			update ();
+		Tiles_.remove (tile);
 	}
 
 	void PageGraphicsItem::paint (QPainter *painter,
-			const QStyleOptionGraphicsItem *option, QWidget *w)
+			const QStyleOptionGraphicsItem *option, QWidget*)
 	{
-		if (Invalid_ && IsDisplayed ())
+		const auto cacheMgr = Core::Instance ().GetPixmapCacheManager ();
+
+		for (const auto tile : GetTiles (option->exposedRect))
 		{
-			auto backendObj = Doc_->GetBackendPlugin ();
-			if (qobject_cast<IBackendPlugin*> (backendObj)->IsThreaded ())
-			{
-				if (!RenderFuture_)
-					RequestThreadedRender ();
+			const auto& rect = GetTileRect (tile);
 
-				setPixmap (GetEmptyPixmap (true));
-			}
-			else
+			const auto pos = Tiles_.find (tile);
+			if (pos == Tiles_.end ())
 			{
-				const auto& img = Doc_->RenderPage (PageNum_, XScale_, YScale_);
-				setPixmap (QPixmap::fromImage (img));
+				PaintPlaceholder (painter, rect);
+				RequestTile (tile);
+				continue;
 			}
-			Invalid_ = false;
 
-			Core::Instance ().GetPixmapCacheManager ()->PixmapChanged (this);
+			painter->drawPixmap (rect.topLeft (), *pos);
+			cacheMgr->TilePainted (this, tile);
 		}
-
-		QGraphicsPixmapItem::paint (painter, option, w);
-		Core::Instance ().GetPixmapCacheManager ()->PixmapPainted (this);
 	}
 
 	void PageGraphicsItem::mousePressEvent (QGraphicsSceneMouseEvent *event)
@@ -227,47 +262,203 @@ namespace Monocle
 		rotateMenu.exec (event->screenPos ());
 	}
 
-	QPixmap PageGraphicsItem::GetEmptyPixmap (bool fill) const
+	QSize PageGraphicsItem::GetScaledSize () const
 	{
 		auto size = Doc_->GetPageSize (PageNum_);
 		size.rwidth () *= XScale_;
 		size.rheight () *= YScale_;
-		QPixmap px { size };
-		if (fill)
-			px.fill ();
-		return px;
+		return size;
 	}
 
-	void PageGraphicsItem::RequestThreadedRender ()
+	QSize PageGraphicsItem::GetTileSize () const
 	{
-		RenderFuture_.reset (new QFutureWatcher<RenderInfo>,
-				[this] (QFutureWatcher<RenderInfo> *watcher)
-				{
-					disconnect (watcher, 0, this, 0);
-					watcher->deleteLater ();
-				});
-		connect (RenderFuture_.get (),
+		return SupportsTiles_ ?
+				QSize { TileSize, TileSize } :
+				GetScaledSize ();
+	}
+
+	QRect PageGraphicsItem::GetTileRect (int tile) const
+	{
+		const QRect pageRect { QPoint {}, GetScaledSize () };
+		if (tile == PreviewTile || !SupportsTiles_)
+			return pageRect;
+
+		const auto cols = (pageRect.width () + TileSize - 1) / TileSize;
+		const QRect rect { tile % cols * TileSize, tile / cols * TileSize, TileSize, TileSize };
+		return rect.intersected (pageRect);
+	}
+
+	QList<int> PageGraphicsItem::GetTiles (const QRectF& area) const
+	{
+		const QRect pageRect { QPoint {}, GetScaledSize () };
+		const auto& rect = area.toAlignedRect ().intersected (pageRect);
+		if (rect.isEmpty ())
+			return {};
+
+		const auto& tileSize = GetTileSize ();
+		const auto cols = (pageRect.width () + tileSize.width () - 1) / tileSize.width ();
+
+		QList<int> result;
+		for (int row = rect.top () / tileSize.height (); row <= rect.bottom () / tileSize.height (); ++row)
+			for (int col = rect.left () / tileSize.width (); col <= rect.right () / tileSize.width (); ++col)
+				result << row * cols + col;
+		return result;
+	}
+
+	double PageGraphicsItem::GetPreviewScale () const
+	{
+		const auto& size = Doc_->GetPageSize (PageNum_);
+		const auto maxDim = std::max (size.width (), size.height ());
+		return maxDim > 0 ?
+				std::min (1., static_cast<double> (PreviewMaxDimension) / maxDim) :
+				1;
+	}
+
+	bool PageGraphicsItem::NeedsPreview () const
+	{
+		return std::max (XScale_, YScale_) > 2 * GetPreviewScale ();
+	}
+
+	void PageGraphicsItem::PaintPlaceholder (QPainter *painter, const QRect& rect)
+	{
+		const auto pos = Tiles_.find (PreviewTile);
+		if (pos == Tiles_.end ())
+		{
+			painter->fillRect (rect, Qt::white);
+			if (NeedsPreview ())
+				RequestTile (PreviewTile);
+			return;
+		}
+
+		const auto& preview = *pos;
+		const auto& pageSize = GetScaledSize ();
+		const auto xRatio = static_cast<double> (preview.width ()) / pageSize.width ();
+		const auto yRatio = static_cast<double> (preview.height ()) / pageSize.height ();
+		const QRectF source
+		{
+			rect.x () * xRatio,
+			rect.y () * yRatio,
+			rect.width () * xRatio,
+			rect.height () * yRatio
+		};
+
+		painter->save ();
+		painter->setRenderHint (QPainter::SmoothPixmapTransform);
+		painter->drawPixmap (QRectF { rect }, preview, source);
+		painter->restore ();
+
+		Core::Instance ().GetPixmapCacheManager ()->TilePainted (this, PreviewTile);
+	}
+
+	std::function<QImage ()> PageGraphicsItem::MakeRenderer (int tile) const
+	{
+		const auto doc = Doc_;
+		const auto page = PageNum_;
+
+		if (tile == PreviewTile)
+		{
+			const auto scale = GetPreviewScale ();
+			return [doc, page, scale] { return doc->RenderPage (page, scale, scale); };
+		}
+
+		const auto xScale = XScale_;
+		const auto yScale = YScale_;
+		if (!SupportsTiles_)
+			return [doc, page, xScale, yScale] { return doc->RenderPage (page, xScale, yScale); };
+
+		const auto& rect = GetTileRect (tile);
+		return [doc, page, xScale, yScale, rect]
+		{
+			const auto tiled = qobject_cast<ISupportTileRendering*> (doc->GetQObject ());
+			return tiled->RenderPageTile (page, xScale, yScale, rect);
+		};
+	}
+
+	void PageGraphicsItem::RequestTile (int tile)
+	{
+		if (Tiles_.contains (tile) || PendingTiles_.contains (tile))
+			return;
+
+		PendingTiles_ << tile;
+
+		/* Non-threaded backends still render in the GUI thread, but
+		 * one tile per event loop iteration, so that the view stays
+		 * responsive and shows the placeholders meanwhile.
+		 */
+		if (!IsThreaded_)
+		{
+			RenderQueue_.prepend (tile);
+			if (!RenderQueueScheduled_)
+			{
+				RenderQueueScheduled_ = true;
+				QTimer::singleShot (0, this, SLOT (renderQueued ()));
+			}
+			return;
+		}
+
+		const auto watcher = new QFutureWatcher<RenderInfo> (this);
+		connect (watcher,
 				SIGNAL (finished ()),
 				this,
-				SLOT (handlePixmapRendered ()));
+				SLOT (handleTileRendered ()));
 
-		// C++14
-		auto xscale = XScale_;
-		auto yscale = YScale_;
-		RenderFuture_->setFuture (QtConcurrent::run ([this, xscale, yscale]
+		const auto& renderer = MakeRenderer (tile);
+		const auto generation = Generation_;
+		const auto expected = Generation_->load ();
+		watcher->setFuture (QtConcurrent::run ([renderer, generation, expected, tile]
 				{
-					return RenderInfo
-					{
-						Doc_->RenderPage (PageNum_, yscale, yscale),
-						xscale,
-						yscale
-					};
+					if (generation->load () != expected)
+						return RenderInfo { {}, tile, expected };
+
+					return RenderInfo { renderer (), tile, expected };
 				}));
 	}
 
+	void PageGraphicsItem::StoreTile (int tile, const QImage& image)
+	{
+		PendingTiles_.remove (tile);
+
+		const auto& px = QPixmap::fromImage (image);
+		Tiles_ [tile] = px;
+		Core::Instance ().GetPixmapCacheManager ()->TileChanged (this, tile, px);
+
+		update (GetTileRect (tile));
+	}
+
+	void PageGraphicsItem::DropTiles (bool withPreview)
+	{
+		++*Generation_;
+
+		const auto cacheMgr = Core::Instance ().GetPixmapCacheManager ();
+		for (auto i = Tiles_.begin (); i != Tiles_.end (); )
+		{
+			if (!withPreview && i.key () == PreviewTile)
+			{
+				++i;
+				continue;
+			}
+
+			cacheMgr->TileDropped (this, i.key ());
+			i = Tiles_.erase (i);
+		}
+
+		PendingTiles_.clear ();
+		RenderQueue_.clear ();
+	}
+
 	bool PageGraphicsItem::IsDisplayed () const
 	{
-		const auto& thisMapped = mapToScene (boundingRect ()).boundingRect ();
+		return IsDisplayed (boundingRect ());
+	}
+
+	bool PageGraphicsItem::IsTileDisplayed (int tile) const
+	{
+		return IsDisplayed (GetTileRect (tile));
+	}
+
+	bool PageGraphicsItem::IsDisplayed (const QRectF& rect) const
+	{
+		const auto& thisMapped = mapToScene (rect).boundingRect ();
 
 		for (auto view : scene ()->views ())
 		{
@@ -283,10 +474,7 @@ namespace Monocle
 
 	QRectF PageGraphicsItem::boundingRect () const
 	{
-		auto size = Doc_->GetPageSize (PageNum_);
-		size.rwidth () *= XScale_;
-		size.rheight () *= YScale_;
-		return QRectF { offset (), size };
+		return QRectF { QPointF {}, GetScaledSize () };
 	}
 
 	QPainterPath PageGraphicsItem::shape () const
@@ -322,24 +510,34 @@ namespace Monocle
 		ArbWidget_->setValue (rotation + LayoutManager_->GetRotation ());
 	}
 
-	void PageGraphicsItem::handlePixmapRendered ()
+	void PageGraphicsItem::renderQueued ()
 	{
-		if (sender () != RenderFuture_.get ())
+		RenderQueueScheduled_ = false;
+		if (RenderQueue_.isEmpty ())
 			return;
 
-		const auto& result = RenderFuture_->result ();
-		RenderFuture_.reset ();
-
-		setPixmap (QPixmap::fromImage (result.Result_));
+		const auto tile = RenderQueue_.removeOne (PreviewTile) ?
+				PreviewTile :
+				RenderQueue_.takeFirst ();
+		StoreTile (tile, MakeRenderer (tile) ());
 
-		if (std::abs (result.XScale_ - XScale_) > std::numeric_limits<double>::epsilon () * XScale_ ||
-			std::abs (result.YScale_ - YScale_) > std::numeric_limits<double>::epsilon () * YScale_)
+		if (!RenderQueue_.isEmpty ())
 		{
-			UpdatePixmap ();
-			return;
+			RenderQueueScheduled_ = true;
+			QTimer::singleShot (0, this, SLOT (renderQueued ()));
 		}
+	}
+
+	void PageGraphicsItem::handleTileRendered ()
+	{
+		const auto watcher = static_cast<QFutureWatcher<RenderInfo>*> (sender ());
+		watcher->deleteLater ();
+
+		const auto& info = watcher->result ();
+		if (info.Generation_ != Generation_->load ())
+			return;
 
-		Core::Instance ().GetPixmapCacheManager ()->PixmapChanged (this);
+		StoreTile (info.Tile_, info.Result_);
 	}
 }
 }
@@ -29,15 +29,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
-#include <QGraphicsPixmapItem>
+#include <QGraphicsItem>
 #include <QPointer>
+#include <QHash>
+#include <QSet>
 #include "interfaces/monocle/idocument.h"
 
-template<typename T>
-class QFutureWatcher;
-
 namespace LeechCraft
 {
 namespace Monocle
@@ -46,7 +46,7 @@ namespace Monocle
 	class ArbitraryRotationWidget;
 
 	class PageGraphicsItem : public QObject
-						   , public QGraphicsPixmapItem
+						   , public QGraphicsItem
 	{
 		Q_OBJECT
 
@@ -56,7 +56,8 @@ namespace Monocle
 		qreal XScale_ = 1;
 		qreal YScale_ = 1;
 
-		bool Invalid_ = true;
+		const bool IsThreaded_;
+		const bool SupportsTiles_;
 
 		std::function<void (int, QPointF)> ReleaseHandler_;
 
@@ -64,13 +65,19 @@ namespace Monocle
 
 		QPointer<ArbitraryRotationWidget> ArbWidget_;
 
+		QHash<int, QPixmap> Tiles_;
+		QSet<int> PendingTiles_;
+		QList<int> RenderQueue_;
+		bool RenderQueueScheduled_ = false;
+
+		const std::shared_ptr<std::atomic<int>> Generation_;
+
 		struct RenderInfo
 		{
 			QImage Result_;
-			double XScale_;
-			double YScale_;
+			int Tile_;
+			int Generation_;
 		};
-		std::shared_ptr<QFutureWatcher<RenderInfo>> RenderFuture_;
 	public:
 		typedef std::function<void (QRectF)> RectSetter_f;
 	private:
@@ -97,10 +104,13 @@ namespace Monocle
 		void RegisterChildRect (QGraphicsItem*, const QRectF&, RectSetter_f);
 		void UnregisterChildRect (QGraphicsItem*);
 
-		void ClearPixmap ();
 		void UpdatePixmap ();
 
+		void Prefetch (Qt::Edge, qreal height);
+
 		bool IsDisplayed () const;
+		bool IsTileDisplayed (int) const;
+		void EvictTile (int);
 
 		QRectF boundingRect () const;
 		QPainterPath shape () const;
@@ -110,8 +120,22 @@ namespace Monocle
 		void mouseReleaseEvent (QGraphicsSceneMouseEvent*);
 		void contextMenuEvent (QGraphicsSceneContextMenuEvent*);
 	private:
-		QPixmap GetEmptyPixmap (bool fill) const;
-		void RequestThreadedRender ();
+		QSize GetScaledSize () const;
+		QSize GetTileSize () const;
+		QRect GetTileRect (int) const;
+		QList<int> GetTiles (const QRectF&) const;
+
+		double GetPreviewScale () const;
+		bool NeedsPreview () const;
+
+		bool IsDisplayed (const QRectF&) const;
+
+		void PaintPlaceholder (QPainter*, const QRect&);
+
+		std::function<QImage ()> MakeRenderer (int) const;
+		void RequestTile (int);
+		void StoreTile (int, const QImage&);
+		void DropTiles (bool withPreview);
 	private slots:
 		void rotateCCW ();
 		void rotateCW ();
@@ -119,7 +143,8 @@ namespace Monocle
 
 		void updateRotation (double, int);
 
-		void handlePixmapRendered ();
+		void renderQueued ();
+		void handleTileRendered ();
 	signals:
 		void rotateRequested (double);
 	};
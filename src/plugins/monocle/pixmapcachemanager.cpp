@@ -28,7 +28,7 @@
  **********************************************************************/
 
 #include "pixmapcachemanager.h"
-#include <numeric>
+#include <QPixmap>
 #include <QtDebug>
 #include "xmlsettingsmanager.h"
 #include "pagegraphicsitem.h"
@@ -47,54 +47,80 @@ namespace Monocle
 
 	namespace
 	{
-		quint64 GetPixmapSize (const QPixmap& px)
+		qint64 GetPixmapSize (const QPixmap& px)
 		{
 			if (px.isNull ())
 				return 0;
 
-			return px.width () * px.height () * px.defaultDepth () / 8 * 1.5;
+			return static_cast<qint64> (px.width ()) * px.height () * px.depth () / 8 * 1.5;
 		}
 	}
 
-	void PixmapCacheManager::PixmapPainted (PageGraphicsItem *item)
+	void PixmapCacheManager::TilePainted (PageGraphicsItem *item, int tile)
 	{
-		RecentlyUsed_.removeAll (item);
-		RecentlyUsed_ << item;
+		const auto pos = Key2Entry_.find ({ item, tile });
+		if (pos == Key2Entry_.end ())
+			return;
+
+		RecentlyUsed_.splice (RecentlyUsed_.end (), RecentlyUsed_, *pos);
 	}
 
-	void PixmapCacheManager::PixmapChanged (PageGraphicsItem *item)
+	void PixmapCacheManager::TileChanged (PageGraphicsItem *item, int tile, const QPixmap& px)
 	{
-		if (RecentlyUsed_.removeAll (item))
-			CurrentSize_ = std::accumulate (RecentlyUsed_.begin (), RecentlyUsed_.end (), 0,
-					[] (qint64 size, const PageGraphicsItem *item)
-						{ return size + GetPixmapSize (item->pixmap ()); });
+		const auto size = GetPixmapSize (px);
+
+		const auto pos = Key2Entry_.find ({ item, tile });
+		if (pos != Key2Entry_.end ())
+		{
+			const auto entry = *pos;
+			CurrentSize_ += size - entry->Size_;
+			entry->Size_ = size;
+			RecentlyUsed_.splice (RecentlyUsed_.end (), RecentlyUsed_, entry);
+		}
+		else
+		{
+			RecentlyUsed_.push_back ({ item, tile, size });
+			Key2Entry_ [{ item, tile }] = std::prev (RecentlyUsed_.end ());
+			CurrentSize_ += size;
+		}
 
-		RecentlyUsed_ << item;
-		CurrentSize_ += GetPixmapSize (item->pixmap ());
 		CheckCache ();
 	}
 
-	void PixmapCacheManager::PixmapDeleted (PageGraphicsItem *item)
+	void PixmapCacheManager::TileDropped (PageGraphicsItem *item, int tile)
 	{
-		CurrentSize_ -= GetPixmapSize (item->pixmap ());
-		RecentlyUsed_.removeAll (item);
+		const auto pos = Key2Entry_.find ({ item, tile });
+		if (pos == Key2Entry_.end ())
+			return;
+
+		CurrentSize_ -= (*pos)->Size_;
+		RecentlyUsed_.erase (*pos);
+		Key2Entry_.erase (pos);
 	}
 
 	void PixmapCacheManager::CheckCache ()
 	{
-		for (auto i = RecentlyUsed_.begin (); i != RecentlyUsed_.end () && MaxSize_ < CurrentSize_; )
+		/* Displayed tiles can't be evicted, so they are moved to the
+		 * end of the queue, and each entry is examined at most once.
+		 */
+		auto toCheck = RecentlyUsed_.size ();
+		while (MaxSize_ < CurrentSize_ && toCheck--)
 		{
-			const auto page = *i;
-			if (page->IsDisplayed ())
+			const auto entry = RecentlyUsed_.begin ();
+			if (entry->Page_->IsTileDisplayed (entry->Tile_))
 			{
-				++i;
+				RecentlyUsed_.splice (RecentlyUsed_.end (), RecentlyUsed_, entry);
 				continue;
 			}
 
-			const quint64 pxSize = GetPixmapSize (page->pixmap ());
-			CurrentSize_ -= pxSize;
-			page->ClearPixmap ();
-			i = RecentlyUsed_.erase (i);
+			const auto page = entry->Page_;
+			const auto tile = entry->Tile_;
+
+			CurrentSize_ -= entry->Size_;
+			Key2Entry_.remove ({ page, tile });
+			RecentlyUsed_.erase (entry);
+
+			page->EvictTile (tile);
 		}
 
 		if (MaxSize_ < CurrentSize_)
@@ -105,7 +131,7 @@ namespace Monocle
 					<< MaxSize_
 					<< "for"
 					<< RecentlyUsed_.size ()
-					<< "pages";
+					<< "tiles";
 	}
 
 	void PixmapCacheManager::handleCacheSizeChanged ()
@@ -29,7 +29,12 @@
 
 #pragma once
 
+#include <list>
 #include <QObject>
+#include <QHash>
+#include <QPair>
+
+class QPixmap;
 
 namespace LeechCraft
 {
@@ -43,13 +48,23 @@ namespace Monocle
 
 		qint64 CurrentSize_ = 0;
 		qint64 MaxSize_ = 0;
-		QList<PageGraphicsItem*> RecentlyUsed_;
+
+		struct Entry
+		{
+			PageGraphicsItem *Page_;
+			int Tile_;
+			qint64 Size_;
+		};
+		std::list<Entry> RecentlyUsed_;
+
+		typedef QPair<PageGraphicsItem*, int> Key_t;
+		QHash<Key_t, std::list<Entry>::iterator> Key2Entry_;
 	public:
 		PixmapCacheManager (QObject* = 0);
 
-		void PixmapPainted (PageGraphicsItem*);
-		void PixmapChanged (PageGraphicsItem*);
-		void PixmapDeleted (PageGraphicsItem*);
+		void TilePainted (PageGraphicsItem*, int);
+		void TileChanged (PageGraphicsItem*, int, const QPixmap&);
+		void TileDropped (PageGraphicsItem*, int);
 	private:
 		void CheckCache ();
 	private slots:
@@ -53,7 +53,7 @@ namespace Dik
 				LeechCraft::Monocle::IBackendPlugin
 				LeechCraft::Monocle::IKnowFileExtensions)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle.Dik")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle.Dik" FILE "manifest.json")
 	public:
 		void Init (ICoreProxy_ptr);
 		void SecondInit ();
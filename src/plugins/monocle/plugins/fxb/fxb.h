@@ -56,7 +56,7 @@ namespace FXB
 				LeechCraft::Monocle::IBackendPlugin
 				LeechCraft::Monocle::IKnowFileExtensions)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle.FXB")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle.FXB" FILE "manifest.json")
 
 		Util::XmlSettingsDialog_ptr XSD_;
 	public:
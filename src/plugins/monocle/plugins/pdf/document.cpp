@@ -135,6 +135,16 @@ namespace PDF
 		return page->renderToImage (72 * xScale, 72 * yScale);
 	}
 
+	QImage Document::RenderPageTile (int num, double xScale, double yScale, const QRect& tile)
+	{
+		std::unique_ptr<Poppler::Page> page (PDocument_->page (num));
+		if (!page)
+			return QImage ();
+
+		return page->renderToImage (72 * xScale, 72 * yScale,
+				tile.x (), tile.y (), tile.width (), tile.height ());
+	}
+
 	QList<ILink_ptr> Document::GetPageLinks (int num)
 	{
 		QList<ILink_ptr> result;
@@ -167,6 +177,31 @@ namespace PDF
 		return page->text (rect);
 	}
 
+	QList<TextBox> Document::GetTextBoxes (int num)
+	{
+		/* Text boxes are requested from a background thread, so a
+		 * separate Poppler document is used to not interfere with the
+		 * GUI thread.
+		 */
+		QMutexLocker locker { &TextDocLock_ };
+		if (!TextDoc_)
+			TextDoc_.reset (Poppler::Document::load (DocURL_.toLocalFile ()));
+		if (!TextDoc_)
+			return {};
+
+		std::unique_ptr<Poppler::Page> page (TextDoc_->page (num));
+		if (!page)
+			return {};
+
+		QList<TextBox> result;
+		for (const auto box : page->textList ())
+		{
+			result.append ({ box->text (), box->boundingBox (), box->hasSpaceAfter () });
+			delete box;
+		}
+		return result;
+	}
+
 	QAbstractItemModel* Document::GetOptContentModel ()
 	{
 		return PDocument_->hasOptionalContent () ?
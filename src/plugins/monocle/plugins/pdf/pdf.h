@@ -56,7 +56,7 @@ namespace PDF
 				LeechCraft::Monocle::IBackendPlugin
 				LeechCraft::Monocle::IKnowFileExtensions)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle.PDF")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle.PDF" FILE "manifest.json")
 
 		Util::XmlSettingsDialog_ptr XSD_;
 	public:
@@ -53,7 +53,7 @@ namespace Postrus
 				LeechCraft::Monocle::IBackendPlugin
 				LeechCraft::Monocle::IKnowFileExtensions)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle.Postrus")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle.Postrus" FILE "manifest.json")
 	public:
 		void Init (ICoreProxy_ptr);
 		void SecondInit ();
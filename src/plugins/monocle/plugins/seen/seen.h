@@ -57,7 +57,7 @@ namespace Seen
 				LeechCraft::Monocle::IKnowFileExtensions
 				LeechCraft::Monocle::IBackendPlugin)
 
-		LC_PLUGIN_METADATA ("org.LeechCraft.Monocle.Seen")
+		Q_PLUGIN_METADATA (IID "org.LeechCraft.Monocle.Seen" FILE "manifest.json")
 
 		ddjvu_context_t *Context_;
 		DocManager *DocMgr_;
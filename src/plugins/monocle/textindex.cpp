@@ -0,0 +1,400 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "textindex.h"
+#include <algorithm>
+#include <stdexcept>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QtConcurrentRun>
+#include <QtDebug>
+#include <util/sys/paths.h>
+#include <util/threads/futures.h>
+#include "interfaces/monocle/ihavetextboxes.h"
+
+namespace LeechCraft
+{
+namespace Monocle
+{
+	namespace
+	{
+		const int ChunkSize = 16;
+
+		const quint32 IndexMagic = 0x4d544958;
+		const quint8 IndexVersion = 1;
+
+		QString HashFile (const QString& path)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+				return {};
+
+			QCryptographicHash hash { QCryptographicHash::Sha1 };
+			if (!hash.addData (&file))
+				return {};
+
+			return hash.result ().toHex ();
+		}
+
+		QString GetIndexPath (const QString& hash)
+		{
+			try
+			{
+				auto dir = Util::CreateIfNotExists ("monocle/textindex");
+				if (!dir.exists (hash.at (0)))
+					dir.mkdir (hash.at (0));
+				return dir.absoluteFilePath (hash.at (0) + '/' + hash);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< e.what ();
+				return {};
+			}
+		}
+
+		QVector<TextIndex::Page> LoadIndex (const QString& path, int numPages)
+		{
+			QFile file { path };
+			if (!file.exists () || !file.open (QIODevice::ReadOnly))
+				return {};
+
+			QDataStream in { &file };
+			in.setVersion (QDataStream::Qt_5_0);
+
+			quint32 magic = 0;
+			quint8 version = 0;
+			qint32 storedNumPages = 0;
+			qint32 count = 0;
+			in >> magic >> version >> storedNumPages >> count;
+			if (magic != IndexMagic ||
+					version != IndexVersion ||
+					storedNumPages != numPages ||
+					count < 0 ||
+					count > numPages)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "ignoring incompatible index"
+						<< path;
+				return {};
+			}
+
+			QVector<TextIndex::Page> pages;
+			pages.reserve (count);
+			for (int i = 0; i < count; ++i)
+			{
+				TextIndex::Page page;
+				qint32 wordsCount = 0;
+				in >> page.Text_ >> wordsCount;
+				if (wordsCount < 0 || wordsCount > page.Text_.size ())
+				{
+					in.setStatus (QDataStream::ReadCorruptData);
+					break;
+				}
+
+				page.Words_.reserve (wordsCount);
+				for (int j = 0; j < wordsCount; ++j)
+				{
+					qint32 start = 0;
+					qint32 length = 0;
+					QRectF rect;
+					in >> start >> length >> rect;
+					page.Words_.append ({ start, length, rect });
+				}
+
+				if (in.status () != QDataStream::Ok)
+					break;
+
+				pages << page;
+			}
+
+			if (in.status () != QDataStream::Ok)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "corrupted index"
+						<< path;
+				return {};
+			}
+
+			return pages;
+		}
+
+		void SaveIndex (const QString& path, int numPages, const QVector<TextIndex::Page>& pages)
+		{
+			QSaveFile file { path };
+			if (!file.open (QIODevice::WriteOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< path
+						<< file.errorString ();
+				return;
+			}
+
+			QDataStream out { &file };
+			out.setVersion (QDataStream::Qt_5_0);
+			out << IndexMagic
+					<< IndexVersion
+					<< static_cast<qint32> (numPages)
+					<< static_cast<qint32> (pages.size ());
+			for (const auto& page : pages)
+			{
+				out << page.Text_
+						<< static_cast<qint32> (page.Words_.size ());
+				for (const auto& word : page.Words_)
+					out << static_cast<qint32> (word.Start_)
+							<< static_cast<qint32> (word.Length_)
+							<< word.Rect_;
+			}
+
+			if (!file.commit ())
+				qWarning () << Q_FUNC_INFO
+						<< "unable to save"
+						<< path
+						<< file.errorString ();
+		}
+
+		bool IsOnNextLine (const TextBox& box, const TextBox& next)
+		{
+			return next.Rect_.center ().y () > box.Rect_.bottom ();
+		}
+
+		TextIndex::Page BuildPage (const QList<TextBox>& boxes)
+		{
+			TextIndex::Page page;
+			page.Words_.reserve (boxes.size ());
+
+			for (int i = 0; i < boxes.size (); ++i)
+			{
+				const auto& box = boxes.at (i);
+				page.Words_.append ({ page.Text_.size (), box.Text_.size (), box.Rect_ });
+				page.Text_ += box.Text_;
+
+				if (box.SpaceAfter_ ||
+						(i < boxes.size () - 1 && IsOnNextLine (box, boxes.at (i + 1))))
+					page.Text_ += ' ';
+			}
+
+			return page;
+		}
+
+		QList<QRectF> FindInPage (const TextIndex::Page& page, const QString& text, Qt::CaseSensitivity cs)
+		{
+			QList<QRectF> result;
+
+			const auto& words = page.Words_;
+			for (auto pos = page.Text_.indexOf (text, 0, cs); pos >= 0;
+					pos = page.Text_.indexOf (text, pos + text.size (), cs))
+			{
+				const auto end = pos + text.size ();
+
+				auto word = std::upper_bound (words.begin (), words.end (), pos,
+						[] (int offset, const TextIndex::Word& word) { return offset < word.Start_; });
+				if (word != words.begin ())
+					--word;
+
+				/* The boxes only have word granularity, so the characters
+				 * are assumed to be of equal width within a word, and the
+				 * parts of a match on the same line are merged together.
+				 */
+				QRectF current;
+				for ( ; word != words.end () && word->Start_ < end; ++word)
+				{
+					const auto from = std::max (pos, word->Start_);
+					const auto to = std::min (end, word->Start_ + word->Length_);
+					if (from >= to)
+						continue;
+
+					const auto& wordRect = word->Rect_;
+					const auto charWidth = wordRect.width () / word->Length_;
+					const QRectF rect
+					{
+						wordRect.left () + (from - word->Start_) * charWidth,
+						wordRect.top (),
+						(to - from) * charWidth,
+						wordRect.height ()
+					};
+
+					if (current.isNull ())
+						current = rect;
+					else if (rect.top () < current.bottom () && rect.bottom () > current.top ())
+						current = current.united (rect);
+					else
+					{
+						result << current;
+						current = rect;
+					}
+				}
+
+				if (!current.isNull ())
+					result << current;
+			}
+
+			return result;
+		}
+
+		struct LoadResult
+		{
+			QString Hash_;
+			QVector<TextIndex::Page> Pages_;
+		};
+	}
+
+	TextIndex::TextIndex (const IDocument_ptr& doc, QObject *parent)
+	: QObject { parent }
+	, Doc_ { doc }
+	, Boxes_ { qobject_cast<IHaveTextBoxes*> (doc->GetQObject ()) }
+	, NumPages_ { doc->GetNumPages () }
+	, Cancelled_ { std::make_shared<std::atomic_bool> (false) }
+	, ResultsCache_ { 32 }
+	{
+		const auto& path = doc->GetDocURL ().toLocalFile ();
+		const auto numPages = NumPages_;
+		Util::Sequence (this,
+				QtConcurrent::run ([path, numPages]
+					{
+						LoadResult result;
+						if (path.isEmpty ())
+							return result;
+
+						result.Hash_ = HashFile (path);
+						if (!result.Hash_.isEmpty ())
+							result.Pages_ = LoadIndex (GetIndexPath (result.Hash_), numPages);
+						return result;
+					})) >>
+				[this] (const LoadResult& result)
+				{
+					Hash_ = result.Hash_;
+					Pages_ = result.Pages_;
+					SavedCount_ = Pages_.size ();
+					Loaded_ = true;
+
+					if (!Pages_.isEmpty ())
+						emit pagesIndexed (0, Pages_.size ());
+
+					ExtractNext ();
+				};
+	}
+
+	TextIndex::~TextIndex ()
+	{
+		*Cancelled_ = true;
+
+		if (Pages_.size () > SavedCount_)
+			Save ();
+	}
+
+	bool TextIndex::IsSupported (const IDocument_ptr& doc)
+	{
+		return qobject_cast<IHaveTextBoxes*> (doc->GetQObject ());
+	}
+
+	bool TextIndex::IsComplete () const
+	{
+		return Loaded_ && Pages_.size () == NumPages_;
+	}
+
+	auto TextIndex::Search (const QString& text, Qt::CaseSensitivity cs, int fromPage) -> Positions_t
+	{
+		if (text.isEmpty ())
+			return {};
+
+		const auto cacheable = !fromPage && IsComplete ();
+		const QPair<QString, int> cacheKey { text, cs };
+		if (cacheable)
+			if (const auto cached = ResultsCache_.object (cacheKey))
+				return *cached;
+
+		Positions_t result;
+		for (int i = fromPage; i < Pages_.size (); ++i)
+		{
+			const auto& rects = FindInPage (Pages_.at (i), text, cs);
+			if (!rects.isEmpty ())
+				result [i] = rects;
+		}
+
+		if (cacheable)
+			ResultsCache_.insert (cacheKey, new Positions_t { result });
+
+		return result;
+	}
+
+	void TextIndex::ExtractNext ()
+	{
+		if (IsComplete ())
+		{
+			if (Pages_.size () > SavedCount_)
+				Save ();
+			return;
+		}
+
+		const auto from = Pages_.size ();
+		const auto count = std::min (ChunkSize, NumPages_ - from);
+
+		const auto doc = Doc_;
+		const auto boxes = Boxes_;
+		const auto cancelled = Cancelled_;
+		Util::Sequence (this,
+				QtConcurrent::run ([doc, boxes, cancelled, from, count]
+					{
+						QVector<Page> pages;
+						for (int i = from; i < from + count && !*cancelled; ++i)
+							pages << BuildPage (boxes->GetTextBoxes (i));
+						return pages;
+					})) >>
+				[this, from] (const QVector<Page>& pages)
+				{
+					Pages_ += pages;
+					emit pagesIndexed (from, pages.size ());
+
+					ExtractNext ();
+				};
+	}
+
+	void TextIndex::Save ()
+	{
+		if (Hash_.isEmpty ())
+			return;
+
+		SavedCount_ = Pages_.size ();
+
+		const auto hash = Hash_;
+		const auto numPages = NumPages_;
+		const auto pages = Pages_;
+		QtConcurrent::run ([hash, numPages, pages]
+				{
+					const auto& path = GetIndexPath (hash);
+					if (!path.isEmpty ())
+						SaveIndex (path, numPages, pages);
+				});
+	}
+}
+}
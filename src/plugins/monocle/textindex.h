@@ -0,0 +1,96 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <QObject>
+#include <QVector>
+#include <QMap>
+#include <QRectF>
+#include <QCache>
+#include <QPair>
+#include "interfaces/monocle/idocument.h"
+
+namespace LeechCraft
+{
+namespace Monocle
+{
+	class IHaveTextBoxes;
+
+	class TextIndex : public QObject
+	{
+		Q_OBJECT
+	public:
+		struct Word
+		{
+			int Start_;
+			int Length_;
+			QRectF Rect_;
+		};
+
+		struct Page
+		{
+			QString Text_;
+			QVector<Word> Words_;
+		};
+
+		typedef QMap<int, QList<QRectF>> Positions_t;
+	private:
+		const IDocument_ptr Doc_;
+		IHaveTextBoxes * const Boxes_;
+		const int NumPages_;
+
+		QString Hash_;
+		bool Loaded_ = false;
+
+		QVector<Page> Pages_;
+		int SavedCount_ = 0;
+
+		const std::shared_ptr<std::atomic_bool> Cancelled_;
+
+		QCache<QPair<QString, int>, Positions_t> ResultsCache_;
+	public:
+		TextIndex (const IDocument_ptr&, QObject* = nullptr);
+		~TextIndex ();
+
+		static bool IsSupported (const IDocument_ptr&);
+
+		bool IsComplete () const;
+
+		Positions_t Search (const QString&, Qt::CaseSensitivity, int fromPage = 0);
+	private:
+		void ExtractNext ();
+		void Save ();
+	signals:
+		void pagesIndexed (int from, int count);
+	};
+}
+}
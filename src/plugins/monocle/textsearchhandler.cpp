@@ -35,6 +35,7 @@
 #include "interfaces/monocle/isearchabledocument.h"
 #include "pagegraphicsitem.h"
 #include "pageslayoutmanager.h"
+#include "textindex.h"
 
 namespace LeechCraft
 {
@@ -57,6 +58,18 @@ namespace Monocle
 		CurrentHighlights_.clear ();
 		CurrentRectIndex_ = -1;
 		CurrentSearchString_.clear ();
+		CurrentPositions_.clear ();
+
+		delete Index_;
+		Index_ = nullptr;
+		if (Doc_ && TextIndex::IsSupported (Doc_))
+		{
+			Index_ = new TextIndex (Doc_, this);
+			connect (Index_,
+					SIGNAL (pagesIndexed (int, int)),
+					this,
+					SLOT (handlePagesIndexed (int, int)));
+		}
 	}
 
 	bool TextSearchHandler::Search (const QString& text, Util::FindNotification::FindFlags flags)
@@ -104,6 +117,9 @@ namespace Monocle
 		{
 			ClearHighlights ();
 			CurrentSearchString_ = results.Text_;
+			CurrentFlags_ = results.FindFlags_;
+			CurrentPositions_ = results.Positions_;
+			ResultsReported_ = true;
 			BuildHighlights (results.Positions_);
 		}
 
@@ -114,14 +130,32 @@ namespace Monocle
 	{
 		ClearHighlights ();
 		CurrentSearchString_ = text;
+		CurrentFlags_ = flags;
+
+		const auto cs = flags & Util::FindNotification::FindCaseSensitively ?
+				Qt::CaseSensitive :
+				Qt::CaseInsensitive;
+
+		if (Index_)
+		{
+			CurrentPositions_ = Index_->Search (text, cs);
+
+			ResultsReported_ = Index_->IsComplete ();
+			if (ResultsReported_)
+				emit gotSearchResults ({ text, flags, CurrentPositions_ });
+
+			BuildHighlights (CurrentPositions_);
+
+			if (!CurrentHighlights_.isEmpty ())
+				SelectItem (0);
+
+			return !CurrentHighlights_.isEmpty () || !Index_->IsComplete ();
+		}
 
 		const auto searchable = qobject_cast<ISearchableDocument*> (Doc_->GetQObject ());
 		if (!searchable)
 			return false;
 
-		const auto cs = flags & Util::FindNotification::FindCaseSensitively ?
-				Qt::CaseSensitive :
-				Qt::CaseInsensitive;
 		const auto& map = searchable->GetTextPositions (text, cs);
 		emit gotSearchResults ({ text, flags, map });
 
@@ -190,5 +224,32 @@ namespace Monocle
 			emit navigateRequested ({}, pageIdx, x, y);
 		}
 	}
+
+	void TextSearchHandler::handlePagesIndexed (int from, int)
+	{
+		if (CurrentSearchString_.isEmpty ())
+			return;
+
+		const auto cs = CurrentFlags_ & Util::FindNotification::FindCaseSensitively ?
+				Qt::CaseSensitive :
+				Qt::CaseInsensitive;
+		const auto& map = Index_->Search (CurrentSearchString_, cs, from);
+		if (!map.isEmpty ())
+		{
+			for (const auto& pair : Util::Stlize (map))
+				CurrentPositions_ [pair.first] = pair.second;
+
+			const auto hadHighlights = !CurrentHighlights_.isEmpty ();
+			BuildHighlights (map);
+			if (!hadHighlights)
+				SelectItem (0);
+		}
+
+		if (!ResultsReported_ && Index_->IsComplete ())
+		{
+			ResultsReported_ = true;
+			emit gotSearchResults ({ CurrentSearchString_, CurrentFlags_, CurrentPositions_ });
+		}
+	}
 }
 }
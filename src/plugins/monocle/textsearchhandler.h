@@ -44,6 +44,7 @@ namespace Monocle
 {
 	class PageGraphicsItem;
 	class PagesLayoutManager;
+	class TextIndex;
 
 	struct TextSearchHandlerResults
 	{
@@ -63,7 +64,12 @@ namespace Monocle
 		IDocument_ptr Doc_;
 		QList<PageGraphicsItem*> Pages_;
 
+		TextIndex *Index_ = nullptr;
+
 		QString CurrentSearchString_;
+		Util::FindNotification::FindFlags CurrentFlags_;
+		QMap<int, QList<QRectF>> CurrentPositions_;
+		bool ResultsReported_ = false;
 
 		QList<QGraphicsRectItem*> CurrentHighlights_;
 		int CurrentRectIndex_;
@@ -81,6 +87,8 @@ namespace Monocle
 		void ClearHighlights ();
 
 		void SelectItem (int);
+	private slots:
+		void handlePagesIndexed (int, int);
 	signals:
 		void navigateRequested (const QString&, int, double, double);
 
@@ -0,0 +1,278 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2010-2012  Oleg Linkin
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "hashcache.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QtConcurrentMap>
+#include <QtDebug>
+#include <util/sys/paths.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+namespace LeechCraft
+{
+namespace NetStoreManager
+{
+	namespace
+	{
+		const quint32 CacheMagic = 0x4c434e48;
+		const quint8 CacheVersion = 1;
+
+		const qint64 BlockSize = 1024 * 1024;
+
+		QString GetCacheFilePath (const QString& localPath)
+		{
+			const auto& id = QCryptographicHash::hash (localPath.toUtf8 (), QCryptographicHash::Md5).toHex ();
+			try
+			{
+				return Util::GetUserDir (Util::UserDir::Cache, "netstoremanager")
+						.filePath ("hashes_" + id);
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "hashes won't be persisted:"
+						<< e.what ();
+				return {};
+			}
+		}
+
+		quint64 GetInode (const QFileInfo& fi)
+		{
+#ifdef Q_OS_UNIX
+			struct stat st;
+			if (!stat (QFile::encodeName (fi.absoluteFilePath ()).constData (), &st))
+				return st.st_ino;
+#else
+			Q_UNUSED (fi)
+#endif
+			return 0;
+		}
+
+		QByteArray HashFile (const QString& path, QCryptographicHash::Algorithm algo)
+		{
+			QFile file { path };
+			if (!file.open (QIODevice::ReadOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open file for hash calculation"
+						<< path
+						<< file.errorString ();
+				return {};
+			}
+
+			QCryptographicHash hash { algo };
+
+			QByteArray block;
+			block.resize (BlockSize);
+			while (true)
+			{
+				const auto read = file.read (block.data (), block.size ());
+				if (read < 0)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "unable to read file for hash calculation"
+							<< path
+							<< file.errorString ();
+					return {};
+				}
+				if (!read)
+					break;
+
+				hash.addData (block.constData (), read);
+			}
+
+			return hash.result ();
+		}
+	}
+
+	HashCache::HashCache (const QString& localPath)
+	: CachePath_ { GetCacheFilePath (localPath) }
+	{
+	}
+
+	QList<QByteArray> HashCache::GetHashes (const QList<QFileInfo>& files, QCryptographicHash::Algorithm algo)
+	{
+		QMutexLocker locker { &Mutex_ };
+
+		if (!Loaded_)
+		{
+			Load ();
+			Loaded_ = true;
+		}
+
+		struct Job
+		{
+			QString Path_;
+			Entry Entry_;
+		};
+		QList<Job> jobs;
+
+		QList<QByteArray> result;
+		QHash<QString, Entry> entries;
+		for (const auto& fi : files)
+		{
+			const auto& path = fi.absoluteFilePath ();
+			const Entry entry
+			{
+				fi.size (),
+				fi.lastModified ().toMSecsSinceEpoch (),
+				GetInode (fi),
+				algo,
+				{}
+			};
+
+			const auto pos = Entries_.find (path);
+			if (pos != Entries_.end () &&
+					pos->Size_ == entry.Size_ &&
+					pos->MTime_ == entry.MTime_ &&
+					pos->Inode_ == entry.Inode_ &&
+					pos->Algorithm_ == entry.Algorithm_)
+			{
+				entries [path] = *pos;
+				result << pos->Hash_;
+			}
+			else
+			{
+				jobs.append ({ path, entry });
+				result << QByteArray {};
+			}
+		}
+
+		QtConcurrent::blockingMap (jobs,
+				[algo] (Job& job) { job.Entry_.Hash_ = HashFile (job.Path_, algo); });
+
+		for (const auto& job : jobs)
+			if (!job.Entry_.Hash_.isEmpty ())
+				entries [job.Path_] = job.Entry_;
+
+		for (int i = 0; i < files.size (); ++i)
+			if (result.at (i).isEmpty ())
+				result [i] = entries.value (files.at (i).absoluteFilePath ()).Hash_;
+
+		const bool changed = !jobs.isEmpty () || entries.size () != Entries_.size ();
+		Entries_ = entries;
+		if (changed)
+			Save ();
+
+		return result;
+	}
+
+	void HashCache::Load ()
+	{
+		if (CachePath_.isEmpty ())
+			return;
+
+		QFile file { CachePath_ };
+		if (!file.exists ())
+			return;
+
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< CachePath_
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream in { &file };
+		in.setVersion (QDataStream::Qt_5_0);
+
+		quint32 magic = 0;
+		quint8 version = 0;
+		in >> magic >> version;
+		if (magic != CacheMagic || version != CacheVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown cache format in"
+					<< CachePath_;
+			return;
+		}
+
+		quint32 count = 0;
+		in >> count;
+		for (quint32 i = 0; i < count && in.status () == QDataStream::Ok; ++i)
+		{
+			QString path;
+			Entry entry;
+			in >> path
+					>> entry.Size_
+					>> entry.MTime_
+					>> entry.Inode_
+					>> entry.Algorithm_
+					>> entry.Hash_;
+			if (in.status () == QDataStream::Ok)
+				Entries_ [path] = entry;
+		}
+	}
+
+	void HashCache::Save () const
+	{
+		if (CachePath_.isEmpty ())
+			return;
+
+		QSaveFile file { CachePath_ };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< CachePath_
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out.setVersion (QDataStream::Qt_5_0);
+		out << CacheMagic
+				<< CacheVersion
+				<< static_cast<quint32> (Entries_.size ());
+		for (auto i = Entries_.begin (); i != Entries_.end (); ++i)
+			out << i.key ()
+					<< i->Size_
+					<< i->MTime_
+					<< i->Inode_
+					<< i->Algorithm_
+					<< i->Hash_;
+
+		if (!file.commit ())
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< CachePath_
+					<< file.errorString ();
+	}
+}
+}
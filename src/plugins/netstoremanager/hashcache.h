@@ -0,0 +1,93 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2010-2012  Oleg Linkin
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QCryptographicHash>
+#include <QFileInfo>
+
+namespace LeechCraft
+{
+namespace NetStoreManager
+{
+	/** @brief Persistent cache of the content hashes of the files in a
+	 * synced directory.
+	 *
+	 * A cached hash is reused as long as the size, the modification time
+	 * and the inode of the file are the same. Files missing from the
+	 * cache are hashed in fixed-size blocks on the global thread pool, so
+	 * the memory used doesn't depend on the file sizes.
+	 *
+	 * The cache is stored in the LeechCraft cache directory, one file
+	 * per synced directory. Only the entries for the files passed to the
+	 * last GetHashes() call are kept on disk.
+	 */
+	class HashCache
+	{
+		struct Entry
+		{
+			qint64 Size_;
+			qint64 MTime_;
+			quint64 Inode_;
+			int Algorithm_;
+			QByteArray Hash_;
+		};
+
+		const QString CachePath_;
+
+		QMutex Mutex_;
+		bool Loaded_ = false;
+		QHash<QString, Entry> Entries_;
+	public:
+		/** @brief Creates the cache for the given local directory.
+		 *
+		 * The cache file is read on the first GetHashes() call.
+		 */
+		explicit HashCache (const QString& localPath);
+
+		HashCache (const HashCache&) = delete;
+		HashCache& operator= (const HashCache&) = delete;
+
+		/** @brief Returns the hashes of the given files.
+		 *
+		 * The returned list has the same order as files. The hash of a
+		 * file that couldn't be read is empty.
+		 *
+		 * This function blocks until all the files are hashed and the
+		 * cache is saved.
+		 */
+		QList<QByteArray> GetHashes (const QList<QFileInfo>& files, QCryptographicHash::Algorithm);
+	private:
+		void Load ();
+		void Save () const;
+	};
+}
+}
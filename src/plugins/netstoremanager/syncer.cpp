@@ -31,9 +31,12 @@
 #include <future>
 #include <QCryptographicHash>
 #include <QFileInfo>
+#include <QDirIterator>
 #include <QStandardItem>
 #include <QtDebug>
 #include <QUuid>
+#include <QtConcurrentRun>
+#include <util/threads/futures.h>
 #include "interfaces/netstoremanager/istorageaccount.h"
 #include "utils.h"
 
@@ -49,6 +52,7 @@ namespace NetStoreManager
 	, Started_ (false)
 	, Account_ (isa)
 	, SFLAccount_ (qobject_cast<ISupportFileListings*> (isa->GetQObject ()))
+	, HashCache_ (std::make_shared<HashCache> (dirPath))
 	{
 	}
 
@@ -162,51 +166,63 @@ namespace NetStoreManager
 				return QCryptographicHash::Md5;
 			}
 		}
-	}
-
-	Snapshot_t Syncer::CreateSnapshot ()
-	{
-		Snapshot_t snapshot;
 
-		for (const auto& fi : QDir (LocalPath_).entryInfoList (QDir::NoDotAndDotDot | QDir::AllEntries))
+		/** Walks the localPath and hashes its files. This is called in a
+		 * separate thread, so it only accesses its arguments and the
+		 * thread-safe cache.
+		 */
+		Snapshot_t CreateSnapshot (const QString& localPath,
+				const QHash<QString, QByteArray>& path2id,
+				HashCache& hashCache, QCryptographicHash::Algorithm algo)
 		{
-			const QString path = fi.absoluteFilePath ().remove (LocalPath_ + "/");
-			Change change;
-			StorageItem storage;
-			if (!Id2Path_.right.count (path))
-				change.ItemID_ = Id2Path_.right.at (path);
-			else
+			QList<Change> changes;
+			QList<QFileInfo> files;
+			QList<int> fileChanges;
+
+			QDirIterator it (localPath,
+					QDir::NoDotAndDotDot | QDir::AllEntries,
+					QDirIterator::Subdirectories);
+			while (it.hasNext ())
 			{
-				change.ItemID_ = QUuid::createUuid ().toByteArray ();
+				it.next ();
+				const auto& fi = it.fileInfo ();
+
+				const QString path = fi.absoluteFilePath ().remove (localPath + "/");
+				Change change;
+				StorageItem storage;
+				if (path2id.contains (path))
+					change.ItemID_ = path2id [path];
+				else
+				{
+					change.ItemID_ = QUuid::createUuid ().toByteArray ();
 
-				storage.IsDirectory_ = fi.isDir ();
-				storage.Name_ = fi.fileName ();
-				storage.ModifyDate_ = fi.lastModified ();
-				storage.ID_ = change.ItemID_;
-			}
+					storage.IsDirectory_ = fi.isDir ();
+					storage.Name_ = fi.fileName ();
+					storage.ModifyDate_ = fi.lastModified ();
+					storage.ID_ = change.ItemID_;
+				}
 
-			if (fi.isFile ())
-			{
-				QFile file (fi.absoluteFilePath ());
-				if (file.open (QIODevice::ReadOnly))
+				if (fi.isFile ())
 				{
-					const auto& ba = file.readAll ();
-					storage.Hash_ = QCryptographicHash::hash (ba,
-							NSMHashType2QtCryproHashAlgorithm (SFLAccount_->GetCheckSumAlgorithm ()));
-					file.close ();
+					storage.Size_ = fi.size ();
+
+					files << fi;
+					fileChanges << changes.size ();
 				}
-				else
-					qWarning () << Q_FUNC_INFO
-							<< "unable to open file for hash calculation";
 
-				storage.Size_ = fi.size ();
+				change.Item_ = storage;
+				changes << change;
 			}
 
-			change.Item_ = storage;
-			snapshot [change.ID_] = change;
-		}
+			const auto& hashes = hashCache.GetHashes (files, algo);
+			for (int i = 0; i < hashes.size (); ++i)
+				changes [fileChanges.at (i)].Item_.Hash_ = hashes.at (i);
 
-		return snapshot;
+			Snapshot_t snapshot;
+			for (const auto& change : changes)
+				snapshot [change.ItemID_] = change;
+			return snapshot;
+		}
 	}
 
 	Snapshot_t Syncer::CreateDiffSnapshot (const Snapshot_t& newSnapshot,
@@ -225,8 +241,21 @@ namespace NetStoreManager
 		QStringList path = RemotePath_.split ('/');
 		CreateRemotePath (path);
 
-		const auto& newSnapshot = CreateSnapshot ();
-		//TODO create diff
+		QHash<QString, QByteArray> path2id;
+		for (const auto& pair : Id2Path_.right)
+			path2id [pair.first] = pair.second;
+
+		const auto& localPath = LocalPath_;
+		const auto hashCache = HashCache_;
+		const auto algo = NSMHashType2QtCryproHashAlgorithm (SFLAccount_->GetCheckSumAlgorithm ());
+		Util::Sequence (this,
+				QtConcurrent::run ([localPath, path2id, hashCache, algo]
+					{ return CreateSnapshot (localPath, path2id, *hashCache, algo); })) >>
+				[this] (const Snapshot_t& newSnapshot)
+				{
+					if (Started_)
+						Snapshot_ = newSnapshot;
+				};
 	}
 
 	void Syncer::stop ()
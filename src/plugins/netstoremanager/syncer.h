@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #ifndef Q_MOC_RUN
 #include <boost/bimap.hpp>
@@ -39,6 +40,7 @@
 #include <QQueue>
 #include "interfaces/netstoremanager/isupportfilelistings.h"
 #include "syncmanager.h"
+#include "hashcache.h"
 
 namespace LeechCraft
 {
@@ -60,6 +62,7 @@ namespace NetStoreManager
 		QQueue<std::function<void (void)>> CallsQueue_;
 
 		Snapshot_t Snapshot_;
+		const std::shared_ptr<HashCache> HashCache_;
 
 	public:
 		explicit Syncer (const QString& dirPath, const QString& remotePath,
@@ -77,7 +80,6 @@ namespace NetStoreManager
 		void CreateRemotePath (const QStringList& path);
 		void DeleteRemotePath (const QStringList& path);
 		void RenameItem (const StorageItem& item, const QString& path);
-		Snapshot_t CreateSnapshot ();
 		Snapshot_t CreateDiffSnapshot (const Snapshot_t& newSnapshot,
 				const Snapshot_t& oldSnapshot);
 
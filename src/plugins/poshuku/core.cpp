@@ -146,6 +146,14 @@ namespace Poshuku
 				SIGNAL (added (const HistoryItem&)),
 				URLCompletionModel_,
 				SLOT (handleItemAdded (const HistoryItem&)));
+		connect (HistoryModel_,
+				SIGNAL (historyLoaded (const history_items_t&)),
+				URLCompletionModel_,
+				SLOT (handleHistoryLoaded (const history_items_t&)));
+		connect (StorageBackend_.get (),
+				SIGNAL (removed (const history_items_t&)),
+				URLCompletionModel_,
+				SLOT (handleItemsRemoved (const history_items_t&)));
 
 		connect (StorageBackend_.get (),
 				SIGNAL (added (const FavoritesModel::FavoritesItem&)),
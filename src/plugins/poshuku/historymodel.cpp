@@ -203,6 +203,7 @@ namespace Poshuku
 
 		Items_.clear ();
 		Core::Instance ().GetStorageBackend ()->LoadHistory (Items_);
+		emit historyLoaded (Items_);
 
 		QSet<QString> urls;
 		for (auto i = Items_.begin (); i != Items_.end (); )
@@ -69,6 +69,11 @@ namespace Poshuku
 		void collectGarbage ();
 		void handleItemAdded (const HistoryItem&);
 	signals:
+		/** Emitted with all the history items, including the ones
+		 * with the same URL, once they are loaded from the storage.
+		 */
+		void historyLoaded (const history_items_t&);
+
 		// Hook support signals
 		/** @brief Called when an entry is going to be added to
 			* history.
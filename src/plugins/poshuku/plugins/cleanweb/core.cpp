@@ -30,6 +30,7 @@
 #include "core.h"
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <QNetworkRequest>
 #include <QRegExp>
@@ -42,7 +43,6 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QtConcurrentRun>
-#include <QtConcurrentMap>
 #include <QMenu>
 #include <QMainWindow>
 #include <QDir>
@@ -63,6 +63,7 @@
 #include "xmlsettingsmanager.h"
 #include "userfiltersmodel.h"
 #include "lineparser.h"
+#include "filterindex.h"
 #include "subscriptionsmodel.h"
 
 Q_DECLARE_METATYPE (QNetworkReply*);
@@ -112,6 +113,8 @@ namespace CleanWeb
 	: UserFilters_ { ufm }
 	, SubsModel_ { model }
 	, Proxy_ { proxy }
+	, EnableFiltering_ { XmlSettingsManager::Instance ()->Bind<bool> ("EnableFiltering") }
+	, EnableElementHiding_ { XmlSettingsManager::Instance ()->Bind<bool> ("EnableElementHiding") }
 	{
 		connect (SubsModel_,
 				SIGNAL (filtersListChanged ()),
@@ -188,117 +191,6 @@ namespace CleanWeb
 
 	namespace
 	{
-#if defined (Q_OS_WIN32) || defined (Q_OS_MAC)
-		// Thanks for this goes to http://www.codeproject.com/KB/string/patmatch.aspx
-		bool WildcardMatches (const char *pattern, const char *str)
-		{
-			enum State {
-				Exact,        // exact match
-				Any,        // ?
-				AnyRepeat    // *
-			};
-
-			const char *s = str;
-			const char *p = pattern;
-			const char *q = 0;
-			int state = 0;
-
-			bool match = true;
-			while (match && *p) {
-				if (*p == '*') {
-					state = AnyRepeat;
-					q = p+1;
-				} else if (*p == '?') state = Any;
-				else state = Exact;
-
-				if (*s == 0) break;
-
-				switch (state) {
-					case Exact:
-						match = *s == *p;
-						s++;
-						p++;
-						break;
-
-					case Any:
-						match = true;
-						s++;
-						p++;
-						break;
-
-					case AnyRepeat:
-						match = true;
-						s++;
-
-						if (*s == *q) p++;
-						break;
-				}
-			}
-
-			if (state == AnyRepeat) return (*s == *q);
-			else if (state == Any) return (*s == *p);
-			else return match && (*s == *p);
-		}
-#else
-#include <fnmatch.h>
-
-		bool WildcardMatches (const char *pat, const char *str)
-		{
-			return !fnmatch (pat, str, 0);
-		}
-#endif
-
-		bool Matches (const FilterItem_ptr& item,
-				const QByteArray& urlUtf8, const QString& domain)
-		{
-			const auto& opt = item->Option_;
-			if (opt.MatchObjects_ != FilterOption::MatchObject::All)
-			{
-				if (!(opt.MatchObjects_ & FilterOption::MatchObject::CSS) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Image) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Script) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::Object) &&
-						!(opt.MatchObjects_ & FilterOption::MatchObject::ObjSubrequest))
-					return false;
-			}
-
-			if (std::any_of (opt.NotDomains_.begin (), opt.NotDomains_.end (),
-						[&domain, &opt] (const QString& notDomain)
-							{ return domain.endsWith (notDomain, opt.Case_); }))
-				return false;
-
-			if (!opt.Domains_.isEmpty () &&
-					std::none_of (opt.Domains_.begin (), opt.Domains_.end (),
-							[&domain, &opt] (const QString& doDomain)
-								{ return domain.endsWith (doDomain, opt.Case_); }))
-				return false;
-
-			switch (opt.MatchType_)
-			{
-			case FilterOption::MTRegexp:
-				return item->RegExp_.Matches (urlUtf8);
-			case FilterOption::MTWildcard:
-				return WildcardMatches (item->PlainMatcher_.constData (), urlUtf8.constData ());
-			case FilterOption::MTPlain:
-				return urlUtf8.indexOf (item->PlainMatcher_) >= 0;
-			case FilterOption::MTBegin:
-				return urlUtf8.startsWith (item->PlainMatcher_);
-			case FilterOption::MTEnd:
-				return urlUtf8.endsWith (item->PlainMatcher_);
-			}
-
-			return false;
-		}
-	}
-
-	namespace
-	{
-		void DumbReductor (bool& res, bool value)
-		{
-			if (value)
-				res = true;
-		}
-
 		FilterOption::MatchObjects ResourceType2Objs (IInterceptableRequests::ResourceType type)
 		{
 			switch (type)
@@ -315,57 +207,16 @@ namespace CleanWeb
 		}
 
 		bool ShouldReject (const IInterceptableRequests::RequestInfo& req,
-				const QList<QList<FilterItem_ptr>>& exceptions,
-				const QList<QList<FilterItem_ptr>>& filters)
+				const std::shared_ptr<const FilterIndexes>& indexes)
 		{
-			if (!XmlSettingsManager::Instance ()->property ("EnableFiltering").toBool ())
-				return false;
-
-			if (!req.PageUrl_.isValid ())
+			if (!indexes || !req.PageUrl_.isValid ())
 				return false;
 
-			const auto objs = ResourceType2Objs (req.ResourceType_);
-
-			const QUrl& url = req.RequestUrl_;
-			const QString& urlStr = url.toString ();
-			const auto& urlUtf8 = urlStr.toUtf8 ();
-			const QString& cinUrlStr = urlStr.toLower ();
-			const auto& cinUrlUtf8 = cinUrlStr.toUtf8 ();
+			const MatchContext ctx { req.RequestUrl_, req.PageUrl_, ResourceType2Objs (req.ResourceType_) };
 
-			const QString& domain = req.PageUrl_.host ();
-			const bool isThirdParty = !url.host ().endsWith (domain);
-
-			auto matches = [=] (const QList<QList<FilterItem_ptr>>& chunks)
-			{
-				return QtConcurrent::blockingMappedReduced (chunks.begin (), chunks.end (),
-						std::function<bool (const QList<FilterItem_ptr>&)>
-						{
-							[=] (const QList<FilterItem_ptr>& items)
-							{
-								for (const auto& item : items)
-								{
-									const auto& opt = item->Option_;
-									if (opt.ThirdParty_ != FilterOption::ThirdParty::Unspecified)
-										if ((opt.ThirdParty_ == FilterOption::ThirdParty::Yes) != isThirdParty)
-											continue;
-
-									if (opt.MatchObjects_ != FilterOption::MatchObject::All &&
-											objs != FilterOption::MatchObject::All &&
-											!(objs & opt.MatchObjects_))
-										continue;
-
-									const auto& utf8 = item->Option_.Case_ == Qt::CaseSensitive ? urlUtf8 : cinUrlUtf8;
-									if (Matches (item, utf8, domain))
-										return true;
-								}
-
-								return false;
-							}
-						}, DumbReductor);
-			};
-			if (matches (exceptions))
+			if (indexes->Exceptions_ && indexes->Exceptions_->Matches (ctx))
 				return false;
-			if (matches (filters))
+			if (indexes->Filters_ && indexes->Filters_->Matches (ctx))
 				return true;
 
 			return false;
@@ -377,7 +228,8 @@ namespace CleanWeb
 		auto interceptor = [this] (const IInterceptableRequests::RequestInfo& info)
 				-> IInterceptableRequests::Result_t
 		{
-			if (!ShouldReject (info, ExceptionsCache_, FilterItemsCache_))
+			if (!EnableFiltering_.Get () ||
+					!ShouldReject (info, std::atomic_load (&Indexes_)))
 				return IInterceptableRequests::Allow {};
 
 			if (info.View_)
@@ -531,7 +383,7 @@ namespace CleanWeb
 
 	void Core::HandleViewLayout (IWebView *view)
 	{
-		if (!XmlSettingsManager::Instance ()->property ("EnableElementHiding").toBool ())
+		if (!EnableElementHiding_.Get ())
 			return;
 
 		if (ScheduledHidings_.contains (view))
@@ -707,63 +559,44 @@ namespace CleanWeb
 
 	void Core::regenFilterCaches ()
 	{
-		ExceptionsCache_.clear ();
-		FilterItemsCache_.clear ();
-
 		auto allFilters = SubsModel_->GetAllFilters ();
 		allFilters << UserFilters_->GetFilter ();
 
-		int exceptionsCount = 0;
-		int filtersCount = 0;
-		for (const Filter& filter : allFilters)
-		{
-			exceptionsCount += filter.Exceptions_.size ();
-			filtersCount += filter.Filters_.size ();
-		}
-
-		auto idealThreads = std::max (QThread::idealThreadCount (), 2);
-
-		const int exChunkSize = std::max (exceptionsCount / idealThreads / 4, 200);
-		const int fChunkSize = std::max (filtersCount / idealThreads / 4, 200);
-		qDebug () << Q_FUNC_INFO << exceptionsCount << filtersCount << exChunkSize << fChunkSize;
-
-		QList<FilterItem_ptr> lastItemsChunk, lastExceptionsChunk;
-		lastItemsChunk.reserve (fChunkSize);
-		lastExceptionsChunk.reserve (exChunkSize);
+		QElapsedTimer timer;
+		timer.start ();
 
+		const auto exceptions = std::make_shared<FilterIndex> ();
+		const auto filters = std::make_shared<FilterIndex> ();
 		for (const Filter& filter : allFilters)
 		{
 			for (const auto& item : filter.Exceptions_)
-			{
-				if (!item->Option_.HideSelector_.isEmpty ())
-					continue;
-
-				lastExceptionsChunk << item;
-				if (lastExceptionsChunk.size () >= exChunkSize)
-				{
-					ExceptionsCache_ << lastExceptionsChunk;
-					lastExceptionsChunk.clear ();
-				}
-			}
+				if (item->Option_.HideSelector_.isEmpty ())
+					exceptions->Add (item);
 
 			for (const auto& item : filter.Filters_)
-			{
-				if (!item->Option_.HideSelector_.isEmpty ())
-					continue;
-
-				lastItemsChunk << item;
-				if (lastItemsChunk.size () >= fChunkSize)
-				{
-					FilterItemsCache_ << lastItemsChunk;
-					lastItemsChunk.clear ();
-				}
-			}
+				if (item->Option_.HideSelector_.isEmpty ())
+					filters->Add (item);
 		}
 
-		if (!lastItemsChunk.isEmpty ())
-			FilterItemsCache_ << lastItemsChunk;
-		if (!lastExceptionsChunk.isEmpty ())
-			ExceptionsCache_ << lastExceptionsChunk;
+		auto dumpStats = [] (const FilterIndex& index)
+		{
+			const auto& stats = index.GetStats ();
+			return QString { "%1 by shortcuts, %2 by domains, %3 regexps, %4 generic" }
+					.arg (stats.Shortcuts_)
+					.arg (stats.Domains_)
+					.arg (stats.RegExps_)
+					.arg (stats.Generic_);
+		};
+		qDebug () << Q_FUNC_INFO
+				<< "built in"
+				<< timer.elapsed ()
+				<< "ms; exceptions:"
+				<< dumpStats (*exceptions)
+				<< "; filters:"
+				<< dumpStats (*filters);
+
+		const auto indexes = std::make_shared<const FilterIndexes> (FilterIndexes { exceptions, filters });
+		std::atomic_store (&Indexes_, indexes);
 	}
 }
 }
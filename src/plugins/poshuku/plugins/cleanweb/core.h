@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <QAbstractItemModel>
 #include <QHash>
 #include <QStringList>
@@ -39,6 +40,7 @@
 #include <interfaces/idownload.h>
 #include <interfaces/poshuku/poshukutypes.h>
 #include <interfaces/core/ihookproxy.h>
+#include <xmlsettingsdialog/boundsetting.h>
 #include "filter.h"
 
 class QNetworkRequest;
@@ -55,6 +57,17 @@ namespace CleanWeb
 {
 	class UserFiltersModel;
 	class SubscriptionsModel;
+	class FilterIndex;
+
+	/** The exception and filter indexes built from the same set of
+	 * filters. They are published together, so a request never sees the
+	 * exceptions of one generation combined with the filters of another.
+	 */
+	struct FilterIndexes
+	{
+		std::shared_ptr<const FilterIndex> Exceptions_;
+		std::shared_ptr<const FilterIndex> Filters_;
+	};
 
 	struct HidingWorkerResult
 	{
@@ -69,8 +82,7 @@ namespace CleanWeb
 		UserFiltersModel * const UserFilters_;
 		SubscriptionsModel * const SubsModel_;
 
-		QList<QList<FilterItem_ptr>> ExceptionsCache_;
-		QList<QList<FilterItem_ptr>> FilterItemsCache_;
+		std::shared_ptr<const FilterIndexes> Indexes_;
 
 		QObjectList Downloaders_;
 
@@ -88,6 +100,9 @@ namespace CleanWeb
 		QSet<IWebView*> ScheduledHidings_;
 
 		const ICoreProxy_ptr Proxy_;
+
+		const Util::BoundSetting<bool> EnableFiltering_;
+		const Util::BoundSetting<bool> EnableElementHiding_;
 	public:
 		Core (SubscriptionsModel*, UserFiltersModel*, const ICoreProxy_ptr&);
 
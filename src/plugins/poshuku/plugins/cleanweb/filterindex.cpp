@@ -0,0 +1,404 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "filterindex.h"
+#include <algorithm>
+#include <QUrl>
+
+#if !defined (Q_OS_WIN32) && !defined (Q_OS_MAC)
+#include <fnmatch.h>
+#endif
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+namespace CleanWeb
+{
+	namespace
+	{
+#if defined (Q_OS_WIN32) || defined (Q_OS_MAC)
+		// Thanks for this goes to http://www.codeproject.com/KB/string/patmatch.aspx
+		bool WildcardMatches (const char *pattern, const char *str)
+		{
+			enum State {
+				Exact,        // exact match
+				Any,        // ?
+				AnyRepeat    // *
+			};
+
+			const char *s = str;
+			const char *p = pattern;
+			const char *q = 0;
+			int state = 0;
+
+			bool match = true;
+			while (match && *p) {
+				if (*p == '*') {
+					state = AnyRepeat;
+					q = p+1;
+				} else if (*p == '?') state = Any;
+				else state = Exact;
+
+				if (*s == 0) break;
+
+				switch (state) {
+					case Exact:
+						match = *s == *p;
+						s++;
+						p++;
+						break;
+
+					case Any:
+						match = true;
+						s++;
+						p++;
+						break;
+
+					case AnyRepeat:
+						match = true;
+						s++;
+
+						if (*s == *q) p++;
+						break;
+				}
+			}
+
+			if (state == AnyRepeat) return (*s == *q);
+			else if (state == Any) return (*s == *p);
+			else return match && (*s == *p);
+		}
+#else
+		bool WildcardMatches (const char *pat, const char *str)
+		{
+			return !fnmatch (pat, str, 0);
+		}
+#endif
+	}
+
+	MatchContext::MatchContext (const QUrl& url, const QUrl& pageUrl, FilterOption::MatchObjects objects)
+	: Domain_ { pageUrl.host () }
+	, Objects_ { objects }
+	{
+		const auto& urlStr = url.toString ();
+		UrlUtf8_ = urlStr.toUtf8 ();
+		CinUrlUtf8_ = urlStr.toLower ().toUtf8 ();
+		IsThirdParty_ = !url.host ().endsWith (Domain_);
+	}
+
+	bool Matches (const FilterItem_ptr& item,
+			const QByteArray& urlUtf8, const QString& domain)
+	{
+		const auto& opt = item->Option_;
+		if (opt.MatchObjects_ != FilterOption::MatchObject::All)
+		{
+			if (!(opt.MatchObjects_ & FilterOption::MatchObject::CSS) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Image) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Script) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::Object) &&
+					!(opt.MatchObjects_ & FilterOption::MatchObject::ObjSubrequest))
+				return false;
+		}
+
+		if (std::any_of (opt.NotDomains_.begin (), opt.NotDomains_.end (),
+					[&domain, &opt] (const QString& notDomain)
+						{ return domain.endsWith (notDomain, opt.Case_); }))
+			return false;
+
+		if (!opt.Domains_.isEmpty () &&
+				std::none_of (opt.Domains_.begin (), opt.Domains_.end (),
+						[&domain, &opt] (const QString& doDomain)
+							{ return domain.endsWith (doDomain, opt.Case_); }))
+			return false;
+
+		switch (opt.MatchType_)
+		{
+		case FilterOption::MTRegexp:
+			return item->RegExp_.Matches (urlUtf8);
+		case FilterOption::MTWildcard:
+			return WildcardMatches (item->PlainMatcher_.constData (), urlUtf8.constData ());
+		case FilterOption::MTPlain:
+			return urlUtf8.indexOf (item->PlainMatcher_) >= 0;
+		case FilterOption::MTBegin:
+			return urlUtf8.startsWith (item->PlainMatcher_);
+		case FilterOption::MTEnd:
+			return urlUtf8.endsWith (item->PlainMatcher_);
+		}
+
+		return false;
+	}
+
+	bool Matches (const FilterItem_ptr& item, const MatchContext& ctx)
+	{
+		const auto& opt = item->Option_;
+		if (opt.ThirdParty_ != FilterOption::ThirdParty::Unspecified)
+			if ((opt.ThirdParty_ == FilterOption::ThirdParty::Yes) != ctx.IsThirdParty_)
+				return false;
+
+		if (opt.MatchObjects_ != FilterOption::MatchObject::All &&
+				ctx.Objects_ != FilterOption::MatchObject::All &&
+				!(ctx.Objects_ & opt.MatchObjects_))
+			return false;
+
+		const auto& utf8 = opt.Case_ == Qt::CaseSensitive ? ctx.UrlUtf8_ : ctx.CinUrlUtf8_;
+		return Matches (item, utf8, ctx.Domain_);
+	}
+
+	namespace
+	{
+		static_assert (FilterIndex::ShortcutLength > 0 && FilterIndex::ShortcutLength < 8,
+				"shortcuts should fit into a quint64 along with the mask");
+
+		const quint64 ShortcutMask = (quint64 { 1 } << (8 * FilterIndex::ShortcutLength)) - 1;
+
+		quint64 PackShortcut (const char *data)
+		{
+			quint64 result = 0;
+			for (int i = 0; i < FilterIndex::ShortcutLength; ++i)
+				result = (result << 8) | static_cast<uchar> (data [i]);
+			return result;
+		}
+
+		/** Splits a wildcard or a regexp pattern into the literal parts
+		 * that any matching URL is guaranteed to contain. Anything we
+		 * aren't sure about just breaks the current part.
+		 */
+		QList<QByteArray> SplitPattern (const QByteArray& pattern, bool isRegexp)
+		{
+			// Alternatives and groups make literal parts optional.
+			if (isRegexp &&
+					(pattern.contains ('|') || pattern.contains ('(') || pattern.contains (')')))
+				return {};
+
+			QList<QByteArray> result;
+			QByteArray current;
+			auto flush = [&result, &current]
+			{
+				if (current.size () >= FilterIndex::ShortcutLength)
+					result << current;
+				current.clear ();
+			};
+
+			for (int i = 0; i < pattern.size (); ++i)
+			{
+				const char c = pattern.at (i);
+				switch (c)
+				{
+				case '\\':
+					flush ();
+					++i;
+					break;
+				case '[':
+				{
+					flush ();
+					const auto closing = pattern.indexOf (']', i + 1);
+					if (closing < 0)
+						return result;
+					i = closing;
+					break;
+				}
+				case '*':
+				case '?':
+				case '{':
+					// The previous character is optional in a regexp.
+					if (isRegexp)
+						current.chop (1);
+					flush ();
+					if (isRegexp && c == '{')
+					{
+						const auto closing = pattern.indexOf ('}', i + 1);
+						if (closing < 0)
+							return result;
+						i = closing;
+					}
+					break;
+				case '+':
+				case '.':
+				case '^':
+				case '$':
+					if (isRegexp)
+						flush ();
+					else
+						current += c;
+					break;
+				default:
+					current += c;
+					break;
+				}
+			}
+			flush ();
+
+			return result;
+		}
+
+		QList<QByteArray> GetLiteralParts (const FilterItem& item)
+		{
+			const auto& matcher = item.PlainMatcher_;
+			if (matcher.size () < FilterIndex::ShortcutLength)
+				return {};
+
+			switch (item.Option_.MatchType_)
+			{
+			case FilterOption::MTPlain:
+			case FilterOption::MTBegin:
+			case FilterOption::MTEnd:
+				return { matcher };
+			case FilterOption::MTWildcard:
+				return SplitPattern (matcher, false);
+			case FilterOption::MTRegexp:
+				// Only the ABP rules converted to regexps keep their
+				// pattern in PlainMatcher_, raw /regexps/ leave it empty.
+				return SplitPattern (matcher, true);
+			}
+
+			return {};
+		}
+
+		uint HashDomain (const QStringRef& domain)
+		{
+			return qHash (domain);
+		}
+	}
+
+	FilterIndex::FilterIndex (const QList<FilterItem_ptr>& items)
+	{
+		for (const auto& item : items)
+			Add (item);
+	}
+
+	void FilterIndex::Add (const FilterItem_ptr& item)
+	{
+		const auto& opt = item->Option_;
+
+		auto& shortcuts = opt.Case_ == Qt::CaseSensitive ? CsShortcuts_ : CinShortcuts_;
+
+		// Among all the shortcuts of the rule pick the one that's used
+		// the least so far to keep the buckets short.
+		quint64 bestShortcut = 0;
+		int bestSize = -1;
+		for (const auto& part : GetLiteralParts (*item))
+			for (int i = 0; i + ShortcutLength <= part.size (); ++i)
+			{
+				const auto shortcut = PackShortcut (part.constData () + i);
+				const auto pos = shortcuts.constFind (shortcut);
+				const auto size = pos == shortcuts.constEnd () ? 0 : pos->size ();
+				if (bestSize < 0 || size < bestSize)
+				{
+					bestShortcut = shortcut;
+					bestSize = size;
+				}
+
+				if (!bestSize)
+					break;
+			}
+
+		if (bestSize >= 0)
+		{
+			shortcuts [bestShortcut] << item;
+			++Stats_.Shortcuts_;
+			return;
+		}
+
+		if (!opt.Domains_.isEmpty () && opt.Case_ == Qt::CaseInsensitive)
+		{
+			for (const auto& domain : opt.Domains_)
+			{
+				const auto& lower = domain.toLower ();
+				Domains_ [HashDomain (QStringRef { &lower })] << item;
+			}
+			++Stats_.Domains_;
+			return;
+		}
+
+		if (opt.MatchType_ == FilterOption::MTRegexp)
+		{
+			RegExps_ << item;
+			++Stats_.RegExps_;
+			return;
+		}
+
+		Generic_ << item;
+		++Stats_.Generic_;
+	}
+
+	bool FilterIndex::Matches (const MatchContext& ctx) const
+	{
+		auto checkBucket = [&ctx] (const Bucket_t& bucket)
+		{
+			return std::any_of (bucket.begin (), bucket.end (),
+					[&ctx] (const FilterItem_ptr& item) { return CleanWeb::Matches (item, ctx); });
+		};
+
+		auto checkShortcuts = [&checkBucket] (const QHash<quint64, Bucket_t>& shortcuts, const QByteArray& url)
+		{
+			if (shortcuts.isEmpty ())
+				return false;
+
+			quint64 shortcut = 0;
+			for (int i = 0; i < url.size (); ++i)
+			{
+				shortcut = ((shortcut << 8) | static_cast<uchar> (url.at (i))) & ShortcutMask;
+				if (i < ShortcutLength - 1)
+					continue;
+
+				const auto pos = shortcuts.constFind (shortcut);
+				if (pos != shortcuts.constEnd () && checkBucket (*pos))
+					return true;
+			}
+
+			return false;
+		};
+
+		if (checkShortcuts (CinShortcuts_, ctx.CinUrlUtf8_) ||
+				checkShortcuts (CsShortcuts_, ctx.UrlUtf8_))
+			return true;
+
+		if (!Domains_.isEmpty ())
+		{
+			// The rules match if the page domain ends with any of their
+			// domains, so every suffix of the page domain is a candidate.
+			const auto& domain = ctx.Domain_.toLower ();
+			for (int i = 0; i <= domain.size (); ++i)
+			{
+				const auto pos = Domains_.constFind (HashDomain (domain.midRef (i)));
+				if (pos != Domains_.constEnd () && checkBucket (*pos))
+					return true;
+			}
+		}
+
+		return checkBucket (Generic_) || checkBucket (RegExps_);
+	}
+
+	FilterIndex::Stats FilterIndex::GetStats () const
+	{
+		return Stats_;
+	}
+}
+}
+}
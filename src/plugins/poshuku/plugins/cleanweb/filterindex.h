@@ -0,0 +1,109 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <QHash>
+#include <QVector>
+#include "filter.h"
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+namespace CleanWeb
+{
+	/** @brief Describes a single request being checked against the filters.
+	 *
+	 * All the derived representations of the URL are computed once per
+	 * request and then shared by all the candidate rules.
+	 */
+	struct MatchContext
+	{
+		QByteArray UrlUtf8_;
+		QByteArray CinUrlUtf8_;
+		QString Domain_;
+		bool IsThirdParty_;
+		FilterOption::MatchObjects Objects_;
+
+		MatchContext (const QUrl& url, const QUrl& pageUrl, FilterOption::MatchObjects objects);
+	};
+
+	bool Matches (const FilterItem_ptr&, const QByteArray& urlUtf8, const QString& domain);
+	bool Matches (const FilterItem_ptr&, const MatchContext&);
+
+	/** @brief A set of filter rules compiled for fast per-request lookup.
+	 *
+	 * Most of the rules contain a literal part that must be present in
+	 * the URL for the rule to match. Such rules are indexed by a short
+	 * fixed-length substring (a shortcut) of that literal part, and only
+	 * the rules whose shortcut occurs in the URL are checked.
+	 *
+	 * The rules without a usable literal part but restricted by the
+	 * $domain option are bucketed by those domains. The rest are kept
+	 * in the regexp and generic buckets that are scanned linearly.
+	 */
+	class FilterIndex
+	{
+	public:
+		static constexpr int ShortcutLength = 4;
+
+		struct Stats
+		{
+			int Shortcuts_ = 0;
+			int Domains_ = 0;
+			int RegExps_ = 0;
+			int Generic_ = 0;
+		};
+	private:
+		using Bucket_t = QVector<FilterItem_ptr>;
+
+		QHash<quint64, Bucket_t> CinShortcuts_;
+		QHash<quint64, Bucket_t> CsShortcuts_;
+		QHash<uint, Bucket_t> Domains_;
+		Bucket_t RegExps_;
+		Bucket_t Generic_;
+
+		Stats Stats_;
+	public:
+		FilterIndex () = default;
+		explicit FilterIndex (const QList<FilterItem_ptr>&);
+
+		void Add (const FilterItem_ptr&);
+
+		bool Matches (const MatchContext&) const;
+
+		Stats GetStats () const;
+	};
+
+	using FilterIndex_ptr = std::shared_ptr<const FilterIndex>;
+}
+}
+}
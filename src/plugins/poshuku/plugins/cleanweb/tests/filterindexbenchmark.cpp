@@ -0,0 +1,287 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "filterindexbenchmark.h"
+#include <algorithm>
+#include <QtTest>
+#include <QFile>
+#include "filterindex.h"
+#include "lineparser.h"
+
+QTEST_MAIN (LeechCraft::Poshuku::CleanWeb::FilterIndexBenchmark)
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+namespace CleanWeb
+{
+	namespace
+	{
+		const int SynthRulesCount = 20000;
+		const int SynthRequestsCount = 2000;
+
+		/* A real-world filter list (say, EasyList) and a recorded URL
+		 * corpus are picked up from the files pointed to by these
+		 * variables, if any. The corpus contains a request per line,
+		 * either as "<page url> <request url>" or just "<request url>".
+		 * Synthetic rules and requests are used otherwise.
+		 */
+		const char * const FiltersVar = "LC_CLEANWEB_FILTERS";
+		const char * const UrlsVar = "LC_CLEANWEB_URLS_CORPUS";
+
+		Filter Parse (const QStringList& lines)
+		{
+			Filter filter;
+			std::for_each (lines.begin (), lines.end (), LineParser { &filter });
+			return filter;
+		}
+
+		QStringList ReadLines (const char *var)
+		{
+			QFile file { QString::fromLocal8Bit (qgetenv (var)) };
+			if (!file.open (QIODevice::ReadOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< file.fileName ()
+						<< file.errorString ();
+				return {};
+			}
+
+			QStringList result;
+			for (const auto& line : QString::fromUtf8 (file.readAll ()).split ('\n', QString::SkipEmptyParts))
+			{
+				const auto& trimmed = line.trimmed ();
+				if (!trimmed.isEmpty () && !trimmed.startsWith ('['))
+					result << trimmed;
+			}
+			return result;
+		}
+
+		QStringList MakeSynthRules ()
+		{
+			QStringList result;
+			for (int i = 0; i < SynthRulesCount; ++i)
+				switch (i % 8)
+				{
+				case 0:
+					result << QString { "||adserver%1.example%2.com^" }.arg (i).arg (i % 50);
+					break;
+				case 1:
+					result << QString { "/banners/%1/*/img" }.arg (i);
+					break;
+				case 2:
+					result << QString { "-advert%1." }.arg (i);
+					break;
+				case 3:
+					result << QString { "|http://track%1.counter.net/" }.arg (i);
+					break;
+				case 4:
+					result << QString { ".gif?pixel=%1|" }.arg (i);
+					break;
+				case 5:
+					result << QString { "/ad$domain=news%1.com" }.arg (i);
+					break;
+				case 6:
+					result << QString { "/beacon%1.$third-party,image" }.arg (i);
+					break;
+				case 7:
+					result << QString { "@@||cdn%1.example%2.com/static/$image" }.arg (i).arg (i % 50);
+					break;
+				}
+
+			result << "/ba[0-9]+nn?er[0-9]+x[0-9]+/"
+					<< "/app-[0-9]+[13579]\\.js/";
+			return result;
+		}
+
+		QList<QPair<QUrl, QUrl>> MakeSynthRequests ()
+		{
+			QList<QPair<QUrl, QUrl>> result;
+			for (int i = 0; i < SynthRequestsCount; ++i)
+			{
+				const QUrl page { QString { "http://news%1.com/article/%2.html" }.arg (i % 30).arg (i) };
+
+				QString url;
+				const int rule = i * 8 % SynthRulesCount;
+				switch (i % 10)
+				{
+				case 0:
+					url = QString { "http://adserver%1.example%2.com/show?id=%3" }.arg (rule).arg (rule % 50).arg (i);
+					break;
+				case 1:
+					url = QString { "http://cdn%1.example%2.com/static/logo.png" }.arg (rule + 7).arg ((rule + 7) % 50);
+					break;
+				case 2:
+					url = QString { "http://media.example.org/banners/%1/300x250/img.png" }.arg (rule + 1);
+					break;
+				case 3:
+					url = QString { "http://track%1.counter.net/hit?page=%2" }.arg (rule + 3).arg (i);
+					break;
+				case 4:
+					url = QString { "http://stats.example.org/1.gif?pixel=%1" }.arg (rule + 4);
+					break;
+				case 5:
+					url = QString { "http://news%1.com/ad/top.png" }.arg (i % 30);
+					break;
+				case 6:
+					url = QString { "http://banner%1x60.example.org/banner468x60.png" }.arg (i);
+					break;
+				default:
+					url = QString { "http://static%1.example.org/assets/app-%2.js" }.arg (i % 7).arg (i);
+					break;
+				}
+
+				result.append ({ page, QUrl { url } });
+			}
+			return result;
+		}
+
+		bool LinearMatches (const QList<FilterItem_ptr>& items, const MatchContext& ctx)
+		{
+			return std::any_of (items.begin (), items.end (),
+					[&ctx] (const FilterItem_ptr& item)
+					{
+						return item->Option_.HideSelector_.isEmpty () && Matches (item, ctx);
+					});
+		}
+
+		FilterIndex MakeIndex (const QList<FilterItem_ptr>& items)
+		{
+			FilterIndex index;
+			for (const auto& item : items)
+				if (item->Option_.HideSelector_.isEmpty ())
+					index.Add (item);
+			return index;
+		}
+
+		const QList<FilterOption::MatchObjects> ObjectsVariants
+		{
+			FilterOption::MatchObject::All,
+			FilterOption::MatchObject::Image,
+			FilterOption::MatchObject::Subdocument
+		};
+	}
+
+	void FilterIndexBenchmark::initTestCase ()
+	{
+		Filter_ = Parse (qEnvironmentVariableIsSet (FiltersVar) ?
+				ReadLines (FiltersVar) :
+				MakeSynthRules ());
+
+		if (qEnvironmentVariableIsSet (UrlsVar))
+			for (const auto& line : ReadLines (UrlsVar))
+			{
+				const auto& parts = line.split (' ', QString::SkipEmptyParts);
+				const QUrl page { parts.value (0) };
+				const QUrl request { parts.value (parts.size () > 1 ? 1 : 0) };
+				Requests_.append ({ page, request });
+			}
+		else
+			Requests_ = MakeSynthRequests ();
+
+		QVERIFY (!Filter_.Filters_.isEmpty ());
+		QVERIFY (!Requests_.isEmpty ());
+	}
+
+	void FilterIndexBenchmark::testClassification ()
+	{
+		const auto& filter = Parse ({
+				"-banners-",
+				"|http://ads.*/track",
+				"ad$domain=news.com|example.org",
+				"/ba[0-9]+r/",
+				"ad"
+			});
+
+		const auto& stats = MakeIndex (filter.Filters_).GetStats ();
+		QCOMPARE (stats.Shortcuts_, 2);
+		QCOMPARE (stats.Domains_, 1);
+		QCOMPARE (stats.RegExps_, 1);
+		QCOMPARE (stats.Generic_, 1);
+	}
+
+	void FilterIndexBenchmark::testEquivalence ()
+	{
+		const auto& exceptions = MakeIndex (Filter_.Exceptions_);
+		const auto& filters = MakeIndex (Filter_.Filters_);
+
+		int blocked = 0;
+		for (const auto& pair : Requests_)
+			for (const auto objs : ObjectsVariants)
+			{
+				const MatchContext ctx { pair.second, pair.first, objs };
+
+				const auto linearException = LinearMatches (Filter_.Exceptions_, ctx);
+				const auto linearFilter = LinearMatches (Filter_.Filters_, ctx);
+				if (exceptions.Matches (ctx) != linearException ||
+						filters.Matches (ctx) != linearFilter)
+					QFAIL (qPrintable (QString { "mismatch for %1 on %2" }
+								.arg (pair.second.toString ())
+								.arg (pair.first.toString ())));
+
+				if (!linearException && linearFilter)
+					++blocked;
+			}
+
+		qDebug () << "blocked" << blocked << "of" << Requests_.size () * ObjectsVariants.size ();
+	}
+
+	void FilterIndexBenchmark::benchmarkLinear ()
+	{
+		QBENCHMARK
+		{
+			for (const auto& pair : Requests_)
+			{
+				const MatchContext ctx { pair.second, pair.first, FilterOption::MatchObject::Image };
+				if (!LinearMatches (Filter_.Exceptions_, ctx))
+					LinearMatches (Filter_.Filters_, ctx);
+			}
+		}
+	}
+
+	void FilterIndexBenchmark::benchmarkIndexed ()
+	{
+		const auto& exceptions = MakeIndex (Filter_.Exceptions_);
+		const auto& filters = MakeIndex (Filter_.Filters_);
+
+		QBENCHMARK
+		{
+			for (const auto& pair : Requests_)
+			{
+				const MatchContext ctx { pair.second, pair.first, FilterOption::MatchObject::Image };
+				if (!exceptions.Matches (ctx))
+					filters.Matches (ctx);
+			}
+		}
+	}
+}
+}
+}
@@ -187,6 +187,25 @@ namespace Poshuku
 				":url"
 				")");
 
+		OutdatedHistoryLoader_ = QSqlQuery (DB_);
+		switch (Type_)
+		{
+			case SBSQLite:
+				OutdatedHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+						"WHERE "
+						"(julianday ('now') - julianday (date) > :age)");
+				break;
+			case SBPostgres:
+				OutdatedHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+						"WHERE "
+						"(date - now () > :age * interval '1 day')");
+				break;
+			case SBMysql:
+				qWarning () << Q_FUNC_INFO
+						<< "it's not MySQL";
+				break;
+		}
+
 		HistoryEraser_ = QSqlQuery (DB_);
 		switch (Type_)
 		{
@@ -206,6 +225,26 @@ namespace Poshuku
 				break;
 		}
 
+		OverlimitHistoryLoader_ = QSqlQuery (DB_);
+		switch (Type_)
+		{
+			case SBSQLite:
+				OverlimitHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+						"WHERE date IN "
+						"(SELECT date FROM history ORDER BY date DESC "
+						"LIMIT 10000 OFFSET :num)");
+				break;
+			case SBPostgres:
+				OverlimitHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+						"WHERE date IN "
+						"	(SELECT date FROM history ORDER BY date DESC OFFSET :num)");
+				break;
+			case SBMysql:
+				qWarning () << Q_FUNC_INFO
+						<< "it's not MySQL";
+				break;
+		}
+
 		HistoryTruncater_ = QSqlQuery (DB_);
 		switch (Type_)
 		{
@@ -353,18 +392,48 @@ namespace Poshuku
 		emit added (item);
 	}
 
+	namespace
+	{
+		bool LoadHistoryItems (QSqlQuery& query, history_items_t& items)
+		{
+			if (!query.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return false;
+			}
+
+			while (query.next ())
+				items.push_back ({
+						query.value (0).toString (),
+						query.value (1).toDateTime (),
+						query.value (2).toString ()
+					});
+
+			query.finish ();
+			return true;
+		}
+	}
+
 	void SQLStorageBackend::ClearOldHistory (int age, int items)
 	{
 		LeechCraft::Util::DBLock lock (DB_);
 		lock.Init ();
+		OutdatedHistoryLoader_.bindValue (":age", age);
 		HistoryEraser_.bindValue (":age", age);
+		OverlimitHistoryLoader_.bindValue (":num", items);
 		HistoryTruncater_.bindValue (":num", items);
 
+		history_items_t removedItems;
+
+		if (!LoadHistoryItems (OutdatedHistoryLoader_, removedItems))
+			return;
 		if (!HistoryEraser_.exec ())
 		{
 			LeechCraft::Util::DBLock::DumpError (HistoryEraser_);
 			return;
 		}
+		if (!LoadHistoryItems (OverlimitHistoryLoader_, removedItems))
+			return;
 		if (!HistoryTruncater_.exec ())
 		{
 			LeechCraft::Util::DBLock::DumpError (HistoryTruncater_);
@@ -372,6 +441,9 @@ namespace Poshuku
 		}
 
 		lock.Good ();
+
+		if (!removedItems.isEmpty ())
+			emit removed (removedItems);
 	}
 
 	void SQLStorageBackend::LoadFavorites (
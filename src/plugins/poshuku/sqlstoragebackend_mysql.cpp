@@ -108,11 +108,22 @@ namespace Poshuku
 				"? "
 				")");
 
+		OutdatedHistoryLoader_ = QSqlQuery (DB_);
+		OutdatedHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+				"WHERE "
+				" DATE_ADD(date, INTERVAL ? DAY) < now ()");
+
 		HistoryEraser_ = QSqlQuery (DB_);
 		HistoryEraser_.prepare ("DELETE FROM history "
 				"WHERE "
 				" DATE_ADD(date, INTERVAL ? DAY) < now () )");
 
+		OverlimitHistoryLoader_ = QSqlQuery (DB_);
+		OverlimitHistoryLoader_.prepare ("SELECT title, date, url FROM history "
+				"WHERE date IN "
+				"(SELECT date FROM history ORDER BY date DESC "
+				"LIMIT 10000 OFFSET ?)");
+
 		HistoryTruncater_ = QSqlQuery (DB_);
 		HistoryTruncater_.prepare ("DELETE FROM history "
 				"WHERE date IN "
@@ -229,18 +240,48 @@ namespace Poshuku
 		emit added (item);
 	}
 
+	namespace
+	{
+		bool LoadHistoryItems (QSqlQuery& query, history_items_t& items)
+		{
+			if (!query.exec ())
+			{
+				LeechCraft::Util::DBLock::DumpError (query);
+				return false;
+			}
+
+			while (query.next ())
+				items.push_back ({
+						query.value (0).toString (),
+						query.value (1).toDateTime (),
+						query.value (2).toString ()
+					});
+
+			query.finish ();
+			return true;
+		}
+	}
+
 	void SQLStorageBackendMysql::ClearOldHistory (int age, int items)
 	{
 		LeechCraft::Util::DBLock lock (DB_);
 		lock.Init ();
+		OutdatedHistoryLoader_.bindValue (0, age);
 		HistoryEraser_.bindValue (0, age);
+		OverlimitHistoryLoader_.bindValue (0, items);
 		HistoryTruncater_.bindValue (1, items);
 
+		history_items_t removedItems;
+
+		if (!LoadHistoryItems (OutdatedHistoryLoader_, removedItems))
+			return;
 		if (!HistoryEraser_.exec ())
 		{
 			LeechCraft::Util::DBLock::DumpError (HistoryEraser_);
 			return;
 		}
+		if (!LoadHistoryItems (OverlimitHistoryLoader_, removedItems))
+			return;
 		if (!HistoryTruncater_.exec ())
 		{
 			LeechCraft::Util::DBLock::DumpError (HistoryTruncater_);
@@ -248,6 +289,9 @@ namespace Poshuku
 		}
 
 		lock.Good ();
+
+		if (!removedItems.isEmpty ())
+			emit removed (removedItems);
 	}
 
 	void SQLStorageBackendMysql::LoadFavorites (
@@ -65,10 +65,28 @@ namespace Poshuku
 					* - url
 					*/
 				HistoryAdder_,
+				/** Binds:
+					* - age
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				OutdatedHistoryLoader_,
 				/** Binds:
 					* - age
 					*/
 				HistoryEraser_,
+				/** Binds:
+					* - items
+					*
+					* Returns:
+					* - title
+					* - date
+					* - url
+					*/
+				OverlimitHistoryLoader_,
 				/** Binds:
 					* - items
 					*/
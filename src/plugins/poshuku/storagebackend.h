@@ -97,7 +97,8 @@ namespace Poshuku
 		/** @brief Clears old history items.
 			*
 			* Removes all the history items that are older than days. Also
-			* removes items that are overlimit.
+			* removes items that are overlimit. Emits the removed() signal
+			* with the items that have been removed.
 			*
 			* @param[in] days Maximum age of an item.
 			* @param[in] items How much items should be kept at most.
@@ -158,6 +159,7 @@ namespace Poshuku
 	signals:
 		void added (const HistoryItem&);
 		void added (const FavoritesModel::FavoritesItem&);
+		void removed (const history_items_t&);
 		void updated (const FavoritesModel::FavoritesItem&);
 		void removed (const FavoritesModel::FavoritesItem&);
 	};
@@ -0,0 +1,286 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "urlcompletionindex.h"
+#include <algorithm>
+#include <numeric>
+#include <QDateTime>
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+	namespace
+	{
+		const int TrigramLength = 3;
+
+		quint64 TrigramAt (const QString& str, int pos)
+		{
+			return (static_cast<quint64> (str.at (pos).unicode ()) << 32) |
+					(static_cast<quint64> (str.at (pos + 1).unicode ()) << 16) |
+					static_cast<quint64> (str.at (pos + 2).unicode ());
+		}
+
+		double ToDays (const QDateTime& dt)
+		{
+			const auto& valid = dt.isValid () ? dt : QDateTime::currentDateTime ();
+			return valid.toMSecsSinceEpoch () / (24 * 60 * 60 * 1000.);
+		}
+
+		QString MakeHaystack (const QString& title, const QString& url)
+		{
+			return (title + '\n' + url).toLower ();
+		}
+	}
+
+	double URLCompletionIndex::Entry::GetRating () const
+	{
+		// Same as SUM (julianday (date)) - julianday (MIN (date)) * COUNT (date)
+		// in the SQLite backend.
+		return VisitsSum_ - Visits_.first () * Visits_.size ();
+	}
+
+	void URLCompletionIndex::Add (const history_items_t& items)
+	{
+		QWriteLocker locker { &Lock_ };
+		for (const auto& item : items)
+			AddUnlocked (item);
+	}
+
+	void URLCompletionIndex::Add (const HistoryItem& item)
+	{
+		QWriteLocker locker { &Lock_ };
+		AddUnlocked (item);
+	}
+
+	void URLCompletionIndex::Remove (const history_items_t& items)
+	{
+		QWriteLocker locker { &Lock_ };
+
+		bool hasEmpty = false;
+		for (const auto& item : items)
+		{
+			const auto pos = URL2Entry_.constFind (item.URL_);
+			if (pos == URL2Entry_.constEnd ())
+				continue;
+
+			auto& visits = Entries_ [*pos].Visits_;
+			if (visits.isEmpty ())
+				continue;
+
+			const auto visit = ToDays (item.DateTime_);
+			auto closest = std::lower_bound (visits.begin (), visits.end (), visit);
+			if (closest == visits.end () ||
+					(closest != visits.begin () && visit - *(closest - 1) < *closest - visit))
+				--closest;
+
+			Entries_ [*pos].VisitsSum_ -= *closest;
+			visits.erase (closest);
+			hasEmpty = hasEmpty || visits.isEmpty ();
+		}
+
+		RatingOrderValid_ = false;
+
+		if (!hasEmpty)
+			return;
+
+		Entries_.erase (std::remove_if (Entries_.begin (), Entries_.end (),
+					[] (const Entry& entry) { return entry.Visits_.isEmpty (); }),
+				Entries_.end ());
+		Entries_.squeeze ();
+
+		// The IDs of the remaining entries have shifted, so the lookup
+		// tables are rebuilt from scratch. This also drops the postings
+		// of the trigrams the retitled entries don't have anymore.
+		URL2Entry_.clear ();
+		Trigrams_.clear ();
+		for (int id = 0; id < Entries_.size (); ++id)
+		{
+			const auto& entry = Entries_.at (id);
+			URL2Entry_ [entry.URL_] = id;
+			IndexTrigrams (id, {}, entry.Haystack_);
+		}
+	}
+
+	history_items_t URLCompletionIndex::Find (const QString& base,
+			int limit, const CancelChecker_f& isCancelled) const
+	{
+		const auto& needle = base.toLower ();
+
+		QReadLocker locker { &Lock_ };
+
+		QVector<int> matched;
+		int checked = 0;
+		auto matches = [this, &needle] (int id)
+		{
+			const auto& entry = Entries_.at (id);
+			return !entry.Visits_.isEmpty () && entry.Haystack_.contains (needle);
+		};
+
+		if (needle.size () < TrigramLength)
+		{
+			// Short queries match lots of entries, so just take the best
+			// rated ones until there is enough.
+			for (const auto id : GetRatingOrder ())
+			{
+				if (!(++checked % 1024) && isCancelled ())
+					return {};
+
+				if (!matches (id))
+					continue;
+
+				matched << id;
+				if (matched.size () >= limit)
+					break;
+			}
+		}
+		else
+		{
+			const QVector<int> *candidates = nullptr;
+			for (int i = 0; i + TrigramLength <= needle.size (); ++i)
+			{
+				const auto pos = Trigrams_.constFind (TrigramAt (needle, i));
+				if (pos == Trigrams_.constEnd ())
+					return {};
+
+				if (!candidates || pos->size () < candidates->size ())
+					candidates = &*pos;
+			}
+
+			for (const auto id : *candidates)
+			{
+				if (!(++checked % 1024) && isCancelled ())
+					return {};
+
+				if (matches (id))
+					matched << id;
+			}
+
+			std::sort (matched.begin (), matched.end ());
+			matched.erase (std::unique (matched.begin (), matched.end ()), matched.end ());
+
+			const auto byRating = [this] (int left, int right)
+			{
+				return Entries_.at (left).GetRating () > Entries_.at (right).GetRating ();
+			};
+			if (matched.size () > limit)
+			{
+				std::partial_sort (matched.begin (), matched.begin () + limit, matched.end (), byRating);
+				matched.resize (limit);
+			}
+			else
+				std::sort (matched.begin (), matched.end (), byRating);
+		}
+
+		history_items_t result;
+		result.reserve (matched.size ());
+		for (const auto id : matched)
+		{
+			const auto& entry = Entries_.at (id);
+			result.push_back ({ entry.Title_, {}, entry.URL_ });
+		}
+		return result;
+	}
+
+	void URLCompletionIndex::AddUnlocked (const HistoryItem& item)
+	{
+		if (item.URL_.isEmpty ())
+			return;
+
+		RatingOrderValid_ = false;
+
+		const auto visit = ToDays (item.DateTime_);
+
+		const auto pos = URL2Entry_.constFind (item.URL_);
+		if (pos == URL2Entry_.constEnd ())
+		{
+			const auto id = Entries_.size ();
+			Entries_.push_back ({
+					item.Title_,
+					item.URL_,
+					MakeHaystack (item.Title_, item.URL_),
+					{ visit },
+					visit
+				});
+			URL2Entry_ [item.URL_] = id;
+			IndexTrigrams (id, {}, Entries_.last ().Haystack_);
+			return;
+		}
+
+		const auto id = *pos;
+		auto& entry = Entries_ [id];
+		entry.VisitsSum_ += visit;
+
+		const auto isLast = entry.Visits_.isEmpty () || visit >= entry.Visits_.last ();
+		entry.Visits_.insert (std::upper_bound (entry.Visits_.begin (), entry.Visits_.end (), visit), visit);
+
+		if (!isLast)
+			return;
+
+		if (item.Title_.isEmpty () || item.Title_ == entry.Title_)
+			return;
+
+		auto haystack = MakeHaystack (item.Title_, item.URL_);
+		IndexTrigrams (id, entry.Haystack_, haystack);
+		entry.Title_ = item.Title_;
+		entry.Haystack_ = std::move (haystack);
+	}
+
+	void URLCompletionIndex::IndexTrigrams (int id, const QString& oldHaystack, const QString& haystack)
+	{
+		for (int i = 0; i + TrigramLength <= haystack.size (); ++i)
+		{
+			if (!oldHaystack.isEmpty () &&
+					oldHaystack.contains (haystack.midRef (i, TrigramLength)))
+				continue;
+
+			auto& ids = Trigrams_ [TrigramAt (haystack, i)];
+			if (ids.isEmpty () || ids.last () != id)
+				ids << id;
+		}
+	}
+
+	QVector<int> URLCompletionIndex::GetRatingOrder () const
+	{
+		QMutexLocker locker { &RatingOrderLock_ };
+		if (!RatingOrderValid_)
+		{
+			RatingOrder_.resize (Entries_.size ());
+			std::iota (RatingOrder_.begin (), RatingOrder_.end (), 0);
+			std::stable_sort (RatingOrder_.begin (), RatingOrder_.end (),
+					[this] (int left, int right)
+					{
+						return Entries_.at (left).GetRating () > Entries_.at (right).GetRating ();
+					});
+			RatingOrderValid_ = true;
+		}
+		return RatingOrder_;
+	}
+}
+}
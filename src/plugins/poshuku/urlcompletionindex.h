@@ -0,0 +1,107 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QVector>
+#include <interfaces/poshuku/poshukutypes.h>
+
+namespace LeechCraft
+{
+namespace Poshuku
+{
+	/** @brief In-memory index of the history for the address bar
+	 * completion.
+	 *
+	 * The history is aggregated by URL, and each URL is rated the same
+	 * way the storage backends do it: the more visits there are and the
+	 * more recent they are, the higher the rating is.
+	 *
+	 * Titles and URLs are indexed by their case-folded trigrams, so a
+	 * lookup only verifies the entries having the rarest trigram of the
+	 * query. Shorter queries walk the entries in the rating order and
+	 * stop as soon as enough matches are found.
+	 *
+	 * The index is safe to query from multiple threads while it is
+	 * being updated.
+	 */
+	class URLCompletionIndex
+	{
+		struct Entry
+		{
+			QString Title_;
+			QString URL_;
+			QString Haystack_;
+
+			// Sorted in ascending order.
+			QVector<double> Visits_;
+			double VisitsSum_;
+
+			double GetRating () const;
+		};
+
+		mutable QReadWriteLock Lock_;
+
+		QVector<Entry> Entries_;
+		QHash<QString, int> URL2Entry_;
+		QHash<quint64, QVector<int>> Trigrams_;
+
+		mutable QMutex RatingOrderLock_;
+		mutable QVector<int> RatingOrder_;
+		mutable bool RatingOrderValid_ = false;
+	public:
+		using CancelChecker_f = std::function<bool ()>;
+
+		void Add (const history_items_t&);
+		void Add (const HistoryItem&);
+
+		/** Forgets the visits the history items correspond to, and
+		 * the entries that have no visits left.
+		 */
+		void Remove (const history_items_t&);
+
+		/** Returns at most limit best rated items whose title or URL
+		 * contains base, case-insensitively.
+		 *
+		 * The isCancelled function is called every now and then, and
+		 * if it returns true, the search is aborted returning an empty
+		 * list.
+		 */
+		history_items_t Find (const QString& base, int limit, const CancelChecker_f& isCancelled) const;
+	private:
+		void AddUnlocked (const HistoryItem&);
+		void IndexTrigrams (int, const QString&, const QString&);
+		QVector<int> GetRatingOrder () const;
+	};
+}
+}
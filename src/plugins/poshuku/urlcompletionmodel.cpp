@@ -32,10 +32,14 @@
 #include <QUrl>
 #include <QTimer>
 #include <QApplication>
+#include <QtConcurrentRun>
 #include <QtDebug>
 #include <util/xpc/defaulthookproxy.h>
+#include <util/threads/futures.h>
 #include <interfaces/core/icoreproxy.h>
 #include "core.h"
+#include "urlcompletionindex.h"
+#include "urlcompletionindexupdater.h"
 
 namespace LeechCraft
 {
@@ -44,7 +48,21 @@ namespace Poshuku
 	URLCompletionModel::URLCompletionModel (QObject *parent)
 	: QAbstractItemModel { parent }
 	, ValidateTimer_ { new QTimer { this } }
+	, Index_ { std::make_shared<URLCompletionIndex> () }
+	, Updater_
 	{
+		new URLCompletionIndexUpdater { Index_ },
+		[] (URLCompletionIndexUpdater *updater)
+		{
+			updater->quit ();
+			updater->wait (5000);
+			delete updater;
+		}
+	}
+	, Generation_ { std::make_shared<std::atomic<quint64>> (0) }
+	{
+		Updater_->start (QThread::LowPriority);
+
 		ValidateTimer_->setSingleShot (true);
 		connect (ValidateTimer_,
 				SIGNAL (timeout ()),
@@ -125,8 +143,8 @@ namespace Poshuku
 
 	void URLCompletionModel::setBase (const QString& str)
 	{
-		Valid_ = false;
 		Base_ = str;
+		++*Generation_;
 
 		ValidateTimer_->stop ();
 		ValidateTimer_->start ();
@@ -134,8 +152,69 @@ namespace Poshuku
 
 	void URLCompletionModel::validate ()
 	{
-		PopulateNonHook ();
+		if (Base_.startsWith ('!'))
+		{
+			auto cats = Core::Instance ().GetProxy ()->GetSearchCategories ();
+			cats.sort ();
+
+			history_items_t items;
+			for (const auto& cat : cats)
+				items.push_back ({ cat, {}, "!" + cat });
+			SetNonHookItems (items);
+			RunHook ();
+			return;
+		}
+
+		const auto generation = Generation_->load ();
+		auto isStale = [current = Generation_, generation] { return *current != generation; };
 
+		Util::Sequence (this,
+				QtConcurrent::run ([index = Index_, base = Base_, isStale]
+						{ return isStale () ? history_items_t {} : index->Find (base, 100, isStale); })) >>
+				[this, isStale] (const history_items_t& items)
+				{
+					if (isStale ())
+						return;
+
+					SetNonHookItems (items);
+					RunHook ();
+				};
+	}
+
+	void URLCompletionModel::handleHistoryLoaded (const history_items_t& items)
+	{
+		Updater_->Add (items);
+	}
+
+	void URLCompletionModel::handleItemAdded (const HistoryItem& item)
+	{
+		Updater_->Add (item);
+	}
+
+	void URLCompletionModel::handleItemsRemoved (const history_items_t& items)
+	{
+		Updater_->Remove (items);
+	}
+
+	void URLCompletionModel::SetNonHookItems (const history_items_t& items)
+	{
+		if (!Items_.isEmpty ())
+		{
+			beginRemoveRows ({}, 0, Items_.size () - 1);
+			Items_.clear ();
+			endRemoveRows ();
+		}
+
+		if (items.isEmpty ())
+			return;
+
+		beginInsertRows ({}, 0, items.size () - 1);
+		Items_ = items;
+		endInsertRows ();
+	}
+
+	void URLCompletionModel::RunHook ()
+	{
 		Util::DefaultHookProxy_ptr proxy (new Util::DefaultHookProxy);
 		int size = Items_.size ();
 		emit hookURLCompletionNewStringRequested (proxy, this, Base_, size);
@@ -153,52 +232,5 @@ namespace Poshuku
 			Items_ = newItems;
 		}
 	}
-
-	void URLCompletionModel::handleItemAdded (const HistoryItem&)
-	{
-		Valid_ = false;
-	}
-
-	void URLCompletionModel::PopulateNonHook ()
-	{
-		if (Valid_)
-			return;
-
-		Valid_ = true;
-
-		int size = Items_.size () - 1;
-		if (size > 0)
-			beginRemoveRows ({}, 0, size);
-		Items_.clear ();
-		if (size > 0)
-			endRemoveRows ();
-
-		if (Base_.startsWith ('!'))
-		{
-			auto cats = Core::Instance ().GetProxy ()->GetSearchCategories ();
-			cats.sort ();
-			for (const auto& cat : cats)
-				Items_.push_back ({ cat, {}, "!" + cat });
-		}
-		else
-		{
-			try
-			{
-				Core::Instance ().GetStorageBackend ()->LoadResemblingHistory (Base_, Items_);
-			}
-			catch (const std::runtime_error& e)
-			{
-				qWarning () << Q_FUNC_INFO << e.what ();
-				Valid_ = false;
-			}
-		}
-
-		size = Items_.size () - 1;
-		if (size >= 0)
-		{
-			beginInsertRows ({}, 0, size);
-			endInsertRows ();
-		}
-	}
 }
 }
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <QAbstractItemModel>
 #include <interfaces/core/ihookproxy.h>
 #include <interfaces/poshuku/iurlcompletionmodel.h>
@@ -40,18 +42,28 @@ namespace LeechCraft
 {
 namespace Poshuku
 {
+	class URLCompletionIndex;
+	class URLCompletionIndexUpdater;
+
 	class URLCompletionModel : public QAbstractItemModel
 							 , public IURLCompletionModel
 	{
 		Q_OBJECT
 		Q_INTERFACES (LeechCraft::Poshuku::IURLCompletionModel)
 
-		mutable bool Valid_ = false;
-		mutable history_items_t Items_;
+		history_items_t Items_;
 
 		QString Base_;
 
 		QTimer * const ValidateTimer_;
+
+		const std::shared_ptr<URLCompletionIndex> Index_;
+		const std::shared_ptr<URLCompletionIndexUpdater> Updater_;
+
+		/* Incremented on each new base, so that the lookups for the
+		 * previous ones could notice they're not needed anymore.
+		 */
+		const std::shared_ptr<std::atomic<quint64>> Generation_;
 	public:
 		enum
 		{
@@ -71,12 +83,15 @@ namespace Poshuku
 
 		void AddItem (const QString& title, const QString& url, size_t pos);
 	private:
-		void PopulateNonHook ();
+		void SetNonHookItems (const history_items_t&);
+		void RunHook ();
 	private slots:
 		void validate ();
 	public slots:
 		void setBase (const QString&);
+		void handleHistoryLoaded (const history_items_t&);
 		void handleItemAdded (const HistoryItem&);
+		void handleItemsRemoved (const history_items_t&);
 	signals:
 		// Plugin API
 		void hookURLCompletionNewStringRequested (LeechCraft::IHookProxy_ptr proxy,
@@ -211,20 +211,19 @@ namespace Snails
 		if (folders.isEmpty ())
 			folders << QStringList ("INBOX");
 
-		return SynchronizeImpl (folders, { }, TaskPriority::Low);
+		return SynchronizeImpl (folders, TaskPriority::Low);
 	}
 
-	QFuture<Account::SynchronizeResult_t> Account::Synchronize (const QStringList& path,
-			const QByteArray& last)
+	QFuture<Account::SynchronizeResult_t> Account::Synchronize (const QStringList& path)
 	{
-		return SynchronizeImpl ({ path }, last, TaskPriority::High);
+		return SynchronizeImpl ({ path }, TaskPriority::High);
 	}
 
 	QFuture<Account::SynchronizeResult_t> Account::SynchronizeImpl (const QList<QStringList>& folders,
-			const QByteArray& last, TaskPriority prio)
+			TaskPriority prio)
 	{
 		const auto& future = WorkerPool_->Schedule (prio,
-				&AccountThreadWorker::Synchronize, folders, last);
+				&AccountThreadWorker::Synchronize, folders);
 		return future * [=] (const auto& result)
 				{
 					return Util::Visit (result.AsVariant (),
@@ -240,9 +239,30 @@ namespace Snails
 									const auto& msgs = pair.second;
 
 									HandleMessagesRemoved (msgs.RemovedIds_, folder);
-									HandleGotOtherMessages (msgs.OtherIds_, folder);
-									HandleMsgHeaders (msgs.NewHeaders_, folder);
-									HandleUpdatedMessages (msgs.UpdatedMsgs_, folder);
+
+									// Only remember the state once the changes are stored,
+									// so that an interrupted or failed sync is redone.
+									Util::Sequence (this, HandleMsgHeaders (msgs.NewHeaders_, folder)) >>
+											[=] (bool saved)
+											{
+												return saved ?
+														HandleReadStatusChanged (msgs.KnownSeen_, folder) :
+														Util::MakeReadyFuture (false);
+											} >>
+											[=] (bool saved)
+											{
+												if (!saved)
+												{
+													qWarning () << Q_FUNC_INFO
+															<< "not storing the sync state of"
+															<< folder
+															<< "since the changes haven't been saved";
+													return;
+												}
+
+												if (msgs.SyncState_)
+													Storage_->SetFolderSyncState (this, folder, *msgs.SyncState_);
+											};
 
 									UpdateFolderCount (folder);
 
@@ -256,8 +276,6 @@ namespace Snails
 								qWarning () << Q_FUNC_INFO
 										<< "error synchronizing"
 										<< folders
-										<< "to"
-										<< last
 										<< ":"
 										<< Util::Visit (err, [] (auto e) { return e.what (); });
 								return SynchronizeResult_t::Left (err);
@@ -316,10 +334,12 @@ namespace Snails
 				[=] (const auto& result)
 				{
 					Util::Visit (result.AsVariant (),
-							[=] (const QList<Message_ptr>& msgs)
+							[=] (Util::Void)
 							{
-								HandleUpdatedMessages (msgs, folder);
-								UpdateFolderCount (folder);
+								QHash<QByteArray, bool> id2read;
+								for (const auto& id : ids)
+									id2read [id] = read;
+								HandleReadStatusChanged (id2read, folder);
 							},
 							[] (auto) {});
 				};
@@ -736,31 +756,41 @@ namespace Snails
 				Core::Instance ().GetProxy ());
 	}
 
-	void Account::HandleMsgHeaders (const QList<Message_ptr>& messages, const QStringList& folder)
+	QFuture<bool> Account::HandleMsgHeaders (const QList<Message_ptr>& messages, const QStringList& folder)
 	{
 		qDebug () << Q_FUNC_INFO << messages.size ();
-		Storage_->SaveMessages (this, folder, messages);
+		const auto& future = Storage_->SaveMessages (this, folder, messages);
 
 		MailModelsManager_->Append (messages);
+
+		return future;
 	}
 
-	void Account::HandleUpdatedMessages (const QList<Message_ptr>& messages, const QStringList& folder)
+	QFuture<bool> Account::HandleUpdatedMessages (const QList<Message_ptr>& messages, const QStringList& folder)
 	{
 		qDebug () << Q_FUNC_INFO << messages.size ();
-		Storage_->SaveMessages (this, folder, messages);
+		const auto& future = Storage_->SaveMessages (this, folder, messages);
 
 		MailModelsManager_->Update (messages);
+
+		return future;
 	}
 
-	void Account::HandleGotOtherMessages (const QList<QByteArray>& ids, const QStringList& folder)
+	QFuture<bool> Account::HandleReadStatusChanged (const QHash<QByteArray, bool>& id2read, const QStringList& folder)
 	{
-		qDebug () << Q_FUNC_INFO << ids.size () << folder;
-		if (ids.isEmpty ())
-			return;
+		if (id2read.isEmpty ())
+			return Util::MakeReadyFuture (true);
 
-		const auto& msgs = Storage_->LoadMessages (this, folder, ids);
+		return Util::Sequence (this, Storage_->UpdateReadStatus (this, folder, id2read)) >>
+				[=] (const QList<Message_ptr>& messages)
+				{
+					if (messages.isEmpty ())
+						return Util::MakeReadyFuture (true);
 
-		MailModelsManager_->Append (msgs);
+					const auto& future = HandleUpdatedMessages (messages, folder);
+					UpdateFolderCount (folder);
+					return future;
+				};
 	}
 
 	void Account::HandleMessagesRemoved (const QList<QByteArray>& ids, const QStringList& folder)
@@ -800,7 +830,7 @@ namespace Snails
 					<< storedCount
 					<< "vs"
 					<< count;
-			Synchronize (folder, {});
+			Synchronize (folder);
 		}
 
 		FoldersModel_->SetFolderCounts (folder, unread, count);
@@ -171,7 +171,7 @@ namespace Snails
 		using SynchronizeResult_t = Util::Either<InvokeError_t<>, SyncStats>;
 
 		QFuture<SynchronizeResult_t> Synchronize ();
-		QFuture<SynchronizeResult_t> Synchronize (const QStringList&, const QByteArray&);
+		QFuture<SynchronizeResult_t> Synchronize (const QStringList&);
 
 		using FetchWholeMessageResult_t = QFuture<WrapReturnType_t<Snails::FetchWholeMessageResult_t>>;
 		FetchWholeMessageResult_t FetchWholeMessage (const Message_ptr&);
@@ -202,7 +202,7 @@ namespace Snails
 
 		ProgressListener_ptr MakeProgressListener (const QString&) const;
 	private:
-		QFuture<SynchronizeResult_t> SynchronizeImpl (const QList<QStringList>&, const QByteArray&, TaskPriority);
+		QFuture<SynchronizeResult_t> SynchronizeImpl (const QList<QStringList>&, TaskPriority);
 		QMutex* GetMutex () const;
 
 		void UpdateNoopInterval ();
@@ -218,10 +218,10 @@ namespace Snails
 		void RequestMessageCount (const QStringList&);
 		void HandleMessageCountFetched (int, int, const QStringList&);
 
-		void HandleUpdatedMessages (const QList<Message_ptr>&, const QStringList&);
+		QFuture<bool> HandleUpdatedMessages (const QList<Message_ptr>&, const QStringList&);
+		QFuture<bool> HandleReadStatusChanged (const QHash<QByteArray, bool>&, const QStringList&);
 		void HandleMessagesRemoved (const QList<QByteArray>&, const QStringList&);
-		void HandleMsgHeaders (const QList<Message_ptr>&, const QStringList&);
-		void HandleGotOtherMessages (const QList<QByteArray>&, const QStringList&);
+		QFuture<bool> HandleMsgHeaders (const QList<Message_ptr>&, const QStringList&);
 
 		void HandleGotFolders (const QList<Folder>&);
 	private slots:
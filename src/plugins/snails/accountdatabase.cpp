@@ -230,6 +230,40 @@ namespace Snails
 		Util::DBLock::Execute (QuerySetMsgRead_);
 	}
 
+	boost::optional<FolderSyncState> AccountDatabase::GetSyncState (const QStringList& folder)
+	{
+		QueryGetSyncState_.bindValue (":path", folder.join ("/"));
+		Util::DBLock::Execute (QueryGetSyncState_);
+
+		const std::shared_ptr<void> finishGuard
+		{
+			nullptr,
+			[this] (void*) { QueryGetSyncState_.finish (); }
+		};
+
+		if (!QueryGetSyncState_.next ())
+			return {};
+
+		FolderSyncState state;
+		state.UIDValidity_ = QueryGetSyncState_.value (0).toUInt ();
+		state.UIDNext_ = QueryGetSyncState_.value (1).toUInt ();
+		state.HighestModSeq_ = QueryGetSyncState_.value (2).toULongLong ();
+		state.MessageCount_ = QueryGetSyncState_.value (3).toUInt ();
+		state.FlagsDeferrals_ = QueryGetSyncState_.value (4).toUInt ();
+		return state;
+	}
+
+	void AccountDatabase::SetSyncState (const QStringList& folder, const FolderSyncState& state)
+	{
+		QuerySetSyncState_.bindValue (":folderId", AddFolder (folder));
+		QuerySetSyncState_.bindValue (":uidValidity", state.UIDValidity_);
+		QuerySetSyncState_.bindValue (":uidNext", state.UIDNext_);
+		QuerySetSyncState_.bindValue (":highestModSeq", static_cast<qlonglong> (state.HighestModSeq_));
+		QuerySetSyncState_.bindValue (":messageCount", state.MessageCount_);
+		QuerySetSyncState_.bindValue (":flagsDeferrals", state.FlagsDeferrals_);
+		Util::DBLock::Execute (QuerySetSyncState_);
+	}
+
 	void AccountDatabase::AddMessageToFolder (int msgTableId, int folderTableId, const QByteArray& msgId)
 	{
 		QueryAddMsgToFolder_.bindValue (":msgId", msgId);
@@ -265,6 +299,17 @@ namespace Snails
 					FolderMessageId TEXT NOT NULL
 					)
 				)d";
+		table2queries ["folder_sync_state"] <<
+				R"d(
+					CREATE TABLE folder_sync_state (
+					FolderId INTEGER PRIMARY KEY REFERENCES folders (Id) ON DELETE CASCADE,
+					UIDValidity INTEGER NOT NULL,
+					UIDNext INTEGER NOT NULL,
+					HighestModSeq INTEGER NOT NULL,
+					MessageCount INTEGER NOT NULL,
+					FlagsDeferrals INTEGER NOT NULL DEFAULT 0
+					)
+				)d";
 
 		QSqlQuery query { *DB_ };
 		for (const auto& pair : Util::Stlize (table2queries))
@@ -358,6 +403,22 @@ namespace Snails
 					VALUES
 					(:msgTableId, :folderId, :msgId)
 				)d");
+
+		QueryGetSyncState_ = QSqlQuery { *DB_ };
+		QueryGetSyncState_.prepare (R"d(
+					SELECT UIDValidity, UIDNext, HighestModSeq, MessageCount, FlagsDeferrals
+					FROM folder_sync_state, folders
+					WHERE folders.FolderPath = :path
+					AND folders.Id = folder_sync_state.FolderId
+				)d");
+
+		QuerySetSyncState_ = QSqlQuery { *DB_ };
+		QuerySetSyncState_.prepare (R"d(
+					INSERT OR REPLACE INTO folder_sync_state
+					(FolderId, UIDValidity, UIDNext, HighestModSeq, MessageCount, FlagsDeferrals)
+					VALUES
+					(:folderId, :uidValidity, :uidNext, :highestModSeq, :messageCount, :flagsDeferrals)
+				)d");
 	}
 
 	int AccountDatabase::AddFolder (const QStringList& folder)
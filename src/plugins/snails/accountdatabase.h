@@ -35,6 +35,7 @@
 #include <QSqlQuery>
 #include <QStringList>
 #include <QMap>
+#include "foldersyncstate.h"
 
 class QSqlDatabase;
 typedef std::shared_ptr<QSqlDatabase> QSqlDatabase_ptr;
@@ -76,6 +77,9 @@ namespace Snails
 		QSqlQuery QueryAddMsgUnfoldered_;
 		QSqlQuery QueryAddMsgToFolder_;
 
+		QSqlQuery QueryGetSyncState_;
+		QSqlQuery QuerySetSyncState_;
+
 		QMap<QStringList, int> KnownFolders_;
 	public:
 		AccountDatabase (const QDir&, Account*, QObject* = nullptr);
@@ -91,6 +95,9 @@ namespace Snails
 
 		boost::optional<int> GetMsgTableId (const QByteArray& uniqueId);
 		boost::optional<int> GetMsgTableId (const QByteArray& msgId, const QStringList& folder);
+
+		boost::optional<FolderSyncState> GetSyncState (const QStringList& folder);
+		void SetSyncState (const QStringList& folder, const FolderSyncState&);
 	private:
 		int AddMessageUnfoldered (const Message_ptr&);
 		void UpdateMessage (int, const Message_ptr&);
@@ -38,6 +38,7 @@
 #include <QtDebug>
 #include <QTimer>
 #include <QCryptographicHash>
+#include <vmime/exception.hpp>
 #include <vmime/security/defaultAuthenticator.hpp>
 #include <vmime/net/transport.hpp>
 #include <vmime/net/store.hpp>
@@ -53,6 +54,7 @@
 #include <util/util.h>
 #include <util/xpc/util.h>
 #include <util/sll/prelude.h>
+#include <util/sll/qtutil.h>
 #include "message.h"
 #include "account.h"
 #include "core.h"
@@ -316,7 +318,17 @@ namespace Snails
 
 		void MessageStructHandler::operator() ()
 		{
-			const auto& structure = VmimeMessage_->getStructure ();
+			decltype (VmimeMessage_->getStructure ()) structure;
+			try
+			{
+				structure = VmimeMessage_->getStructure ();
+			}
+			catch (const vmime::exceptions::unfetched_object&)
+			{
+				// The structure is only fetched along with the whole message.
+				return;
+			}
+
 			if (!structure)
 				return;
 
@@ -537,8 +549,7 @@ namespace Snails
 		}
 	}
 
-	auto AccountThreadWorker::FetchMessagesIMAP (const QList<QStringList>& origFolders,
-			const QByteArray& last) -> Folder2Messages_t
+	auto AccountThreadWorker::FetchMessagesIMAP (const QList<QStringList>& origFolders) -> Folder2Messages_t
 	{
 		Folder2Messages_t result;
 
@@ -547,8 +558,37 @@ namespace Snails
 
 		for (const auto& folder : origFolders)
 		{
-			if (const auto& netFolder = GetFolder (folder, FolderMode::ReadOnly))
-				result [folder] = FetchMessagesInFolder (folder, netFolder, last);
+			// A folder failing to sync shouldn't keep the other ones
+			// from syncing. Connection failures are still left to the
+			// caller to reconnect and retry.
+			try
+			{
+				if (const auto& netFolder = GetFolder (folder, FolderMode::ReadOnly))
+					result [folder] = FetchMessagesInFolder (folder, netFolder);
+			}
+			catch (const vmime::exceptions::connection_error&)
+			{
+				throw;
+			}
+			catch (const vmime::exceptions::not_connected&)
+			{
+				throw;
+			}
+			catch (const vmime::exceptions::socket_exception&)
+			{
+				throw;
+			}
+			catch (const vmime::exceptions::operation_timed_out&)
+			{
+				throw;
+			}
+			catch (const std::exception& e)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to sync"
+						<< folder
+						<< e.what ();
+			}
 
 			pl->Increment ();
 		}
@@ -558,129 +598,31 @@ namespace Snails
 		return result;
 	}
 
-	namespace
-	{
-		MessageVector_t GetMessagesInFolder (const VmimeFolder_ptr& folder, const QByteArray& lastId)
-		{
-			const int desiredFlags = vmime::net::fetchAttributes::FLAGS |
-						vmime::net::fetchAttributes::SIZE |
-						vmime::net::fetchAttributes::UID |
-						vmime::net::fetchAttributes::FULL_HEADER |
-						vmime::net::fetchAttributes::STRUCTURE |
-						vmime::net::fetchAttributes::ENVELOPE;
-
-			if (lastId.isEmpty ())
-			{
-				const auto count = folder->getMessageCount ();
-
-				MessageVector_t messages;
-				messages.reserve (count);
-
-				const auto chunkSize = 100;
-				for (vmime::size_t i = 0; i < count; i += chunkSize)
-				{
-					const auto endVal = i + chunkSize;
-					const auto& set = vmime::net::messageSet::byNumber (i + 1, std::min (count, endVal));
-					try
-					{
-						auto theseMessages = folder->getAndFetchMessages (set, desiredFlags);
-						std::move (theseMessages.begin (), theseMessages.end (), std::back_inserter (messages));
-					}
-					catch (const std::exception& e)
-					{
-						qWarning () << Q_FUNC_INFO
-								<< "cannot get messages from"
-								<< i + 1
-								<< "to"
-								<< endVal
-								<< "because:"
-								<< e.what ();
-						return {};
-					}
-				}
-
-				return messages;
-			}
-			else
-			{
-				const auto& set = vmime::net::messageSet::byUID (lastId.constData (), "*");
-				try
-				{
-					return folder->getAndFetchMessages (set, desiredFlags);
-				}
-				catch (const std::exception& e)
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "cannot get messages from"
-							<< lastId
-							<< "because:"
-							<< e.what ();
-					return {};
-				}
-			}
-		}
-	}
-
 	auto AccountThreadWorker::FetchMessagesInFolder (const QStringList& folderName,
-			const VmimeFolder_ptr& folder, const QByteArray& lastId) -> FolderMessages
+			const VmimeFolder_ptr& folder) -> FolderMessages
 	{
 		const auto changeGuard = ChangeListener_->Disable ();
 
-		qDebug () << Q_FUNC_INFO << folderName << folder.get () << lastId;
-
-		auto messages = GetMessagesInFolder (folder, lastId);
-		auto newMessages = Util::Map (messages, [this, &folderName] (const auto& msg)
-				{
-					auto res = FromHeaders (msg);
-					res->AddFolder (folderName);
-					return res;
-				});
-		auto existing = Storage_->LoadIDs (A_, folderName);
-
-		QList<QByteArray> ids;
-
-		QList<Message_ptr> updatedMessages;
-		Q_FOREACH (const auto& msg, newMessages)
-		{
-			if (!existing.contains (msg->GetFolderID ()))
-				continue;
+		const auto& stored = Storage_->GetFolderSyncState (A_, folderName);
+		const auto& existing = Storage_->LoadIDs (A_, folderName);
 
-			existing.removeAll (msg->GetFolderID ());
-			newMessages.removeAll (msg);
+		qDebug () << Q_FUNC_INFO << folderName << folder.get () << existing.size ();
 
-			bool isUpdated = false;
+		const auto& changes = FolderSyncer { folder }.Sync (stored, existing);
 
-			auto updated = Storage_->LoadMessage (A_, folderName, msg->GetFolderID ());
+		FolderMessages result;
+		result.RemovedIds_ = changes.Removed_;
+		result.KnownSeen_ = changes.KnownSeen_;
+		result.SyncState_ = changes.State_;
 
-			if (updated->IsRead () != msg->IsRead ())
-			{
-				updated->SetRead (msg->IsRead ());
-				isUpdated = true;
-			}
-
-			auto sumFolders = updated->GetFolders ();
-			if (!folderName.isEmpty () &&
-					!sumFolders.contains (folderName))
-			{
-				updated->AddFolder (folderName);
-				isUpdated = true;
-			}
-
-			updated->SetVmimeHeader (msg->GetVmimeHeader ());
-
-			if (isUpdated)
-				updatedMessages << updated;
-			else
-				ids << msg->GetFolderID ();
+		for (const auto& message : changes.NewMessages_)
+		{
+			const auto& msg = FromHeaders (message);
+			msg->AddFolder (folderName);
+			result.NewHeaders_ << msg;
 		}
 
-		return
-		{
-			newMessages,
-			updatedMessages,
-			ids,
-			lastId.isEmpty () ? existing : QList<QByteArray> {}
-		};
+		return result;
 	}
 
 	namespace
@@ -689,8 +631,8 @@ namespace Snails
 		{
 			vmime::messageParser mp { FromNetMessage (full) };
 
-			if (!msg->GetVmimeHeader ())
-				msg->SetVmimeHeader (full->getHeader ());
+			// The sync only fetches a part of the headers.
+			msg->SetVmimeHeader (full->getHeader ());
 
 			QString html;
 			QStringList plainParts;
@@ -876,11 +818,11 @@ namespace Snails
 		sendNoop ();
 	}
 
-	auto AccountThreadWorker::Synchronize (const QList<QStringList>& foldersToFetch, const QByteArray& last) -> SyncResult
+	auto AccountThreadWorker::Synchronize (const QList<QStringList>& foldersToFetch) -> SyncResult
 	{
 		const auto& store = MakeStore ();
 		const auto& folders = SyncIMAPFolders (store);
-		const auto& fetchResult = FetchMessagesIMAP (foldersToFetch, last);
+		const auto& fetchResult = FetchMessagesIMAP (foldersToFetch);
 		return { folders, fetchResult };
 	}
 
@@ -910,16 +852,7 @@ namespace Snails
 						vmime::net::message::FLAG_MODE_ADD :
 						vmime::net::message::FLAG_MODE_REMOVE);
 
-		QList<Message_ptr> messages;
-		for (const auto& id : ids)
-		{
-			const auto& message = Storage_->LoadMessage (A_, folderPath, id);
-			message->SetRead (read);
-
-			messages << message;
-		}
-
-		return SetReadStatusResult_t::Right (messages);
+		return SetReadStatusResult_t::Right ({});
 	}
 
 	FetchWholeMessageResult_t AccountThreadWorker::FetchWholeMessage (Message_ptr origMsg)
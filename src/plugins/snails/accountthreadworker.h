@@ -43,6 +43,7 @@
 #include "message.h"
 #include "account.h"
 #include "accountthreadworkerfwd.h"
+#include "foldersyncer.h"
 
 class QTimer;
 
@@ -59,8 +60,6 @@ namespace Snails
 
 	struct Folder;
 
-	using MessageVector_t = std::vector<vmime::shared_ptr<vmime::net::message>>;
-	using VmimeFolder_ptr = vmime::shared_ptr<vmime::net::folder>;
 	using CertList_t = std::vector<vmime::shared_ptr<vmime::security::cert::X509Certificate>>;
 
 	class AccountThreadWorker : public QObject
@@ -98,9 +97,10 @@ namespace Snails
 		struct FolderMessages
 		{
 			QList<Message_ptr> NewHeaders_;
-			QList<Message_ptr> UpdatedMsgs_;
-			QList<QByteArray> OtherIds_;
+			QHash<QByteArray, bool> KnownSeen_;
 			QList<QByteArray> RemovedIds_;
+
+			boost::optional<FolderSyncState> SyncState_;
 		};
 		using Folder2Messages_t = QHash<QStringList, FolderMessages>;
 	private:
@@ -111,8 +111,8 @@ namespace Snails
 
 		Message_ptr FromHeaders (const vmime::shared_ptr<vmime::net::message>&) const;
 
-		Folder2Messages_t FetchMessagesIMAP (const QList<QStringList>&, const QByteArray&);
-		FolderMessages FetchMessagesInFolder (const QStringList&, const VmimeFolder_ptr&, const QByteArray&);
+		Folder2Messages_t FetchMessagesIMAP (const QList<QStringList>&);
+		FolderMessages FetchMessagesInFolder (const QStringList&, const VmimeFolder_ptr&);
 
 		QList<Folder> SyncIMAPFolders (vmime::shared_ptr<vmime::net::store>);
 		QList<Message_ptr> FetchFullMessages (const std::vector<vmime::shared_ptr<vmime::net::message>>&);
@@ -131,13 +131,13 @@ namespace Snails
 			QList<Folder> AllFolders_;
 			Folder2Messages_t Messages_;
 		};
-		SyncResult Synchronize (const QList<QStringList>&, const QByteArray& last);
+		SyncResult Synchronize (const QList<QStringList>&);
 
 		using MsgCountError_t = boost::variant<FolderNotFound>;
 		using MsgCountResult_t = Util::Either<MsgCountError_t, QPair<int, int>>;
 		MsgCountResult_t GetMessageCount (const QStringList& folder);
 
-		using SetReadStatusResult_t = Util::Either<boost::variant<FolderNotFound>, QList<Message_ptr>>;
+		using SetReadStatusResult_t = Util::Either<boost::variant<FolderNotFound>, Util::Void>;
 		SetReadStatusResult_t SetReadStatus (bool read, const QList<QByteArray>& ids, const QStringList& folder);
 
 		FetchWholeMessageResult_t FetchWholeMessage (Message_ptr);
@@ -0,0 +1,246 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "foldersyncer.h"
+#include <algorithm>
+#include <QSet>
+#include <QtDebug>
+#include <vmime/net/imap/IMAPFolderStatus.hpp>
+#include <vmime/net/imap/IMAPMessage.hpp>
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	FolderSyncer::FolderSyncer (const VmimeFolder_ptr& folder)
+	: Folder_ { folder }
+	{
+	}
+
+	namespace
+	{
+		const int HeadersChunkSize = 100;
+
+		QByteArray GetUID (const vmime::shared_ptr<vmime::net::message>& msg)
+		{
+			return static_cast<vmime::string> (msg->getUID ()).c_str ();
+		}
+
+		bool IsSeen (const vmime::shared_ptr<vmime::net::message>& msg)
+		{
+			return msg->getFlags () & vmime::net::message::FLAG_SEEN;
+		}
+
+		quint64 GetModSeq (const vmime::shared_ptr<vmime::net::message>& msg)
+		{
+			const auto& imapMsg = vmime::dynamicCast<vmime::net::imap::IMAPMessage> (msg);
+			return imapMsg ? imapMsg->getModSequence () : 0;
+		}
+
+		MessageVector_t FetchByUIDs (const VmimeFolder_ptr& folder, const QList<QByteArray>& uids,
+				const vmime::net::fetchAttributes& attrs)
+		{
+			MessageVector_t messages;
+			messages.reserve (uids.size ());
+
+			for (int i = 0; i < uids.size (); i += HeadersChunkSize)
+			{
+				auto set = vmime::net::messageSet::empty ();
+				for (const auto& uid : uids.mid (i, HeadersChunkSize))
+					set.addRange (vmime::net::UIDMessageRange (uid.constData ()));
+
+				auto theseMessages = folder->getAndFetchMessages (set, attrs);
+				std::move (theseMessages.begin (), theseMessages.end (), std::back_inserter (messages));
+			}
+
+			return messages;
+		}
+	}
+
+	auto FolderSyncer::Sync (const boost::optional<FolderSyncState>& stored,
+			const QList<QByteArray>& knownIds) -> Result
+	{
+		Result result;
+		result.State_ = GetServerState ();
+		result.Plan_ = PlanFolderSync (stored, result.State_, knownIds.size ());
+
+		const auto& plan = result.Plan_;
+		if (plan.FlagsDeferred_)
+		{
+			result.State_.HighestModSeq_ = stored->HighestModSeq_;
+			result.State_.FlagsDeferrals_ = stored->FlagsDeferrals_ + 1;
+		}
+
+		if (plan.Kind_ == FolderSyncPlan::Kind::UpToDate)
+			return result;
+
+		QSet<QByteArray> known;
+		if (stored && stored->UIDValidity_ != result.State_.UIDValidity_)
+		{
+			// The old UIDs now refer to different messages, if any.
+			qDebug () << Q_FUNC_INFO
+					<< "UIDVALIDITY changed from"
+					<< stored->UIDValidity_
+					<< "to"
+					<< result.State_.UIDValidity_;
+			result.Removed_ = knownIds;
+		}
+		else
+			known = QSet<QByteArray>::fromList (knownIds);
+
+		const bool isFull = plan.Kind_ == FolderSyncPlan::Kind::Full;
+
+		// Nothing to compare flags against, so just fetch the headers
+		// (along with the flags) of everything. The messages are listed
+		// by their UIDs first: unlike the sequence numbers, they don't
+		// shift if something gets expunged meanwhile.
+		if (isFull && known.isEmpty ())
+		{
+			if (!result.State_.MessageCount_)
+				return result;
+
+			QList<QByteArray> uids;
+			for (const auto& msg : Folder_->getAndFetchMessages (vmime::net::messageSet::byUID ("1", "*"),
+						vmime::net::fetchAttributes::UID))
+				uids << GetUID (msg);
+
+			result.NewMessages_ = FetchByUIDs (Folder_, uids, GetHeaderAttributes ());
+			return result;
+		}
+
+		QList<QByteArray> missing;
+
+		if (plan.FetchFlags_ && (isFull || stored->UIDNext_ > 1))
+		{
+			const auto& set = isFull ?
+					vmime::net::messageSet::byUID ("1", "*") :
+					vmime::net::messageSet::byUID ("1",
+							QByteArray::number (stored->UIDNext_ - 1).constData ());
+			const auto& flagged = result.State_.MessageCount_ ?
+					Folder_->getAndFetchMessages (set,
+							vmime::net::fetchAttributes::FLAGS | vmime::net::fetchAttributes::UID) :
+					MessageVector_t {};
+
+			QSet<QByteArray> present;
+			present.reserve (flagged.size ());
+			for (const auto& msg : flagged)
+			{
+				const auto& uid = GetUID (msg);
+				present << uid;
+
+				if (!known.contains (uid))
+				{
+					missing << uid;
+					continue;
+				}
+
+				if (plan.ChangedSince_)
+				{
+					const auto modSeq = GetModSeq (msg);
+					if (modSeq && modSeq <= plan.ChangedSince_)
+						continue;
+				}
+
+				result.KnownSeen_ [uid] = IsSeen (msg);
+			}
+
+			for (const auto& uid : known)
+				if (!present.contains (uid) &&
+						(isFull || uid.toUInt () < stored->UIDNext_))
+					result.Removed_ << uid;
+		}
+
+		if (!missing.isEmpty ())
+			result.NewMessages_ = FetchByUIDs (Folder_, missing, GetHeaderAttributes ());
+
+		if (!isFull && plan.NewFromUID_ && result.State_.MessageCount_)
+		{
+			const auto& set = vmime::net::messageSet::byUID (QByteArray::number (plan.NewFromUID_).constData (), "*");
+			for (const auto& msg : Folder_->getAndFetchMessages (set, GetHeaderAttributes ()))
+			{
+				// UID ranges ending with * always include the last message.
+				const auto& uid = GetUID (msg);
+				if (uid.toUInt () < plan.NewFromUID_)
+					continue;
+
+				if (known.contains (uid))
+					result.KnownSeen_ [uid] = IsSeen (msg);
+				else
+					result.NewMessages_.push_back (msg);
+			}
+		}
+
+		qDebug () << Q_FUNC_INFO
+				<< (isFull ? "full" : "incremental")
+				<< "sync:"
+				<< result.NewMessages_.size ()
+				<< "new,"
+				<< result.KnownSeen_.size ()
+				<< "flags,"
+				<< result.Removed_.size ()
+				<< "removed";
+
+		return result;
+	}
+
+	FolderSyncState FolderSyncer::GetServerState () const
+	{
+		FolderSyncState state;
+
+		const auto& status = Folder_->getStatus ();
+		state.MessageCount_ = status->getMessageCount ();
+
+		if (const auto& imapStatus = vmime::dynamicCast<vmime::net::imap::IMAPFolderStatus> (status))
+		{
+			state.UIDValidity_ = imapStatus->getUIDValidity ();
+			state.UIDNext_ = imapStatus->getUIDNext ();
+			state.HighestModSeq_ = imapStatus->getHighestModSeq ();
+		}
+
+		return state;
+	}
+
+	vmime::net::fetchAttributes FolderSyncer::GetHeaderAttributes ()
+	{
+		vmime::net::fetchAttributes attrs
+		{
+			vmime::net::fetchAttributes::FLAGS |
+					vmime::net::fetchAttributes::SIZE |
+					vmime::net::fetchAttributes::UID |
+					vmime::net::fetchAttributes::ENVELOPE
+		};
+
+		// Not a part of the envelope, but needed for threading.
+		attrs.add ("References");
+		attrs.add ("In-Reply-To");
+
+		return attrs;
+	}
+}
+}
@@ -0,0 +1,98 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <boost/optional.hpp>
+#include <QHash>
+#include <QList>
+#include <QByteArray>
+#include <vmime/net/folder.hpp>
+#include <vmime/net/message.hpp>
+#include "foldersyncstate.h"
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	using MessageVector_t = std::vector<vmime::shared_ptr<vmime::net::message>>;
+	using VmimeFolder_ptr = vmime::shared_ptr<vmime::net::folder>;
+
+	/** @brief Fetches the changes in an IMAP folder since the last sync.
+	 *
+	 * The folder status (UIDVALIDITY, UIDNEXT and, if the server
+	 * supports CONDSTORE, HIGHESTMODSEQ) is compared to the stored one,
+	 * and only what has changed is fetched: headers of the messages
+	 * with new UIDs and flags of the already known messages.
+	 *
+	 * New messages are fetched with the envelope and a couple of
+	 * threading-related headers only, the structure and the bodies are
+	 * left to be fetched once the message is actually opened.
+	 *
+	 * The syncer doesn't depend on the account or the local storage,
+	 * so it could be tested against any IMAP server.
+	 */
+	class FolderSyncer
+	{
+		const VmimeFolder_ptr Folder_;
+	public:
+		struct Result
+		{
+			FolderSyncPlan Plan_;
+
+			/** The state to be stored once the result is processed.
+			 */
+			FolderSyncState State_;
+
+			/** Headers of the messages that aren't known yet.
+			 */
+			MessageVector_t NewMessages_;
+
+			/** The \Seen flags of the known messages that might have
+			 * changed since the last sync.
+			 */
+			QHash<QByteArray, bool> KnownSeen_;
+
+			/** UIDs of the known messages that are no longer present
+			 * in the folder.
+			 */
+			QList<QByteArray> Removed_;
+		};
+
+		explicit FolderSyncer (const VmimeFolder_ptr&);
+
+		Result Sync (const boost::optional<FolderSyncState>& stored, const QList<QByteArray>& knownIds);
+
+		FolderSyncState GetServerState () const;
+
+		static vmime::net::fetchAttributes GetHeaderAttributes ();
+	};
+}
+}
@@ -0,0 +1,96 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "foldersyncstate.h"
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	bool operator== (const FolderSyncState& left, const FolderSyncState& right)
+	{
+		return left.UIDValidity_ == right.UIDValidity_ &&
+				left.UIDNext_ == right.UIDNext_ &&
+				left.HighestModSeq_ == right.HighestModSeq_ &&
+				left.MessageCount_ == right.MessageCount_;
+	}
+
+	bool operator!= (const FolderSyncState& left, const FolderSyncState& right)
+	{
+		return !(left == right);
+	}
+
+	FolderSyncPlan PlanFolderSync (const boost::optional<FolderSyncState>& stored,
+			const FolderSyncState& server, int knownCount)
+	{
+		FolderSyncPlan plan;
+
+		if (!stored ||
+				!server.UIDValidity_ ||
+				stored->UIDValidity_ != server.UIDValidity_)
+		{
+			plan.Kind_ = FolderSyncPlan::Kind::Full;
+			plan.NewFromUID_ = 1;
+			plan.FetchFlags_ = true;
+			return plan;
+		}
+
+		const bool hasModSeq = stored->HighestModSeq_ && server.HighestModSeq_;
+
+		if (server.UIDNext_ > stored->UIDNext_)
+			plan.NewFromUID_ = stored->UIDNext_;
+
+		// Each new message has a new UID, so if the count doesn't match
+		// the number of the already known messages plus the new ones,
+		// some messages were expunged.
+		const auto newCount = server.UIDNext_ - stored->UIDNext_;
+		const bool expunged = server.MessageCount_ != static_cast<quint32> (knownCount) + newCount;
+
+		// Without CONDSTORE flag changes are invisible in the folder
+		// status, so the flags might have changed at any time.
+		const bool flagsChanged = !hasModSeq || server.HighestModSeq_ != stored->HighestModSeq_;
+		const bool mayDefer = stored->FlagsDeferrals_ < MaxFlagsDeferrals &&
+				(!hasModSeq || plan.NewFromUID_);
+
+		if (expunged || (flagsChanged && !mayDefer))
+		{
+			plan.FetchFlags_ = true;
+			if (hasModSeq)
+				plan.ChangedSince_ = stored->HighestModSeq_;
+		}
+		else if (flagsChanged)
+			plan.FlagsDeferred_ = true;
+
+		plan.Kind_ = plan.NewFromUID_ || plan.FetchFlags_ ?
+				FolderSyncPlan::Kind::Incremental :
+				FolderSyncPlan::Kind::UpToDate;
+		return plan;
+	}
+}
+}
@@ -0,0 +1,122 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <QtGlobal>
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	/** @brief The server-side state of a folder as of the last sync.
+	 *
+	 * HighestModSeq_ is zero if the server doesn't support CONDSTORE.
+	 *
+	 * FlagsDeferrals_ is the number of syncs in a row that have
+	 * postponed fetching the flags, see FolderSyncPlan::FlagsDeferred_.
+	 * It isn't a part of the server state, so it's not compared.
+	 */
+	struct FolderSyncState
+	{
+		quint32 UIDValidity_ = 0;
+		quint32 UIDNext_ = 0;
+		quint64 HighestModSeq_ = 0;
+		quint32 MessageCount_ = 0;
+
+		quint32 FlagsDeferrals_ = 0;
+	};
+
+	bool operator== (const FolderSyncState&, const FolderSyncState&);
+	bool operator!= (const FolderSyncState&, const FolderSyncState&);
+
+	/** @brief Describes what should be fetched to bring a folder up to date.
+	 */
+	struct FolderSyncPlan
+	{
+		enum class Kind
+		{
+			/** Nothing has changed since the last sync.
+			 */
+			UpToDate,
+
+			/** Only the changes since the last sync should be fetched.
+			 */
+			Incremental,
+
+			/** Either the folder has never been synced or its
+			 * UIDVALIDITY has changed, so the locally known UIDs
+			 * can't be trusted.
+			 */
+			Full
+		} Kind_ = Kind::Full;
+
+		/** Headers of the messages with UIDs starting from this one
+		 * should be fetched, or 0 if there are no new messages.
+		 */
+		quint32 NewFromUID_ = 0;
+
+		/** Whether the flags of the already known messages should be
+		 * fetched. This also gives the list of the UIDs still present
+		 * on the server, so it's also needed to detect expunges.
+		 */
+		bool FetchFlags_ = false;
+
+		/** Only the flags of messages modified after this modseq are of
+		 * interest, or 0 if all of them are.
+		 */
+		quint64 ChangedSince_ = 0;
+
+		/** Whether the flags refetch has been postponed even though the
+		 * flags might have changed.
+		 *
+		 * New messages bump the HIGHESTMODSEQ too, and refetching the
+		 * flags of the whole folder each time a message arrives costs
+		 * way more than fetching the message itself. So if the new
+		 * messages alone might explain the change, the stored
+		 * HIGHESTMODSEQ should be kept as is instead, and the flags are
+		 * fetched by the next sync that sees no new messages.
+		 *
+		 * Without CONDSTORE nothing tells whether the flags have
+		 * changed, so they are only refetched every few syncs.
+		 *
+		 * Either way, the flags are fetched anyway once they have been
+		 * postponed MaxFlagsDeferrals times in a row, so that a folder
+		 * that gets new mail on each sync still has its flags synced.
+		 */
+		bool FlagsDeferred_ = false;
+	};
+
+	const quint32 MaxFlagsDeferrals = 5;
+
+	FolderSyncPlan PlanFolderSync (const boost::optional<FolderSyncState>& stored,
+			const FolderSyncState& server, int knownCount);
+}
+}
@@ -28,6 +28,7 @@
  **********************************************************************/
 
 #include "mailmodelsmanager.h"
+#include <util/threads/futures.h>
 #include "account.h"
 #include "mailmodel.h"
 #include "core.h"
@@ -82,7 +83,12 @@ namespace Snails
 
 		try
 		{
-			mailModel->Append (Storage_->LoadMessages (Acc_, path, ids));
+			Util::Sequence (mailModel, Storage_->LoadMessages (Acc_, path, ids)) >>
+					[mailModel, path] (const QList<Message_ptr>& messages)
+					{
+						if (mailModel->GetCurrentFolder () == path)
+							mailModel->Append (messages);
+					};
 		}
 		catch (const std::exception& e)
 		{
@@ -90,7 +96,7 @@ namespace Snails
 					<< e.what ();
 		}
 
-		Acc_->Synchronize (path, ids.isEmpty () ? QByteArray {} : ids.last ());
+		Acc_->Synchronize (path);
 	}
 
 	void MailModelsManager::Append (const QList<Message_ptr>& messages)
@@ -45,6 +45,7 @@
 #include <util/sll/visitor.h>
 #include <util/sll/util.h>
 #include <util/shortcuts/shortcutmanager.h>
+#include <util/threads/futures.h>
 #include <interfaces/core/iiconthememanager.h>
 #include "core.h"
 #include "storage.h"
@@ -104,10 +105,10 @@ namespace Snails
 		MailSortFilterModel_->sort (static_cast<int> (MailModel::Column::Date),
 				Qt::DescendingOrder);
 
-		MailTreeDelegate_ = new MailTreeDelegate ([this] (const QByteArray& id) -> Message_ptr
+		MailTreeDelegate_ = new MailTreeDelegate ([this] (const QByteArray& id)
 				{
 					if (!CurrAcc_ || !MailModel_)
-						return {};
+						return Util::MakeReadyFuture (Message_ptr {});
 					return Storage_->LoadMessage (CurrAcc_.get (),
 							MailModel_->GetCurrentFolder (), id);
 				},
@@ -765,10 +766,10 @@ namespace Snails
 		const auto& idx = MailSortFilterModel_->mapToSource (sidx);
 		const auto& id = idx.sibling (idx.row (), 0).data (MailModel::MailRole::ID).toByteArray ();
 
-		Message_ptr msg;
+		QFuture<Message_ptr> future;
 		try
 		{
-			msg = Storage_->LoadMessage (CurrAcc_.get (), folder, id);
+			future = Storage_->LoadMessage (CurrAcc_.get (), folder, id);
 		}
 		catch (const std::exception& e)
 		{
@@ -783,6 +784,26 @@ namespace Snails
 			return;
 		}
 
+		Util::Sequence (this, future) >>
+				[this, id] (const Message_ptr& msg)
+				{
+					const auto& cur = Ui_.MailTree_->currentIndex ();
+					if (cur.data (MailModel::MailRole::ID).toByteArray () != id)
+						return;
+
+					if (!msg)
+					{
+						Ui_.MailView_->setHtml (tr ("<h2>Unable to load mail</h2>"));
+						return;
+					}
+
+					ShowMessage (msg);
+					UpdateMsgActionsStatus ();
+				};
+	}
+
+	void MailTab::ShowMessage (const Message_ptr& msg)
+	{
 		SetMessage (msg);
 
 		if (!msg->IsFullyFetched ())
@@ -1121,8 +1142,12 @@ namespace Snails
 		if (path.isEmpty ())
 			return;
 
-		const auto& msg = Storage_->LoadMessage (CurrAcc_.get (), folder, id);
-		CurrAcc_->FetchAttachment (msg, name, path);
+		Util::Sequence (this, Storage_->LoadMessage (CurrAcc_.get (), folder, id)) >>
+				[acc = CurrAcc_, name, path] (const Message_ptr& msg)
+				{
+					if (msg)
+						acc->FetchAttachment (msg, name, path);
+				};
 	}
 
 	void MailTab::handleFetchNewMail ()
@@ -1136,7 +1161,7 @@ namespace Snails
 		if (!CurrAcc_)
 			return;
 
-		CurrAcc_->Synchronize (MailModel_->GetCurrentFolder (), {});
+		CurrAcc_->Synchronize (MailModel_->GetCurrentFolder ());
 	}
 }
 }
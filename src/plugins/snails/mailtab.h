@@ -123,6 +123,7 @@ namespace Snails
 		QList<Folder> GetActualFolders () const;
 
 		void SetMessage (const Message_ptr&);
+		void ShowMessage (const Message_ptr&);
 
 		void HandleLinkedRequested (MsgType);
 	private slots:
@@ -37,6 +37,7 @@
 #include <QtDebug>
 #include <util/sll/slotclosure.h>
 #include <util/sll/delayedexecutor.h>
+#include <util/threads/futures.h>
 #include "common.h"
 #include "mailtab.h"
 #include "mailmodel.h"
@@ -284,12 +285,12 @@ namespace Snails
 			if (actInfo.Children_.isEmpty ())
 				new Util::SlotClosure<Util::NoDeletePolicy>
 				{
-					[loader, handler = actInfo.Handler_]
+					[loader, handler = actInfo.Handler_, action]
 					{
-						Message_ptr msg;
+						QFuture<Message_ptr> future;
 						try
 						{
-							msg = loader ();
+							future = loader ();
 						}
 						catch (const std::exception& e)
 						{
@@ -299,7 +300,18 @@ namespace Snails
 							return;
 						}
 
-						handler (msg);
+						Util::Sequence (action, future) >>
+								[handler] (const Message_ptr& msg)
+								{
+									if (!msg)
+									{
+										qWarning () << Q_FUNC_INFO
+												<< "unable to load message";
+										return;
+									}
+
+									handler (msg);
+								};
 					},
 					action,
 					SIGNAL (triggered ()),
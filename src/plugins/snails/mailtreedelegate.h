@@ -31,6 +31,7 @@
 
 #include <functional>
 #include <memory>
+#include <QFuture>
 #include <QStyledItemDelegate>
 
 class QByteArray;
@@ -45,7 +46,7 @@ namespace Snails
 	class Message;
 	using Message_ptr = std::shared_ptr<Message>;
 
-	using MessageLoader_f = std::function<Message_ptr (QByteArray)>;
+	using MessageLoader_f = std::function<QFuture<Message_ptr> (QByteArray)>;
 
 	class MailTreeDelegate : public QStyledItemDelegate
 	{
@@ -289,13 +289,29 @@ namespace Snails
 			VmimeHeader_.reset ();
 	}
 
+	namespace
+	{
+		const quint8 FullVersion = 1;
+		const quint8 HeadersOnlyVersion = 2;
+	}
+
 	QByteArray Message::Serialize () const
+	{
+		return SerializeImpl (true);
+	}
+
+	QByteArray Message::SerializeHeaders () const
+	{
+		return SerializeImpl (false);
+	}
+
+	QByteArray Message::SerializeImpl (bool withBodies) const
 	{
 		QByteArray result;
 
 		QDataStream str (&result, QIODevice::WriteOnly);
 		str.setVersion (QDataStream::Qt_4_8);
-		str << static_cast<quint8> (1)
+		str << (withBodies ? FullVersion : HeadersOnlyVersion)
 			<< FolderID_
 			<< MessageID_
 			<< Folders_
@@ -303,10 +319,11 @@ namespace Snails
 			<< Date_
 			<< Recipients_
 			<< Subject_
-			<< IsRead_
-			<< Body_
-			<< HTMLBody_
-			<< InReplyTo_
+			<< IsRead_;
+		if (withBodies)
+			str << Body_
+				<< HTMLBody_;
+		str << InReplyTo_
 			<< References_
 			<< Addresses_
 			<< Attachments_;
@@ -332,7 +349,7 @@ namespace Snails
 		str.setVersion (QDataStream::Qt_4_8);
 		quint8 version = 0;
 		str >> version;
-		if (version != 1)
+		if (version != FullVersion && version != HeadersOnlyVersion)
 			throw std::runtime_error (qPrintable ("Failed to deserialize Message: unknown version " + QString::number (version)));
 
 		str >> FolderID_
@@ -342,10 +359,16 @@ namespace Snails
 			>> Date_
 			>> Recipients_
 			>> Subject_
-			>> IsRead_
-			>> Body_
-			>> HTMLBody_
-			>> InReplyTo_
+			>> IsRead_;
+		if (version == FullVersion)
+			str >> Body_
+				>> HTMLBody_;
+		else
+		{
+			Body_.clear ();
+			HTMLBody_.clear ();
+		}
+		str >> InReplyTo_
 			>> References_
 			>> Addresses_
 			>> Attachments_;
@@ -358,6 +381,32 @@ namespace Snails
 			VmimeHeader_.reset ();
 	}
 
+	QByteArray Message::SerializeBodies () const
+	{
+		QByteArray result;
+
+		QDataStream str (&result, QIODevice::WriteOnly);
+		str.setVersion (QDataStream::Qt_4_8);
+		str << FullVersion
+			<< Body_
+			<< HTMLBody_;
+
+		return result;
+	}
+
+	void Message::DeserializeBodies (const QByteArray& data)
+	{
+		QDataStream str (data);
+		str.setVersion (QDataStream::Qt_4_8);
+		quint8 version = 0;
+		str >> version;
+		if (version != FullVersion)
+			throw std::runtime_error (qPrintable ("Failed to deserialize Message bodies: unknown version " + QString::number (version)));
+
+		str >> Body_
+			>> HTMLBody_;
+	}
+
 	QString GetNiceMail (const Message::Address_t& pair)
 	{
 		const QString& fromName = pair.first;
@@ -150,6 +150,19 @@ namespace Snails
 
 		QByteArray Serialize () const;
 		void Deserialize (const QByteArray&);
+
+		/** @brief Serializes everything except the message bodies.
+		 *
+		 * The result is understood by Deserialize(), and the bodies
+		 * could be restored later via DeserializeBodies().
+		 */
+		QByteArray SerializeHeaders () const;
+
+		QByteArray SerializeBodies () const;
+		void DeserializeBodies (const QByteArray&);
+	private:
+		QByteArray SerializeImpl (bool withBodies) const;
+	public:
 	signals:
 		void readStatusChanged (const QByteArray&, bool);
 	};
@@ -0,0 +1,632 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "messagestore.h"
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+#include <QDataStream>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	namespace
+	{
+		const QString IndexFileName { "messages.index" };
+		const QString UnreadableLegacyDirName { "legacy.unreadable" };
+
+		const quint32 IndexMagic = 0x4c43534d;
+		const quint32 IndexVersion = 1;
+
+		enum IndexOp : quint8
+		{
+			Put = 1,
+			Remove = 2
+		};
+
+		// Messages are mostly text, and the fastest zlib level already
+		// gets most of the gain.
+		const int CompressionLevel = 1;
+
+		const qint64 MaxSegmentSize = 64 * 1024 * 1024;
+		const qint64 MinSegmentsGarbage = 16 * 1024 * 1024;
+	}
+
+	bool MessageStore::Location::IsValid () const
+	{
+		return Segment_ >= 0;
+	}
+
+	MessageStore::MessageStore (const QDir& dir)
+	: Dir_ { dir }
+	{
+	}
+
+	void MessageStore::Save (const QList<Message_ptr>& msgs)
+	{
+		QMutexLocker locker { &Mutex_ };
+		EnsureOpen ();
+		SaveUnlocked (msgs);
+	}
+
+	void MessageStore::Remove (const QByteArray& id)
+	{
+		QMutexLocker locker { &Mutex_ };
+		EnsureOpen ();
+		if (!Entries_.remove (id))
+			return;
+
+		AppendIndex (id, nullptr);
+		Index_.flush ();
+	}
+
+	Message_ptr MessageStore::Load (const QByteArray& id, LoadMode mode)
+	{
+		QMutexLocker locker { &Mutex_ };
+		EnsureOpen ();
+		const auto pos = Entries_.constFind (id);
+		if (pos == Entries_.constEnd ())
+			return {};
+
+		return LoadEntry (id, *pos, mode);
+	}
+
+	QList<Message_ptr> MessageStore::Load (const QList<QByteArray>& ids, LoadMode mode)
+	{
+		QMutexLocker locker { &Mutex_ };
+		EnsureOpen ();
+
+		// Read the records in the order they are laid out on disk.
+		QList<QPair<int, Entry>> toLoad;
+		for (int i = 0; i < ids.size (); ++i)
+		{
+			const auto pos = Entries_.constFind (ids.at (i));
+			if (pos != Entries_.constEnd ())
+				toLoad.append ({ i, *pos });
+		}
+		std::sort (toLoad.begin (), toLoad.end (),
+				[] (const QPair<int, Entry>& left, const QPair<int, Entry>& right)
+				{
+					const auto& l = left.second.Headers_;
+					const auto& r = right.second.Headers_;
+					return std::tie (l.Segment_, l.Offset_) < std::tie (r.Segment_, r.Offset_);
+				});
+
+		QVector<Message_ptr> loaded (ids.size ());
+		for (const auto& pair : toLoad)
+			loaded [pair.first] = LoadEntry (ids.at (pair.first), pair.second, mode);
+
+		QList<Message_ptr> result;
+		result.reserve (toLoad.size ());
+		for (const auto& msg : loaded)
+			if (msg)
+				result << msg;
+		return result;
+	}
+
+	boost::optional<bool> MessageStore::IsRead (const QByteArray& id)
+	{
+		QMutexLocker locker { &Mutex_ };
+		EnsureOpen ();
+		const auto pos = Entries_.constFind (id);
+		if (pos == Entries_.constEnd ())
+			return {};
+
+		return pos->IsRead_;
+	}
+
+	void MessageStore::SaveUnlocked (const QList<Message_ptr>& msgs)
+	{
+		for (const auto& msg : msgs)
+		{
+			const auto& id = msg->GetFolderID ();
+			if (id.isEmpty ())
+				continue;
+
+			Entry entry;
+			entry.Headers_ = Append (qCompress (msg->SerializeHeaders (), CompressionLevel));
+			if (msg->IsFullyFetched ())
+				entry.Bodies_ = Append (qCompress (msg->SerializeBodies (), CompressionLevel));
+			else
+			{
+				// Headers-only updates (like read flag changes) keep the
+				// previously fetched bodies.
+				const auto pos = Entries_.constFind (id);
+				if (pos != Entries_.constEnd ())
+					entry.Bodies_ = pos->Bodies_;
+			}
+			entry.IsRead_ = msg->IsRead ();
+
+			Entries_ [id] = entry;
+			AppendIndex (id, &entry);
+		}
+
+		WriteSegment_.flush ();
+		Index_.flush ();
+	}
+
+	void MessageStore::EnsureOpen ()
+	{
+		if (IsOpen_)
+			return;
+
+		// Start over if a previous attempt has thrown halfway.
+		Entries_.clear ();
+		IndexRecords_ = 0;
+
+		Open ();
+		ImportLegacy ();
+		IsOpen_ = true;
+	}
+
+	void MessageStore::Open ()
+	{
+		const auto isIndexComplete = ReplayIndex ();
+
+		qint64 liveBytes = 0;
+		for (const auto& entry : Entries_)
+			for (const auto& loc : { entry.Headers_, entry.Bodies_ })
+				if (loc.IsValid ())
+					liveBytes += loc.Length_;
+
+		qint64 totalBytes = 0;
+		qint32 maxSegment = -1;
+		for (const auto segment : ListSegments ())
+		{
+			totalBytes += QFileInfo { SegmentPath (segment) }.size ();
+			maxSegment = std::max (maxSegment, segment);
+		}
+
+		const auto garbage = totalBytes - liveBytes;
+		const bool compactSegments = garbage > MinSegmentsGarbage && garbage > liveBytes;
+		if (compactSegments)
+		{
+			qDebug () << Q_FUNC_INFO
+					<< "compacting"
+					<< Dir_.path ()
+					<< "with"
+					<< garbage
+					<< "garbage bytes of"
+					<< totalBytes;
+			WriteSegmentNum_ = maxSegment + 1;
+			Compact ();
+		}
+
+		if (!isIndexComplete ||
+				compactSegments ||
+				IndexRecords_ > 2 * Entries_.size () + 256)
+			RewriteIndex ();
+
+		// Segments that aren't referenced by the index are either fully
+		// garbage or leftovers of an interrupted compaction.
+		QSet<qint32> referenced;
+		for (const auto& entry : Entries_)
+			for (const auto& loc : { entry.Headers_, entry.Bodies_ })
+				if (loc.IsValid ())
+					referenced << loc.Segment_;
+
+		WriteSegmentNum_ = 0;
+		for (const auto segment : ListSegments ())
+			if (!referenced.contains (segment))
+			{
+				ReadSegments_.remove (segment);
+				QFile::remove (SegmentPath (segment));
+			}
+			else
+				WriteSegmentNum_ = std::max (WriteSegmentNum_, segment);
+	}
+
+	void MessageStore::ImportLegacy ()
+	{
+		// Each message used to be stored in its own file in a directory
+		// named after the last three hex digits of its ID. Folder
+		// directories are hex-encoded UTF-8 and thus never that short.
+		for (const auto& shard : Dir_.entryList (QDir::Dirs | QDir::NoDotAndDotDot))
+		{
+			if (shard.size () != 3)
+				continue;
+
+			QDir shardDir = Dir_;
+			if (!shardDir.cd (shard))
+				continue;
+
+			QStringList imported;
+			QStringList unreadable;
+			QList<Message_ptr> msgs;
+			for (const auto& name : shardDir.entryList (QDir::Files))
+			{
+				QFile file { shardDir.filePath (name) };
+				if (!file.open (QIODevice::ReadOnly))
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "unable to open"
+							<< file.fileName ()
+							<< file.errorString ();
+					unreadable << name;
+					continue;
+				}
+
+				const auto& msg = std::make_shared<Message> ();
+				try
+				{
+					msg->Deserialize (qUncompress (file.readAll ()));
+				}
+				catch (const std::exception& e)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "error deserializing the message from"
+							<< file.fileName ()
+							<< e.what ();
+					unreadable << name;
+					continue;
+				}
+				msgs << msg;
+				imported << name;
+			}
+
+			SaveUnlocked (msgs);
+
+			for (const auto& name : imported)
+				shardDir.remove (name);
+
+			// Keep whatever couldn't be imported, so that it could still
+			// be recovered by hand.
+			if (!unreadable.isEmpty ())
+			{
+				QDir quarantine = Dir_;
+				if (!quarantine.mkpath (UnreadableLegacyDirName) ||
+						!quarantine.cd (UnreadableLegacyDirName))
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "unable to create"
+							<< Dir_.filePath (UnreadableLegacyDirName)
+							<< "leaving the unreadable files in"
+							<< shardDir.path ();
+					continue;
+				}
+
+				for (const auto& name : unreadable)
+					if (!QFile::rename (shardDir.filePath (name), quarantine.filePath (shard + '_' + name)))
+						qWarning () << Q_FUNC_INFO
+								<< "unable to move"
+								<< shardDir.filePath (name)
+								<< "to"
+								<< quarantine.path ();
+			}
+
+			Dir_.rmdir (shard);
+
+			qDebug () << Q_FUNC_INFO
+					<< "imported"
+					<< msgs.size ()
+					<< "messages from"
+					<< shardDir.path ();
+		}
+	}
+
+	void MessageStore::Compact ()
+	{
+		for (auto& entry : Entries_)
+			for (auto loc : { &entry.Headers_, &entry.Bodies_ })
+			{
+				if (!loc->IsValid ())
+					continue;
+
+				const auto& data = Read (*loc);
+				if (data.size () != loc->Length_)
+				{
+					qWarning () << Q_FUNC_INFO
+							<< "unable to read a record from"
+							<< loc->Segment_;
+					*loc = {};
+					continue;
+				}
+
+				*loc = Append (data);
+			}
+
+		WriteSegment_.close ();
+		ReadSegments_.clear ();
+	}
+
+	bool MessageStore::ReplayIndex ()
+	{
+		Index_.setFileName (Dir_.filePath (IndexFileName));
+		if (!Index_.exists ())
+			return true;
+
+		if (!Index_.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< Index_.fileName ()
+					<< Index_.errorString ();
+			throw std::runtime_error ("Unable to open the messages index");
+		}
+
+		QDataStream str { &Index_ };
+		str.setVersion (QDataStream::Qt_5_0);
+
+		quint32 magic = 0;
+		quint32 version = 0;
+		str >> magic >> version;
+		if (magic != IndexMagic || version != IndexVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown index format"
+					<< magic
+					<< version
+					<< "in"
+					<< Index_.fileName ();
+			Index_.close ();
+			throw std::runtime_error ("Unknown messages index format");
+		}
+
+		bool complete = true;
+		while (!str.atEnd ())
+		{
+			quint8 op = 0;
+			QByteArray id;
+			Entry entry;
+			str >> op >> id;
+			if (op == IndexOp::Put)
+				str >> entry.Headers_.Segment_
+					>> entry.Headers_.Offset_
+					>> entry.Headers_.Length_
+					>> entry.Bodies_.Segment_
+					>> entry.Bodies_.Offset_
+					>> entry.Bodies_.Length_
+					>> entry.IsRead_;
+
+			if (str.status () != QDataStream::Ok ||
+					(op != IndexOp::Put && op != IndexOp::Remove))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "truncated index"
+						<< Index_.fileName ();
+				complete = false;
+				break;
+			}
+
+			if (op == IndexOp::Put)
+				Entries_ [id] = entry;
+			else
+				Entries_.remove (id);
+			++IndexRecords_;
+		}
+
+		Index_.close ();
+		return complete;
+	}
+
+	void MessageStore::RewriteIndex ()
+	{
+		Index_.close ();
+
+		QSaveFile file { Dir_.filePath (IndexFileName) };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			throw std::runtime_error ("Unable to rewrite the messages index");
+		}
+
+		{
+			QDataStream str { &file };
+			str.setVersion (QDataStream::Qt_5_0);
+			str << IndexMagic << IndexVersion;
+		}
+
+		Index_.setFileName (file.fileName ());
+		IndexRecords_ = 0;
+
+		for (auto i = Entries_.begin (); i != Entries_.end (); ++i)
+		{
+			QDataStream str { &file };
+			str.setVersion (QDataStream::Qt_5_0);
+			str << static_cast<quint8> (IndexOp::Put)
+				<< i.key ()
+				<< i->Headers_.Segment_
+				<< i->Headers_.Offset_
+				<< i->Headers_.Length_
+				<< i->Bodies_.Segment_
+				<< i->Bodies_.Offset_
+				<< i->Bodies_.Length_
+				<< i->IsRead_;
+			++IndexRecords_;
+		}
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to commit"
+					<< file.fileName ()
+					<< file.errorString ();
+			throw std::runtime_error ("Unable to rewrite the messages index");
+		}
+	}
+
+	void MessageStore::AppendIndex (const QByteArray& id, const Entry *entry)
+	{
+		if (!Index_.isOpen ())
+		{
+			const auto isNew = !Index_.exists () || !Index_.size ();
+			if (!Index_.open (QIODevice::WriteOnly | QIODevice::Append))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< Index_.fileName ()
+						<< Index_.errorString ();
+				throw std::runtime_error ("Unable to open the messages index");
+			}
+
+			if (isNew)
+			{
+				QDataStream str { &Index_ };
+				str.setVersion (QDataStream::Qt_5_0);
+				str << IndexMagic << IndexVersion;
+			}
+		}
+
+		QDataStream str { &Index_ };
+		str.setVersion (QDataStream::Qt_5_0);
+		if (entry)
+			str << static_cast<quint8> (IndexOp::Put)
+				<< id
+				<< entry->Headers_.Segment_
+				<< entry->Headers_.Offset_
+				<< entry->Headers_.Length_
+				<< entry->Bodies_.Segment_
+				<< entry->Bodies_.Offset_
+				<< entry->Bodies_.Length_
+				<< entry->IsRead_;
+		else
+			str << static_cast<quint8> (IndexOp::Remove)
+				<< id;
+
+		++IndexRecords_;
+	}
+
+	MessageStore::Location MessageStore::Append (const QByteArray& data)
+	{
+		if (WriteSegment_.isOpen () && WriteOffset_ >= MaxSegmentSize)
+		{
+			WriteSegment_.close ();
+			++WriteSegmentNum_;
+		}
+
+		while (!WriteSegment_.isOpen ())
+		{
+			WriteSegment_.setFileName (SegmentPath (WriteSegmentNum_));
+			if (!WriteSegment_.open (QIODevice::WriteOnly | QIODevice::Append))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< WriteSegment_.fileName ()
+						<< WriteSegment_.errorString ();
+				throw std::runtime_error ("Unable to open the messages segment");
+			}
+			WriteOffset_ = WriteSegment_.size ();
+
+			if (WriteOffset_ >= MaxSegmentSize)
+			{
+				WriteSegment_.close ();
+				++WriteSegmentNum_;
+			}
+		}
+
+		if (WriteSegment_.write (data) != data.size ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to write to"
+					<< WriteSegment_.fileName ()
+					<< WriteSegment_.errorString ();
+			throw std::runtime_error ("Unable to write the messages segment");
+		}
+
+		const Location loc { WriteSegmentNum_, WriteOffset_, data.size () };
+		WriteOffset_ += data.size ();
+		return loc;
+	}
+
+	QByteArray MessageStore::Read (const Location& loc)
+	{
+		if (loc.Segment_ == WriteSegmentNum_ && WriteSegment_.isOpen ())
+			WriteSegment_.flush ();
+
+		auto file = ReadSegments_.value (loc.Segment_);
+		if (!file)
+		{
+			file = std::make_shared<QFile> (SegmentPath (loc.Segment_));
+			if (!file->open (QIODevice::ReadOnly))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to open"
+						<< file->fileName ()
+						<< file->errorString ();
+				return {};
+			}
+			ReadSegments_ [loc.Segment_] = file;
+		}
+
+		if (!file->seek (loc.Offset_))
+			return {};
+
+		return file->read (loc.Length_);
+	}
+
+	Message_ptr MessageStore::LoadEntry (const QByteArray& id, const Entry& entry, LoadMode mode)
+	{
+		const auto& msg = std::make_shared<Message> ();
+		try
+		{
+			msg->Deserialize (qUncompress (Read (entry.Headers_)));
+			if (mode == LoadMode::Full && entry.Bodies_.IsValid ())
+				msg->DeserializeBodies (qUncompress (Read (entry.Bodies_)));
+		}
+		catch (const std::exception& e)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "error deserializing the message"
+					<< id.toHex ()
+					<< "from"
+					<< Dir_.path ()
+					<< e.what ();
+			return {};
+		}
+
+		return msg;
+	}
+
+	QString MessageStore::SegmentPath (qint32 segment) const
+	{
+		return Dir_.filePath (QString { "messages.%1.seg" }.arg (segment));
+	}
+
+	QList<qint32> MessageStore::ListSegments () const
+	{
+		QList<qint32> result;
+		for (const auto& name : Dir_.entryList ({ "messages.*.seg" }, QDir::Files))
+		{
+			bool ok = false;
+			const auto segment = name.section ('.', 1, 1).toInt (&ok);
+			if (ok)
+				result << segment;
+		}
+		return result;
+	}
+}
+}
@@ -0,0 +1,136 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <boost/optional.hpp>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include "message.h"
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	/** @brief Packed storage of the messages of a single folder.
+	 *
+	 * Messages are appended to a few segment files, headers and bodies
+	 * being separate records, so that the headers could be loaded
+	 * without touching the bodies. The locations of the records along
+	 * with the read flags live in an append-only index file that's
+	 * replayed on opening.
+	 *
+	 * Both the index and the segments are compacted on opening once
+	 * they accumulate enough garbage.
+	 *
+	 * Constructing the store doesn't touch the disk: it is opened by
+	 * the first method call, so the replay, the compaction and the
+	 * legacy import run on the thread that first uses the store.
+	 *
+	 * The legacy message files that can't be read are moved to the
+	 * <code>legacy.unreadable</code> subdirectory instead of being
+	 * deleted.
+	 *
+	 * All the methods are thread-safe.
+	 */
+	class MessageStore
+	{
+		struct Location
+		{
+			qint32 Segment_ = -1;
+			qint64 Offset_ = 0;
+			qint32 Length_ = 0;
+
+			bool IsValid () const;
+		};
+
+		struct Entry
+		{
+			Location Headers_;
+			Location Bodies_;
+			bool IsRead_ = false;
+		};
+
+		const QDir Dir_;
+
+		mutable QMutex Mutex_;
+
+		bool IsOpen_ = false;
+
+		QHash<QByteArray, Entry> Entries_;
+
+		QFile Index_;
+		int IndexRecords_ = 0;
+
+		QFile WriteSegment_;
+		qint32 WriteSegmentNum_ = 0;
+		qint64 WriteOffset_ = 0;
+		QHash<qint32, std::shared_ptr<QFile>> ReadSegments_;
+	public:
+		enum class LoadMode
+		{
+			HeadersOnly,
+			Full
+		};
+
+		explicit MessageStore (const QDir&);
+
+		void Save (const QList<Message_ptr>&);
+		void Remove (const QByteArray&);
+
+		Message_ptr Load (const QByteArray&, LoadMode);
+		QList<Message_ptr> Load (const QList<QByteArray>&, LoadMode);
+
+		boost::optional<bool> IsRead (const QByteArray&);
+	private:
+		void SaveUnlocked (const QList<Message_ptr>&);
+
+		void EnsureOpen ();
+		void Open ();
+		void ImportLegacy ();
+		void Compact ();
+
+		bool ReplayIndex ();
+		void RewriteIndex ();
+		void AppendIndex (const QByteArray&, const Entry*);
+
+		Location Append (const QByteArray&);
+		QByteArray Read (const Location&);
+		Message_ptr LoadEntry (const QByteArray&, const Entry&, LoadMode);
+
+		QString SegmentPath (qint32) const;
+		QList<qint32> ListSegments () const;
+	};
+
+	typedef std::shared_ptr<MessageStore> MessageStore_ptr;
+}
+}
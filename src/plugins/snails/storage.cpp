@@ -31,7 +31,6 @@
 #include <stdexcept>
 #include <QFile>
 #include <QApplication>
-#include <QtConcurrentMap>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -39,10 +38,12 @@
 #include <QtConcurrentRun>
 #include <util/db/dblock.h>
 #include <util/sys/paths.h>
+#include <util/sll/qtutil.h>
 #include <util/threads/futures.h>
 #include "xmlsettingsmanager.h"
 #include "account.h"
 #include "accountdatabase.h"
+#include "messagestore.h"
 
 namespace LeechCraft
 {
@@ -68,65 +69,37 @@ namespace Snails
 		SDir_ = Util::CreateIfNotExists ("snails/storage");
 	}
 
-	namespace
-	{
-		QList<Message_ptr> MessageSaverProc (QList<Message_ptr> msgs, const QDir& dir)
-		{
-			for (const auto& msg : msgs)
-			{
-				if (msg->GetFolderID ().isEmpty ())
-					continue;
-
-				const QString dirName = msg->GetFolderID ().toHex ().right (3);
-
-				QDir msgDir = dir;
-				if (!dir.exists (dirName))
-					msgDir.mkdir (dirName);
-				if (!msgDir.cd (dirName))
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "unable to cd into"
-							<< msgDir.filePath (dirName);
-					continue;
-				}
-
-				QFile file (msgDir.filePath (msg->GetFolderID ().toHex ()));
-				file.open (QIODevice::WriteOnly);
-				file.write (qCompress (msg->Serialize (), 9));
-			}
-
-			return msgs;
-		}
-	}
-
-	void Storage::SaveMessages (Account *acc, const QStringList& folder, const QList<Message_ptr>& msgs)
+	QFuture<bool> Storage::SaveMessages (Account *acc, const QStringList& folder, const QList<Message_ptr>& msgs)
 	{
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
-		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.exists (subdir))
-				dir.mkdir (subdir);
-
-			if (!dir.cd (subdir))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
-		}
+		const auto& store = StoreForFolder (acc, folder);
 
 		for (const auto& msg : msgs)
 			PendingSaveMessages_ [acc] [msg->GetFolderID ()] = msg;
 
-		Util::Sequence (this, QtConcurrent::run (MessageSaverProc, msgs, dir)) >>
-				[this, acc] (const QList<Message_ptr>& messages)
+		const auto& future = Util::Sequence (this,
+				QtConcurrent::run ([store, msgs]
+					{
+						try
+						{
+							store->Save (msgs);
+							return true;
+						}
+						catch (const std::exception& e)
+						{
+							qWarning () << Q_FUNC_INFO
+									<< "unable to save messages:"
+									<< e.what ();
+							return false;
+						}
+					})) >>
+				[this, acc, msgs] (bool saved)
 				{
 					auto& hash = PendingSaveMessages_ [acc];
 
-					for (const auto& msg : messages)
+					for (const auto& msg : msgs)
 						hash.remove (msg->GetFolderID ());
+
+					return Util::MakeReadyFuture (saved);
 				};
 
 		for (const auto& msg : msgs)
@@ -135,159 +108,81 @@ namespace Snails
 				continue;
 
 			AddMessage (msg, acc);
-			UpdateCaches (msg);
 		}
-	}
-
-	MessageSet Storage::LoadMessages (Account *acc)
-	{
-		MessageSet result;
 
-		const QDir& dir = DirForAccount (acc);
-		for (const auto& str : dir.entryList (QDir::NoDotAndDotDot | QDir::Dirs))
-		{
-			QDir subdir = dir;
-			if (!subdir.cd (str))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< str;
-				continue;
-			}
-
-			for (const auto& str : subdir.entryList (QDir::NoDotAndDotDot | QDir::Files))
-			{
-				QFile file (subdir.filePath (str));
-				if (!file.open (QIODevice::ReadOnly))
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "unable to open"
-							<< str
-							<< file.errorString ();
-					continue;
-				}
-
-				const auto& msg = std::make_shared<Message> ();
-				try
-				{
-					msg->Deserialize (qUncompress (file.readAll ()));
-				}
-				catch (const std::exception& e)
-				{
-					qWarning () << Q_FUNC_INFO
-							<< "error deserializing the message from"
-							<< file.fileName ()
-							<< e.what ();
-					continue;
-				}
-				result << msg;
-				UpdateCaches (msg);
-			}
-		}
-
-		for (const auto& msg : PendingSaveMessages_ [acc])
-		{
-			result << msg;
-			UpdateCaches (msg);
-		}
-
-		return result;
+		return future;
 	}
 
-	Message_ptr Storage::LoadMessage (Account *acc, const QStringList& folder, const QByteArray& id)
+	QFuture<Message_ptr> Storage::LoadMessage (Account *acc, const QStringList& folder, const QByteArray& id)
 	{
-		if (PendingSaveMessages_ [acc].contains (id))
-			return PendingSaveMessages_ [acc] [id];
+		if (const auto& msg = PendingSaveMessages_.value (acc).value (id))
+			return Util::MakeReadyFuture (msg);
 
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
-		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.cd (subdir))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
-		}
-
-		const auto& msg = LoadMessage (acc, dir, id);
-		UpdateCaches (msg);
-		return msg;
+		const auto& store = StoreForFolder (acc, folder);
+		return QtConcurrent::run ([store, folder, id]
+				{
+					try
+					{
+						if (const auto& msg = store->Load (id, MessageStore::LoadMode::Full))
+							return msg;
+
+						qWarning () << Q_FUNC_INFO
+								<< "unable to load message"
+								<< id.toHex ()
+								<< "from"
+								<< folder;
+					}
+					catch (const std::exception& e)
+					{
+						qWarning () << Q_FUNC_INFO
+								<< "unable to load message"
+								<< id.toHex ()
+								<< "from"
+								<< folder
+								<< e.what ();
+					}
+					return Message_ptr {};
+				});
 	}
 
-	Message_ptr Storage::LoadMessage (Account *acc, QDir dir, const QByteArray& id) const
+	QFuture<QList<Message_ptr>> Storage::LoadMessages (Account *acc, const QStringList& folder, const QList<QByteArray>& ids)
 	{
-		if (PendingSaveMessages_ [acc].contains (id))
-			return PendingSaveMessages_ [acc] [id];
-
-		if (!dir.cd (id.toHex ().right (3)))
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to cd to"
-					<< dir.filePath (id.toHex ().right (3));
-			throw std::runtime_error ("Unable to cd to the directory");
-		}
-
-		QFile file (dir.filePath (id.toHex ()));
-		if (!file.open (QIODevice::ReadOnly))
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to open"
-					<< file.fileName ()
-					<< file.errorString ();
-			throw std::runtime_error ("Unable to open the message file");
-		}
-
-		const auto& msg = std::make_shared<Message> ();
-		try
-		{
-			msg->Deserialize (qUncompress (file.readAll ()));
-		}
-		catch (const std::exception& e)
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "error deserializing the message from"
-					<< file.fileName ()
-					<< e.what ();
-			throw;
-		}
+		QList<Message_ptr> pendingMsgs;
 
-		return msg;
-	}
-
-	QList<Message_ptr> Storage::LoadMessages (Account *acc, const QStringList& folder, const QList<QByteArray>& ids)
-	{
-		auto rootDir = DirForAccount (acc);
-		for (const auto& elem : folder)
+		const auto& pending = PendingSaveMessages_.value (acc);
+		QList<QByteArray> toLoad;
+		for (const auto& id : ids)
 		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!rootDir.cd (subdir) &&
-					!(rootDir.mkpath (subdir) && rootDir.cd (subdir)))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< rootDir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
-			}
+			if (const auto& msg = pending.value (id))
+				pendingMsgs << msg;
+			else
+				toLoad << id;
 		}
 
-		QList<Message_ptr> result;
-		auto future = QtConcurrent::mapped (ids,
-				std::function<Message_ptr (QByteArray)>
+		const auto& store = StoreForFolder (acc, folder);
+
+		// The message list only needs the headers, the bodies are loaded
+		// via LoadMessage() once a message is actually opened.
+		return Util::Sequence (this,
+				QtConcurrent::run ([store, toLoad, folder]
+					{
+						try
+						{
+							return store->Load (toLoad, MessageStore::LoadMode::HeadersOnly);
+						}
+						catch (const std::exception& e)
+						{
+							qWarning () << Q_FUNC_INFO
+									<< "unable to load messages from"
+									<< folder
+									<< e.what ();
+							return QList<Message_ptr> {};
+						}
+					})) >>
+				[pendingMsgs] (const QList<Message_ptr>& loaded)
 				{
-					[this, acc, rootDir] (const QByteArray& id)
-						{ return LoadMessage (acc, rootDir, id); }
-				});
-
-		for (const auto& item : future.results ())
-			result << item;
-
-		for (const auto& msg : result)
-			UpdateCaches (msg);
-
-		return result;
+					return Util::MakeReadyFuture (pendingMsgs + loaded);
+				};
 	}
 
 	QList<QByteArray> Storage::LoadIDs (Account *acc, const QStringList& folder)
@@ -300,29 +195,12 @@ namespace Snails
 		PendingSaveMessages_ [acc].remove (id);
 
 		BaseForAccount (acc)->RemoveMessage (id, folder,
-				[this, acc, folder, id] { RemoveMessageFile (acc, folder, id); });
+				[this, acc, folder, id] { StoreForFolder (acc, folder)->Remove (id); });
 	}
 
-	int Storage::GetNumMessages (Account *acc) const
+	int Storage::GetNumMessages (Account *acc)
 	{
-		int result = 0;
-
-		const QDir& dir = DirForAccount (acc);
-		for (const auto& str : dir.entryList (QDir::NoDotAndDotDot | QDir::Dirs))
-		{
-			QDir subdir = dir;
-			if (!subdir.cd (str))
-			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< str;
-				continue;
-			}
-
-			result += subdir.entryList (QDir::NoDotAndDotDot | QDir::Files).size ();
-		}
-
-		return result;
+		return BaseForAccount (acc)->GetMessageCount ();
 	}
 
 	int Storage::GetNumMessages (Account *acc, const QStringList& folder)
@@ -335,54 +213,86 @@ namespace Snails
 		return BaseForAccount (acc)->GetUnreadMessageCount (folder);
 	}
 
-	bool Storage::HasMessagesIn (Account *acc) const
+	bool Storage::HasMessagesIn (Account *acc)
 	{
 		return GetNumMessages (acc);
 	}
 
-	bool Storage::IsMessageRead (Account *acc, const QStringList& folder, const QByteArray& id)
+	QFuture<QList<Message_ptr>> Storage::UpdateReadStatus (Account *acc,
+			const QStringList& folder, const QHash<QByteArray, bool>& id2read)
 	{
-		if (IsMessageRead_.contains (id))
-			return IsMessageRead_ [id];
+		QList<Message_ptr> pendingMsgs;
 
-		return LoadMessage (acc, folder, id)->IsRead ();
-	}
-
-	void Storage::RemoveMessageFile (Account *acc, const QStringList& folder, const QByteArray& id)
-	{
-		auto dir = DirForAccount (acc);
-		for (const auto& elem : folder)
+		const auto& pending = PendingSaveMessages_.value (acc);
+		QHash<QByteArray, bool> toCheck;
+		for (const auto& pair : Util::Stlize (id2read))
 		{
-			const auto& subdir = elem.toUtf8 ().toHex ();
-			if (!dir.cd (subdir))
+			const auto& msg = pending.value (pair.first);
+			if (!msg)
+				toCheck [pair.first] = pair.second;
+			else if (msg->IsRead () != pair.second)
 			{
-				qWarning () << Q_FUNC_INFO
-						<< "unable to cd to"
-						<< dir.filePath (subdir);
-				throw std::runtime_error ("Unable to cd to the directory");
+				msg->SetRead (pair.second);
+				pendingMsgs << msg;
 			}
 		}
 
-		if (!dir.cd (id.toHex ().right (3)))
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to cd to"
-					<< dir.filePath (id.toHex ().right (3));
-			throw std::runtime_error ("Unable to cd to the directory");
-		}
+		if (toCheck.isEmpty ())
+			return Util::MakeReadyFuture (pendingMsgs);
 
-		QFile file (dir.filePath (id.toHex ()));
-		if (!file.exists ())
-			return;
+		const auto& store = StoreForFolder (acc, folder);
 
-		qDebug () << "removing" << file.fileName () << file.size ();
-		if (!file.remove ())
-		{
-			qWarning () << Q_FUNC_INFO
-					<< "unable to remove the file:"
-					<< file.errorString ();
-			throw std::runtime_error ("Unable to remove the file");
-		}
+		// The flags are served from the store index, and only the headers
+		// of the changed messages are loaded: saving them keeps the bodies.
+		return QtConcurrent::run ([store, toCheck, folder, pendingMsgs]
+				{
+					auto result = pendingMsgs;
+					for (const auto& pair : Util::Stlize (toCheck))
+					{
+						try
+						{
+							const auto isRead = store->IsRead (pair.first);
+							if (!isRead)
+							{
+								qWarning () << Q_FUNC_INFO
+										<< "unknown message"
+										<< pair.first.toHex ()
+										<< "in"
+										<< folder;
+								continue;
+							}
+							if (*isRead == pair.second)
+								continue;
+
+							const auto& msg = store->Load (pair.first, MessageStore::LoadMode::HeadersOnly);
+							if (!msg)
+								continue;
+
+							msg->SetRead (pair.second);
+							result << msg;
+						}
+						catch (const std::exception& e)
+						{
+							qWarning () << Q_FUNC_INFO
+									<< "unable to update the message"
+									<< pair.first.toHex ()
+									<< "in"
+									<< folder
+									<< e.what ();
+						}
+					}
+					return result;
+				});
+	}
+
+	boost::optional<FolderSyncState> Storage::GetFolderSyncState (Account *acc, const QStringList& folder)
+	{
+		return BaseForAccount (acc)->GetSyncState (folder);
+	}
+
+	void Storage::SetFolderSyncState (Account *acc, const QStringList& folder, const FolderSyncState& state)
+	{
+		BaseForAccount (acc)->SetSyncState (folder, state);
 	}
 
 	QDir Storage::DirForAccount (Account *acc) const
@@ -403,6 +313,33 @@ namespace Snails
 		return dir;
 	}
 
+	MessageStore_ptr Storage::StoreForFolder (Account *acc, const QStringList& folder)
+	{
+		QMutexLocker locker { &StoresMutex_ };
+
+		auto& stores = Stores_ [acc];
+		if (const auto& store = stores.value (folder))
+			return store;
+
+		auto dir = DirForAccount (acc);
+		for (const auto& elem : folder)
+		{
+			const auto& subdir = elem.toUtf8 ().toHex ();
+			if (!dir.cd (subdir) &&
+					!(dir.mkpath (subdir) && dir.cd (subdir)))
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "unable to cd to"
+						<< dir.filePath (subdir);
+				throw std::runtime_error ("Unable to cd to the directory");
+			}
+		}
+
+		const auto& store = std::make_shared<MessageStore> (dir);
+		stores [folder] = store;
+		return store;
+	}
+
 	AccountDatabase_ptr Storage::BaseForAccount (Account *acc)
 	{
 		if (AccountBases_.contains (acc))
@@ -419,10 +356,5 @@ namespace Snails
 		const auto& base = BaseForAccount (acc);
 		base->AddMessage (msg);
 	}
-
-	void Storage::UpdateCaches (Message_ptr msg)
-	{
-		IsMessageRead_ [msg->GetFolderID ()] = msg->IsRead ();
-	}
 }
 }
@@ -34,7 +34,10 @@
 #include <QSettings>
 #include <QHash>
 #include <QSet>
+#include <QMutex>
+#include <QFuture>
 #include "message.h"
+#include "foldersyncstate.h"
 
 namespace LeechCraft
 {
@@ -45,43 +48,70 @@ namespace Snails
 	class AccountDatabase;
 	typedef std::shared_ptr<AccountDatabase> AccountDatabase_ptr;
 
+	class MessageStore;
+	typedef std::shared_ptr<MessageStore> MessageStore_ptr;
+
 	class Storage : public QObject
 	{
 		Q_OBJECT
 
 		QDir SDir_;
 		QSettings Settings_;
-		QHash<QByteArray, bool> IsMessageRead_;
 
 		QHash<Account*, AccountDatabase_ptr> AccountBases_;
+
+		QMutex StoresMutex_;
+		QHash<Account*, QHash<QStringList, MessageStore_ptr>> Stores_;
+
 		QHash<Account*, QHash<QByteArray, Message_ptr>> PendingSaveMessages_;
 	public:
 		Storage (QObject* = nullptr);
 
-		void SaveMessages (Account*, const QStringList& folders, const QList<Message_ptr>&);
+		/** Saves the given messages.
+		 *
+		 * The messages are written in a separate thread, and the future
+		 * tells whether they have been written successfully.
+		 */
+		QFuture<bool> SaveMessages (Account*, const QStringList& folders, const QList<Message_ptr>&);
 
-		MessageSet LoadMessages (Account*);
-		Message_ptr LoadMessage (Account*, const QStringList& folder, const QByteArray& id);
-		QList<Message_ptr> LoadMessages (Account*, const QStringList& folder, const QList<QByteArray>& ids);
+		/** Loads the given message along with its bodies.
+		 *
+		 * The message is loaded in a separate thread. The future holds
+		 * a null pointer if the message can't be loaded.
+		 */
+		QFuture<Message_ptr> LoadMessage (Account*, const QStringList& folder, const QByteArray& id);
+		/** Loads the headers of the given messages.
+		 *
+		 * Opening the folder's store for the first time may take a while,
+		 * so the messages are loaded in a separate thread.
+		 */
+		QFuture<QList<Message_ptr>> LoadMessages (Account*, const QStringList& folder, const QList<QByteArray>& ids);
 
 		QList<QByteArray> LoadIDs (Account*, const QStringList& folder);
 		void RemoveMessage (Account*, const QStringList&, const QByteArray&);
 
-		int GetNumMessages (Account*) const;
+		int GetNumMessages (Account*);
 		int GetNumMessages (Account*, const QStringList& folder);
 		int GetNumUnread (Account*, const QStringList& folder);
-		bool HasMessagesIn (Account*) const;
+		bool HasMessagesIn (Account*);
 
-		bool IsMessageRead (Account*, const QStringList& folder, const QByteArray&);
-	private:
-		Message_ptr LoadMessage (Account*, QDir, const QByteArray&) const;
-		void RemoveMessageFile (Account*, const QStringList&, const QByteArray&);
+		/** Sets the read flags of the given messages to the given values.
+		 *
+		 * The flags are checked in a separate thread, and the future
+		 * holds the messages whose flags differ, loaded without bodies
+		 * and updated, so that they could be saved back.
+		 */
+		QFuture<QList<Message_ptr>> UpdateReadStatus (Account*, const QStringList& folder,
+				const QHash<QByteArray, bool>& id2read);
+
+		boost::optional<FolderSyncState> GetFolderSyncState (Account*, const QStringList& folder);
+		void SetFolderSyncState (Account*, const QStringList& folder, const FolderSyncState&);
 	private:
 		QDir DirForAccount (Account*) const;
+		MessageStore_ptr StoreForFolder (Account*, const QStringList&);
 		AccountDatabase_ptr BaseForAccount (Account*);
 
 		void AddMessage (Message_ptr, Account*);
-		void UpdateCaches (Message_ptr);
 	};
 }
 }
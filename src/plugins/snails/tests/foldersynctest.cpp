@@ -0,0 +1,220 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "foldersynctest.h"
+#include <QtTest>
+#include <vmime/net/session.hpp>
+#include <vmime/net/store.hpp>
+#include "foldersyncer.h"
+
+QTEST_MAIN (LeechCraft::Snails::FolderSyncTest)
+
+namespace LeechCraft
+{
+namespace Snails
+{
+	namespace
+	{
+		FolderSyncState MakeState (quint32 validity, quint32 next, quint64 modseq, quint32 count)
+		{
+			FolderSyncState state;
+			state.UIDValidity_ = validity;
+			state.UIDNext_ = next;
+			state.HighestModSeq_ = modseq;
+			state.MessageCount_ = count;
+			return state;
+		}
+	}
+
+	void FolderSyncTest::testFirstSync ()
+	{
+		const auto& plan = PlanFolderSync ({}, MakeState (1, 101, 500, 100), 0);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Full);
+		QCOMPARE (plan.NewFromUID_, 1u);
+		QVERIFY (plan.FetchFlags_);
+	}
+
+	void FolderSyncTest::testUnchanged ()
+	{
+		const auto& state = MakeState (1, 100001, 123456, 100000);
+		const auto& plan = PlanFolderSync (state, state, 100000);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::UpToDate);
+		QCOMPARE (plan.NewFromUID_, 0u);
+		QVERIFY (!plan.FetchFlags_);
+	}
+
+	void FolderSyncTest::testNoCondstore ()
+	{
+		// Nothing tells whether the flags have changed, but refetching
+		// them on each sync costs too much.
+		const auto& state = MakeState (1, 101, 0, 100);
+		const auto& plan = PlanFolderSync (state, state, 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::UpToDate);
+		QVERIFY (!plan.FetchFlags_);
+		QVERIFY (plan.FlagsDeferred_);
+	}
+
+	void FolderSyncTest::testNoCondstoreDeferralsExhausted ()
+	{
+		auto stored = MakeState (1, 101, 0, 100);
+		stored.FlagsDeferrals_ = MaxFlagsDeferrals;
+		const auto& plan = PlanFolderSync (stored, MakeState (1, 101, 0, 100), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QVERIFY (plan.FetchFlags_);
+		QVERIFY (!plan.FlagsDeferred_);
+		QCOMPARE (plan.ChangedSince_, 0ull);
+	}
+
+	void FolderSyncTest::testNewMessages ()
+	{
+		const auto& plan = PlanFolderSync (MakeState (1, 101, 500, 100), MakeState (1, 104, 503, 103), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 101u);
+		QVERIFY (!plan.FetchFlags_);
+		QVERIFY (plan.FlagsDeferred_);
+	}
+
+	void FolderSyncTest::testDeferredFlagChanges ()
+	{
+		// The previous sync has fetched the new messages and kept the
+		// older modseq, so the next quiet sync catches up on the flags.
+		const auto& plan = PlanFolderSync (MakeState (1, 104, 500, 103), MakeState (1, 104, 503, 103), 103);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 0u);
+		QVERIFY (plan.FetchFlags_);
+		QVERIFY (!plan.FlagsDeferred_);
+		QCOMPARE (plan.ChangedSince_, 500ull);
+	}
+
+	void FolderSyncTest::testNewMessagesDeferralsExhausted ()
+	{
+		// The folder has got new messages on each of the previous syncs,
+		// so the flags can't wait any longer.
+		auto stored = MakeState (1, 101, 500, 100);
+		stored.FlagsDeferrals_ = MaxFlagsDeferrals;
+		const auto& plan = PlanFolderSync (stored, MakeState (1, 104, 503, 103), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 101u);
+		QVERIFY (plan.FetchFlags_);
+		QVERIFY (!plan.FlagsDeferred_);
+		QCOMPARE (plan.ChangedSince_, 500ull);
+	}
+
+	void FolderSyncTest::testNewMessagesExpunged ()
+	{
+		// Messages have both arrived and been expunged, so the flags
+		// are needed right away to learn which ones are gone.
+		const auto& plan = PlanFolderSync (MakeState (1, 101, 500, 100), MakeState (1, 104, 505, 101), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 101u);
+		QVERIFY (plan.FetchFlags_);
+		QVERIFY (!plan.FlagsDeferred_);
+		QCOMPARE (plan.ChangedSince_, 500ull);
+	}
+
+	void FolderSyncTest::testFlagChanges ()
+	{
+		const auto& plan = PlanFolderSync (MakeState (1, 101, 500, 100), MakeState (1, 101, 502, 100), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 0u);
+		QVERIFY (plan.FetchFlags_);
+		QCOMPARE (plan.ChangedSince_, 500ull);
+	}
+
+	void FolderSyncTest::testExpunged ()
+	{
+		// A message has been appended and another one has been expunged,
+		// so the count alone doesn't change.
+		const auto& plan = PlanFolderSync (MakeState (1, 101, 0, 100), MakeState (1, 102, 0, 100), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (plan.NewFromUID_, 101u);
+		QVERIFY (plan.FetchFlags_);
+	}
+
+	void FolderSyncTest::testUIDValidityChanged ()
+	{
+		const auto& plan = PlanFolderSync (MakeState (1, 101, 500, 100), MakeState (2, 101, 500, 100), 100);
+		QVERIFY (plan.Kind_ == FolderSyncPlan::Kind::Full);
+	}
+
+	void FolderSyncTest::testLiveSync ()
+	{
+		const auto& url = qgetenv ("LC_SNAILS_TEST_IMAP_URL");
+		if (url.isEmpty ())
+			QSKIP ("LC_SNAILS_TEST_IMAP_URL is not set");
+
+		const auto& session = vmime::net::session::create ();
+		const auto& store = session->getStore (vmime::utility::url (url.constData ()));
+		store->connect ();
+
+		const auto& folder = store->getDefaultFolder ();
+		folder->open (vmime::net::folder::MODE_READ_WRITE);
+
+		const auto& first = FolderSyncer { folder }.Sync ({}, {});
+		QVERIFY (first.Plan_.Kind_ == FolderSyncPlan::Kind::Full);
+		QVERIFY (first.State_.UIDValidity_);
+		QVERIFY2 (first.State_.HighestModSeq_, "the server doesn't seem to support CONDSTORE");
+		QCOMPARE (static_cast<quint32> (first.NewMessages_.size ()), first.State_.MessageCount_);
+		QVERIFY2 (!first.NewMessages_.empty (), "the INBOX should contain at least one message");
+
+		QList<QByteArray> known;
+		for (const auto& msg : first.NewMessages_)
+			known << static_cast<vmime::string> (msg->getUID ()).c_str ();
+
+		const auto& second = FolderSyncer { folder }.Sync (first.State_, known);
+		QVERIFY (second.Plan_.Kind_ == FolderSyncPlan::Kind::UpToDate);
+		QVERIFY (second.NewMessages_.empty ());
+		QVERIFY (second.KnownSeen_.isEmpty ());
+		QVERIFY (second.Removed_.isEmpty ());
+
+		const auto& msg = first.NewMessages_.front ();
+		const bool wasSeen = msg->getFlags () & vmime::net::message::FLAG_SEEN;
+		const auto& toggle = [&] (bool seen)
+		{
+			folder->setMessageFlags (vmime::net::messageSet::byUID (msg->getUID ()),
+					vmime::net::message::FLAG_SEEN,
+					seen ?
+							vmime::net::message::FLAG_MODE_ADD :
+							vmime::net::message::FLAG_MODE_REMOVE);
+		};
+
+		toggle (!wasSeen);
+		const auto& third = FolderSyncer { folder }.Sync (first.State_, known);
+		toggle (wasSeen);
+
+		QVERIFY (third.Plan_.Kind_ == FolderSyncPlan::Kind::Incremental);
+		QCOMPARE (third.Plan_.NewFromUID_, 0u);
+		QVERIFY (third.NewMessages_.empty ());
+		QVERIFY (third.Removed_.isEmpty ());
+		QCOMPARE (third.KnownSeen_.value (known.front (), wasSeen), !wasSeen);
+
+		store->disconnect ();
+	}
+}
+}
@@ -32,6 +32,8 @@
 #include <stdexcept>
 #include <type_traits>
 #include <memory>
+#include <array>
+#include <iterator>
 #include <boost/fusion/include/for_each.hpp>
 #include <boost/fusion/include/fold.hpp>
 #include <boost/fusion/include/filter_if.hpp>
@@ -375,6 +377,22 @@ namespace oral
 			}
 		};
 
+		struct BatchCollector
+		{
+			const bool BindPrimaryKey_;
+			QList<QVariantList>& Columns_;
+
+			template<typename T>
+			int operator() (int index, const T& t) const
+			{
+				if (!BindPrimaryKey_ && IsPKey<T>::value)
+					return index;
+
+				Columns_ [index] << ToVariant<T> {} (t);
+				return index + 1;
+			}
+		};
+
 		struct Selector
 		{
 			QSqlQuery_ptr Q_;
@@ -396,17 +414,23 @@ namespace oral
 			QList<QString> BoundFields_;
 		};
 
+		template<typename T>
+		void RunInserter (const CachedFieldsData& data, const QSqlQuery_ptr& insertQuery, bool bindPrimaryKey, const T& t)
+		{
+			boost::fusion::fold<T, QStringList, Inserter> (t, data.BoundFields_, Inserter { bindPrimaryKey, insertQuery });
+			if (!insertQuery->exec ())
+			{
+				DBLock::DumpError (*insertQuery);
+				throw QueryException ("insert query execution failed", insertQuery);
+			}
+		}
+
 		template<typename T>
 		std::function<void (T)> MakeInserter (CachedFieldsData data, QSqlQuery_ptr insertQuery, bool bindPrimaryKey)
 		{
 			return [data, insertQuery, bindPrimaryKey] (const T& t)
 			{
-				boost::fusion::fold<T, QStringList, Inserter> (t, data.BoundFields_, Inserter { bindPrimaryKey, insertQuery });
-				if (!insertQuery->exec ())
-				{
-					DBLock::DumpError (*insertQuery);
-					throw QueryException ("insert query execution failed", insertQuery);
-				}
+				RunInserter (data, insertQuery, bindPrimaryKey, t);
 			};
 		}
 
@@ -492,6 +516,11 @@ namespace oral
 			const CachedFieldsData Data_;
 			const QString InsertSuffix_;
 
+			/* Prepared lazily, one per InsertAction, and shared between
+			 * the copies of this object.
+			 */
+			const std::shared_ptr<std::array<QSqlQuery_ptr, 3>> Queries_;
+
 			struct PrivateTag {};
 
 			AdaptInsert (const CachedFieldsData& data, const PrivateTag&)
@@ -499,7 +528,25 @@ namespace oral
 			, InsertSuffix_ (" INTO " + data.Table_ +
 					" (" + QStringList { data.Fields_ }.join (", ") + ") VALUES (" +
 					QStringList { data.BoundFields_ }.join (", ") + ");")
+			, Queries_ (std::make_shared<std::array<QSqlQuery_ptr, 3>> ())
+			{
+			}
+
+			QSqlQuery_ptr GetQuery (InsertAction action) const
 			{
+				auto& query = (*Queries_) [static_cast<int> (action)];
+				if (query)
+					return query;
+
+				const auto newQuery = std::make_shared<QSqlQuery> (Data_.DB_);
+				if (!newQuery->prepare (GetInsertPrefix (action) + InsertSuffix_))
+				{
+					DBLock::DumpError (*newQuery);
+					throw QueryException ("insert query preparation failed", newQuery);
+				}
+
+				query = newQuery;
+				return query;
 			}
 		public:
 			template<bool Autogen = HasAutogenPKey<Seq> ()>
@@ -529,9 +576,8 @@ namespace oral
 			template<bool Autogen = HasAutogenPKey<Seq> ()>
 			EnableIf_t<Autogen> operator() (Seq& t, InsertAction action = InsertAction::Default) const
 			{
-				auto query = std::make_shared<QSqlQuery> (Data_.DB_);
-				query->prepare (GetInsertPrefix (action) + InsertSuffix_);
-				MakeInserter<Seq> (Data_, query, false) (t);
+				const auto& query = GetQuery (action);
+				RunInserter (Data_, query, false, t);
 
 				constexpr auto index = FindPKey<Seq>::result_type::value;
 				boost::fusion::at_c<index> (t) = FromVariant<ValueAtC_t<Seq, index>> {} (query->lastInsertId ());
@@ -541,9 +587,8 @@ namespace oral
 			EnableIf_t<Autogen, ValueAtC_t<SeqPrime, FindPKey<SeqPrime>::result_type::value>>
 				operator() (const Seq& t, InsertAction action = InsertAction::Default) const
 			{
-				auto query = std::make_shared<QSqlQuery> (Data_.DB_);
-				query->prepare (GetInsertPrefix (action) + InsertSuffix_);
-				MakeInserter<Seq> (Data_, query, false) (t);
+				const auto& query = GetQuery (action);
+				RunInserter (Data_, query, false, t);
 
 				constexpr auto index = FindPKey<Seq>::result_type::value;
 				return FromVariant<ValueAtC_t<Seq, index>> {} (query->lastInsertId ());
@@ -552,9 +597,59 @@ namespace oral
 			template<bool Autogen = HasAutogenPKey<Seq> ()>
 			EnableIf_t<!Autogen> operator() (const Seq& t, InsertAction action = InsertAction::Default) const
 			{
-				auto query = std::make_shared<QSqlQuery> (Data_.DB_);
-				query->prepare (GetInsertPrefix (action) + InsertSuffix_);
-				MakeInserter<Seq> (Data_, query, true) (t);
+				RunInserter (Data_, GetQuery (action), true, t);
+			}
+
+			/** @brief Inserts all the records from the given range in a
+			 * single transaction.
+			 *
+			 * The values are bound column-wise and executed via
+			 * QSqlQuery::execBatch(), which falls back to executing the
+			 * prepared query once per record on drivers without native
+			 * batch operations.
+			 *
+			 * Unlike the single-record insert, this doesn't update the
+			 * autogenerated primary keys of the records.
+			 *
+			 * @param[in] items The range of records to insert.
+			 * @param[in] action The action to take on conflicts.
+			 *
+			 * @throw QueryException
+			 * @throw std::runtime_error if the transaction cannot be
+			 * started.
+			 */
+			template<typename Range>
+			void InsertBatch (const Range& items, InsertAction action = InsertAction::Default) const
+			{
+				using std::begin;
+				using std::end;
+				if (begin (items) == end (items))
+					return;
+
+				constexpr bool bindPrimaryKey = !HasAutogenPKey<Seq> ();
+
+				auto db = Data_.DB_;
+				DBLock lock { db };
+				lock.Init ();
+
+				QList<QVariantList> columns;
+				for (int i = 0; i < Data_.BoundFields_.size (); ++i)
+					columns << QVariantList {};
+
+				for (const auto& item : items)
+					boost::fusion::fold<Seq, int, BatchCollector> (item, 0, BatchCollector { bindPrimaryKey, columns });
+
+				const auto& query = GetQuery (action);
+				for (int i = 0; i < columns.size (); ++i)
+					query->bindValue (Data_.BoundFields_.at (i), columns.at (i));
+
+				if (!query->execBatch ())
+				{
+					DBLock::DumpError (*query);
+					throw QueryException ("batch insert query execution failed", query);
+				}
+
+				lock.Good ();
 			}
 		};
 
@@ -0,0 +1,223 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "oralinsertbenchmark.h"
+#include <QtTest>
+#include <QElapsedTimer>
+#include <oral.h>
+
+QTEST_MAIN (LeechCraft::Util::OralInsertBenchmark)
+
+namespace LeechCraft
+{
+namespace Util
+{
+	struct AutogenRecord
+	{
+		oral::PKey<int> ID_;
+		QString Name_;
+		int Value_;
+
+		static QString ClassName ()
+		{
+			return "AutogenRecord";
+		}
+	};
+
+	struct KeyedRecord
+	{
+		oral::PKey<QString, oral::NoAutogen> Key_;
+		int Value_;
+
+		static QString ClassName ()
+		{
+			return "KeyedRecord";
+		}
+	};
+}
+}
+
+BOOST_FUSION_ADAPT_STRUCT (LeechCraft::Util::AutogenRecord,
+		(decltype (LeechCraft::Util::AutogenRecord::ID_), ID_)
+		(decltype (LeechCraft::Util::AutogenRecord::Name_), Name_)
+		(decltype (LeechCraft::Util::AutogenRecord::Value_), Value_))
+
+BOOST_FUSION_ADAPT_STRUCT (LeechCraft::Util::KeyedRecord,
+		(decltype (LeechCraft::Util::KeyedRecord::Key_), Key_)
+		(decltype (LeechCraft::Util::KeyedRecord::Value_), Value_))
+
+namespace LeechCraft
+{
+namespace Util
+{
+	namespace
+	{
+		QList<AutogenRecord> MakeRecords (int count)
+		{
+			QList<AutogenRecord> result;
+			result.reserve (count);
+			for (int i = 0; i < count; ++i)
+				result.append ({ {}, QString { "record %1" }.arg (i), i });
+			return result;
+		}
+
+		void PopulateCounts ()
+		{
+			QTest::addColumn<int> ("count");
+
+			for (int count : { 100, 1000, 10000 })
+				QTest::newRow (QString::number (count).toLatin1 ()) << count;
+		}
+
+		void ReportRate (int count, qint64 nsecs)
+		{
+			qDebug () << count
+					<< "rows:"
+					<< static_cast<qint64> (count * 1e9 / std::max<qint64> (nsecs, 1))
+					<< "rows/sec";
+		}
+	}
+
+	void OralInsertBenchmark::initTestCase ()
+	{
+		DB_ = QSqlDatabase::addDatabase ("QSQLITE", "org.LeechCraft.Util.OralInsertBenchmark");
+		DB_.setDatabaseName (":memory:");
+		QVERIFY (DB_.open ());
+	}
+
+	void OralInsertBenchmark::cleanupTestCase ()
+	{
+		DB_.close ();
+	}
+
+	void OralInsertBenchmark::init ()
+	{
+		RunTextQuery (DB_, "DROP TABLE IF EXISTS AutogenRecord;");
+		RunTextQuery (DB_, "DROP TABLE IF EXISTS KeyedRecord;");
+	}
+
+	void OralInsertBenchmark::testSingleInsert ()
+	{
+		const auto& adapted = oral::Adapt<AutogenRecord> (DB_);
+
+		auto records = MakeRecords (10);
+		for (auto& record : records)
+			adapted.DoInsert_ (record);
+
+		QCOMPARE (records.last ().ID_.Val_, 10);
+
+		const auto& selected = adapted.DoSelectAll_ ();
+		QCOMPARE (selected.size (), records.size ());
+		for (int i = 0; i < selected.size (); ++i)
+		{
+			QCOMPARE (selected.at (i).Name_, records.at (i).Name_);
+			QCOMPARE (selected.at (i).Value_, records.at (i).Value_);
+		}
+	}
+
+	void OralInsertBenchmark::testBatchInsert ()
+	{
+		const auto& adapted = oral::Adapt<AutogenRecord> (DB_);
+
+		const auto& records = MakeRecords (100);
+		adapted.DoInsert_.InsertBatch (records);
+
+		const auto& selected = adapted.DoSelectAll_ ();
+		QCOMPARE (selected.size (), records.size ());
+		for (int i = 0; i < selected.size (); ++i)
+		{
+			QCOMPARE (selected.at (i).Name_, records.at (i).Name_);
+			QCOMPARE (selected.at (i).Value_, records.at (i).Value_);
+		}
+	}
+
+	void OralInsertBenchmark::testBatchReplace ()
+	{
+		const auto& adapted = oral::Adapt<KeyedRecord> (DB_);
+
+		adapted.DoInsert_.InsertBatch (QList<KeyedRecord> { { "a", 1 }, { "b", 2 } });
+		adapted.DoInsert_.InsertBatch (QList<KeyedRecord> { { "b", 3 }, { "c", 4 } },
+				oral::InsertAction::Replace);
+
+		auto selected = adapted.DoSelectAll_ ();
+		std::sort (selected.begin (), selected.end (),
+				[] (const KeyedRecord& r1, const KeyedRecord& r2) { return r1.Key_.Val_ < r2.Key_.Val_; });
+		QCOMPARE (selected.size (), 3);
+		QCOMPARE (selected.at (1).Key_.Val_, QString { "b" });
+		QCOMPARE (selected.at (1).Value_, 3);
+
+		QVERIFY_EXCEPTION_THROWN (adapted.DoInsert_.InsertBatch (QList<KeyedRecord> { { "d", 5 }, { "a", 6 } }),
+				oral::QueryException);
+		QCOMPARE (adapted.DoSelectAll_ ().size (), 3);
+	}
+
+	void OralInsertBenchmark::benchmarkSingle_data ()
+	{
+		PopulateCounts ();
+	}
+
+	void OralInsertBenchmark::benchmarkSingle ()
+	{
+		QFETCH (int, count);
+
+		const auto& adapted = oral::Adapt<AutogenRecord> (DB_);
+		auto records = MakeRecords (count);
+
+		QElapsedTimer timer;
+		timer.start ();
+		QBENCHMARK_ONCE
+		{
+			for (auto& record : records)
+				adapted.DoInsert_ (record);
+		}
+		ReportRate (count, timer.nsecsElapsed ());
+	}
+
+	void OralInsertBenchmark::benchmarkBatch_data ()
+	{
+		PopulateCounts ();
+	}
+
+	void OralInsertBenchmark::benchmarkBatch ()
+	{
+		QFETCH (int, count);
+
+		const auto& adapted = oral::Adapt<AutogenRecord> (DB_);
+		const auto& records = MakeRecords (count);
+
+		QElapsedTimer timer;
+		timer.start ();
+		QBENCHMARK_ONCE
+		{
+			adapted.DoInsert_.InsertBatch (records);
+		}
+		ReportRate (count, timer.nsecsElapsed ());
+	}
+}
+}
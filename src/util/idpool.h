@@ -30,6 +30,7 @@
 #pragma once
 
 #include "utilconfig.h"
+#include <atomic>
 #include <QByteArray>
 #include <QSet>
 #include <QDataStream>
@@ -43,12 +44,15 @@ namespace Util
 	 *
 	 * This class holds a pool of identificators of the given type \em T.
 	 * It is very simple and produces consecutive IDs, this \em T should
-	 * support <code>operator++()</code>.
+	 * be an integral type.
+	 *
+	 * GetID() is thread-safe, so the same pool may be used to generate
+	 * IDs from several threads at once.
 	 */
 	template<typename T>
 	class IDPool
 	{
-		T CurrentID_;
+		std::atomic<T> CurrentID_;
 	public:
 		/** @brief Creates a pool with the given initial value.
 		 *
@@ -59,6 +63,26 @@ namespace Util
 		{
 		}
 
+		/** @brief Copies the current state of the \em other pool.
+		 *
+		 * @param[in] other The pool to copy the state of.
+		 */
+		IDPool (const IDPool& other)
+		: CurrentID_ (other.CurrentID_.load ())
+		{
+		}
+
+		/** @brief Copies the current state of the \em other pool.
+		 *
+		 * @param[in] other The pool to copy the state of.
+		 * @return This pool.
+		 */
+		IDPool& operator= (const IDPool& other)
+		{
+			CurrentID_ = other.CurrentID_.load ();
+			return *this;
+		}
+
 		/** @brief Destroys the pool.
 		 */
 		virtual ~IDPool ()
@@ -103,7 +127,7 @@ namespace Util
 				QDataStream ostr (&result, QIODevice::WriteOnly);
 				quint8 ver = 1;
 				ostr << ver;
-				ostr << CurrentID_;
+				ostr << CurrentID_.load ();
 			}
 			return result;
 		}
@@ -122,7 +146,11 @@ namespace Util
 			quint8 ver;
 			istr >> ver;
 			if (ver == 1)
-				istr >> CurrentID_;
+			{
+				T id;
+				istr >> id;
+				CurrentID_ = id;
+			}
 			else
 				qWarning () << Q_FUNC_INFO
 						<< "unknown version"
@@ -28,14 +28,13 @@
  **********************************************************************/
 
 #include "customcookiejar.h"
-#include <set>
 #include <algorithm>
 #include <QNetworkCookie>
+#include <QStringList>
+#include <QUrl>
 #include <QtDebug>
 #include <QDateTime>
-#include <QtConcurrentRun>
 #include <util/sll/util.h>
-#include <util/threads/futures.h>
 
 namespace LeechCraft
 {
@@ -88,44 +87,144 @@ namespace Util
 
 	void CustomCookieJar::Load (const QByteArray& data)
 	{
-		QList<QNetworkCookie> cookies, filteredCookies;
+		QList<QNetworkCookie> cookies;
 		for (const auto& ba : data.split ('\n'))
 			cookies << QNetworkCookie::parseCookies (ba);
 
+		LoadCookies (cookies);
+		DirtyDomains_.unite (QSet<QString>::fromList (GetDomains ()));
+	}
+
+	void CustomCookieJar::LoadCookies (const QList<QNetworkCookie>& cookies)
+	{
+		Domain2Cookies_.clear ();
+
+		QList<QNetworkCookie> filteredCookies;
+
 		const auto& now = QDateTime::currentDateTime ();
 		for (const auto& cookie : cookies)
 		{
-			if (FilterTrackingCookies_ &&
-					cookie.name ().startsWith ("__utm"))
-				continue;
-
-			if (cookie.expirationDate () < now)
+			if ((FilterTrackingCookies_ && cookie.name ().startsWith ("__utm")) ||
+					cookie.expirationDate () < now)
+			{
+				DirtyDomains_ << cookie.domain ();
 				continue;
+			}
 
 			filteredCookies << cookie;
+			AddCookie (cookie);
 		}
+
 		emit cookiesAdded (filteredCookies);
-		setAllCookies (filteredCookies);
 	}
 
 	void CustomCookieJar::CollectGarbage ()
 	{
-		const auto& cookies = allCookies ();
-		QList<QNetworkCookie> result;
+		int before = 0;
+		int after = 0;
+
 		const auto& now = QDateTime::currentDateTime ();
+		for (auto i = Domain2Cookies_.begin (); i != Domain2Cookies_.end (); )
+		{
+			auto& cookies = *i;
+			before += cookies.size ();
+
+			const auto expired = std::remove_if (cookies.begin (), cookies.end (),
+					[&now] (const QNetworkCookie& cookie)
+					{
+						return !cookie.isSessionCookie () &&
+								cookie.expirationDate () < now;
+					});
+			if (expired != cookies.end ())
+			{
+				cookies.erase (expired, cookies.end ());
+				DirtyDomains_ << i.key ();
+			}
+
+			after += cookies.size ();
+
+			if (cookies.isEmpty ())
+				i = Domain2Cookies_.erase (i);
+			else
+				++i;
+		}
+
+		qDebug () << Q_FUNC_INFO << before << after;
+	}
+
+	QSet<QString> CustomCookieJar::TakeDirtyDomains ()
+	{
+		QSet<QString> result;
+		std::swap (result, DirtyDomains_);
+		return result;
+	}
+
+	void CustomCookieJar::MarkDomainsDirty (const QSet<QString>& domains)
+	{
+		DirtyDomains_.unite (domains);
+	}
+
+	QStringList CustomCookieJar::GetDomains () const
+	{
+		return Domain2Cookies_.keys ();
+	}
+
+	QList<QNetworkCookie> CustomCookieJar::GetDomainCookies (const QString& domain) const
+	{
+		return Domain2Cookies_.value (domain);
+	}
+
+	QList<QNetworkCookie> CustomCookieJar::allCookies () const
+	{
+		QList<QNetworkCookie> result;
+		for (const auto& cookies : Domain2Cookies_)
+			result += cookies;
+		return result;
+	}
+
+	void CustomCookieJar::setAllCookies (const QList<QNetworkCookie>& cookies)
+	{
+		DirtyDomains_.unite (QSet<QString>::fromList (GetDomains ()));
+		Domain2Cookies_.clear ();
+
 		for (const auto& cookie : cookies)
 		{
-			if (!cookie.isSessionCookie () &&
-					cookie.expirationDate () < now)
-				continue;
+			AddCookie (cookie);
+			DirtyDomains_ << cookie.domain ();
+		}
+	}
 
-			if (result.contains (cookie))
-				continue;
+	namespace
+	{
+		// The same rules as QNetworkCookieJar uses.
+		bool IsParentPath (const QString& path, const QString& reference)
+		{
+			if ((path.isEmpty () && reference == "/") || path.startsWith (reference))
+			{
+				if (path.size () == reference.size ())
+					return true;
+				if (reference.endsWith ('/'))
+					return true;
+				if (path.at (reference.size ()) == '/')
+					return true;
+			}
+			return false;
+		}
+
+		QStringList GetCandidateDomains (const QString& host)
+		{
+			QStringList result { host };
 
-			result << cookie;
+			if (host.isEmpty ())
+				return result;
+
+			// An IP address has no parent domains, but a leading dot
+			// doesn't hurt since no cookie has such a domain.
+			for (int pos = 0; pos >= 0; pos = host.indexOf ('.', pos + 1))
+				result << (pos ? host.mid (pos) : '.' + host);
+
+			return result;
 		}
-		qDebug () << Q_FUNC_INFO << cookies.size () << result.size ();
-		setAllCookies (result);
 	}
 
 	QList<QNetworkCookie> CustomCookieJar::cookiesForUrl (const QUrl& url) const
@@ -133,11 +232,119 @@ namespace Util
 		if (!Enabled_)
 			return {};
 
-		QList<QNetworkCookie> filtered;
-		for (const auto& cookie : QNetworkCookieJar::cookiesForUrl (url))
-			if (!filtered.contains (cookie))
-				filtered << cookie;
-		return filtered;
+		const auto& now = QDateTime::currentDateTimeUtc ();
+		const bool isEncrypted = !url.scheme ().compare ("https", Qt::CaseInsensitive);
+		const auto& path = url.path ();
+
+		QList<QNetworkCookie> result;
+		for (const auto& domain : GetCandidateDomains (url.host ()))
+		{
+			const auto pos = Domain2Cookies_.find (domain);
+			if (pos == Domain2Cookies_.end ())
+				continue;
+
+			for (const auto& cookie : *pos)
+			{
+				if (!IsParentPath (path, cookie.path ()))
+					continue;
+				if (cookie.isSecure () && !isEncrypted)
+					continue;
+				if (!cookie.isSessionCookie () && cookie.expirationDate () < now)
+					continue;
+
+				result << cookie;
+			}
+		}
+
+		// Cookies with longer paths go first, like in QNetworkCookieJar.
+		std::stable_sort (result.begin (), result.end (),
+				[] (const QNetworkCookie& left, const QNetworkCookie& right)
+					{ return left.path ().size () > right.path ().size (); });
+
+		return result;
+	}
+
+	bool CustomCookieJar::insertCookie (const QNetworkCookie& cookie)
+	{
+		const bool isDeletion = !cookie.isSessionCookie () &&
+				cookie.expirationDate () < QDateTime::currentDateTimeUtc ();
+
+		const auto& domain = cookie.domain ();
+		auto& cookies = Domain2Cookies_ [domain];
+
+		const auto pos = std::find_if (cookies.begin (), cookies.end (),
+				[&cookie] (const QNetworkCookie& other) { return other.hasSameIdentifier (cookie); });
+		if (pos != cookies.end ())
+		{
+			if (!isDeletion && *pos == cookie)
+				return true;
+
+			RemovedInBatch_ << *pos;
+			cookies.erase (pos);
+			DirtyDomains_ << domain;
+		}
+
+		if (!isDeletion)
+		{
+			cookies << cookie;
+			AddedInBatch_ << cookie;
+			DirtyDomains_ << domain;
+		}
+		else if (cookies.isEmpty ())
+			Domain2Cookies_.remove (domain);
+
+		FlushChanges ();
+
+		return !isDeletion;
+	}
+
+	bool CustomCookieJar::deleteCookie (const QNetworkCookie& cookie)
+	{
+		const auto& domain = cookie.domain ();
+		const auto domainPos = Domain2Cookies_.find (domain);
+		if (domainPos == Domain2Cookies_.end ())
+			return false;
+
+		auto& cookies = *domainPos;
+		const auto pos = std::find_if (cookies.begin (), cookies.end (),
+				[&cookie] (const QNetworkCookie& other) { return other.hasSameIdentifier (cookie); });
+		if (pos == cookies.end ())
+			return false;
+
+		RemovedInBatch_ << *pos;
+		cookies.erase (pos);
+		if (cookies.isEmpty ())
+			Domain2Cookies_.erase (domainPos);
+		DirtyDomains_ << domain;
+
+		FlushChanges ();
+
+		return true;
+	}
+
+	void CustomCookieJar::AddCookie (const QNetworkCookie& cookie)
+	{
+		auto& cookies = Domain2Cookies_ [cookie.domain ()];
+		const auto pos = std::find_if (cookies.begin (), cookies.end (),
+				[&cookie] (const QNetworkCookie& other) { return other.hasSameIdentifier (cookie); });
+		if (pos != cookies.end ())
+			*pos = cookie;
+		else
+			cookies << cookie;
+	}
+
+	void CustomCookieJar::FlushChanges ()
+	{
+		if (InBatch_)
+			return;
+
+		if (!RemovedInBatch_.isEmpty ())
+			emit cookiesRemoved (RemovedInBatch_);
+		if (!AddedInBatch_.isEmpty ())
+			emit cookiesAdded (AddedInBatch_);
+
+		RemovedInBatch_.clear ();
+		AddedInBatch_.clear ();
 	}
 
 	namespace
@@ -167,51 +374,6 @@ namespace Util
 
 			return false;
 		}
-
-		struct CookiesDiff
-		{
-			QList<QNetworkCookie> Added_;
-			QList<QNetworkCookie> Removed_;
-		};
-
-		auto CookieToTuple (const QNetworkCookie& c)
-		{
-			return std::make_tuple (c.isHttpOnly (),
-					c.isSecure (),
-					c.isSessionCookie (),
-					c.name (),
-					c.domain (),
-					c.path (),
-					c.value (),
-					c.expirationDate ());
-		}
-
-		struct CookieLess
-		{
-			bool operator() (const QNetworkCookie& left, const QNetworkCookie& right) const
-			{
-				return CookieToTuple (left) < CookieToTuple (right);
-			}
-		};
-
-		CookiesDiff CheckDifferences (const QList<QNetworkCookie>& previousList,
-				const QList<QNetworkCookie>& currentList)
-		{
-			using Set_t = std::set<QNetworkCookie, CookieLess>;
-			Set_t previous { previousList.begin (), previousList.end () };
-			Set_t current { currentList.begin (), currentList.end () };
-
-			CookiesDiff diff;
-			std::set_difference (previous.begin (), previous.end (),
-					current.begin (), current.end (),
-					std::back_inserter (diff.Removed_),
-					CookieLess {});
-			std::set_difference (current.begin (), current.end (),
-					previous.begin (), previous.end (),
-					std::back_inserter (diff.Added_),
-					CookieLess {});
-			return diff;
-		}
 	}
 
 	bool CustomCookieJar::setCookiesFromUrl (const QList<QNetworkCookie>& cookieList, const QUrl& url)
@@ -250,20 +412,15 @@ namespace Util
 				filtered << cookie;
 		}
 
-		const auto& existing = cookiesForUrl (url);
-		if (existing.isEmpty ())
-			emit cookiesAdded (filtered);
-		else
-			Util::Sequence (this, QtConcurrent::run (CheckDifferences, existing, filtered)) >>
-					[this] (const CookiesDiff& diff)
-					{
-						if (!diff.Removed_.isEmpty ())
-							emit cookiesRemoved (diff.Removed_);
-						if (!diff.Added_.isEmpty ())
-							emit cookiesAdded (diff.Added_);
-					};
+		// QNetworkCookieJar normalizes and validates the cookies and
+		// then calls insertCookie(), which collects the changes.
+		InBatch_ = true;
+		const auto result = QNetworkCookieJar::setCookiesFromUrl (filtered, url);
+		InBatch_ = false;
+
+		FlushChanges ();
 
-		return QNetworkCookieJar::setCookiesFromUrl (filtered, url);
+		return result;
 	}
 }
 }
@@ -30,8 +30,11 @@
 #pragma once
 
 #include <QNetworkCookieJar>
+#include <QNetworkCookie>
 #include <QByteArray>
 #include <QRegExp>
+#include <QHash>
+#include <QSet>
 #include "networkconfig.h"
 
 namespace LeechCraft
@@ -43,6 +46,11 @@ namespace Util
 	 * Allows one to filter tracking cookies, filter duplicate cookies
 	 * and has unlimited storage period.
 	 *
+	 * The cookies are indexed by their domain, so adding, removing and
+	 * looking up cookies only touches the domains involved. The jar
+	 * also tracks which domains have changed, so that only those could
+	 * be persisted.
+	 *
 	 * @ingroup NetworkUtil
 	 */
 	class UTIL_NETWORK_API CustomCookieJar : public QNetworkCookieJar
@@ -55,6 +63,13 @@ namespace Util
 
 		QList<QRegExp> WL_;
 		QList<QRegExp> BL_;
+
+		QHash<QString, QList<QNetworkCookie>> Domain2Cookies_;
+		QSet<QString> DirtyDomains_;
+
+		bool InBatch_ = false;
+		QList<QNetworkCookie> AddedInBatch_;
+		QList<QNetworkCookie> RemovedInBatch_;
 	public:
 		/** @brief Constructs the cookie jar.
 		 *
@@ -129,18 +144,83 @@ namespace Util
 		/** Restores the cookies from the array previously obtained
 		 * from Save().
 		 *
+		 * All the restored domains are marked as changed.
+		 *
 		 * @param[in] data Serialized cookies.
 		 * @sa Save()
 		 */
 		void Load (const QByteArray& data);
 
-		/** Removes duplicate cookies.
+		/** @brief Restores the given cookies, replacing the current ones.
+		 *
+		 * Expired cookies as well as tracking cookies (if they are
+		 * filtered) are skipped. The domains of the skipped cookies are
+		 * marked as changed, while the rest aren't.
+		 *
+		 * @param[in] cookies The cookies to restore.
+		 *
+		 * @sa TakeDirtyDomains()
+		 */
+		void LoadCookies (const QList<QNetworkCookie>& cookies);
+
+		/** Removes expired cookies.
 		 */
 		void CollectGarbage ();
 
+		/** @brief Returns the domains that have changed since the last
+		 * call to this function.
+		 *
+		 * @return The changed domains, as returned by
+		 * QNetworkCookie::domain().
+		 *
+		 * @sa GetDomainCookies()
+		 */
+		QSet<QString> TakeDirtyDomains ();
+
+		/** @brief Marks the given domains as changed.
+		 *
+		 * This is useful if the domains returned by TakeDirtyDomains()
+		 * couldn't be persisted.
+		 *
+		 * @param[in] domains The domains to mark as changed.
+		 */
+		void MarkDomainsDirty (const QSet<QString>& domains);
+
+		/** @brief Returns all the known domains.
+		 *
+		 * @return The domains having cookies in the jar.
+		 */
+		QStringList GetDomains () const;
+
+		/** @brief Returns the cookies for the given cookie domain.
+		 *
+		 * Unlike cookiesForUrl(), this function returns only the
+		 * cookies whose QNetworkCookie::domain() is exactly the
+		 * \em domain, including the expired ones.
+		 *
+		 * @param[in] domain The cookie domain.
+		 * @return The cookies of the \em domain.
+		 */
+		QList<QNetworkCookie> GetDomainCookies (const QString& domain) const;
+
+		/** @brief Returns all the cookies in the jar.
+		 *
+		 * @return All the cookies in the jar.
+		 */
+		QList<QNetworkCookie> allCookies () const;
+
+		/** @brief Replaces all the cookies in the jar.
+		 *
+		 * All the previous and the new domains are marked as changed.
+		 *
+		 * @param[in] cookies The new cookies.
+		 */
+		void setAllCookies (const QList<QNetworkCookie>& cookies);
+
 		/** @brief Returns cookies for the given url.
 		 *
-		 * This function automatically filters out duplicate cookies.
+		 * Only the cookies of the url host and its parent domains are
+		 * considered.
 		 *
 		 * If the cookie jar is disabled, this function does nothing.
 		 *
@@ -159,8 +239,16 @@ namespace Util
 		 */
 		bool setCookiesFromUrl (const QList<QNetworkCookie>& cookieList, const QUrl& url);
 
-		using QNetworkCookieJar::allCookies;
-		using QNetworkCookieJar::setAllCookies;
+		/** @brief Reimplemented from QNetworkCookieJar.
+		 */
+		bool insertCookie (const QNetworkCookie& cookie);
+
+		/** @brief Reimplemented from QNetworkCookieJar.
+		 */
+		bool deleteCookie (const QNetworkCookie& cookie);
+	private:
+		void AddCookie (const QNetworkCookie&);
+		void FlushChanges ();
 	signals:
 		void cookiesAdded (const QList<QNetworkCookie>&);
 		void cookiesRemoved (const QList<QNetworkCookie>&);
@@ -30,10 +30,8 @@
 #include "networkdiskcache.h"
 #include <QtDebug>
 #include <QDir>
-#include <QFuture>
 #include <QMutexLocker>
 #include <util/sys/paths.h>
-#include <util/threads/futures.h>
 #include "networkdiskcachegc.h"
 
 namespace LeechCraft
@@ -50,23 +48,33 @@ namespace Util
 
 	NetworkDiskCache::NetworkDiskCache (const QString& subpath, QObject *parent)
 	: QNetworkDiskCache (parent)
-	, CurrentSize_ (-1)
 	, InsertRemoveMutex_ (QMutex::Recursive)
 	, GcGuard_ (NetworkDiskCacheGC::Instance ().RegisterDirectory (GetCacheDir (subpath),
 			[this] { return maximumCacheSize (); }))
+	, Index_ (NetworkDiskCacheGC::Instance ().GetIndex (GetCacheDir (subpath)))
 	{
 		setCacheDirectory (GetCacheDir (subpath));
 	}
 
+	NetworkDiskCacheStats NetworkDiskCache::GetStats () const
+	{
+		return Index_->GetStats ();
+	}
+
 	qint64 NetworkDiskCache::cacheSize () const
 	{
-		return CurrentSize_;
+		return Index_->GetTotalSize ();
 	}
 
 	QIODevice* NetworkDiskCache::data (const QUrl& url)
 	{
 		QMutexLocker lock (&InsertRemoveMutex_);
-		return QNetworkDiskCache::data (url);
+		const auto dev = QNetworkDiskCache::data (url);
+		if (dev)
+			Index_->RecordHit (url);
+		else
+			Index_->RecordMiss ();
+		return dev;
 	}
 
 	void NetworkDiskCache::insert (QIODevice *device)
@@ -79,9 +87,10 @@ namespace Util
 			return;
 		}
 
-		PendingUrl2Devs_ [PendingDev2Url_.take (device)].removeAll (device);
+		const auto& url = PendingDev2Url_.take (device);
+		PendingUrl2Devs_ [url].removeAll (device);
 
-		CurrentSize_ += device->size ();
+		Index_->RecordInsert (url, device->size ());
 		QNetworkDiskCache::insert (device);
 	}
 
@@ -105,6 +114,7 @@ namespace Util
 		QMutexLocker lock (&InsertRemoveMutex_);
 		for (const auto dev : PendingUrl2Devs_.take (url))
 			PendingDev2Url_.remove (dev);
+		Index_->RecordRemove (url);
 		return QNetworkDiskCache::remove (url);
 	}
 
@@ -116,16 +126,19 @@ namespace Util
 
 	qint64 NetworkDiskCache::expire ()
 	{
-		if (CurrentSize_ < 0)
-		{
-			const auto& dir = cacheDirectory ();
-			Util::Sequence (this, NetworkDiskCacheGC::Instance ().GetCurrentSize (dir)) >>
-					[this] (qint64 res) { CurrentSize_ = res; };
-
+		// Pretend there's enough room until the index is loaded.
+		const auto size = Index_->GetTotalSize ();
+		if (size < 0)
 			return maximumCacheSize () * 8 / 10;
-		}
 
-		return CurrentSize_;
+		if (size <= maximumCacheSize ())
+			return size;
+
+		QMutexLocker lock (&InsertRemoveMutex_);
+		for (const auto& url : Index_->TakeEvicted (maximumCacheSize () * 9 / 10))
+			QNetworkDiskCache::remove (url);
+
+		return Index_->GetTotalSize ();
 	}
 }
 }
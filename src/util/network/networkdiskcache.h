@@ -29,11 +29,13 @@
 
 #pragma once
 
+#include <memory>
 #include <QNetworkDiskCache>
 #include <QMutex>
 #include <QHash>
 #include <util/sll/util.h>
 #include "networkconfig.h"
+#include "networkdiskcacheindex.h"
 
 namespace LeechCraft
 {
@@ -49,6 +51,9 @@ namespace Util
 	 * also triggered manually via the collectGarbage() slot.
 	 *
 	 * The garbage is collected until cache takes 90% of its maximum size.
+	 * Least recently used items are evicted first, as tracked by the
+	 * NetworkDiskCacheIndex shared by all the caches in the same
+	 * directory, so eviction doesn't need to scan the cache directory.
 	 *
 	 * @ingroup NetworkUtil
 	 */
@@ -56,14 +61,13 @@ namespace Util
 	{
 		Q_OBJECT
 
-		qint64 CurrentSize_;
-
 		mutable QMutex InsertRemoveMutex_;
 
 		QHash<QIODevice*, QUrl> PendingDev2Url_;
 		QHash<QUrl, QList<QIODevice*>> PendingUrl2Devs_;
 
 		const Util::DefaultScopeGuard GcGuard_;
+		const std::shared_ptr<NetworkDiskCacheIndex> Index_;
 	public:
 		/** @brief Constructs the new disk cache.
 		 *
@@ -77,6 +81,15 @@ namespace Util
 		 */
 		NetworkDiskCache (const QString& subpath, QObject *parent = 0);
 
+		/** @brief Returns the usage counters of this cache directory.
+		 *
+		 * The counters are shared by all the caches in the same
+		 * directory.
+		 *
+		 * @return The usage counters of this cache directory.
+		 */
+		NetworkDiskCacheStats GetStats () const;
+
 		/** @brief Reimplemented from QNetworkDiskCache.
 		 */
 		qint64 cacheSize () const override;
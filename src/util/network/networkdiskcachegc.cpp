@@ -32,12 +32,13 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QtConcurrentRun>
-#include <QDateTime>
+#include <QNetworkDiskCache>
 #include <QtDebug>
 #include <util/sll/qtutil.h>
 #include <util/sll/prelude.h>
 #include <util/sll/util.h>
 #include <util/threads/futures.h>
+#include "networkdiskcacheindex.h"
 
 namespace LeechCraft
 {
@@ -50,7 +51,7 @@ namespace Util
 				SIGNAL (timeout ()),
 				this,
 				SLOT (handleCollect ()));
-		timer->start (60 * 60 * 1000);
+		timer->start (10 * 60 * 1000);
 	}
 
 	NetworkDiskCacheGC& NetworkDiskCacheGC::Instance ()
@@ -63,7 +64,6 @@ namespace Util
 	{
 		struct SizeCollectInfo
 		{
-			QMultiMap<QDateTime, QString> Items_;
 			qint64 TotalSize_ = 0;
 		};
 
@@ -76,9 +76,8 @@ namespace Util
 
 			while (it.hasNext ())
 			{
-				const auto& path = it.next ();
+				it.next ();
 				const auto& info = it.fileInfo ();
-				result.Items_.insert (info.created (), path);
 				result.TotalSize_ += info.size ();
 			}
 
@@ -98,9 +97,21 @@ namespace Util
 		list.push_front (sizeGetter);
 		const auto thisItem = list.begin ();
 
+		if (!Indexes_.contains (path))
+		{
+			const auto index = std::make_shared<NetworkDiskCacheIndex> (path);
+			Indexes_ [path] = index;
+			QtConcurrent::run ([index] { index->Load (); });
+		}
+
 		return Util::MakeScopeGuard ([this, path, thisItem] { UnregisterDirectory (path, thisItem); }).EraseType ();
 	}
 
+	std::shared_ptr<NetworkDiskCacheIndex> NetworkDiskCacheGC::GetIndex (const QString& path) const
+	{
+		return Indexes_.value (path);
+	}
+
 	void NetworkDiskCacheGC::UnregisterDirectory (const QString& path, CacheSizeGetters_t::iterator pos)
 	{
 		if (!Directories_.contains (path))
@@ -118,32 +129,40 @@ namespace Util
 			return;
 
 		Directories_.remove (path);
+		Indexes_.remove (path);
 		LastSizes_.remove (path);
 	}
 
 	namespace
 	{
-		qint64 Collector (const QString& cacheDirectory, qint64 goal)
+		qint64 Collector (const QString& cacheDirectory,
+				const std::shared_ptr<NetworkDiskCacheIndex>& index, qint64 goal)
 		{
-			if (cacheDirectory.isEmpty ())
+			if (cacheDirectory.isEmpty () || !index->IsReady ())
 				return 0;
 
 			qDebug () << Q_FUNC_INFO << "running..." << cacheDirectory << goal;
 
-			auto sizeInfoResult = CollectSizes (cacheDirectory);
-
-			for (auto i = sizeInfoResult.Items_.constBegin ();
-					i != sizeInfoResult.Items_.constEnd () && sizeInfoResult.TotalSize_ > goal;
-					++i)
+			const auto& evicted = index->TakeEvicted (goal);
+			if (!evicted.isEmpty ())
 			{
-				QFile file { *i };
-				sizeInfoResult.TotalSize_ -= file.size ();
-				file.remove ();
+				// Only the file names are needed from the cache, which
+				// doesn't scan the directory.
+				QNetworkDiskCache cache;
+				cache.setCacheDirectory (cacheDirectory);
+				for (const auto& url : evicted)
+					cache.remove (url);
 			}
 
-			qDebug () << "collector finished" << sizeInfoResult.TotalSize_;
+			index->Save ();
+
+			const auto& stats = index->GetStats ();
+			qDebug () << "collector finished"
+					<< stats.TotalSize_
+					<< "; evicted" << evicted.size ()
+					<< "; hit ratio" << stats.GetHitRatio ();
 
-			return sizeInfoResult.TotalSize_;
+			return stats.TotalSize_;
 		}
 	};
 
@@ -156,13 +175,19 @@ namespace Util
 			return;
 		}
 
-		QList<QPair<QString, int>> dirs;
+		struct CollectInfo
+		{
+			QString Dir_;
+			std::shared_ptr<NetworkDiskCacheIndex> Index_;
+			qint64 Goal_;
+		};
+		QList<CollectInfo> dirs;
 		for (const auto& pair : Util::Stlize (Directories_))
 		{
 			const auto& getters = pair.second;
 			const auto minSize = (*std::min_element (getters.begin (), getters.end (),
 						Util::ComparingBy (Apply))) ();
-			dirs.append ({ pair.first, minSize });
+			dirs.append ({ pair.first, Indexes_.value (pair.first), static_cast<qint64> (minSize) * 9 / 10 });
 		}
 
 		if (dirs.isEmpty ())
@@ -174,8 +199,8 @@ namespace Util
 				QtConcurrent::run ([dirs]
 						{
 							QMap<QString, qint64> sizes;
-							for (const auto& pair : dirs)
-								sizes [pair.first] = Collector (pair.first, pair.second);
+							for (const auto& info : dirs)
+								sizes [info.Dir_] = Collector (info.Dir_, info.Index_, info.Goal_);
 							return sizes;
 						})) >>
 				[this] (const QMap<QString, qint64>& sizes)
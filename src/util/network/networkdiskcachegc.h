@@ -43,12 +43,18 @@ namespace LeechCraft
 {
 namespace Util
 {
+	class NetworkDiskCacheIndex;
+
 	/** @brief Garbage collection for a set of network disk caches.
 	 *
 	 * This GC manager class aids having multiple network disk caches at
 	 * the same path and running garbage collection periodically on them,
 	 * but only once per each path.
 	 *
+	 * Each registered path has a NetworkDiskCacheIndex shared by all the
+	 * caches at that path, and the least recently used items according
+	 * to that index are evicted.
+	 *
 	 * @ingroup NetworkUtil
 	 */
 	class NetworkDiskCacheGC : public QObject
@@ -57,6 +63,7 @@ namespace Util
 
 		using CacheSizeGetters_t = QLinkedList<std::function<int ()>>;
 		QMap<QString, CacheSizeGetters_t> Directories_;
+		QMap<QString, std::shared_ptr<NetworkDiskCacheIndex>> Indexes_;
 
 		QMap<QString, qint64> LastSizes_;
 
@@ -99,14 +106,29 @@ namespace Util
 		 * registered multiple times with size getters returning
 		 * different values, the minimum one is used.
 		 *
+		 * The LRU index for the \em path is created and loaded in a
+		 * separate thread when the path is registered for the first
+		 * time.
+		 *
 		 * @param[in] path The path to register for garbage collection.
 		 * @param[in] sizeGetter The functor returning the desired total
 		 * size of files under the \em path.
 		 * @return A guard object unregistering the path when it is
 		 * destroyed.
+		 *
+		 * @sa GetIndex()
 		 */
 		Util::DefaultScopeGuard RegisterDirectory (const QString& path,
 				const std::function<int ()>& sizeGetter);
+
+		/** @brief Returns the LRU index for the registered \em path.
+		 *
+		 * @param[in] path The path previously registered via
+		 * RegisterDirectory().
+		 * @return The index for the \em path, or a null pointer if the
+		 * \em path isn't registered.
+		 */
+		std::shared_ptr<NetworkDiskCacheIndex> GetIndex (const QString& path) const;
 	private:
 		void UnregisterDirectory (const QString&, CacheSizeGetters_t::iterator);
 	private slots:
@@ -0,0 +1,323 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "networkdiskcacheindex.h"
+#include <algorithm>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QNetworkDiskCache>
+#include <QtDebug>
+
+namespace LeechCraft
+{
+namespace Util
+{
+	namespace
+	{
+		const quint32 IndexMagic = 0x4c434458;
+		const quint8 IndexVersion = 1;
+	}
+
+	NetworkDiskCacheIndex::NetworkDiskCacheIndex (const QString& directory)
+	: Directory_ { directory }
+	{
+	}
+
+	NetworkDiskCacheIndex::~NetworkDiskCacheIndex ()
+	{
+		Save ();
+	}
+
+	void NetworkDiskCacheIndex::Load ()
+	{
+		Items_t loaded;
+		if (ReadIndex (loaded))
+			QFile::remove (GetIndexPath ());
+		else
+			loaded = RebuildIndex ();
+
+		QMutexLocker locker { &Mutex_ };
+
+		for (auto it = loaded.rbegin (); it != loaded.rend (); ++it)
+		{
+			if (Url2Item_.contains (it->Url_) ||
+					RemovedWhileLoading_.contains (it->Url_))
+				continue;
+
+			Items_.push_front (*it);
+			Url2Item_ [it->Url_] = Items_.begin ();
+
+			++Stats_.Items_;
+			Stats_.TotalSize_ += it->Size_;
+		}
+
+		RemovedWhileLoading_.clear ();
+
+		IsReady_ = true;
+		IsDirty_ = true;
+	}
+
+	void NetworkDiskCacheIndex::Save ()
+	{
+		Items_t items;
+
+		{
+			QMutexLocker locker { &Mutex_ };
+			if (!IsReady_ || !IsDirty_)
+				return;
+
+			items = Items_;
+			IsDirty_ = false;
+		}
+
+		QSaveFile file { GetIndexPath () };
+		if (!file.open (QIODevice::WriteOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return;
+		}
+
+		QDataStream out { &file };
+		out.setVersion (QDataStream::Qt_5_0);
+		out << IndexMagic
+				<< IndexVersion
+				<< static_cast<quint32> (items.size ());
+		for (const auto& item : items)
+			out << item.Url_ << item.Size_;
+
+		if (!file.commit ())
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to save"
+					<< file.fileName ()
+					<< file.errorString ();
+
+			QMutexLocker locker { &Mutex_ };
+			IsDirty_ = true;
+		}
+	}
+
+	bool NetworkDiskCacheIndex::IsReady () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return IsReady_;
+	}
+
+	void NetworkDiskCacheIndex::RecordHit (const QUrl& url)
+	{
+		QMutexLocker locker { &Mutex_ };
+		++Stats_.Hits_;
+
+		const auto pos = Url2Item_.find (url);
+		if (pos == Url2Item_.end ())
+			return;
+
+		Items_.splice (Items_.end (), Items_, *pos);
+		IsDirty_ = true;
+	}
+
+	void NetworkDiskCacheIndex::RecordMiss ()
+	{
+		QMutexLocker locker { &Mutex_ };
+		++Stats_.Misses_;
+	}
+
+	void NetworkDiskCacheIndex::RecordInsert (const QUrl& url, qint64 size)
+	{
+		QMutexLocker locker { &Mutex_ };
+		++Stats_.Insertions_;
+		IsDirty_ = true;
+
+		const auto pos = Url2Item_.find (url);
+		if (pos != Url2Item_.end ())
+		{
+			const auto item = *pos;
+			Stats_.TotalSize_ += size - item->Size_;
+			item->Size_ = size;
+			Items_.splice (Items_.end (), Items_, item);
+			return;
+		}
+
+		Items_.push_back ({ url, size });
+		Url2Item_ [url] = std::prev (Items_.end ());
+
+		++Stats_.Items_;
+		Stats_.TotalSize_ += size;
+	}
+
+	void NetworkDiskCacheIndex::RecordRemove (const QUrl& url)
+	{
+		QMutexLocker locker { &Mutex_ };
+
+		if (!IsReady_)
+			RemovedWhileLoading_ << url;
+
+		const auto pos = Url2Item_.find (url);
+		if (pos == Url2Item_.end ())
+			return;
+
+		--Stats_.Items_;
+		Stats_.TotalSize_ -= (*pos)->Size_;
+
+		Items_.erase (*pos);
+		Url2Item_.erase (pos);
+		IsDirty_ = true;
+	}
+
+	QList<QUrl> NetworkDiskCacheIndex::TakeEvicted (qint64 goal)
+	{
+		QMutexLocker locker { &Mutex_ };
+		if (!IsReady_)
+			return {};
+
+		QList<QUrl> result;
+		while (Stats_.TotalSize_ > goal && !Items_.empty ())
+		{
+			const auto& item = Items_.front ();
+			result << item.Url_;
+
+			--Stats_.Items_;
+			Stats_.TotalSize_ -= item.Size_;
+			++Stats_.Evictions_;
+			Stats_.EvictedBytes_ += item.Size_;
+
+			Url2Item_.remove (item.Url_);
+			Items_.pop_front ();
+		}
+
+		if (!result.isEmpty ())
+			IsDirty_ = true;
+
+		return result;
+	}
+
+	qint64 NetworkDiskCacheIndex::GetTotalSize () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return IsReady_ ? Stats_.TotalSize_ : -1;
+	}
+
+	NetworkDiskCacheStats NetworkDiskCacheIndex::GetStats () const
+	{
+		QMutexLocker locker { &Mutex_ };
+		return Stats_;
+	}
+
+	QString NetworkDiskCacheIndex::GetIndexPath () const
+	{
+		return QDir { Directory_ }.filePath ("lc_lru.index");
+	}
+
+	bool NetworkDiskCacheIndex::ReadIndex (Items_t& items) const
+	{
+		QFile file { GetIndexPath () };
+		if (!file.exists ())
+			return false;
+
+		if (!file.open (QIODevice::ReadOnly))
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unable to open"
+					<< file.fileName ()
+					<< file.errorString ();
+			return false;
+		}
+
+		QDataStream in { &file };
+		in.setVersion (QDataStream::Qt_5_0);
+
+		quint32 magic = 0;
+		quint8 version = 0;
+		quint32 count = 0;
+		in >> magic >> version >> count;
+		if (magic != IndexMagic || version != IndexVersion)
+		{
+			qWarning () << Q_FUNC_INFO
+					<< "unknown index format in"
+					<< file.fileName ();
+			return false;
+		}
+
+		for (quint32 i = 0; i < count; ++i)
+		{
+			Item item;
+			in >> item.Url_ >> item.Size_;
+			if (in.status () != QDataStream::Ok)
+			{
+				qWarning () << Q_FUNC_INFO
+						<< "truncated index in"
+						<< file.fileName ();
+				return false;
+			}
+			items.push_back (item);
+		}
+
+		return true;
+	}
+
+	NetworkDiskCacheIndex::Items_t NetworkDiskCacheIndex::RebuildIndex () const
+	{
+		qDebug () << Q_FUNC_INFO << "rebuilding the index for" << Directory_;
+
+		// QNetworkDiskCache::fileMetaData() just parses the given file.
+		QNetworkDiskCache cache;
+
+		QList<QPair<QDateTime, Item>> found;
+
+		QDirIterator it { Directory_, { "*.d" }, QDir::Files, QDirIterator::Subdirectories };
+		while (it.hasNext ())
+		{
+			const auto& path = it.next ();
+			const auto& info = it.fileInfo ();
+
+			const auto& url = cache.fileMetaData (path).url ();
+			if (!url.isValid ())
+				continue;
+
+			found.append ({ std::max (info.lastRead (), info.lastModified ()), { url, info.size () } });
+		}
+
+		std::stable_sort (found.begin (), found.end (),
+				[] (const QPair<QDateTime, Item>& left, const QPair<QDateTime, Item>& right)
+					{ return left.first < right.first; });
+
+		Items_t result;
+		for (const auto& pair : found)
+			result.push_back (pair.second);
+		return result;
+	}
+}
+}
@@ -0,0 +1,209 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <list>
+#include <QHash>
+#include <QSet>
+#include <QUrl>
+#include <QMutex>
+#include "networkconfig.h"
+
+namespace LeechCraft
+{
+namespace Util
+{
+	/** @brief Usage counters of a network disk cache directory.
+	 *
+	 * The counters are kept in memory and thus describe the current
+	 * session only.
+	 *
+	 * @ingroup NetworkUtil
+	 */
+	struct NetworkDiskCacheStats
+	{
+		/** @brief The number of data() calls that found the URL.
+		 */
+		quint64 Hits_ = 0;
+
+		/** @brief The number of data() calls that didn't find the URL.
+		 */
+		quint64 Misses_ = 0;
+
+		/** @brief The number of items inserted into the cache.
+		 */
+		quint64 Insertions_ = 0;
+
+		/** @brief The number of items evicted to fit into the cache size.
+		 */
+		quint64 Evictions_ = 0;
+
+		/** @brief The total size of the evicted items.
+		 */
+		qint64 EvictedBytes_ = 0;
+
+		/** @brief The number of items currently in the cache.
+		 */
+		int Items_ = 0;
+
+		/** @brief The total size of the items currently in the cache.
+		 */
+		qint64 TotalSize_ = 0;
+
+		/** @brief Returns the ratio of hits to all the data() calls.
+		 *
+		 * @return The hit ratio, or 0 if data() hasn't been called yet.
+		 */
+		double GetHitRatio () const
+		{
+			const auto total = Hits_ + Misses_;
+			return total ? static_cast<double> (Hits_) / total : 0;
+		}
+	};
+
+	/** @brief A persistent index of the items of a network disk cache
+	 * ordered by their last access.
+	 *
+	 * The index makes eviction cost proportional to the number of
+	 * evicted items and evicts least recently used items first.
+	 *
+	 * The index is saved to the cache directory and loaded from it via
+	 * Load(). The file is removed once loaded and written back by Save(),
+	 * so an index that wasn't saved cleanly is rebuilt from the cache
+	 * directory contents next time.
+	 *
+	 * The index may be used before it is loaded: the loaded items are
+	 * merged as older than anything recorded meanwhile.
+	 *
+	 * This class is thread-safe.
+	 *
+	 * @ingroup NetworkUtil
+	 */
+	class UTIL_NETWORK_API NetworkDiskCacheIndex
+	{
+		struct Item
+		{
+			QUrl Url_;
+			qint64 Size_;
+		};
+		using Items_t = std::list<Item>;
+
+		const QString Directory_;
+
+		mutable QMutex Mutex_;
+
+		Items_t Items_;
+		QHash<QUrl, Items_t::iterator> Url2Item_;
+		QSet<QUrl> RemovedWhileLoading_;
+
+		bool IsReady_ = false;
+		bool IsDirty_ = false;
+
+		NetworkDiskCacheStats Stats_;
+	public:
+		/** @brief Creates an empty index for the given cache directory.
+		 *
+		 * @param[in] directory The cache directory.
+		 */
+		explicit NetworkDiskCacheIndex (const QString& directory);
+
+		/** @brief Saves the index if it has been loaded.
+		 */
+		~NetworkDiskCacheIndex ();
+
+		NetworkDiskCacheIndex (const NetworkDiskCacheIndex&) = delete;
+		NetworkDiskCacheIndex& operator= (const NetworkDiskCacheIndex&) = delete;
+
+		/** @brief Loads the index from the cache directory.
+		 *
+		 * If there is no saved index, it is rebuilt from the cache
+		 * files, ordered by their access and modification times.
+		 *
+		 * This function blocks and is meant to be called from a
+		 * worker thread.
+		 */
+		void Load ();
+
+		/** @brief Saves the index to the cache directory if it has
+		 * changed since the last save.
+		 */
+		void Save ();
+
+		/** @brief Returns whether the index has been loaded.
+		 */
+		bool IsReady () const;
+
+		/** @brief Marks the url as just used.
+		 */
+		void RecordHit (const QUrl& url);
+
+		/** @brief Records an unsuccessful lookup.
+		 */
+		void RecordMiss ();
+
+		/** @brief Records a new or updated item.
+		 *
+		 * @param[in] url The URL of the item.
+		 * @param[in] size The size of the item data.
+		 */
+		void RecordInsert (const QUrl& url, qint64 size);
+
+		/** @brief Records an item removed from the cache.
+		 */
+		void RecordRemove (const QUrl& url);
+
+		/** @brief Takes the least recently used items out of the index
+		 * until the total size is not bigger than goal.
+		 *
+		 * The caller is responsible for removing the returned items
+		 * from the cache.
+		 *
+		 * @param[in] goal The desired total size.
+		 * @return The URLs of the items to evict, least recently used
+		 * first.
+		 */
+		QList<QUrl> TakeEvicted (qint64 goal);
+
+		/** @brief Returns the total size of the indexed items.
+		 *
+		 * @return The total size, or -1 if the index isn't loaded yet.
+		 */
+		qint64 GetTotalSize () const;
+
+		/** @brief Returns the usage counters of this cache directory.
+		 */
+		NetworkDiskCacheStats GetStats () const;
+	private:
+		QString GetIndexPath () const;
+		bool ReadIndex (Items_t&) const;
+		Items_t RebuildIndex () const;
+	};
+}
+}
@@ -0,0 +1,146 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "customcookiejartest.h"
+#include <QtTest>
+#include <QNetworkCookie>
+#include <customcookiejar.h>
+
+QTEST_MAIN (LeechCraft::Util::CustomCookieJarTest)
+
+namespace LeechCraft
+{
+namespace Util
+{
+	namespace
+	{
+		QList<QNetworkCookie> Parse (const QByteArray& header)
+		{
+			return QNetworkCookie::parseCookies (header);
+		}
+
+		QStringList Names (const QList<QNetworkCookie>& cookies)
+		{
+			QStringList result;
+			for (const auto& cookie : cookies)
+				result << QString::fromLatin1 (cookie.name ());
+			return result;
+		}
+	}
+
+	void CustomCookieJarTest::testHostOnlyCookie ()
+	{
+		QNetworkCookie cookie { "a", "1" };
+		cookie.setDomain ("www.example.com");
+		cookie.setPath ("/");
+
+		CustomCookieJar jar;
+		jar.insertCookie (cookie);
+
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://www.example.com/page" })), QStringList { "a" });
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://sub.www.example.com/" })), QStringList {});
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://example.com/" })), QStringList {});
+	}
+
+	void CustomCookieJarTest::testDomainCookie ()
+	{
+		CustomCookieJar jar;
+		jar.setCookiesFromUrl (Parse ("a=1; Domain=example.com"), QUrl { "http://www.example.com/" });
+
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://example.com/" })), QStringList { "a" });
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://a.b.example.com/" })), QStringList { "a" });
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://notexample.com/" })), QStringList {});
+	}
+
+	void CustomCookieJarTest::testPathAndSecure ()
+	{
+		CustomCookieJar jar;
+		const QUrl url { "https://example.com/" };
+		jar.setCookiesFromUrl (Parse ("root=1; Path=/"), url);
+		jar.setCookiesFromUrl (Parse ("dir=1; Path=/dir"), url);
+		jar.setCookiesFromUrl (Parse ("sec=1; Path=/dir/sub; Secure"), url);
+
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "https://example.com/dir/sub/x" })),
+				(QStringList { "sec", "dir", "root" }));
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://example.com/dir/sub/x" })),
+				(QStringList { "dir", "root" }));
+		QCOMPARE (Names (jar.cookiesForUrl (QUrl { "http://example.com/directory" })),
+				QStringList { "root" });
+	}
+
+	void CustomCookieJarTest::testReplace ()
+	{
+		CustomCookieJar jar;
+		const QUrl url { "http://example.com/" };
+		jar.setCookiesFromUrl (Parse ("a=1"), url);
+
+		QSignalSpy added { &jar, SIGNAL (cookiesAdded (QList<QNetworkCookie>)) };
+		QSignalSpy removed { &jar, SIGNAL (cookiesRemoved (QList<QNetworkCookie>)) };
+
+		jar.setCookiesFromUrl (Parse ("a=1"), url);
+		QCOMPARE (added.size (), 0);
+		QCOMPARE (removed.size (), 0);
+
+		jar.setCookiesFromUrl (Parse ("a=2"), url);
+		QCOMPARE (added.size (), 1);
+		QCOMPARE (removed.size (), 1);
+
+		const auto& cookies = jar.cookiesForUrl (url);
+		QCOMPARE (cookies.size (), 1);
+		QCOMPARE (cookies.at (0).value (), QByteArray { "2" });
+	}
+
+	void CustomCookieJarTest::testExpiredRemoves ()
+	{
+		CustomCookieJar jar;
+		const QUrl url { "http://example.com/" };
+		jar.setCookiesFromUrl (Parse ("a=1"), url);
+		jar.setCookiesFromUrl (Parse ("a=1; Expires=Thu, 01 Jan 1970 00:00:01 GMT"), url);
+
+		QCOMPARE (jar.cookiesForUrl (url).size (), 0);
+		QCOMPARE (jar.GetDomains (), QStringList {});
+	}
+
+	void CustomCookieJarTest::testDirtyDomains ()
+	{
+		CustomCookieJar jar;
+		jar.setCookiesFromUrl (Parse ("a=1"), QUrl { "http://example.com/" });
+		jar.setCookiesFromUrl (Parse ("b=1; Domain=example.org"), QUrl { "http://www.example.org/" });
+
+		QCOMPARE (jar.TakeDirtyDomains (), (QSet<QString> { ".example.com", ".example.org" }));
+		QCOMPARE (jar.TakeDirtyDomains (), QSet<QString> {});
+
+		jar.setCookiesFromUrl (Parse ("a=1"), QUrl { "http://example.com/" });
+		QCOMPARE (jar.TakeDirtyDomains (), QSet<QString> {});
+
+		jar.LoadCookies (jar.allCookies ());
+		QCOMPARE (jar.TakeDirtyDomains (), QSet<QString> {});
+	}
+}
+}
@@ -0,0 +1,161 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#include "networkdiskcacheindextest.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <networkdiskcacheindex.h>
+
+QTEST_MAIN (LeechCraft::Util::NetworkDiskCacheIndexTest)
+
+namespace LeechCraft
+{
+namespace Util
+{
+	namespace
+	{
+		QUrl MkUrl (int num)
+		{
+			return QUrl { "http://example.com/" + QString::number (num) };
+		}
+
+		void Fill (NetworkDiskCacheIndex& index, int count)
+		{
+			for (int i = 0; i < count; ++i)
+				index.RecordInsert (MkUrl (i), 10);
+		}
+	}
+
+	void NetworkDiskCacheIndexTest::testLRUOrder ()
+	{
+		QTemporaryDir dir;
+		NetworkDiskCacheIndex index { dir.path () };
+		index.Load ();
+
+		Fill (index, 5);
+		index.RecordHit (MkUrl (0));
+		index.RecordHit (MkUrl (2));
+
+		const auto& evicted = index.TakeEvicted (20);
+		QCOMPARE (evicted, (QList<QUrl> { MkUrl (1), MkUrl (3), MkUrl (4) }));
+		QCOMPARE (index.GetTotalSize (), qint64 { 20 });
+	}
+
+	void NetworkDiskCacheIndexTest::testReinsert ()
+	{
+		QTemporaryDir dir;
+		NetworkDiskCacheIndex index { dir.path () };
+		index.Load ();
+
+		Fill (index, 3);
+		index.RecordInsert (MkUrl (0), 25);
+
+		QCOMPARE (index.GetTotalSize (), qint64 { 45 });
+		QCOMPARE (index.TakeEvicted (25), (QList<QUrl> { MkUrl (1), MkUrl (2) }));
+	}
+
+	void NetworkDiskCacheIndexTest::testRemove ()
+	{
+		QTemporaryDir dir;
+		NetworkDiskCacheIndex index { dir.path () };
+		index.Load ();
+
+		Fill (index, 3);
+		index.RecordRemove (MkUrl (1));
+		index.RecordRemove (MkUrl (10));
+
+		QCOMPARE (index.GetTotalSize (), qint64 { 20 });
+		QCOMPARE (index.TakeEvicted (0), (QList<QUrl> { MkUrl (0), MkUrl (2) }));
+	}
+
+	void NetworkDiskCacheIndexTest::testStats ()
+	{
+		QTemporaryDir dir;
+		NetworkDiskCacheIndex index { dir.path () };
+		index.Load ();
+
+		Fill (index, 4);
+		index.RecordHit (MkUrl (0));
+		index.RecordHit (MkUrl (1));
+		index.RecordHit (MkUrl (2));
+		index.RecordMiss ();
+		index.TakeEvicted (30);
+
+		const auto& stats = index.GetStats ();
+		QCOMPARE (stats.Hits_, quint64 { 3 });
+		QCOMPARE (stats.Misses_, quint64 { 1 });
+		QCOMPARE (stats.Insertions_, quint64 { 4 });
+		QCOMPARE (stats.Evictions_, quint64 { 1 });
+		QCOMPARE (stats.EvictedBytes_, qint64 { 10 });
+		QCOMPARE (stats.Items_, 3);
+		QCOMPARE (stats.TotalSize_, qint64 { 30 });
+		QCOMPARE (stats.GetHitRatio (), 0.75);
+	}
+
+	void NetworkDiskCacheIndexTest::testPersistence ()
+	{
+		QTemporaryDir dir;
+
+		{
+			NetworkDiskCacheIndex index { dir.path () };
+			index.Load ();
+			Fill (index, 4);
+			index.RecordHit (MkUrl (0));
+		}
+
+		NetworkDiskCacheIndex index { dir.path () };
+		QCOMPARE (index.GetTotalSize (), qint64 { -1 });
+		index.Load ();
+		QCOMPARE (index.GetTotalSize (), qint64 { 40 });
+		QCOMPARE (index.TakeEvicted (0),
+				(QList<QUrl> { MkUrl (1), MkUrl (2), MkUrl (3), MkUrl (0) }));
+	}
+
+	void NetworkDiskCacheIndexTest::testMergeOnLoad ()
+	{
+		QTemporaryDir dir;
+
+		{
+			NetworkDiskCacheIndex index { dir.path () };
+			index.Load ();
+			Fill (index, 4);
+		}
+
+		NetworkDiskCacheIndex index { dir.path () };
+		index.RecordInsert (MkUrl (1), 5);
+		index.RecordInsert (MkUrl (10), 10);
+		index.RecordRemove (MkUrl (2));
+		index.Load ();
+
+		QCOMPARE (index.GetTotalSize (), qint64 { 35 });
+		QCOMPARE (index.TakeEvicted (0),
+				(QList<QUrl> { MkUrl (0), MkUrl (3), MkUrl (1), MkUrl (10) }));
+	}
+}
+}
@@ -162,6 +162,12 @@ namespace Util
 
 		PropertyChanged (propName, propValue);
 
+		{
+			QMutexLocker locker { &SlotsLock_ };
+			for (const auto& slot : Slots_.value (name))
+				slot->Update (propValue);
+		}
+
 		if (ApplyProps_.contains (name))
 		{
 			const auto& objects = ApplyProps_.values (name);
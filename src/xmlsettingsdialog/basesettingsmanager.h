@@ -30,7 +30,9 @@
 #pragma once
 
 #include <memory>
+#include <QHash>
 #include <QMap>
+#include <QMutex>
 #include <QPair>
 #include <QObject>
 #include <QSettings>
@@ -38,6 +40,7 @@
 #include <QDynamicPropertyChangeEvent>
 #include <QPointer>
 #include "xsdconfig.h"
+#include "boundsetting.h"
 
 #define PROP2CHAR(a) (a.toUtf8 ().constData ())
 
@@ -66,6 +69,9 @@ namespace Util
 		bool IsInitializing_;
 		bool CleanupScheduled_;
 
+		QMutex SlotsLock_;
+		QHash<QByteArray, QList<std::shared_ptr<SettingSlotBase>>> Slots_;
+
 		friend class LeechCraft::SettingsThread;
 	protected:
 		bool ReadAllKeys_;
@@ -142,6 +148,42 @@ namespace Util
 		 */
 		QVariant Property (const QString& propName, const QVariant& def);
 
+		/** @brief Binds a typed handle to the given property.
+		 *
+		 * The returned handle always holds the current value of the
+		 * property converted to T and may be read from any thread
+		 * without going through the QObject property system. This is
+		 * the preferred way to read settings in hot paths like
+		 * per-request or per-message handlers.
+		 *
+		 * Handles bound to the same property with the same type share
+		 * their storage, so binding is cheap, but it's still better to
+		 * bind once and keep the handle.
+		 *
+		 * This function should be called from the thread the settings
+		 * manager lives in.
+		 *
+		 * @param[in] propName The name of the property to bind to.
+		 * @return The handle for reading the property value.
+		 *
+		 * @tparam T The type of the property value.
+		 */
+		template<typename T>
+		BoundSetting<T> Bind (const QByteArray& propName)
+		{
+			QMutexLocker locker { &SlotsLock_ };
+
+			auto& propSlots = Slots_ [propName];
+			for (const auto& slot : propSlots)
+				if (slot->GetTypeId () == qMetaTypeId<T> ())
+					return BoundSetting<T> { std::static_pointer_cast<SettingSlot<T>> (slot) };
+
+			const auto slot = std::make_shared<SettingSlot<T>> ();
+			slot->Update (property (propName.constData ()));
+			propSlots << slot;
+			return BoundSetting<T> { slot };
+		}
+
 		/** @brief Sets the value directly, without metaproperties system.
 		 *
 		 * This function just plainly calls setValue() on the
@@ -0,0 +1,147 @@
+/**********************************************************************
+ * LeechCraft - modular cross-platform feature rich internet client.
+ * Copyright (C) 2006-2014  Georg Rudoy
+ *
+ * Boost Software License - Version 1.0 - August 17th, 2003
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ **********************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <QVariant>
+
+namespace LeechCraft
+{
+namespace Util
+{
+	/** @brief The shared storage for the current value of a setting.
+	 *
+	 * Instances are owned by BaseSettingsManager and shared with the
+	 * BoundSetting objects that refer to them.
+	 *
+	 * @sa BoundSetting
+	 */
+	class SettingSlotBase
+	{
+	public:
+		virtual ~SettingSlotBase () = default;
+
+		/** @brief Returns the meta type ID of the stored value.
+		 */
+		virtual int GetTypeId () const = 0;
+
+		/** @brief Stores the new value of the setting.
+		 *
+		 * @param[in] value The new value of the setting.
+		 */
+		virtual void Update (const QVariant& value) = 0;
+	};
+
+	/** @brief Stores arbitrary types as atomically replaced immutable
+	 * snapshots.
+	 */
+	template<typename T, typename = void>
+	class SettingSlot : public SettingSlotBase
+	{
+		std::shared_ptr<const T> Value_ = std::make_shared<const T> ();
+	public:
+		int GetTypeId () const override
+		{
+			return qMetaTypeId<T> ();
+		}
+
+		void Update (const QVariant& value) override
+		{
+			std::atomic_store (&Value_, std::make_shared<const T> (value.value<T> ()));
+		}
+
+		T Get () const
+		{
+			return *std::atomic_load (&Value_);
+		}
+	};
+
+	/** @brief Stores arithmetic types directly in an atomic variable.
+	 */
+	template<typename T>
+	class SettingSlot<T, std::enable_if_t<std::is_arithmetic<T>::value>> : public SettingSlotBase
+	{
+		std::atomic<T> Value_ { T {} };
+	public:
+		int GetTypeId () const override
+		{
+			return qMetaTypeId<T> ();
+		}
+
+		void Update (const QVariant& value) override
+		{
+			Value_.store (value.value<T> (), std::memory_order_relaxed);
+		}
+
+		T Get () const
+		{
+			return Value_.load (std::memory_order_relaxed);
+		}
+	};
+
+	/** @brief A typed handle for reading a setting from any thread.
+	 *
+	 * A BoundSetting is obtained once via BaseSettingsManager::Bind()
+	 * and then reflects the current value of the setting: the settings
+	 * manager updates it whenever the corresponding property changes.
+	 * Reading the value never touches the settings manager, so it is
+	 * cheap and may be done from any thread, unlike
+	 * QObject::property().
+	 *
+	 * A default-constructed BoundSetting isn't bound to anything and
+	 * always returns a default-constructed T.
+	 *
+	 * @tparam T The type of the setting value.
+	 *
+	 * @sa BaseSettingsManager::Bind()
+	 */
+	template<typename T>
+	class BoundSetting
+	{
+		std::shared_ptr<const SettingSlot<T>> Slot_ = std::make_shared<SettingSlot<T>> ();
+	public:
+		BoundSetting () = default;
+
+		explicit BoundSetting (const std::shared_ptr<const SettingSlot<T>>& slot)
+		: Slot_ { slot }
+		{
+		}
+
+		/** @brief Returns the current value of the setting.
+		 */
+		T Get () const
+		{
+			return Slot_->Get ();
+		}
+	};
+}
+}